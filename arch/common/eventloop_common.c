@@ -53,3 +53,71 @@ UA_KeyValueRestriction_validate(const UA_Logger *logger, const char *logprefix,
 
     return UA_STATUSCODE_GOOD;
 }
+
+#ifdef UA_ENABLE_EVENTLOOP_STATISTICS
+
+/* Four sub-buckets per power of two. Values below four have their own
+ * bucket. */
+#define UA_HISTOGRAM_SUBBITS 2
+#define UA_HISTOGRAM_SUB (1 << UA_HISTOGRAM_SUBBITS)
+
+static size_t
+histogramBucket(UA_UInt64 v) {
+    if(v < UA_HISTOGRAM_SUB)
+        return (size_t)v;
+#if defined(__GNUC__) || defined(__clang__)
+    unsigned msb = 63 - (unsigned)__builtin_clzll(v);
+#else
+    unsigned msb = 0;
+    for(UA_UInt64 x = v; x >>= 1;)
+        msb++;
+#endif
+    size_t idx = (size_t)(msb - UA_HISTOGRAM_SUBBITS + 1) * UA_HISTOGRAM_SUB +
+        (size_t)((v >> (msb - UA_HISTOGRAM_SUBBITS)) & (UA_HISTOGRAM_SUB - 1));
+    return (idx < UA_EVENTLOOPHISTOGRAM_BUCKETS) ?
+        idx : UA_EVENTLOOPHISTOGRAM_BUCKETS - 1;
+}
+
+/* Largest value counted in the bucket */
+static UA_DateTime
+histogramBucketMax(size_t idx) {
+    if(idx < UA_HISTOGRAM_SUB)
+        return (UA_DateTime)idx;
+    size_t exp = idx / UA_HISTOGRAM_SUB - 1; /* Shift of the sub-bucket width */
+    UA_UInt64 base = (UA_UInt64)(UA_HISTOGRAM_SUB + idx % UA_HISTOGRAM_SUB) << exp;
+    return (UA_DateTime)(base + ((UA_UInt64)1 << exp) - 1);
+}
+
+void
+UA_EventLoopHistogram_add(UA_EventLoopHistogram *h, UA_DateTime value) {
+    if(value < 0)
+        value = 0; /* The clock was shifted */
+    h->count++;
+    h->total += value;
+    if(value > h->max)
+        h->max = value;
+    h->buckets[histogramBucket((UA_UInt64)value)]++;
+}
+
+UA_DateTime
+UA_EventLoopHistogram_percentile(const UA_EventLoopHistogram *h,
+                                 UA_Double percentile) {
+    if(h->count == 0)
+        return 0;
+    if(percentile > 100.0)
+        percentile = 100.0;
+    UA_UInt64 rank = (UA_UInt64)((UA_Double)h->count * percentile / 100.0);
+    if(rank == 0)
+        rank = 1;
+    UA_UInt64 seen = 0;
+    for(size_t i = 0; i < UA_EVENTLOOPHISTOGRAM_BUCKETS; i++) {
+        seen += h->buckets[i];
+        if(seen < rank)
+            continue;
+        UA_DateTime bound = histogramBucketMax(i);
+        return (bound < h->max) ? bound : h->max;
+    }
+    return h->max;
+}
+
+#endif /* UA_ENABLE_EVENTLOOP_STATISTICS */
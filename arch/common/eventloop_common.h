@@ -32,6 +32,22 @@ UA_KeyValueRestriction_validate(const UA_Logger *logger,
                                 size_t restrictionsSize,
                                 const UA_KeyValueMap *map);
 
+#ifdef UA_ENABLE_EVENTLOOP_STATISTICS
+
+void
+UA_EventLoopHistogram_add(UA_EventLoopHistogram *h, UA_DateTime value);
+
+static UA_INLINE void
+UA_EventLoopCallbackStatistics_add(UA_EventLoopCallbackStatistics *s,
+                                   UA_DateTime value) {
+    s->count++;
+    s->total += value;
+    if(value > s->max)
+        s->max = value;
+}
+
+#endif
+
 _UA_END_DECLS
 
 #endif /* UA_EVENTLOOP_COMMON_H_ */
@@ -45,7 +45,18 @@ calculateNextTime(UA_DateTime currentTime, UA_DateTime baseTime,
 
 void
 UA_Timer_init(UA_Timer *t) {
+#ifdef UA_ENABLE_TIMER_WHEEL
+    UA_Timer_initBackend(t, UA_TIMERBACKEND_WHEEL);
+#else
+    UA_Timer_initBackend(t, UA_TIMERBACKEND_ZIPTREE);
+#endif
+}
+
+void
+UA_Timer_initBackend(UA_Timer *t, UA_TimerBackend backend) {
     memset(t, 0, sizeof(UA_Timer));
+    if(backend == UA_TIMERBACKEND_WHEEL)
+        t->wheel = UA_TimerWheel_new();
     UA_LOCK_INIT(&t->timerMutex);
 }
 
@@ -131,17 +142,24 @@ UA_Timer_add(UA_Timer *t, UA_Callback callback,
     te->data = data;
     te->nextTime = nextTime;
     te->timerPolicy = timerPolicy;
-
-    /* Adjust the nextTime to batch cyclic callbacks */
-    batchTimerEntry(t, te);
+#ifdef UA_ENABLE_EVENTLOOP_STATISTICS
+    memset(&te->stats, 0, sizeof(UA_EventLoopCallbackStatistics));
+#endif
 
     /* Insert into the timer */
     UA_LOCK(&t->timerMutex);
     te->id = ++t->idCounter;
     if(callbackId)
         *callbackId = te->id;
-    ZIP_INSERT(UA_TimerTree, &t->tree, te);
-    ZIP_INSERT(UA_TimerIdTree, &t->idTree, te);
+    if(t->wheel) {
+        /* The wheel batches all callbacks within the same tick */
+        UA_TimerWheel_add(t->wheel, te, now);
+    } else {
+        /* Adjust the nextTime to batch cyclic callbacks */
+        batchTimerEntry(t, te);
+        ZIP_INSERT(UA_TimerTree, &t->tree, te);
+        ZIP_INSERT(UA_TimerIdTree, &t->idTree, te);
+    }
     UA_UNLOCK(&t->timerMutex);
 
     return UA_STATUSCODE_GOOD;
@@ -168,7 +186,8 @@ UA_Timer_modify(UA_Timer *t, UA_UInt64 callbackId,
     UA_LOCK(&t->timerMutex);
 
     /* Find timer entry based on id */
-    UA_TimerEntry *te = ZIP_FIND(UA_TimerIdTree, &t->idTree, &callbackId);
+    UA_TimerEntry *te = (t->wheel) ? UA_TimerWheel_find(t->wheel, callbackId) :
+        ZIP_FIND(UA_TimerIdTree, &t->idTree, &callbackId);
     if(!te) {
         UA_UNLOCK(&t->timerMutex);
         return UA_STATUSCODE_BADNOTFOUND;
@@ -176,7 +195,9 @@ UA_Timer_modify(UA_Timer *t, UA_UInt64 callbackId,
 
     /* The entry is either in the timer tree or current processed. If
      * in-process, the entry is re-added to the timer-tree right after. */
-    UA_Boolean processing = (ZIP_REMOVE(UA_TimerTree, &t->tree, te) == NULL);
+    UA_Boolean processing = (t->wheel) ?
+        !UA_TimerWheel_unschedule(t->wheel, te) :
+        (ZIP_REMOVE(UA_TimerTree, &t->tree, te) == NULL);
 
     /* The nextTime must only be modified after ZIP_REMOVE. The logic is
      * identical to the creation of a new timer. */
@@ -186,10 +207,13 @@ UA_Timer_modify(UA_Timer *t, UA_UInt64 callbackId,
     te->timerPolicy = timerPolicy;
 
     /* Adjust the nextTime to batch cyclic callbacks */
-    batchTimerEntry(t, te);
+    if(!t->wheel)
+        batchTimerEntry(t, te);
 
     if(processing)
         te->nextTime -= interval; /* adjust for re-adding after processing */
+    else if(t->wheel)
+        UA_TimerWheel_schedule(t->wheel, te, now);
     else
         ZIP_INSERT(UA_TimerTree, &t->tree, te);
 
@@ -200,7 +224,8 @@ UA_Timer_modify(UA_Timer *t, UA_UInt64 callbackId,
 void
 UA_Timer_remove(UA_Timer *t, UA_UInt64 callbackId) {
     UA_LOCK(&t->timerMutex);
-    UA_TimerEntry *te = ZIP_FIND(UA_TimerIdTree, &t->idTree, &callbackId);
+    UA_TimerEntry *te = (t->wheel) ? UA_TimerWheel_find(t->wheel, callbackId) :
+        ZIP_FIND(UA_TimerIdTree, &t->idTree, &callbackId);
     if(!te) {
         UA_UNLOCK(&t->timerMutex);
         return;
@@ -209,9 +234,14 @@ UA_Timer_remove(UA_Timer *t, UA_UInt64 callbackId) {
     /* The entry is either in the timer tree or in the process tree. If in the
      * process tree, leave a sentinel (callback == NULL) to delete it during
      * processing. Do not edit the process tree while iterating over it. */
-    UA_Boolean processing = (ZIP_REMOVE(UA_TimerTree, &t->tree, te) == NULL);
+    UA_Boolean processing = (t->wheel) ?
+        !UA_TimerWheel_unschedule(t->wheel, te) :
+        (ZIP_REMOVE(UA_TimerTree, &t->tree, te) == NULL);
     if(!processing) {
-        ZIP_REMOVE(UA_TimerIdTree, &t->idTree, te);
+        if(t->wheel)
+            UA_TimerWheel_remove(t->wheel, te);
+        else
+            ZIP_REMOVE(UA_TimerIdTree, &t->idTree, te);
         UA_free(te);
     } else {
         te->cb = NULL;
@@ -225,22 +255,32 @@ struct TimerProcessContext {
     UA_DateTime now;
 };
 
-static void *
-processEntryCallback(void *context, UA_TimerEntry *te) {
-    struct TimerProcessContext *tpc = (struct TimerProcessContext*)context;
-    UA_Timer *t = tpc->t;
-
+/* Execute the callback and compute the next execution time. Returns false if
+ * the entry needs to be removed afterwards. */
+static UA_Boolean
+executeEntry(UA_Timer *t, UA_TimerEntry *te, UA_DateTime now) {
     /* Execute the callback */
     if(te->cb) {
+#ifdef UA_ENABLE_EVENTLOOP_STATISTICS
+        UA_DateTime start = 0;
+        if(t->statistics) {
+            start = t->clock->dateTime_nowMonotonic(t->clock);
+            UA_EventLoopHistogram_add(&t->statistics->timerLag, start - te->nextTime);
+        }
+#endif
         te->cb(te->application, te->data);
+#ifdef UA_ENABLE_EVENTLOOP_STATISTICS
+        if(t->statistics) {
+            UA_DateTime duration = t->clock->dateTime_nowMonotonic(t->clock) - start;
+            UA_EventLoopHistogram_add(&t->statistics->timerCallbacks, duration);
+            UA_EventLoopCallbackStatistics_add(&te->stats, duration);
+        }
+#endif
     }
 
     /* Remove the entry if marked for deletion or a "once" policy */
-    if(!te->cb || te->timerPolicy == UA_TIMERPOLICY_ONCE) {
-        ZIP_REMOVE(UA_TimerIdTree, &t->idTree, te);
-        UA_free(te);
-        return NULL;
-    }
+    if(!te->cb || te->timerPolicy == UA_TIMERPOLICY_ONCE)
+        return false;
 
     /* Set the time for the next regular execution */
     te->nextTime += te->interval;
@@ -256,10 +296,23 @@ processEntryCallback(void *context, UA_TimerEntry *te) {
      *
      * Otherwise calculate the next execution time based on the original base
      * time. */
-    if(te->nextTime < tpc->now) {
+    if(te->nextTime < now) {
         te->nextTime = (te->timerPolicy == UA_TIMERPOLICY_CURRENTTIME) ?
-            tpc->now + te->interval :
-            calculateNextTime(tpc->now, te->nextTime, te->interval);
+            now + te->interval :
+            calculateNextTime(now, te->nextTime, te->interval);
+    }
+    return true;
+}
+
+static void *
+processEntryCallback(void *context, UA_TimerEntry *te) {
+    struct TimerProcessContext *tpc = (struct TimerProcessContext*)context;
+    UA_Timer *t = tpc->t;
+
+    if(!executeEntry(t, te, tpc->now)) {
+        ZIP_REMOVE(UA_TimerIdTree, &t->idTree, te);
+        UA_free(te);
+        return NULL;
     }
 
     /* Insert back into the time-sorted tree */
@@ -267,10 +320,36 @@ processEntryCallback(void *context, UA_TimerEntry *te) {
     return NULL;
 }
 
+static UA_DateTime
+processWheel(UA_Timer *t, UA_DateTime now) {
+    UA_TimerWheel *w = t->wheel;
+    /* Detach all due entries from the wheel. Entries removed by the callbacks
+     * in the meantime are only marked with a sentinel. So the list of expired
+     * entries remains intact. */
+    UA_TimerEntry *te = UA_TimerWheel_expire(w, now);
+    while(te) {
+        UA_TimerEntry *next = te->wheelNext;
+        if(executeEntry(t, te, now)) {
+            UA_TimerWheel_schedule(w, te, now);
+        } else {
+            UA_TimerWheel_remove(w, te);
+            UA_free(te);
+        }
+        te = next;
+    }
+    return UA_TimerWheel_next(w);
+}
+
 UA_DateTime
 UA_Timer_process(UA_Timer *t, UA_DateTime now) {
     UA_LOCK(&t->timerMutex);
 
+    if(t->wheel) {
+        UA_DateTime next = processWheel(t, now);
+        UA_UNLOCK(&t->timerMutex);
+        return next;
+    }
+
     /* Move all entries <= now to the processTree */
     UA_TimerTree processTree;
     ZIP_INIT(&processTree);
@@ -297,6 +376,11 @@ UA_Timer_process(UA_Timer *t, UA_DateTime now) {
 UA_DateTime
 UA_Timer_next(UA_Timer *t) {
     UA_LOCK(&t->timerMutex);
+    if(t->wheel) {
+        UA_DateTime next = UA_TimerWheel_next(t->wheel);
+        UA_UNLOCK(&t->timerMutex);
+        return next;
+    }
     UA_TimerEntry *first = ZIP_MIN(UA_TimerTree, &t->tree);
     UA_DateTime next = (first) ? first->nextTime : UA_INT64_MAX;
     UA_UNLOCK(&t->timerMutex);
@@ -313,6 +397,10 @@ void
 UA_Timer_clear(UA_Timer *t) {
     UA_LOCK(&t->timerMutex);
 
+    if(t->wheel) {
+        UA_TimerWheel_delete(t->wheel);
+        t->wheel = NULL;
+    }
     ZIP_ITER(UA_TimerIdTree, &t->idTree, freeEntryCallback, NULL);
     t->tree.root = NULL;
     t->idTree.root = NULL;
@@ -324,3 +412,33 @@ UA_Timer_clear(UA_Timer *t) {
     UA_LOCK_DESTROY(&t->timerMutex);
 #endif
 }
+
+#ifdef UA_ENABLE_EVENTLOOP_STATISTICS
+
+struct TimerIterateContext {
+    UA_TimerIterateCallback cb;
+    void *context;
+};
+
+static void *
+iterateEntryCallback(void *context, UA_TimerEntry *te) {
+    struct TimerIterateContext *tic = (struct TimerIterateContext*)context;
+    tic->cb(tic->context, te);
+    return NULL;
+}
+
+void
+UA_Timer_iterate(UA_Timer *t, UA_TimerIterateCallback cb, void *context) {
+    UA_LOCK(&t->timerMutex);
+    if(t->wheel) {
+        UA_TimerWheel_iterate(t->wheel, cb, context);
+    } else {
+        struct TimerIterateContext tic;
+        tic.cb = cb;
+        tic.context = context;
+        ZIP_ITER(UA_TimerIdTree, &t->idTree, iterateEntryCallback, &tic);
+    }
+    UA_UNLOCK(&t->timerMutex);
+}
+
+#endif /* UA_ENABLE_EVENTLOOP_STATISTICS */
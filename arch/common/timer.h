@@ -12,6 +12,7 @@
 #include <open62541/types.h>
 #include <open62541/plugin/eventloop.h>
 #include "ziptree.h"
+#include "eventloop_common.h"
 
 _UA_BEGIN_DECLS
 
@@ -39,24 +40,65 @@ typedef struct UA_TimerEntry {
 
     ZIP_ENTRY(UA_TimerEntry) idTreeEntry;
     UA_UInt64 id;                            /* Id of the entry */
+
+    /* Only used by the timing wheel backend */
+    struct UA_TimerEntry *wheelNext;  /* Circular list of the slot. Also
+                                       * links the list of processed entries. */
+    struct UA_TimerEntry *wheelPrev;
+    struct UA_TimerEntry **wheelSlot; /* NULL while the entry is processed */
+    struct UA_TimerEntry *idNext;     /* Chaining in the id hash map */
+
+#ifdef UA_ENABLE_EVENTLOOP_STATISTICS
+    UA_EventLoopCallbackStatistics stats;
+#endif
 } UA_TimerEntry;
 
 typedef ZIP_HEAD(UA_TimerTree, UA_TimerEntry) UA_TimerTree;
 typedef ZIP_HEAD(UA_TimerIdTree, UA_TimerEntry) UA_TimerIdTree;
 
+/* The timer has two interchangeable backends for storing the entries:
+ *
+ * - The zip-tree backend keeps the entries sorted by time and by id. Insertion
+ *   and removal are O(log n). Cyclic callbacks with the "CurrentTime" policy
+ *   are batched with nearby callbacks of a compatible interval.
+ * - The hierarchical timing wheel has O(1) insertion and removal and expires
+ *   all entries of a tick (1024 * 100ns) together. This scales better for
+ *   servers with a large number of cyclic callbacks (e.g. sampling
+ *   MonitoredItems). The tick resolution is kept by the precise nextTime of
+ *   the entries. So no callback is executed early. */
+typedef enum {
+    UA_TIMERBACKEND_ZIPTREE = 0,
+    UA_TIMERBACKEND_WHEEL = 1
+} UA_TimerBackend;
+
+typedef struct UA_TimerWheel UA_TimerWheel;
+
 typedef struct {
+    UA_TimerWheel *wheel;  /* Set if the timing wheel backend is used */
     UA_TimerTree tree;     /* The root of the time-sorted tree */
     UA_TimerIdTree idTree; /* The root of the id-sorted tree */
     UA_UInt64 idCounter;   /* Generate unique identifiers. Identifiers are
                             * always above zero. */
+#ifdef UA_ENABLE_EVENTLOOP_STATISTICS
+    /* The execution times of the callbacks are measured with the clock of the
+     * EventLoop if the statistics are set */
+    UA_EventLoop *clock;
+    UA_EventLoopStatistics *statistics;
+#endif
 #if UA_MULTITHREADING >= 100
     UA_Lock timerMutex;
 #endif
 } UA_Timer;
 
+/* Initialize with the default backend. That is the timing wheel if
+ * UA_ENABLE_TIMER_WHEEL is defined. */
 void
 UA_Timer_init(UA_Timer *t);
 
+/* Falls back to the zip-tree backend if the wheel cannot be allocated */
+void
+UA_Timer_initBackend(UA_Timer *t, UA_TimerBackend backend);
+
 UA_DateTime
 UA_Timer_next(UA_Timer *t);
 
@@ -80,6 +122,61 @@ UA_Timer_process(UA_Timer *t, UA_DateTime now);
 void
 UA_Timer_clear(UA_Timer *t);
 
+#ifdef UA_ENABLE_EVENTLOOP_STATISTICS
+/* Iterate over all entries (in no particular order). The callback is executed
+ * with the timer mutex held and must not modify the timer. */
+typedef void (*UA_TimerIterateCallback)(void *context, UA_TimerEntry *te);
+
+void
+UA_Timer_iterate(UA_Timer *t, UA_TimerIterateCallback cb, void *context);
+#endif
+
+/* Internal interface of the timing wheel backend. The entries are allocated
+ * and freed by the UA_Timer. The wheel only stores them. */
+
+UA_TimerWheel *
+UA_TimerWheel_new(void);
+
+/* Frees the wheel and all entries it contains */
+void
+UA_TimerWheel_delete(UA_TimerWheel *w);
+
+/* Add to the id map and schedule for te->nextTime */
+void
+UA_TimerWheel_add(UA_TimerWheel *w, UA_TimerEntry *te, UA_DateTime now);
+
+UA_TimerEntry *
+UA_TimerWheel_find(UA_TimerWheel *w, UA_UInt64 id);
+
+/* Remove from the id map. The entry must not be scheduled. */
+void
+UA_TimerWheel_remove(UA_TimerWheel *w, UA_TimerEntry *te);
+
+/* Schedule for te->nextTime. The entry must not be scheduled already. */
+void
+UA_TimerWheel_schedule(UA_TimerWheel *w, UA_TimerEntry *te, UA_DateTime now);
+
+/* Returns false if the entry is not scheduled (i.e. currently processed) */
+UA_Boolean
+UA_TimerWheel_unschedule(UA_TimerWheel *w, UA_TimerEntry *te);
+
+/* Detach all entries with nextTime <= now. They are returned as a list linked
+ * via wheelNext and need to be scheduled again or removed. */
+UA_TimerEntry *
+UA_TimerWheel_expire(UA_TimerWheel *w, UA_DateTime now);
+
+/* Returns the next execution time or a lower bound for it. The lower bound is
+ * used if the next entries still have to be cascaded from the higher levels of
+ * the wheel. UA_INT64_MAX is returned for an empty wheel. */
+UA_DateTime
+UA_TimerWheel_next(UA_TimerWheel *w);
+
+#ifdef UA_ENABLE_EVENTLOOP_STATISTICS
+void
+UA_TimerWheel_iterate(UA_TimerWheel *w, UA_TimerIterateCallback cb,
+                      void *context);
+#endif
+
 _UA_END_DECLS
 
 #endif /* UA_TIMER_H_ */
@@ -0,0 +1,432 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "timer.h"
+
+/* Hierarchical timing wheel. Every level has 64 slots. A slot of level 0
+ * covers one tick. A slot of level n covers 64^n ticks. The entries are placed
+ * according to the highest 6-bit group in which their tick differs from the
+ * current tick of the wheel. So all entries of a level-n slot share the upper
+ * bits with the current tick and are cascaded to the lower levels once the
+ * current tick reaches the beginning of the slot. Entries beyond the range of
+ * the top level are kept in an overflow list that is cascaded when the upper
+ * bits of the current tick change. The occupied slots of every level are
+ * tracked in a bitmap to skip over empty slots. */
+
+#define UA_TIMERWHEEL_TICKSHIFT 10 /* One tick is 1024 * 100ns */
+#define UA_TIMERWHEEL_LEVELS 6
+#define UA_TIMERWHEEL_SLOTBITS 6
+#define UA_TIMERWHEEL_SLOTS (1 << UA_TIMERWHEEL_SLOTBITS)
+#define UA_TIMERWHEEL_SLOTMASK (UA_TIMERWHEEL_SLOTS - 1)
+#define UA_TIMERWHEEL_RANGEBITS (UA_TIMERWHEEL_LEVELS * UA_TIMERWHEEL_SLOTBITS)
+#define UA_TIMERWHEEL_IDMAPSIZE 64 /* Initial size, grows as powers of two */
+
+struct UA_TimerWheel {
+    UA_UInt64 current; /* Current tick. No scheduled entry is before it. */
+    UA_UInt64 occupied[UA_TIMERWHEEL_LEVELS];
+    UA_TimerEntry *slots[UA_TIMERWHEEL_LEVELS][UA_TIMERWHEEL_SLOTS];
+    UA_TimerEntry *overflow;
+
+    /* The ids are assigned from a counter. So the lower bits are a perfect
+     * hash for the id map. */
+    UA_TimerEntry **idMap;
+    size_t idMapSize;
+    size_t idCount;
+};
+
+static unsigned
+lowestBit(UA_UInt64 x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctzll(x);
+#else
+    unsigned i = 0;
+    while(!(x & 1)) {
+        x >>= 1;
+        i++;
+    }
+    return i;
+#endif
+}
+
+static unsigned
+highestBit(UA_UInt64 x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - (unsigned)__builtin_clzll(x);
+#else
+    unsigned i = 0;
+    while(x >>= 1)
+        i++;
+    return i;
+#endif
+}
+
+static UA_UInt64
+toTick(UA_DateTime time) {
+    return (time <= 0) ? 0 : (UA_UInt64)time >> UA_TIMERWHEEL_TICKSHIFT;
+}
+
+static UA_Boolean
+isEmpty(const UA_TimerWheel *w) {
+    if(w->overflow)
+        return false;
+    for(size_t i = 0; i < UA_TIMERWHEEL_LEVELS; i++) {
+        if(w->occupied[i])
+            return false;
+    }
+    return true;
+}
+
+UA_TimerWheel *
+UA_TimerWheel_new(void) {
+    UA_TimerWheel *w = (UA_TimerWheel*)UA_calloc(1, sizeof(UA_TimerWheel));
+    if(!w)
+        return NULL;
+    w->idMap = (UA_TimerEntry**)
+        UA_calloc(UA_TIMERWHEEL_IDMAPSIZE, sizeof(UA_TimerEntry*));
+    if(!w->idMap) {
+        UA_free(w);
+        return NULL;
+    }
+    w->idMapSize = UA_TIMERWHEEL_IDMAPSIZE;
+    return w;
+}
+
+void
+UA_TimerWheel_delete(UA_TimerWheel *w) {
+    /* All entries are in the id map. Also the entries that are currently
+     * processed. */
+    for(size_t i = 0; i < w->idMapSize; i++) {
+        UA_TimerEntry *te = w->idMap[i];
+        while(te) {
+            UA_TimerEntry *next = te->idNext;
+            UA_free(te);
+            te = next;
+        }
+    }
+    UA_free(w->idMap);
+    UA_free(w);
+}
+
+/********/
+/* Slot */
+/********/
+
+static void
+slotAppend(UA_TimerEntry **slot, UA_TimerEntry *te) {
+    UA_TimerEntry *head = *slot;
+    te->wheelSlot = slot;
+    if(!head) {
+        te->wheelNext = te;
+        te->wheelPrev = te;
+        *slot = te;
+        return;
+    }
+    /* Append at the end to execute in the order of insertion */
+    te->wheelNext = head;
+    te->wheelPrev = head->wheelPrev;
+    head->wheelPrev->wheelNext = te;
+    head->wheelPrev = te;
+}
+
+static void
+slotRemove(UA_TimerWheel *w, UA_TimerEntry *te) {
+    UA_TimerEntry **slot = te->wheelSlot;
+    te->wheelSlot = NULL;
+    if(te->wheelNext != te) {
+        te->wheelPrev->wheelNext = te->wheelNext;
+        te->wheelNext->wheelPrev = te->wheelPrev;
+        if(*slot == te)
+            *slot = te->wheelNext;
+        return;
+    }
+
+    /* The slot is empty now */
+    *slot = NULL;
+    if(slot == &w->overflow)
+        return;
+    size_t pos = (size_t)(slot - &w->slots[0][0]);
+    w->occupied[pos / UA_TIMERWHEEL_SLOTS] &=
+        ~((UA_UInt64)1 << (pos % UA_TIMERWHEEL_SLOTS));
+}
+
+/* Detach the entire list of the slot */
+static UA_TimerEntry *
+slotTake(UA_TimerWheel *w, size_t level, size_t pos) {
+    UA_TimerEntry *head = w->slots[level][pos];
+    if(!head)
+        return NULL;
+    w->slots[level][pos] = NULL;
+    w->occupied[level] &= ~((UA_UInt64)1 << pos);
+    head->wheelPrev->wheelNext = NULL; /* Break the circle */
+    return head;
+}
+
+/**************/
+/* Scheduling */
+/**************/
+
+static void
+insert(UA_TimerWheel *w, UA_TimerEntry *te) {
+    /* Entries that are already due are placed in the current slot */
+    UA_UInt64 tick = toTick(te->nextTime);
+    if(tick < w->current)
+        tick = w->current;
+
+    /* Beyond the range of the top level */
+    UA_UInt64 diff = tick ^ w->current;
+    if(diff >> UA_TIMERWHEEL_RANGEBITS) {
+        slotAppend(&w->overflow, te);
+        return;
+    }
+
+    /* Select the level by the highest group of bits that differs */
+    size_t level = (diff) ? highestBit(diff) / UA_TIMERWHEEL_SLOTBITS : 0;
+    size_t pos = (size_t)(tick >> (level * UA_TIMERWHEEL_SLOTBITS)) &
+        UA_TIMERWHEEL_SLOTMASK;
+    w->occupied[level] |= (UA_UInt64)1 << pos;
+    slotAppend(&w->slots[level][pos], te);
+}
+
+void
+UA_TimerWheel_schedule(UA_TimerWheel *w, UA_TimerEntry *te, UA_DateTime now) {
+    /* Move an empty wheel forward. Otherwise the first entry after a long
+     * pause is placed relative to an outdated tick. */
+    UA_UInt64 nowTick = toTick(now);
+    if(nowTick > w->current && isEmpty(w))
+        w->current = nowTick;
+    insert(w, te);
+}
+
+UA_Boolean
+UA_TimerWheel_unschedule(UA_TimerWheel *w, UA_TimerEntry *te) {
+    if(!te->wheelSlot)
+        return false;
+    slotRemove(w, te);
+    return true;
+}
+
+/**********/
+/* Id Map */
+/**********/
+
+static void
+growIdMap(UA_TimerWheel *w) {
+    size_t newSize = w->idMapSize * 2;
+    UA_TimerEntry **newMap = (UA_TimerEntry**)
+        UA_calloc(newSize, sizeof(UA_TimerEntry*));
+    if(!newMap)
+        return; /* Keep the map. Only the chains get longer. */
+    for(size_t i = 0; i < w->idMapSize; i++) {
+        UA_TimerEntry *te = w->idMap[i];
+        while(te) {
+            UA_TimerEntry *next = te->idNext;
+            size_t pos = (size_t)(te->id & (newSize - 1));
+            te->idNext = newMap[pos];
+            newMap[pos] = te;
+            te = next;
+        }
+    }
+    UA_free(w->idMap);
+    w->idMap = newMap;
+    w->idMapSize = newSize;
+}
+
+void
+UA_TimerWheel_add(UA_TimerWheel *w, UA_TimerEntry *te, UA_DateTime now) {
+    if(w->idCount >= w->idMapSize)
+        growIdMap(w);
+    size_t pos = (size_t)(te->id & (w->idMapSize - 1));
+    te->idNext = w->idMap[pos];
+    w->idMap[pos] = te;
+    w->idCount++;
+    UA_TimerWheel_schedule(w, te, now);
+}
+
+UA_TimerEntry *
+UA_TimerWheel_find(UA_TimerWheel *w, UA_UInt64 id) {
+    UA_TimerEntry *te = w->idMap[id & (w->idMapSize - 1)];
+    while(te && te->id != id)
+        te = te->idNext;
+    return te;
+}
+
+void
+UA_TimerWheel_remove(UA_TimerWheel *w, UA_TimerEntry *te) {
+    UA_TimerEntry **pp = &w->idMap[te->id & (w->idMapSize - 1)];
+    while(*pp && *pp != te)
+        pp = &(*pp)->idNext;
+    if(!*pp)
+        return;
+    *pp = te->idNext;
+    w->idCount--;
+}
+
+#ifdef UA_ENABLE_EVENTLOOP_STATISTICS
+void
+UA_TimerWheel_iterate(UA_TimerWheel *w, UA_TimerIterateCallback cb,
+                      void *context) {
+    for(size_t i = 0; i < w->idMapSize; i++) {
+        for(UA_TimerEntry *te = w->idMap[i]; te; te = te->idNext)
+            cb(context, te);
+    }
+}
+#endif
+
+/**********/
+/* Expiry */
+/**********/
+
+/* Returns the first tick after the current level-0 block where a slot of the
+ * higher levels (or the overflow list) needs to be cascaded. UA_UINT64_MAX if
+ * the higher levels are empty. */
+static UA_UInt64
+nextCascade(const UA_TimerWheel *w) {
+    for(size_t level = 1; level < UA_TIMERWHEEL_LEVELS; level++) {
+        size_t shift = level * UA_TIMERWHEEL_SLOTBITS;
+        size_t pos = (size_t)(w->current >> shift) & UA_TIMERWHEEL_SLOTMASK;
+        /* The slots of the level are all after the current position */
+        UA_UInt64 later = w->occupied[level] & ~(((UA_UInt64)2 << pos) - 1);
+        if(!later)
+            continue;
+        /* The lower levels are always cascaded before the higher levels */
+        shift += UA_TIMERWHEEL_SLOTBITS;
+        return ((w->current >> shift) << shift) |
+            ((UA_UInt64)lowestBit(later) << (level * UA_TIMERWHEEL_SLOTBITS));
+    }
+    if(w->overflow)
+        return ((w->current >> UA_TIMERWHEEL_RANGEBITS) + 1)
+            << UA_TIMERWHEEL_RANGEBITS;
+    return UA_UINT64_MAX;
+}
+
+static void
+reinsertList(UA_TimerWheel *w, UA_TimerEntry *te) {
+    while(te) {
+        UA_TimerEntry *next = te->wheelNext;
+        insert(w, te);
+        te = next;
+    }
+}
+
+/* Advance to the tick and move the entries from the slots that begin there to
+ * the lower levels. Starting from the top so that every entry moves down in
+ * one step. */
+static void
+cascade(UA_TimerWheel *w, UA_UInt64 tick) {
+    UA_UInt64 changed = w->current ^ tick;
+    w->current = tick;
+    if(changed >> UA_TIMERWHEEL_RANGEBITS) {
+        UA_TimerEntry *overflow = w->overflow;
+        if(overflow) {
+            w->overflow = NULL;
+            overflow->wheelPrev->wheelNext = NULL;
+            reinsertList(w, overflow);
+        }
+    }
+    size_t top = highestBit(changed) / UA_TIMERWHEEL_SLOTBITS;
+    if(top >= UA_TIMERWHEEL_LEVELS)
+        top = UA_TIMERWHEEL_LEVELS - 1;
+    for(size_t level = top; level > 0; level--) {
+        size_t pos = (size_t)(tick >> (level * UA_TIMERWHEEL_SLOTBITS)) &
+            UA_TIMERWHEEL_SLOTMASK;
+        reinsertList(w, slotTake(w, level, pos));
+    }
+}
+
+/* Move the due entries of the level-0 slots [from, to] to the expired list.
+ * In the last slot only the entries with nextTime <= now are due. */
+static UA_TimerEntry **
+collect(UA_TimerWheel *w, size_t from, size_t to, UA_Boolean partial,
+        UA_DateTime now, UA_TimerEntry **tail) {
+    UA_UInt64 range = w->occupied[0] & ~(((UA_UInt64)1 << from) - 1);
+    if(to < UA_TIMERWHEEL_SLOTS - 1)
+        range &= ((UA_UInt64)2 << to) - 1;
+    while(range) {
+        size_t pos = lowestBit(range);
+        range &= range - 1;
+        if(!partial || pos != to) {
+            /* Take the entire slot */
+            UA_TimerEntry *head = slotTake(w, 0, pos);
+            for(UA_TimerEntry *te = head; te; te = te->wheelNext)
+                te->wheelSlot = NULL;
+            *tail = head;
+            while(*tail)
+                tail = &(*tail)->wheelNext;
+            continue;
+        }
+
+        /* Take only the due entries */
+        UA_TimerEntry *te = w->slots[0][pos];
+        UA_TimerEntry *last = te->wheelPrev;
+        UA_Boolean done = false;
+        while(!done) {
+            UA_TimerEntry *next = te->wheelNext;
+            done = (te == last);
+            if(te->nextTime <= now) {
+                slotRemove(w, te);
+                te->wheelNext = NULL;
+                *tail = te;
+                tail = &te->wheelNext;
+            }
+            te = next;
+        }
+    }
+    return tail;
+}
+
+UA_TimerEntry *
+UA_TimerWheel_expire(UA_TimerWheel *w, UA_DateTime now) {
+    UA_TimerEntry *expired = NULL;
+    UA_TimerEntry **tail = &expired;
+    UA_UInt64 nowTick = toTick(now);
+    if(nowTick < w->current)
+        nowTick = w->current;
+
+    while(true) {
+        size_t pos = (size_t)w->current & UA_TIMERWHEEL_SLOTMASK;
+
+        /* The current level-0 block contains nowTick */
+        if((nowTick >> UA_TIMERWHEEL_SLOTBITS) ==
+           (w->current >> UA_TIMERWHEEL_SLOTBITS)) {
+            collect(w, pos, (size_t)nowTick & UA_TIMERWHEEL_SLOTMASK,
+                    true, now, tail);
+            w->current = nowTick;
+            break;
+        }
+
+        /* Take the remainder of the current block. Then skip ahead to the next
+         * slot of the higher levels that needs to be cascaded. */
+        tail = collect(w, pos, UA_TIMERWHEEL_SLOTS - 1, false, now, tail);
+        UA_UInt64 next = nextCascade(w);
+        if(next > nowTick) {
+            w->current = nowTick;
+            break;
+        }
+        cascade(w, next);
+    }
+    return expired;
+}
+
+UA_DateTime
+UA_TimerWheel_next(UA_TimerWheel *w) {
+    /* The first occupied level-0 slot contains the earliest entry */
+    size_t pos = (size_t)w->current & UA_TIMERWHEEL_SLOTMASK;
+    UA_UInt64 later = w->occupied[0] & ~(((UA_UInt64)1 << pos) - 1);
+    if(later) {
+        UA_TimerEntry *head = w->slots[0][lowestBit(later)];
+        UA_DateTime next = head->nextTime;
+        for(UA_TimerEntry *te = head->wheelNext; te != head; te = te->wheelNext) {
+            if(te->nextTime < next)
+                next = te->nextTime;
+        }
+        return next;
+    }
+
+    /* Wake up when the next slot needs to be cascaded */
+    UA_UInt64 cascadeTick = nextCascade(w);
+    if(cascadeTick == UA_UINT64_MAX)
+        return UA_INT64_MAX;
+    return (UA_DateTime)(cascadeTick << UA_TIMERWHEEL_TICKSHIFT);
+}
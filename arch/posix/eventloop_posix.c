@@ -138,6 +138,9 @@ processDelayed(UA_EventLoopPOSIX *el) {
     resetDelayedQueue(el, &dc, &tail);
 
     /* Loop until we reach the tail (or head and tail are both NULL) */
+#ifdef UA_ENABLE_EVENTLOOP_STATISTICS
+    size_t queueLength = 0;
+#endif
     UA_DelayedCallback *next;
     for(; dc; dc = next) {
         next = dc->next;
@@ -145,14 +148,37 @@ processDelayed(UA_EventLoopPOSIX *el) {
             next = (UA_DelayedCallback *)UA_atomic_load((void**)&dc->next);
         if(!dc->callback)
             continue;
+#ifdef UA_ENABLE_EVENTLOOP_STATISTICS
+        queueLength++;
+        UA_DateTime start = el->eventLoop.dateTime_nowMonotonic(&el->eventLoop);
+        dc->callback(dc->application, dc->context);
+        /* Don't access dc after the callback. It might be freed. */
+        UA_EventLoopHistogram_add(&el->statistics.delayedCallbacks,
+                                  el->eventLoop.dateTime_nowMonotonic(&el->eventLoop) - start);
+#else
         dc->callback(dc->application, dc->context);
+#endif
     }
+
+#ifdef UA_ENABLE_EVENTLOOP_STATISTICS
+    el->statistics.delayedQueueLength = queueLength;
+    if(queueLength > el->statistics.delayedQueueLengthMax)
+        el->statistics.delayedQueueLengthMax = queueLength;
+#endif
 }
 
 /***********************/
 /* EventLoop Lifecycle */
 /***********************/
 
+/* Configuration parameters */
+#define POSIXEVENTLOOP_PARAMETERSSIZE 1
+#define POSIXEVENTLOOP_PARAMINDEX_IOURING 0
+
+static UA_KeyValueRestriction POSIXEventLoopConfigParameters[POSIXEVENTLOOP_PARAMETERSSIZE] = {
+    {{0, UA_STRING_STATIC("io-uring")}, &UA_TYPES[UA_TYPES_BOOLEAN], false, true, false}
+};
+
 static UA_StatusCode
 UA_EventLoopPOSIX_start(UA_EventLoopPOSIX *el) {
     UA_LOCK(&el->elMutex);
@@ -166,6 +192,36 @@ UA_EventLoopPOSIX_start(UA_EventLoopPOSIX *el) {
     UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
                  "Starting the EventLoop");
 
+    /* Check the parameters */
+    UA_StatusCode res =
+        UA_KeyValueRestriction_validate(el->eventLoop.logger, "Eventloop",
+                                        POSIXEventLoopConfigParameters,
+                                        POSIXEVENTLOOP_PARAMETERSSIZE,
+                                        &el->eventLoop.params);
+    if(res != UA_STATUSCODE_GOOD) {
+        UA_UNLOCK(&el->elMutex);
+        return res;
+    }
+
+    /* Use the io_uring? */
+    UA_Boolean useIOUring = false;
+    const UA_Boolean *iouring = (const UA_Boolean*)
+        UA_KeyValueMap_getScalar(&el->eventLoop.params,
+                                 POSIXEventLoopConfigParameters[POSIXEVENTLOOP_PARAMINDEX_IOURING].name,
+                                 &UA_TYPES[UA_TYPES_BOOLEAN]);
+    if(iouring)
+        useIOUring = *iouring;
+#ifndef UA_HAVE_IO_URING
+    if(useIOUring) {
+        UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                     "Eventloop\t| Parameter io-uring is set, but the io_uring "
+                     "backend is not available (build with UA_ENABLE_IO_URING "
+                     "on Linux)");
+        UA_UNLOCK(&el->elMutex);
+        return UA_STATUSCODE_BADNOTSUPPORTED;
+    }
+#endif
+
     /* Setting custom clock source */
     const UA_Int32 *cs = (const UA_Int32*)
         UA_KeyValueMap_getScalar(&el->eventLoop.params,
@@ -207,6 +263,21 @@ UA_EventLoopPOSIX_start(UA_EventLoopPOSIX *el) {
         return UA_STATUSCODE_BADINTERNALERROR;
     }
 
+#ifdef UA_HAVE_IO_URING
+    /* Use the io_uring if enabled. Fall back to epoll if the io_uring cannot
+     * be set up (e.g. disabled in the kernel). The io_uring binds the
+     * requests to the thread that has submitted them. So it is opt-in for
+     * applications that run the EventLoop from a single thread. */
+    if(useIOUring &&
+       UA_EventLoopPOSIX_IOUring_start(el) != UA_STATUSCODE_GOOD) {
+        UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                       "Eventloop\t| Could not set up the io_uring, "
+                       "falling back to epoll");
+    }
+    if(UA_EventLoopPOSIX_usesIOUring(el))
+        goto start_eventsources;
+#endif
+
     /* Create the epoll socket */
 #ifdef UA_HAVE_EPOLL
     el->epollfd = epoll_create1(0);
@@ -240,8 +311,10 @@ UA_EventLoopPOSIX_start(UA_EventLoopPOSIX *el) {
     }
 #endif
 
+#ifdef UA_HAVE_IO_URING
+ start_eventsources:
+#endif
     /* Start the EventSources */
-    UA_StatusCode res = UA_STATUSCODE_GOOD;
     UA_EventSource *es = el->eventLoop.eventSources;
     while(es) {
         res |= es->start(es);
@@ -271,6 +344,13 @@ checkClosed(UA_EventLoopPOSIX *el) {
     if(el->delayedHead1 != NULL && el->delayedHead2 != NULL)
         return;
 
+#ifdef UA_HAVE_IO_URING
+    /* Not closed until the io_uring has completed the requests of the
+     * deregistered fds */
+    if(UA_EventLoopPOSIX_usesIOUring(el) && el->uring.detached > 0)
+        return;
+#endif
+
     /* Close the self-pipe when everything else is done */
     UA_close(el->selfpipe[0]);
     UA_close(el->selfpipe[1]);
@@ -280,7 +360,12 @@ checkClosed(UA_EventLoopPOSIX *el) {
         UA_EVENTLOOPSTATE_STOPPED;
 
     /* Close the epoll/IOCP socket once all EventSources have shut down */
-#ifdef UA_HAVE_EPOLL
+#ifdef UA_HAVE_IO_URING
+    if(UA_EventLoopPOSIX_usesIOUring(el))
+        UA_EventLoopPOSIX_IOUring_stop(el);
+    else
+        UA_close(el->epollfd);
+#elif defined(UA_HAVE_EPOLL)
     UA_close(el->epollfd);
 #endif
 
@@ -360,6 +445,12 @@ UA_EventLoopPOSIX_run(UA_EventLoopPOSIX *el, UA_UInt32 timeout) {
      *   running out and executing the due cyclic callbacks. */
     processDelayed(el);
 
+#ifdef UA_ENABLE_EVENTLOOP_STATISTICS
+    /* The fd callbacks are added during the polling */
+    el->iterationTime =
+        el->eventLoop.dateTime_nowMonotonic(&el->eventLoop) - dateBefore;
+#endif
+
     /* A delayed callback could create another delayed callback (or re-add
      * itself). In that case we don't want to wait (indefinitely) for an event
      * to happen. Process queued events but don't sleep. Then process the
@@ -384,6 +475,10 @@ UA_EventLoopPOSIX_run(UA_EventLoopPOSIX *el, UA_UInt32 timeout) {
     if(el->eventLoop.state == UA_EVENTLOOPSTATE_STOPPING)
         checkClosed(el);
 
+#ifdef UA_ENABLE_EVENTLOOP_STATISTICS
+    UA_EventLoopHistogram_add(&el->statistics.iterations, el->iterationTime);
+#endif
+
     el->executing = false;
     UA_UNLOCK(&el->elMutex);
     return rv;
@@ -558,10 +653,20 @@ UA_EventLoop_new_POSIX(const UA_Logger *logger) {
     UA_LOCK_INIT(&el->elMutex);
     UA_Timer_init(&el->timer);
 
+#ifdef UA_ENABLE_EVENTLOOP_STATISTICS
+    el->timer.clock = &el->eventLoop;
+    el->timer.statistics = &el->statistics;
+    LIST_INIT(&el->statsFDs);
+#endif
+
     /* Initialize the queue */
     el->delayedTail = &el->delayedHead1;
     el->delayedHead2 = (UA_DelayedCallback*)0x01; /* sentinel value */
 
+#ifdef UA_HAVE_IO_URING
+    el->uring.fd = UA_INVALID_FD;
+#endif
+
 #ifdef UA_ARCHITECTURE_WIN32
     /* Start the WSA networking subsystem on Windows */
     WSADATA wsaData;
@@ -722,6 +827,123 @@ UA_EventLoopPOSIX_setReusable(UA_FD sockfd) {
 #endif
 }
 
+/**************/
+/* Statistics */
+/**************/
+
+#ifdef UA_ENABLE_EVENTLOOP_STATISTICS
+
+static void
+statisticsAddFD(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd) {
+    if(rfd->statsPointers.le_prev)
+        return; /* Already registered */
+    memset(&rfd->stats, 0, sizeof(UA_EventLoopCallbackStatistics));
+    LIST_INSERT_HEAD(&el->statsFDs, rfd, statsPointers);
+}
+
+static void
+statisticsRemoveFD(UA_RegisteredFD *rfd) {
+    if(!rfd->statsPointers.le_prev)
+        return; /* Not registered */
+    LIST_REMOVE(rfd, statsPointers);
+    rfd->statsPointers.le_prev = NULL;
+}
+
+void
+UA_EventLoopPOSIX_recordFD(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd,
+                           UA_DateTime start) {
+    UA_DateTime duration =
+        el->eventLoop.dateTime_nowMonotonic(&el->eventLoop) - start;
+    UA_EventLoopHistogram_add(&el->statistics.fdCallbacks, duration);
+    UA_EventLoopCallbackStatistics_add(&rfd->stats, duration);
+    el->iterationTime += duration;
+}
+
+/* The rfd is not freed during the callback. Closing the fd frees it only in a
+ * delayed callback. */
+void
+UA_EventLoopPOSIX_processFD(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd,
+                            short event) {
+    UA_DateTime start = el->eventLoop.dateTime_nowMonotonic(&el->eventLoop);
+    rfd->eventSourceCB(rfd->es, rfd, event);
+    UA_EventLoopPOSIX_recordFD(el, rfd, start);
+}
+
+void
+UA_EventLoopPOSIX_getStatistics(UA_EventLoop *public_el,
+                                UA_EventLoopStatistics *stats) {
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)public_el;
+    UA_LOCK(&el->elMutex);
+    *stats = el->statistics;
+    UA_UNLOCK(&el->elMutex);
+}
+
+static void
+resetTimerStatistics(void *context, UA_TimerEntry *te) {
+    memset(&te->stats, 0, sizeof(UA_EventLoopCallbackStatistics));
+}
+
+void
+UA_EventLoopPOSIX_resetStatistics(UA_EventLoop *public_el) {
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)public_el;
+    UA_LOCK(&el->elMutex);
+    memset(&el->statistics, 0, sizeof(UA_EventLoopStatistics));
+    UA_Timer_iterate(&el->timer, resetTimerStatistics, NULL);
+    UA_RegisteredFD *rfd;
+    LIST_FOREACH(rfd, &el->statsFDs, statsPointers) {
+        memset(&rfd->stats, 0, sizeof(UA_EventLoopCallbackStatistics));
+    }
+    UA_UNLOCK(&el->elMutex);
+}
+
+struct TimerStatisticsContext {
+    UA_EventLoopPOSIX_TimerStatisticsCallback cb;
+    void *context;
+};
+
+static void
+iterateTimerStatistics(void *context, UA_TimerEntry *te) {
+    struct TimerStatisticsContext *tsc = (struct TimerStatisticsContext*)context;
+    if(!te->cb)
+        return; /* Marked for deletion */
+    tsc->cb(tsc->context, te->id, te->cb, te->application, te->data, &te->stats);
+}
+
+void
+UA_EventLoopPOSIX_iterateTimerStatistics(UA_EventLoop *public_el,
+                                         UA_EventLoopPOSIX_TimerStatisticsCallback cb,
+                                         void *context) {
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)public_el;
+    struct TimerStatisticsContext tsc;
+    tsc.cb = cb;
+    tsc.context = context;
+    UA_LOCK(&el->elMutex);
+    UA_Timer_iterate(&el->timer, iterateTimerStatistics, &tsc);
+    UA_UNLOCK(&el->elMutex);
+}
+
+void
+UA_EventLoopPOSIX_iterateConnectionStatistics(UA_EventLoop *public_el,
+                                              UA_EventLoopPOSIX_ConnectionStatisticsCallback cb,
+                                              void *context) {
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)public_el;
+    UA_LOCK(&el->elMutex);
+    UA_RegisteredFD *rfd;
+    LIST_FOREACH(rfd, &el->statsFDs, statsPointers) {
+        if(rfd->es->eventSourceType != UA_EVENTSOURCETYPE_CONNECTIONMANAGER)
+            continue; /* E.g. the fd of the InterruptManager */
+        cb(context, (UA_ConnectionManager*)rfd->es, (uintptr_t)rfd->fd, &rfd->stats);
+    }
+    UA_UNLOCK(&el->elMutex);
+}
+
+#else
+
+#define statisticsAddFD(el, rfd) do { } while(0)
+#define statisticsRemoveFD(rfd) do { } while(0)
+
+#endif /* UA_ENABLE_EVENTLOOP_STATISTICS */
+
 /************************/
 /* Select / epoll Logic */
 /************************/
@@ -759,6 +981,7 @@ UA_EventLoopPOSIX_registerFD(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd) {
     /* Add to the last entry */
     el->fds[el->fdsSize] = rfd;
     el->fdsSize++;
+    statisticsAddFD(el, rfd);
     return UA_STATUSCODE_GOOD;
 }
 
@@ -786,6 +1009,8 @@ UA_EventLoopPOSIX_deregisterFD(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd) {
     if(i == el->fdsSize)
         return;
 
+    statisticsRemoveFD(rfd);
+
     if(el->fdsSize > 1) {
         /* Move the last entry in the ith slot and realloc. */
         el->fdsSize--;
@@ -902,7 +1127,7 @@ UA_EventLoopPOSIX_pollFDs(UA_EventLoopPOSIX *el, UA_DateTime listenTimeout) {
                      (unsigned)rfd->fd);
 
         /* Call the EventSource callback */
-        rfd->eventSourceCB(rfd->es, rfd, event);
+        UA_EventLoopPOSIX_processFD(el, rfd, event);
 
         /* The fd has removed itself */
         if(i == el->fdsSize || rfd != el->fds[i])
@@ -913,8 +1138,12 @@ UA_EventLoopPOSIX_pollFDs(UA_EventLoopPOSIX *el, UA_DateTime listenTimeout) {
 
 #else /* defined(UA_HAVE_EPOLL) */
 
-UA_StatusCode
-UA_EventLoopPOSIX_registerFD(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd) {
+static UA_StatusCode
+registerFD(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd) {
+#ifdef UA_HAVE_IO_URING
+    if(UA_EventLoopPOSIX_usesIOUring(el))
+        return UA_EventLoopPOSIX_IOUring_registerFD(el, rfd);
+#endif
     struct epoll_event event;
     memset(&event, 0, sizeof(struct epoll_event));
     event.data.ptr = rfd;
@@ -935,8 +1164,20 @@ UA_EventLoopPOSIX_registerFD(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd) {
     return UA_STATUSCODE_GOOD;
 }
 
+UA_StatusCode
+UA_EventLoopPOSIX_registerFD(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd) {
+    UA_StatusCode res = registerFD(el, rfd);
+    if(res == UA_STATUSCODE_GOOD)
+        statisticsAddFD(el, rfd);
+    return res;
+}
+
 UA_StatusCode
 UA_EventLoopPOSIX_modifyFD(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd) {
+#ifdef UA_HAVE_IO_URING
+    if(UA_EventLoopPOSIX_usesIOUring(el))
+        return UA_EventLoopPOSIX_IOUring_modifyFD(el, rfd);
+#endif
     struct epoll_event event;
     memset(&event, 0, sizeof(struct epoll_event));
     event.data.ptr = rfd;
@@ -959,6 +1200,13 @@ UA_EventLoopPOSIX_modifyFD(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd) {
 
 void
 UA_EventLoopPOSIX_deregisterFD(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd) {
+    statisticsRemoveFD(rfd);
+#ifdef UA_HAVE_IO_URING
+    if(UA_EventLoopPOSIX_usesIOUring(el)) {
+        UA_EventLoopPOSIX_IOUring_deregisterFD(el, rfd);
+        return;
+    }
+#endif
     int res = epoll_ctl(el->epollfd, EPOLL_CTL_DEL, rfd->fd, NULL);
     if(res != 0) {
         UA_LOG_SOCKET_ERRNO_WRAP(
@@ -972,6 +1220,11 @@ UA_StatusCode
 UA_EventLoopPOSIX_pollFDs(UA_EventLoopPOSIX *el, UA_DateTime listenTimeout) {
     UA_assert(listenTimeout >= 0);
 
+#ifdef UA_HAVE_IO_URING
+    if(UA_EventLoopPOSIX_usesIOUring(el))
+        return UA_EventLoopPOSIX_IOUring_pollFDs(el, listenTimeout);
+#endif
+
     /* If there is a positive timeout, wait at least one millisecond, the
      * minimum for blocking epoll_wait. This prevents a busy-loop, as the
      * open62541 library allows even smaller timeouts, which can result in a
@@ -1037,7 +1290,7 @@ UA_EventLoopPOSIX_pollFDs(UA_EventLoopPOSIX *el, UA_DateTime listenTimeout) {
         }
 
         /* Call the EventSource callback */
-        rfd->eventSourceCB(rfd->es, rfd, revent);
+        UA_EventLoopPOSIX_processFD(el, rfd, revent);
     }
     return UA_STATUSCODE_GOOD;
 }
@@ -262,6 +262,12 @@ typedef int SOCKET;
 # include <sys/epoll.h>
 #endif
 
+/* io_uring is an optional backend for the epoll-based EventLoop */
+#if defined(UA_HAVE_EPOLL) && defined(UA_ENABLE_IO_URING)
+# define UA_HAVE_IO_URING
+# include <linux/io_uring.h>
+#endif
+
 /*---------------------------*/
 /* File Handling Definitions */
 /*---------------------------*/
@@ -362,6 +368,15 @@ struct UA_RegisteredFD {
 
     UA_EventSource *es; /* Backpointer to the EventSource */
     UA_FDCallback eventSourceCB;
+
+#ifdef UA_HAVE_IO_URING
+    struct UA_IOUringPoll *uringPoll; /* Poll request if the io_uring is used */
+#endif
+
+#ifdef UA_ENABLE_EVENTLOOP_STATISTICS
+    LIST_ENTRY(UA_RegisteredFD) statsPointers; /* All registered fds */
+    UA_EventLoopCallbackStatistics stats;
+#endif
 };
 
 enum ZIP_CMP cmpFD(const UA_FD *a, const UA_FD *b);
@@ -375,6 +390,83 @@ typedef struct UA_DeregisteredListenFD {
 
 typedef LIST_HEAD(UA_DeregisteredListenFDList, UA_DeregisteredListenFD) UA_DeregisteredListenFDList;
 
+#ifdef UA_HAVE_IO_URING
+
+/* Requests submitted to the io_uring carry a pointer to a UA_IOUringRequest in
+ * the user_data. The callback is executed for every completion entry. Requests
+ * with a NULL user_data (e.g. cancellations) are ignored. The callback returns
+ * false if the completion was only internal bookkeeping (e.g. a completed send)
+ * and nothing was signaled to the application. The EventLoop then keeps waiting
+ * for "real" events until the timeout, like with epoll. */
+struct UA_IOUringRequest;
+typedef struct UA_IOUringRequest UA_IOUringRequest;
+
+typedef UA_Boolean (*UA_IOUringCallback)(UA_IOUringRequest *req, int res,
+                                         unsigned int flags);
+
+struct UA_IOUringRequest {
+    UA_IOUringCallback callback;
+    void *context;
+
+    /* Cancellation that could not be queued as the submission queue was
+     * full. It is queued once the submission queue has space again. */
+    LIST_ENTRY(UA_IOUringRequest) cancelPointers;
+    UA_Boolean cancelPending;
+};
+
+typedef struct {
+    int fd; /* UA_INVALID_FD if the io_uring is not used */
+
+    /* Submission queue */
+    unsigned int *sqHead;
+    unsigned int *sqTail;
+    unsigned int sqLocalTail; /* Includes the SQEs not yet committed */
+    unsigned int sqMask;
+    unsigned int sqEntries;
+    struct io_uring_sqe *sqes;
+
+    /* Completion queue */
+    unsigned int *cqHead;
+    unsigned int *cqTail;
+    unsigned int cqMask;
+    struct io_uring_cqe *cqes;
+
+    /* Memory mappings shared with the kernel */
+    void *sqRing;
+    size_t sqRingSize;
+    void *cqRing;
+    size_t cqRingSize;
+    size_t sqesSize;
+
+    /* The EventLoop waits in io_uring_enter without holding the lock. SQEs
+     * are then submitted right away instead of batching them. */
+    UA_Boolean waiting;
+
+    /* Requests for fds that were deregistered while the request was still
+     * in-flight. The io_uring is not closed before they have completed. */
+    size_t detached;
+
+    /* Requests to be cancelled when the submission queue has space again */
+    LIST_HEAD(, UA_IOUringRequest) pendingCancels;
+
+    UA_UInt16 nextBufferGroup;
+    UA_IOUringRequest selfpipeRequest;
+} UA_IOUring;
+
+/* Ring of receive buffers provided to the kernel. The kernel picks a buffer
+ * when data arrives. The buffer is returned to the ring after processing. */
+typedef struct {
+    struct io_uring_buf_ring *br;
+    size_t brSize;
+    UA_Byte *buffers;
+    size_t bufferSize;
+    UA_UInt16 entries; /* Power of two */
+    UA_UInt16 group;
+    UA_UInt16 tail;
+} UA_IOUringBufferRing;
+
+#endif /* UA_HAVE_IO_URING */
+
 /* All ConnectionManager in the POSIX EventLoop can be cast to
  * UA_ConnectionManagerPOSIX. They carry a sorted tree of their open
  * sockets/file-descriptors. */
@@ -391,6 +483,11 @@ typedef struct {
 
     /* Closed listening sockets queued for later reopening */
     UA_DeregisteredListenFDList listenFDs;
+
+#ifdef UA_HAVE_IO_URING
+    /* Receive buffers for the io_uring (NULL if the io_uring is not used) */
+    UA_IOUringBufferRing *bufRing;
+#endif
 } UA_POSIXConnectionManager;
 
 typedef struct {
@@ -427,6 +524,9 @@ typedef struct {
 
 #if defined(UA_HAVE_EPOLL)
     UA_FD epollfd;
+# if defined(UA_HAVE_IO_URING)
+    UA_IOUring uring; /* Used instead of epoll if uring.fd is valid */
+# endif
 #else
     UA_RegisteredFD **fds;
     size_t fdsSize;
@@ -435,6 +535,12 @@ typedef struct {
     /* Self-pipe to cancel blocking wait */
     UA_FD selfpipe[2]; /* 0: read, 1: write */
 
+#ifdef UA_ENABLE_EVENTLOOP_STATISTICS
+    UA_EventLoopStatistics statistics;
+    UA_DateTime iterationTime; /* Processing time of the current iteration */
+    LIST_HEAD(, UA_RegisteredFD) statsFDs;
+#endif
+
 #if UA_MULTITHREADING >= 100
     UA_Lock elMutex;
 #endif
@@ -457,6 +563,89 @@ UA_EventLoopPOSIX_deregisterFD(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd);
 UA_StatusCode
 UA_EventLoopPOSIX_pollFDs(UA_EventLoopPOSIX *el, UA_DateTime listenTimeout);
 
+/* Execute the EventSource callback for an event on the fd */
+#ifdef UA_ENABLE_EVENTLOOP_STATISTICS
+void
+UA_EventLoopPOSIX_processFD(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd,
+                            short event);
+
+/* Account the execution time since start to the fd. For callbacks of the fd
+ * that are not executed via _processFD. */
+void
+UA_EventLoopPOSIX_recordFD(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd,
+                           UA_DateTime start);
+#else
+# define UA_EventLoopPOSIX_processFD(el, rfd, event) \
+    (rfd)->eventSourceCB((rfd)->es, rfd, event)
+#endif
+
+#ifdef UA_HAVE_IO_URING
+
+/* The io_uring backend. Selected at startup with the "io-uring" parameter. The
+ * registered fds are then polled with io_uring poll requests. Additionally,
+ * ConnectionManagers can submit their own requests. */
+
+#define UA_EventLoopPOSIX_usesIOUring(el) ((el)->uring.fd != UA_INVALID_FD)
+
+UA_StatusCode
+UA_EventLoopPOSIX_IOUring_start(UA_EventLoopPOSIX *el);
+
+void
+UA_EventLoopPOSIX_IOUring_stop(UA_EventLoopPOSIX *el);
+
+UA_StatusCode
+UA_EventLoopPOSIX_IOUring_registerFD(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd);
+
+UA_StatusCode
+UA_EventLoopPOSIX_IOUring_modifyFD(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd);
+
+void
+UA_EventLoopPOSIX_IOUring_deregisterFD(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd);
+
+UA_StatusCode
+UA_EventLoopPOSIX_IOUring_pollFDs(UA_EventLoopPOSIX *el, UA_DateTime listenTimeout);
+
+/* Submit the pending SQEs and process the available completions without
+ * waiting. Used to release resources held by just-cancelled requests. */
+void
+UA_EventLoopPOSIX_IOUring_reap(UA_EventLoopPOSIX *el);
+
+/* Get a zeroed SQE with the request set as user_data (can be NULL). Returns
+ * NULL if the submission queue is full. The SQE has to be committed before the
+ * next SQE is taken. */
+struct io_uring_sqe *
+UA_EventLoopPOSIX_IOUring_getSQE(UA_EventLoopPOSIX *el, UA_IOUringRequest *req);
+
+/* Commit the SQE. The SQEs are submitted in one batch when the EventLoop waits
+ * for the next completions or has processed them. Outside of the EventLoop
+ * processing (or when the EventLoop is waiting), the SQE is submitted right
+ * away. */
+void
+UA_EventLoopPOSIX_IOUring_commitSQE(UA_EventLoopPOSIX *el);
+
+/* Cancel an in-flight request. Its completion is still reported. If the
+ * submission queue is full, the cancellation is queued later on. */
+void
+UA_EventLoopPOSIX_IOUring_cancel(UA_EventLoopPOSIX *el, UA_IOUringRequest *req);
+
+UA_IOUringBufferRing *
+UA_EventLoopPOSIX_IOUring_newBufferRing(UA_EventLoopPOSIX *el, UA_UInt16 entries,
+                                        size_t bufferSize);
+
+void
+UA_EventLoopPOSIX_IOUring_deleteBufferRing(UA_EventLoopPOSIX *el,
+                                           UA_IOUringBufferRing *ring);
+
+/* Get the buffer selected by the kernel (buffer id from the CQE flags) */
+UA_ByteString
+UA_EventLoopPOSIX_IOUring_getBuffer(UA_IOUringBufferRing *ring, UA_UInt16 bid);
+
+/* Return the buffer to the kernel */
+void
+UA_EventLoopPOSIX_IOUring_recycleBuffer(UA_IOUringBufferRing *ring, UA_UInt16 bid);
+
+#endif /* UA_HAVE_IO_URING */
+
 /* Helper functions across EventSources */
 
 UA_StatusCode
@@ -17,6 +17,20 @@
 #include <net/ethernet.h> /* ETH_P_*/
 #include <linux/if_packet.h>
 #include <linux/net_tstamp.h> /* txtime */
+#include <sys/mman.h>
+
+/* Memory-mapped TPACKET_V3 rings. The received frames are read from the blocks
+ * of the rx ring in shared memory. Frames to be sent are written to the tx ring
+ * and the kernel is notified once for all frames of an EventLoop iteration. */
+#ifdef TPACKET3_HDRLEN
+#define ETH_HAVE_PACKET_RING
+#define ETH_RING_BLOCKSIZE (1 << 16) /* Multiple of the page size */
+#define ETH_RING_FRAMESIZE 2048      /* Fits a full frame with the tx header */
+#define ETH_RING_DEFAULT_BLOCKS 16
+#define ETH_RING_RETIRE_TIMEOUT 1    /* Hand over partially filled rx blocks
+                                      * after 1ms */
+#define ETH_RING_TXOFFSET TPACKET_ALIGN(sizeof(struct tpacket3_hdr))
+#endif
 
 /* Configuration parameters */
 
@@ -27,7 +41,7 @@ static UA_KeyValueRestriction ethManagerParams[ETH_MANAGERPARAMS] = {
     {{0, UA_STRING_STATIC("send-bufsize")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false}
 };
 
-#define ETH_PARAMETERSSIZE 15
+#define ETH_PARAMETERSSIZE 17
 #define ETH_PARAMINDEX_ADDR 0
 #define ETH_PARAMINDEX_LISTEN 1
 #define ETH_PARAMINDEX_IFACE 2
@@ -43,6 +57,8 @@ static UA_KeyValueRestriction ethManagerParams[ETH_MANAGERPARAMS] = {
 #define ETH_PARAMINDEX_TXTIME_PICO 12
 #define ETH_PARAMINDEX_TXTIME_DROP 13
 #define ETH_PARAMINDEX_VALIDATE 14
+#define ETH_PARAMINDEX_PACKETRING 15
+#define ETH_PARAMINDEX_PACKETRING_BLOCKS 16
 
 static UA_KeyValueRestriction ethConnectionParams[ETH_PARAMETERSSIZE+1] = {
     {{0, UA_STRING_STATIC("address")}, &UA_TYPES[UA_TYPES_STRING], false, true, false},
@@ -60,6 +76,8 @@ static UA_KeyValueRestriction ethConnectionParams[ETH_PARAMETERSSIZE+1] = {
     {{0, UA_STRING_STATIC("txtime-pico")}, &UA_TYPES[UA_TYPES_UINT16], false, true, false},
     {{0, UA_STRING_STATIC("txtime-drop-late")}, &UA_TYPES[UA_TYPES_BOOLEAN], false, true, false},
     {{0, UA_STRING_STATIC("validate")}, &UA_TYPES[UA_TYPES_BOOLEAN], false, true, false},
+    {{0, UA_STRING_STATIC("packet-ring")}, &UA_TYPES[UA_TYPES_BOOLEAN], false, true, false},
+    {{0, UA_STRING_STATIC("packet-ring-blocks")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
     /* Duplicated address parameter with a scalar value required. For the send-socket case. */
     {{0, UA_STRING_STATIC("address")}, &UA_TYPES[UA_TYPES_STRING], true, true, false},
 };
@@ -85,8 +103,27 @@ typedef struct {
     unsigned char lengthOffset; /* No length field if zero */
 
     UA_Boolean txtimeEnabled;
+
+#ifdef ETH_HAVE_PACKET_RING
+    /* Memory-mapped ring. Listen connections have an rx ring with blocks of
+     * frames. Send connections have a tx ring with one frame per slot. */
+    UA_Byte *ring;
+    size_t ringSize;
+    unsigned int ringSlots;   /* Number of blocks (rx) or frames (tx) */
+    unsigned int ringPos;     /* Next block to read (rx) or frame to fill (tx) */
+    UA_Boolean txPending;     /* The kernel was not notified of all frames */
+#endif
 } ETH_FD;
 
+typedef struct {
+    UA_POSIXConnectionManager pcm;
+#ifdef ETH_HAVE_PACKET_RING
+    /* Notify the kernel of the frames written to the tx rings during the
+     * current EventLoop iteration */
+    UA_DelayedCallback txCallback;
+#endif
+} ETH_ConnectionManager;
+
 /* The format of a Ethernet address is six groups of hexadecimal digits,
  * separated by hyphens (e.g. 01-23-45-67-89-ab). */
 static UA_StatusCode
@@ -244,6 +281,268 @@ ETH_freeNetworkBuffer(UA_ConnectionManager *cm, uintptr_t connectionId,
     UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
 }
 
+/* Parse the Ethernet header and forward the frame to the application. If the
+ * VLAN tag was stripped by the network driver, then it is taken from the
+ * auxiliary data of the packet ring. */
+static void
+ETH_processFrame(UA_ConnectionManager *cm, ETH_FD *conn, UA_ByteString frame,
+                 UA_Boolean hasTci, UA_UInt16 tci) {
+    /* Parse the Ethernet header */
+    unsigned char destAddr[ETHER_ADDR_LEN];
+    unsigned char sourceAddr[ETHER_ADDR_LEN];
+    UA_UInt16 etherType = 0;
+    UA_UInt16 vid = 0;
+    UA_Byte pcp = 0;
+    UA_Boolean dei = 0;
+    size_t headerSize = parseETHHeader(&frame, destAddr, sourceAddr,
+                                       &etherType, &vid, &pcp, &dei);
+    if(headerSize == 0)
+        return;
+    if(hasTci && vid == 0) {
+        pcp = (tci >> 13) & 0x07;
+        dei = (tci >> 12) & 0x01;
+        vid = tci & 0x0FFF;
+    }
+
+    /* Set up the parameter arguments passed to the application */
+    unsigned char destAddrBytes[18];
+    unsigned char sourceAddrBytes[18];
+    setAddrString(destAddrBytes, destAddr);
+    setAddrString(sourceAddrBytes, sourceAddr);
+    UA_String destAddrStr = {17, destAddrBytes};
+    UA_String sourceAddrStr = {17, sourceAddrBytes};
+
+    size_t paramsSize = 2;
+    UA_KeyValuePair params[6];
+    params[0].key = UA_QUALIFIEDNAME(0, "destination-address");
+    UA_Variant_setScalar(&params[0].value, &destAddrStr, &UA_TYPES[UA_TYPES_STRING]);
+    params[1].key = UA_QUALIFIEDNAME(0, "source-address");
+    UA_Variant_setScalar(&params[1].value, &sourceAddrStr, &UA_TYPES[UA_TYPES_STRING]);
+
+    if(etherType > 0) {
+        params[2].key = UA_QUALIFIEDNAME(0, "ethertype");
+        UA_Variant_setScalar(&params[2].value, &etherType, &UA_TYPES[UA_TYPES_UINT16]);
+        paramsSize++;
+    }
+
+    if(vid > 0) {
+        params[paramsSize].key = UA_QUALIFIEDNAME(0, "vid");
+        UA_Variant_setScalar(&params[paramsSize].value, &vid, &UA_TYPES[UA_TYPES_UINT16]);
+        params[paramsSize+1].key = UA_QUALIFIEDNAME(0, "pcp");
+        UA_Variant_setScalar(&params[paramsSize+1].value, &pcp, &UA_TYPES[UA_TYPES_BYTE]);
+        params[paramsSize+2].key = UA_QUALIFIEDNAME(0, "dei");
+        UA_Variant_setScalar(&params[paramsSize+2].value, &dei, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        paramsSize += 3;
+    }
+
+    /* Callback to the application layer with the Ethernet header hidden */
+    UA_KeyValueMap map = {paramsSize, params};
+    frame.data += headerSize;
+    frame.length -= headerSize;
+    conn->applicationCB(cm, (uintptr_t)conn->rfd.fd, conn->application,
+                        &conn->context, UA_CONNECTIONSTATE_ESTABLISHED,
+                        &map, frame);
+}
+
+#ifdef ETH_HAVE_PACKET_RING
+
+/* Set up the memory-mapped ring for the socket. Returns without a ring if this
+ * is not possible. Then the socket is used with recv/sendto as usual. */
+static void
+ETH_setupRing(UA_EventLoopPOSIX *el, ETH_FD *conn,
+              const UA_KeyValueMap *params, UA_Boolean rx) {
+    UA_UInt32 blocks = ETH_RING_DEFAULT_BLOCKS;
+    const UA_UInt32 *blocksParam = (const UA_UInt32*)
+        UA_KeyValueMap_getScalar(params,
+                                 ethConnectionParams[ETH_PARAMINDEX_PACKETRING_BLOCKS].name,
+                                 &UA_TYPES[UA_TYPES_UINT32]);
+    if(blocksParam && *blocksParam > 0)
+        blocks = *blocksParam;
+
+    int ringType = (rx) ? PACKET_RX_RING : PACKET_TX_RING;
+    struct tpacket_req3 req;
+    memset(&req, 0, sizeof(struct tpacket_req3));
+    req.tp_block_size = ETH_RING_BLOCKSIZE;
+    req.tp_block_nr = blocks;
+    req.tp_frame_size = ETH_RING_FRAMESIZE;
+    req.tp_frame_nr = (ETH_RING_BLOCKSIZE / ETH_RING_FRAMESIZE) * blocks;
+    if(rx)
+        req.tp_retire_blk_tov = ETH_RING_RETIRE_TIMEOUT;
+
+    /* Skip malformed frames in the tx ring instead of stalling */
+    int version = TPACKET_V3;
+    int loss = 1;
+    UA_RESET_ERRNO;
+    if(UA_setsockopt(conn->rfd.fd, SOL_PACKET, PACKET_VERSION,
+                     &version, sizeof(version)) < 0 ||
+       (!rx && UA_setsockopt(conn->rfd.fd, SOL_PACKET, PACKET_LOSS,
+                             &loss, sizeof(loss)) < 0) ||
+       UA_setsockopt(conn->rfd.fd, SOL_PACKET, ringType, &req, sizeof(req)) < 0)
+        goto fallback;
+
+    size_t ringSize = (size_t)ETH_RING_BLOCKSIZE * blocks;
+    void *ring = mmap(NULL, ringSize, PROT_READ | PROT_WRITE,
+                      MAP_SHARED, conn->rfd.fd, 0);
+    if(ring == MAP_FAILED) {
+        /* Release the ring in the kernel. Otherwise recv gets no frames. */
+        memset(&req, 0, sizeof(struct tpacket_req3));
+        UA_setsockopt(conn->rfd.fd, SOL_PACKET, ringType, &req, sizeof(req));
+        goto fallback;
+    }
+
+    conn->ring = (UA_Byte*)ring;
+    conn->ringSize = ringSize;
+    conn->ringSlots = (rx) ? blocks : req.tp_frame_nr;
+    conn->ringPos = 0;
+    UA_LOG_INFO(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                "ETH %u\t| Mapped a TPACKET_V3 %s ring of %u kB",
+                (unsigned)conn->rfd.fd, (rx) ? "rx" : "tx",
+                (unsigned)(ringSize / 1024));
+    return;
+
+ fallback:
+    UA_LOG_SOCKET_ERRNO_WRAP(
+       UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                      "ETH %u\t| Could not set up the packet ring (%s). "
+                      "Using the socket without the ring.",
+                      (unsigned)conn->rfd.fd, errno_str));
+}
+
+/* Process all blocks that the kernel has handed over. The frames are passed to
+ * the application directly from the shared memory. */
+static void
+ETH_receiveRing(UA_ConnectionManager *cm, ETH_FD *conn) {
+    while(true) {
+        struct tpacket_block_desc *bd = (struct tpacket_block_desc*)
+            &conn->ring[(size_t)conn->ringPos * ETH_RING_BLOCKSIZE];
+        if(!(bd->hdr.bh1.block_status & TP_STATUS_USER))
+            break;
+        __sync_synchronize(); /* Read the frames only after the status */
+
+        UA_Byte *pos = (UA_Byte*)bd + bd->hdr.bh1.offset_to_first_pkt;
+        for(UA_UInt32 i = 0; i < bd->hdr.bh1.num_pkts; i++) {
+            struct tpacket3_hdr *ppd = (struct tpacket3_hdr*)pos;
+            UA_ByteString frame = {ppd->tp_snaplen, pos + ppd->tp_mac};
+            ETH_processFrame(cm, conn, frame,
+                             (ppd->tp_status & TP_STATUS_VLAN_VALID) != 0,
+                             (UA_UInt16)ppd->hv1.tp_vlan_tci);
+            pos += ppd->tp_next_offset;
+        }
+
+        /* Return the block to the kernel */
+        __sync_synchronize();
+        bd->hdr.bh1.block_status = TP_STATUS_KERNEL;
+        conn->ringPos = (conn->ringPos + 1) % conn->ringSlots;
+
+        /* Stop if the connection was closed by the application */
+        if(conn->rfd.dc.callback)
+            break;
+    }
+}
+
+/* Notify the kernel to send out the frames written to the tx ring */
+static UA_StatusCode
+ETH_kickRing(UA_EventLoopPOSIX *el, ETH_FD *conn) {
+    conn->txPending = false;
+    UA_RESET_ERRNO;
+    ssize_t n = sendto(conn->rfd.fd, NULL, 0, MSG_DONTWAIT,
+                       (struct sockaddr*)&conn->sll, sizeof(conn->sll));
+    if(n < 0 && UA_ERRNO != UA_INTERRUPTED && UA_ERRNO != UA_WOULDBLOCK &&
+       UA_ERRNO != UA_AGAIN && UA_ERRNO != ENOBUFS) {
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                        "ETH %u\t| Sending from the tx ring failed with error %s",
+                        (unsigned)conn->rfd.fd, errno_str));
+        return UA_STATUSCODE_BADCONNECTIONCLOSED;
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+static void ETH_shutdown(UA_POSIXConnectionManager *pcm, ETH_FD *conn);
+
+static void *
+ETH_kickCB(void *application, UA_RegisteredFD *rfd) {
+    ETH_ConnectionManager *ecm = (ETH_ConnectionManager*)application;
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)ecm->pcm.cm.eventSource.eventLoop;
+    ETH_FD *conn = (ETH_FD*)rfd;
+    if(conn->txPending && ETH_kickRing(el, conn) != UA_STATUSCODE_GOOD)
+        ETH_shutdown(&ecm->pcm, conn);
+    return NULL;
+}
+
+/* Delayed callback to notify the kernel once for all frames written to the tx
+ * rings in the current EventLoop iteration */
+static void
+ETH_delayedKick(void *application, void *context) {
+    ETH_ConnectionManager *ecm = (ETH_ConnectionManager*)application;
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)ecm->pcm.cm.eventSource.eventLoop;
+    (void)el;
+    UA_LOCK_ASSERT(&el->elMutex); /* Delayed callbacks run with the lock held */
+    ecm->txCallback.callback = NULL;
+    ZIP_ITER(UA_FDTree, &ecm->pcm.fds, ETH_kickCB, ecm);
+}
+
+/* Copy the frame into the next slot of the tx ring. Waits (blocking) if all
+ * slots are still in use by the kernel. */
+static UA_StatusCode
+ETH_sendRing(ETH_ConnectionManager *ecm, ETH_FD *conn, const UA_ByteString *buf) {
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)ecm->pcm.cm.eventSource.eventLoop;
+    struct tpacket3_hdr *hdr = (struct tpacket3_hdr*)
+        &conn->ring[(size_t)conn->ringPos * ETH_RING_FRAMESIZE];
+
+    struct pollfd tmp_poll_fd;
+    tmp_poll_fd.fd = conn->rfd.fd;
+    tmp_poll_fd.events = UA_POLLOUT;
+    while(hdr->tp_status != TP_STATUS_AVAILABLE) {
+        UA_StatusCode res = ETH_kickRing(el, conn);
+        if(res != UA_STATUSCODE_GOOD)
+            return res;
+        UA_RESET_ERRNO;
+        int poll_ret = UA_poll(&tmp_poll_fd, 1, 100);
+        if(poll_ret < 0 && UA_ERRNO != UA_INTERRUPTED) {
+            UA_LOG_SOCKET_ERRNO_WRAP(
+               UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                            "ETH %u\t| Send failed with error %s",
+                            (unsigned)conn->rfd.fd, errno_str));
+            return UA_STATUSCODE_BADCONNECTIONCLOSED;
+        }
+        __sync_synchronize();
+    }
+
+    memcpy((UA_Byte*)hdr + ETH_RING_TXOFFSET, buf->data, buf->length);
+    hdr->tp_len = (__u32)buf->length;
+    hdr->tp_next_offset = 0;
+    __sync_synchronize(); /* Write the frame before handing it over */
+    hdr->tp_status = TP_STATUS_SEND_REQUEST;
+    conn->ringPos = (conn->ringPos + 1) % conn->ringSlots;
+    conn->txPending = true;
+
+    /* Notify the kernel right away if we are not inside the EventLoop */
+    if(!el->executing)
+        return ETH_kickRing(el, conn);
+
+    /* Send out at the end of the EventLoop iteration */
+    if(!ecm->txCallback.callback) {
+        ecm->txCallback.callback = ETH_delayedKick;
+        ecm->txCallback.application = ecm;
+        ecm->txCallback.context = NULL;
+        UA_EventLoopPOSIX_addDelayedCallback((UA_EventLoop*)el, &ecm->txCallback);
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+static void
+ETH_freeRing(UA_EventLoopPOSIX *el, ETH_FD *conn) {
+    if(!conn->ring)
+        return;
+    if(conn->txPending)
+        ETH_kickRing(el, conn); /* Best effort */
+    munmap(conn->ring, conn->ringSize);
+    conn->ring = NULL;
+}
+
+#endif /* ETH_HAVE_PACKET_RING */
+
 /* Test if the ConnectionManager can be stopped */
 static void
 ETH_checkStopped(UA_POSIXConnectionManager *pcm) {
@@ -283,6 +582,11 @@ ETH_close(UA_POSIXConnectionManager *pcm, ETH_FD *conn) {
                         UA_CONNECTIONSTATE_CLOSING,
                         &UA_KEYVALUEMAP_NULL, UA_BYTESTRING_NULL);
 
+#ifdef ETH_HAVE_PACKET_RING
+    /* Unmap the ring */
+    ETH_freeRing(el, conn);
+#endif
+
     /* Close the socket */
     UA_RESET_ERRNO;
     int ret = UA_close(conn->rfd.fd);
@@ -337,6 +641,13 @@ ETH_connectionSocketCallback(UA_ConnectionManager *cm, UA_RegisteredFD *rfd,
         return;
     }
 
+#ifdef ETH_HAVE_PACKET_RING
+    if(conn->ring) {
+        ETH_receiveRing(cm, conn);
+        return;
+    }
+#endif
+
     /* Use the already allocated receive-buffer */
     UA_ByteString response = pcm->rxBuffer;
 
@@ -372,58 +683,7 @@ ETH_connectionSocketCallback(UA_ConnectionManager *cm, UA_RegisteredFD *rfd,
                  (unsigned)rfd->fd, (unsigned)ret);
 
     response.length = (size_t)ret;
-
-    /* Parse the Ethernet header */
-    unsigned char destAddr[ETHER_ADDR_LEN];
-    unsigned char sourceAddr[ETHER_ADDR_LEN];
-    UA_UInt16 etherType = 0;
-    UA_UInt16 vid = 0;
-    UA_Byte pcp = 0;
-    UA_Boolean dei = 0;
-    size_t headerSize = parseETHHeader(&response, destAddr, sourceAddr,
-                                       &etherType, &vid, &pcp, &dei);
-    if(headerSize == 0)
-        return;
-
-    /* Set up the parameter arguments passed to the application */
-    unsigned char destAddrBytes[18];
-    unsigned char sourceAddrBytes[18];
-    setAddrString(destAddrBytes, destAddr);
-    setAddrString(sourceAddrBytes, sourceAddr);
-    UA_String destAddrStr = {17, destAddrBytes};
-    UA_String sourceAddrStr = {17, sourceAddrBytes};
-
-    size_t paramsSize = 2;
-    UA_KeyValuePair params[6];
-    params[0].key = UA_QUALIFIEDNAME(0, "destination-address");
-    UA_Variant_setScalar(&params[0].value, &destAddrStr, &UA_TYPES[UA_TYPES_STRING]);
-    params[1].key = UA_QUALIFIEDNAME(0, "source-address");
-    UA_Variant_setScalar(&params[1].value, &sourceAddrStr, &UA_TYPES[UA_TYPES_STRING]);
-
-    if(etherType > 0) {
-        params[2].key = UA_QUALIFIEDNAME(0, "ethertype");
-        UA_Variant_setScalar(&params[1].value, &etherType, &UA_TYPES[UA_TYPES_UINT16]);
-        paramsSize++;
-    }
-
-    if(vid > 0) {
-        params[paramsSize].key = UA_QUALIFIEDNAME(0, "vid");
-        UA_Variant_setScalar(&params[paramsSize].value, &vid, &UA_TYPES[UA_TYPES_UINT16]);
-        params[paramsSize+1].key = UA_QUALIFIEDNAME(0, "pcp");
-        UA_Variant_setScalar(&params[paramsSize+1].value, &pcp, &UA_TYPES[UA_TYPES_BYTE]);
-        params[paramsSize+2].key = UA_QUALIFIEDNAME(0, "dei");
-        UA_Variant_setScalar(&params[paramsSize+2].value, &dei, &UA_TYPES[UA_TYPES_BOOLEAN]);
-        paramsSize += 3;
-    }
-
-    /* Callback to the application layer with the Ethernet header hidden */
-    UA_KeyValueMap map = {paramsSize, params};
-    response.data += headerSize;
-    response.length -= headerSize;
-    conn->applicationCB(cm, (uintptr_t)rfd->fd, conn->application, &conn->context,
-                        UA_CONNECTIONSTATE_ESTABLISHED, &map, response);
-    response.data -= headerSize;
-    response.length += headerSize;
+    ETH_processFrame(cm, conn, response, false, 0);
 }
 
 static UA_StatusCode
@@ -723,6 +983,17 @@ ETH_openConnection(UA_ConnectionManager *cm, const UA_KeyValueMap *params,
     conn->application = application;
     conn->applicationCB = connectionCallback;
 
+#ifdef ETH_HAVE_PACKET_RING
+    /* Set up the ring before binding the listen socket. So that no frames are
+     * received outside of the ring. */
+    const UA_Boolean *packetRing = (const UA_Boolean*)
+        UA_KeyValueMap_getScalar(params,
+                                 ethConnectionParams[ETH_PARAMINDEX_PACKETRING].name,
+                                 &UA_TYPES[UA_TYPES_BOOLEAN]);
+    if(!validate && packetRing && *packetRing)
+        ETH_setupRing(el, conn, params, (listen && *listen));
+#endif
+
     /* Configure a listen or a send connection */
     if(!listen || !*listen) {
         /* Get the source address for the interface */
@@ -767,6 +1038,10 @@ ETH_openConnection(UA_ConnectionManager *cm, const UA_KeyValueMap *params,
     return UA_STATUSCODE_GOOD;
 
  cleanup:
+#ifdef ETH_HAVE_PACKET_RING
+    if(conn)
+        ETH_freeRing(el, conn);
+#endif
     UA_close(sockfd);
     UA_free(conn);
     UA_UNLOCK(&el->elMutex);
@@ -929,6 +1204,31 @@ ETH_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
         return UA_STATUSCODE_BADINTERNALERROR;
     }
 
+#ifdef ETH_HAVE_PACKET_RING
+    /* Send via the tx ring. Frames with a txtime and frames that exceed the
+     * slot size are sent with the socket, after those already in the ring. */
+    if(conn->ring) {
+        UA_StatusCode res = UA_STATUSCODE_GOOD;
+        UA_Boolean useRing =
+            (!txtime && buf->length <= ETH_RING_FRAMESIZE - ETH_RING_TXOFFSET);
+        if(useRing)
+            res = ETH_sendRing((ETH_ConnectionManager*)pcm, conn, buf);
+        else if(conn->txPending)
+            res = ETH_kickRing(el, conn);
+        if(res != UA_STATUSCODE_GOOD) {
+            ETH_shutdown(pcm, conn);
+            UA_UNLOCK(&el->elMutex);
+            UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
+            return res;
+        }
+        if(useRing) {
+            UA_UNLOCK(&el->elMutex);
+            UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
+            return UA_STATUSCODE_GOOD;
+        }
+    }
+#endif
+
     /* Prevent OS signals when sending to a closed socket */
     int flags = MSG_NOSIGNAL;
 
@@ -1086,7 +1386,7 @@ static const char *ethName = "eth";
 UA_ConnectionManager *
 UA_ConnectionManager_new_POSIX_Ethernet(const UA_String eventSourceName) {
     UA_POSIXConnectionManager *cm = (UA_POSIXConnectionManager*)
-        UA_calloc(1, sizeof(UA_POSIXConnectionManager));
+        UA_calloc(1, sizeof(ETH_ConnectionManager));
     if(!cm)
         return NULL;
 
@@ -0,0 +1,713 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "eventloop_posix.h"
+
+#if defined(UA_HAVE_IO_URING)
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <endian.h>
+
+/* Number of entries in the submission and completion queue. The completion
+ * queue is larger as multishot requests create many completions. */
+#define UA_IOURING_SQ_ENTRIES 256
+#define UA_IOURING_CQ_ENTRIES 4096
+
+/* The io_uring is used via the raw system calls. So there is no dependency on
+ * liburing. */
+
+static int
+iouring_setup(unsigned int entries, struct io_uring_params *p) {
+    int ret = (int)syscall(__NR_io_uring_setup, entries, p);
+    return (ret < 0) ? -errno : ret;
+}
+
+static int
+iouring_enter(int fd, unsigned int toSubmit, unsigned int minComplete,
+              unsigned int flags, void *arg, size_t argSize) {
+    int ret = (int)syscall(__NR_io_uring_enter, fd, toSubmit, minComplete,
+                           flags, arg, argSize);
+    return (ret < 0) ? -errno : ret;
+}
+
+static int
+iouring_register(int fd, unsigned int opcode, void *arg, unsigned int nrArgs) {
+    int ret = (int)syscall(__NR_io_uring_register, fd, opcode, arg, nrArgs);
+    return (ret < 0) ? -errno : ret;
+}
+
+/* Submit the committed SQEs that the kernel has not yet consumed */
+static void
+submitSQEs(UA_EventLoopPOSIX *el) {
+    UA_IOUring *ring = &el->uring;
+    unsigned int pending = *ring->sqTail -
+        __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE);
+    if(pending == 0)
+        return;
+
+    int ret;
+    do {
+        ret = iouring_enter(ring->fd, pending, 0, 0, NULL, 0);
+    } while(ret == -EINTR);
+
+    /* -EBUSY and -EAGAIN are temporary. The SQEs are submitted again with the
+     * next call. */
+    if(ret < 0 && ret != -EBUSY && ret != -EAGAIN) {
+        errno = -ret;
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                          "Eventloop\t| io_uring submission failed (%s)",
+                          errno_str));
+    }
+}
+
+struct io_uring_sqe *
+UA_EventLoopPOSIX_IOUring_getSQE(UA_EventLoopPOSIX *el, UA_IOUringRequest *req) {
+    UA_LOCK_ASSERT(&el->elMutex);
+    UA_IOUring *ring = &el->uring;
+
+    /* The submission queue is full. Submit to make space. */
+    unsigned int tail = ring->sqLocalTail;
+    if(tail - __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE) >= ring->sqEntries) {
+        submitSQEs(el);
+        if(tail - __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE) >= ring->sqEntries) {
+            UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                           "Eventloop\t| The io_uring submission queue is full");
+            return NULL;
+        }
+    }
+
+    struct io_uring_sqe *sqe = &ring->sqes[tail & ring->sqMask];
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    sqe->user_data = (__u64)(uintptr_t)req;
+    ring->sqLocalTail++;
+    return sqe;
+}
+
+void
+UA_EventLoopPOSIX_IOUring_commitSQE(UA_EventLoopPOSIX *el) {
+    UA_LOCK_ASSERT(&el->elMutex);
+    UA_IOUring *ring = &el->uring;
+
+    /* Make the SQE visible for the kernel */
+    __atomic_store_n(ring->sqTail, ring->sqLocalTail, __ATOMIC_RELEASE);
+
+    /* Batch the submissions while the EventLoop processes the completions.
+     * They are submitted with the next wait or at the end of the polling. */
+    if(el->executing && !ring->waiting)
+        return;
+    submitSQEs(el);
+}
+
+static UA_Boolean
+sqFull(UA_IOUring *ring) {
+    return (ring->sqLocalTail - __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE) >=
+            ring->sqEntries);
+}
+
+/* The cancellation could not be queued. Retry when the submission queue has
+ * space again. Dropping it would leave the request (and the EventLoop
+ * shutdown) waiting forever. */
+static void
+deferCancel(UA_EventLoopPOSIX *el, UA_IOUringRequest *req) {
+    if(req->cancelPending)
+        return;
+    LIST_INSERT_HEAD(&el->uring.pendingCancels, req, cancelPointers);
+    req->cancelPending = true;
+}
+
+/* Queue the deferred cancellations. Called before waiting on the io_uring. */
+static void
+submitPendingCancels(UA_EventLoopPOSIX *el) {
+    UA_IOUring *ring = &el->uring;
+    UA_IOUringRequest *req;
+    while((req = LIST_FIRST(&ring->pendingCancels))) {
+        if(sqFull(ring)) {
+            submitSQEs(el);
+            if(sqFull(ring))
+                return;
+        }
+        struct io_uring_sqe *sqe = UA_EventLoopPOSIX_IOUring_getSQE(el, NULL);
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->addr = (__u64)(uintptr_t)req;
+        UA_EventLoopPOSIX_IOUring_commitSQE(el);
+        LIST_REMOVE(req, cancelPointers);
+        req->cancelPending = false;
+    }
+}
+
+void
+UA_EventLoopPOSIX_IOUring_cancel(UA_EventLoopPOSIX *el, UA_IOUringRequest *req) {
+    struct io_uring_sqe *sqe = UA_EventLoopPOSIX_IOUring_getSQE(el, NULL);
+    if(!sqe) {
+        deferCancel(el, req);
+        return;
+    }
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->addr = (__u64)(uintptr_t)req;
+    UA_EventLoopPOSIX_IOUring_commitSQE(el);
+}
+
+/* The kernel reads the poll mask as a 32-bit value with swapped halfwords on
+ * big-endian hosts (to stay compatible with the 16-bit poll_events). */
+static void
+setPollEvents(struct io_uring_sqe *sqe, unsigned int events) {
+#if __BYTE_ORDER == __BIG_ENDIAN
+    sqe->poll32_events = (events << 16) | (events >> 16);
+#else
+    sqe->poll32_events = events;
+#endif
+}
+
+/*************/
+/* Self-Pipe */
+/*************/
+
+static void armSelfPipe(UA_EventLoopPOSIX *el);
+
+/* The self-pipe cancels the waiting. So this is never a silent completion. */
+static UA_Boolean
+selfpipeCallback(UA_IOUringRequest *req, int res, unsigned int flags) {
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)req->context;
+    char buf[128];
+    while(read(el->selfpipe[0], buf, sizeof(buf)) > 0) {}
+    if(res != -ECANCELED)
+        armSelfPipe(el);
+    return true;
+}
+
+static void
+armSelfPipe(UA_EventLoopPOSIX *el) {
+    struct io_uring_sqe *sqe =
+        UA_EventLoopPOSIX_IOUring_getSQE(el, &el->uring.selfpipeRequest);
+    if(!sqe)
+        return;
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = el->selfpipe[0];
+    setPollEvents(sqe, POLLIN);
+    UA_EventLoopPOSIX_IOUring_commitSQE(el);
+}
+
+/*************/
+/* Lifecycle */
+/*************/
+
+static void
+unmapRing(UA_IOUring *ring) {
+    if(ring->sqes)
+        munmap(ring->sqes, ring->sqesSize);
+    if(ring->cqRing && ring->cqRing != ring->sqRing)
+        munmap(ring->cqRing, ring->cqRingSize);
+    if(ring->sqRing)
+        munmap(ring->sqRing, ring->sqRingSize);
+    ring->sqes = NULL;
+    ring->sqRing = NULL;
+    ring->cqRing = NULL;
+}
+
+UA_StatusCode
+UA_EventLoopPOSIX_IOUring_start(UA_EventLoopPOSIX *el) {
+    UA_LOCK_ASSERT(&el->elMutex);
+    UA_IOUring *ring = &el->uring;
+    memset(ring, 0, sizeof(UA_IOUring));
+    ring->fd = UA_INVALID_FD;
+    LIST_INIT(&ring->pendingCancels);
+
+    /* Create the io_uring. Retry without the optional flags for older
+     * kernels. */
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(struct io_uring_params));
+    p.flags = IORING_SETUP_CQSIZE | IORING_SETUP_SUBMIT_ALL |
+        IORING_SETUP_COOP_TASKRUN;
+    p.cq_entries = UA_IOURING_CQ_ENTRIES;
+    int fd = iouring_setup(UA_IOURING_SQ_ENTRIES, &p);
+    if(fd == -EINVAL) {
+        memset(&p, 0, sizeof(struct io_uring_params));
+        p.flags = IORING_SETUP_CQSIZE;
+        p.cq_entries = UA_IOURING_CQ_ENTRIES;
+        fd = iouring_setup(UA_IOURING_SQ_ENTRIES, &p);
+    }
+    if(fd < 0) {
+        errno = -fd;
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                          "Eventloop\t| Could not create the io_uring (%s)",
+                          errno_str));
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+
+    /* Timeouts for waiting on completions are required */
+    if(!(p.features & IORING_FEAT_EXT_ARG) || !(p.features & IORING_FEAT_NODROP)) {
+        UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                       "Eventloop\t| The kernel does not support the "
+                       "required io_uring features");
+        UA_close(fd);
+        return UA_STATUSCODE_BADNOTSUPPORTED;
+    }
+
+    /* Map the queues into memory */
+    ring->sqRingSize = p.sq_off.array + p.sq_entries * sizeof(unsigned int);
+    ring->cqRingSize = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if(p.features & IORING_FEAT_SINGLE_MMAP) {
+        if(ring->cqRingSize > ring->sqRingSize)
+            ring->sqRingSize = ring->cqRingSize;
+        ring->cqRingSize = ring->sqRingSize;
+    }
+    ring->sqRing = mmap(NULL, ring->sqRingSize, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if(ring->sqRing == MAP_FAILED) {
+        ring->sqRing = NULL;
+        goto error;
+    }
+    if(p.features & IORING_FEAT_SINGLE_MMAP) {
+        ring->cqRing = ring->sqRing;
+    } else {
+        ring->cqRing = mmap(NULL, ring->cqRingSize, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if(ring->cqRing == MAP_FAILED) {
+            ring->cqRing = NULL;
+            goto error;
+        }
+    }
+    ring->sqesSize = p.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = (struct io_uring_sqe*)
+        mmap(NULL, ring->sqesSize, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if(ring->sqes == MAP_FAILED) {
+        ring->sqes = NULL;
+        goto error;
+    }
+
+    UA_Byte *sq = (UA_Byte*)ring->sqRing;
+    ring->sqHead = (unsigned int*)(sq + p.sq_off.head);
+    ring->sqTail = (unsigned int*)(sq + p.sq_off.tail);
+    ring->sqMask = *(unsigned int*)(sq + p.sq_off.ring_mask);
+    ring->sqEntries = p.sq_entries;
+    ring->sqLocalTail = *ring->sqTail;
+
+    /* The SQEs are always used in order. Map the indirection array to the
+     * identity once. */
+    unsigned int *sqArray = (unsigned int*)(sq + p.sq_off.array);
+    for(unsigned int i = 0; i < p.sq_entries; i++)
+        sqArray[i] = i;
+
+    UA_Byte *cq = (UA_Byte*)ring->cqRing;
+    ring->cqHead = (unsigned int*)(cq + p.cq_off.head);
+    ring->cqTail = (unsigned int*)(cq + p.cq_off.tail);
+    ring->cqMask = *(unsigned int*)(cq + p.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)(cq + p.cq_off.cqes);
+
+    ring->fd = fd;
+
+    /* Always poll on the self-pipe */
+    ring->selfpipeRequest.callback = selfpipeCallback;
+    ring->selfpipeRequest.context = el;
+    armSelfPipe(el);
+
+    UA_LOG_INFO(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                "Eventloop\t| Using the io_uring with %u submission and "
+                "%u completion entries", p.sq_entries, p.cq_entries);
+    return UA_STATUSCODE_GOOD;
+
+ error:
+    UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                   "Eventloop\t| Could not map the io_uring queues");
+    unmapRing(ring);
+    UA_close(fd);
+    return UA_STATUSCODE_BADINTERNALERROR;
+}
+
+void
+UA_EventLoopPOSIX_IOUring_stop(UA_EventLoopPOSIX *el) {
+    UA_IOUring *ring = &el->uring;
+    UA_assert(ring->detached == 0);
+    UA_assert(LIST_EMPTY(&ring->pendingCancels));
+    unmapRing(ring);
+    UA_close(ring->fd);
+    ring->fd = UA_INVALID_FD;
+}
+
+/*******************/
+/* FD Registration */
+/*******************/
+
+/* The registered fds are polled with oneshot poll requests that are re-armed
+ * after the event was processed. This retains the level-triggered semantics of
+ * epoll. */
+
+typedef struct UA_IOUringPoll {
+    UA_IOUringRequest req;
+    UA_EventLoopPOSIX *el;
+    UA_RegisteredFD *rfd; /* NULL after deregistering */
+    unsigned int events;  /* Poll events of the armed request */
+    UA_Boolean armed;
+    UA_Boolean removing;
+    UA_Boolean dispatching;
+} UA_IOUringPoll;
+
+static unsigned int
+pollEvents(const UA_RegisteredFD *rfd) {
+    unsigned int events = 0;
+    if(rfd->listenEvents & UA_FDEVENT_IN)
+        events |= POLLIN;
+    if(rfd->listenEvents & UA_FDEVENT_OUT)
+        events |= POLLOUT;
+    return events;
+}
+
+static UA_StatusCode
+armPoll(UA_EventLoopPOSIX *el, UA_IOUringPoll *poll) {
+    unsigned int events = pollEvents(poll->rfd);
+    if(poll->armed || events == 0)
+        return UA_STATUSCODE_GOOD;
+    struct io_uring_sqe *sqe = UA_EventLoopPOSIX_IOUring_getSQE(el, &poll->req);
+    if(!sqe)
+        return UA_STATUSCODE_BADINTERNALERROR;
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = poll->rfd->fd;
+    setPollEvents(sqe, events);
+    UA_EventLoopPOSIX_IOUring_commitSQE(el);
+    poll->events = events;
+    poll->armed = true;
+    return UA_STATUSCODE_GOOD;
+}
+
+static void
+removePoll(UA_EventLoopPOSIX *el, UA_IOUringPoll *poll) {
+    if(poll->removing)
+        return;
+    poll->removing = true;
+    struct io_uring_sqe *sqe = UA_EventLoopPOSIX_IOUring_getSQE(el, NULL);
+    if(!sqe) {
+        deferCancel(el, &poll->req);
+        return;
+    }
+    sqe->opcode = IORING_OP_POLL_REMOVE;
+    sqe->addr = (__u64)(uintptr_t)&poll->req;
+    UA_EventLoopPOSIX_IOUring_commitSQE(el);
+}
+
+static UA_Boolean
+pollCallback(UA_IOUringRequest *req, int res, unsigned int flags) {
+    UA_IOUringPoll *poll = (UA_IOUringPoll*)req;
+    UA_EventLoopPOSIX *el = poll->el;
+    poll->armed = false;
+    poll->removing = false;
+
+    /* The fd was deregistered in the meantime */
+    UA_RegisteredFD *rfd = poll->rfd;
+    if(!rfd) {
+        UA_assert(el->uring.detached > 0);
+        el->uring.detached--;
+        UA_free(poll);
+        return false;
+    }
+
+    /* The rfd is already registered for removal. Don't process incoming
+     * events any longer. */
+    if(rfd->dc.callback)
+        return false;
+
+    /* Get the event. Only report events the rfd (still) listens on. The poll
+     * was removed (-ECANCELED) if the events were modified. */
+    short event = 0;
+    if(res < 0) {
+        if(res != -ECANCELED)
+            event = UA_FDEVENT_ERR;
+    } else if((res & POLLIN) && (rfd->listenEvents & UA_FDEVENT_IN)) {
+        event = UA_FDEVENT_IN;
+    } else if((res & POLLOUT) && (rfd->listenEvents & UA_FDEVENT_OUT)) {
+        event = UA_FDEVENT_OUT;
+    } else if(res & (POLLERR | POLLHUP | POLLNVAL)) {
+        event = UA_FDEVENT_ERR;
+    }
+
+    /* Call the EventSource callback */
+    if(event) {
+        poll->dispatching = true;
+        UA_EventLoopPOSIX_processFD(el, rfd, event);
+        poll->dispatching = false;
+
+        /* The fd has removed itself */
+        if(!poll->rfd) {
+            UA_free(poll);
+            return true;
+        }
+        if(poll->rfd->dc.callback)
+            return true;
+    }
+
+    /* Re-arm for the next event */
+    armPoll(el, poll);
+    return (event != 0);
+}
+
+UA_StatusCode
+UA_EventLoopPOSIX_IOUring_registerFD(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd) {
+    UA_LOCK_ASSERT(&el->elMutex);
+    UA_IOUringPoll *poll = (UA_IOUringPoll*)UA_calloc(1, sizeof(UA_IOUringPoll));
+    if(!poll)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    poll->req.callback = pollCallback;
+    poll->el = el;
+    poll->rfd = rfd;
+    UA_StatusCode res = armPoll(el, poll);
+    if(res != UA_STATUSCODE_GOOD) {
+        UA_free(poll);
+        return res;
+    }
+    rfd->uringPoll = poll;
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_StatusCode
+UA_EventLoopPOSIX_IOUring_modifyFD(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd) {
+    UA_LOCK_ASSERT(&el->elMutex);
+    UA_IOUringPoll *poll = rfd->uringPoll;
+    if(!poll)
+        return UA_STATUSCODE_BADINTERNALERROR;
+
+    /* Not armed (or currently processed) -> arm with the new events */
+    if(!poll->armed) {
+        if(poll->dispatching)
+            return UA_STATUSCODE_GOOD; /* Re-armed after the callback */
+        return armPoll(el, poll);
+    }
+
+    /* Remove the armed poll. It gets re-armed with the new events in the
+     * callback. */
+    if(poll->events != pollEvents(rfd))
+        removePoll(el, poll);
+    return UA_STATUSCODE_GOOD;
+}
+
+void
+UA_EventLoopPOSIX_IOUring_deregisterFD(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd) {
+    UA_LOCK_ASSERT(&el->elMutex);
+    UA_IOUringPoll *poll = rfd->uringPoll;
+    if(!poll)
+        return;
+    rfd->uringPoll = NULL;
+    poll->rfd = NULL;
+
+    /* Cleaned up in the callback */
+    if(poll->dispatching)
+        return;
+
+    /* Not in-flight -> free right away */
+    if(!poll->armed) {
+        UA_free(poll);
+        return;
+    }
+
+    /* Remove and free in the callback */
+    el->uring.detached++;
+    removePoll(el, poll);
+}
+
+/***********/
+/* Polling */
+/***********/
+
+/* Process the completions that are available now. Completions arriving during
+ * the processing are left for later so that timed callbacks are not starved.
+ * Returns whether a completion was signaled to the application. */
+static UA_Boolean
+processCompletions(UA_IOUring *ring) {
+    UA_Boolean signaled = false;
+    unsigned int head = *ring->cqHead;
+    unsigned int tail = __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE);
+    for(; head != tail; head++) {
+        struct io_uring_cqe *cqe = &ring->cqes[head & ring->cqMask];
+        UA_IOUringRequest *req = (UA_IOUringRequest*)(uintptr_t)cqe->user_data;
+        int res = cqe->res;
+        unsigned int flags = cqe->flags;
+        __atomic_store_n(ring->cqHead, head + 1, __ATOMIC_RELEASE);
+        if(!req)
+            continue;
+        /* The request has completed before the deferred cancellation was
+         * queued */
+        if(req->cancelPending && !(flags & IORING_CQE_F_MORE)) {
+            LIST_REMOVE(req, cancelPointers);
+            req->cancelPending = false;
+        }
+        signaled |= req->callback(req, res, flags);
+    }
+    return signaled;
+}
+
+void
+UA_EventLoopPOSIX_IOUring_reap(UA_EventLoopPOSIX *el) {
+    UA_LOCK_ASSERT(&el->elMutex);
+    UA_IOUring *ring = &el->uring;
+    submitPendingCancels(el);
+    unsigned int toSubmit = *ring->sqTail -
+        __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE);
+    iouring_enter(ring->fd, toSubmit, 0, IORING_ENTER_GETEVENTS, NULL, 0);
+    processCompletions(ring);
+}
+
+UA_StatusCode
+UA_EventLoopPOSIX_IOUring_pollFDs(UA_EventLoopPOSIX *el, UA_DateTime listenTimeout) {
+    UA_LOCK_ASSERT(&el->elMutex);
+    UA_IOUring *ring = &el->uring;
+
+    /* Submit the batched SQEs and wait for completions in one system call */
+    struct __kernel_timespec ts;
+    ts.tv_sec = (long long)(listenTimeout / UA_DATETIME_SEC);
+    ts.tv_nsec = (long long)((listenTimeout % UA_DATETIME_SEC) * 100);
+    struct io_uring_getevents_arg arg;
+    memset(&arg, 0, sizeof(struct io_uring_getevents_arg));
+    arg.ts = (__u64)(uintptr_t)&ts;
+    submitPendingCancels(el);
+    unsigned int toSubmit = *ring->sqTail -
+        __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE);
+
+    UA_DateTime deadline =
+        el->eventLoop.dateTime_nowMonotonic(&el->eventLoop) + listenTimeout;
+
+    UA_Boolean signaled = false;
+    do {
+        ring->waiting = true;
+        UA_UNLOCK(&el->elMutex);
+        int ret = iouring_enter(ring->fd, toSubmit, 1,
+                                IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+                                &arg, sizeof(struct io_uring_getevents_arg));
+        UA_LOCK(&el->elMutex);
+        ring->waiting = false;
+
+        /* -ETIME: Timeout, -EINTR: Interrupted, -EBUSY: Completion queue
+         * overflow (flushed by processing the completions) */
+        if(ret < 0 && ret != -ETIME && ret != -EINTR &&
+           ret != -EBUSY && ret != -EAGAIN) {
+            errno = -ret;
+            UA_LOG_SOCKET_ERRNO_WRAP(
+               UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                              "Eventloop\t| Error waiting on the io_uring (%s)",
+                              errno_str));
+            return UA_STATUSCODE_BADINTERNALERROR;
+        }
+        if(ret == -ETIME || ret == -EINTR)
+            break;
+
+        signaled |= processCompletions(ring);
+
+        /* Return to process the delayed callbacks */
+        if(el->delayedHead1 != NULL && el->delayedHead2 != NULL)
+            break;
+
+        /* Only silent completions (e.g. finished sends). Wait for the
+         * remaining time. */
+        listenTimeout = deadline - el->eventLoop.dateTime_nowMonotonic(&el->eventLoop);
+        if(listenTimeout < 0)
+            listenTimeout = 0;
+        ts.tv_sec = (long long)(listenTimeout / UA_DATETIME_SEC);
+        ts.tv_nsec = (long long)((listenTimeout % UA_DATETIME_SEC) * 100);
+        submitPendingCancels(el);
+        toSubmit = *ring->sqTail - __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE);
+    } while(!signaled && listenTimeout > 0 &&
+            el->eventLoop.state != UA_EVENTLOOPSTATE_STOPPING);
+
+    /* Submit the SQEs batched during the processing of the completions (e.g.
+     * the responses). They must not wait for the next iteration. */
+    submitSQEs(el);
+    return UA_STATUSCODE_GOOD;
+}
+
+/*******************/
+/* Buffer Handling */
+/*******************/
+
+UA_IOUringBufferRing *
+UA_EventLoopPOSIX_IOUring_newBufferRing(UA_EventLoopPOSIX *el, UA_UInt16 entries,
+                                        size_t bufferSize) {
+    UA_LOCK_ASSERT(&el->elMutex);
+    UA_assert(entries > 0 && (entries & (entries - 1)) == 0);
+
+    UA_IOUringBufferRing *ring = (UA_IOUringBufferRing*)
+        UA_calloc(1, sizeof(UA_IOUringBufferRing));
+    if(!ring)
+        return NULL;
+    ring->entries = entries;
+    ring->bufferSize = bufferSize;
+
+    /* The ring memory must be page-aligned */
+    ring->brSize = entries * sizeof(struct io_uring_buf);
+    ring->br = (struct io_uring_buf_ring*)
+        mmap(NULL, ring->brSize, PROT_READ | PROT_WRITE,
+             MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if(ring->br == MAP_FAILED) {
+        UA_free(ring);
+        return NULL;
+    }
+
+    ring->buffers = (UA_Byte*)UA_malloc(entries * bufferSize);
+    if(!ring->buffers) {
+        munmap(ring->br, ring->brSize);
+        UA_free(ring);
+        return NULL;
+    }
+
+    /* Register with a fresh buffer group id */
+    ring->group = el->uring.nextBufferGroup++;
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(struct io_uring_buf_reg));
+    reg.ring_addr = (__u64)(uintptr_t)ring->br;
+    reg.ring_entries = entries;
+    reg.bgid = ring->group;
+    int ret = iouring_register(el->uring.fd, IORING_REGISTER_PBUF_RING, &reg, 1);
+    if(ret < 0) {
+        errno = -ret;
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                          "Eventloop\t| Could not register the buffer ring (%s)",
+                          errno_str));
+        UA_free(ring->buffers);
+        munmap(ring->br, ring->brSize);
+        UA_free(ring);
+        return NULL;
+    }
+
+    /* Provide all buffers to the kernel */
+    for(UA_UInt16 i = 0; i < entries; i++)
+        UA_EventLoopPOSIX_IOUring_recycleBuffer(ring, i);
+    return ring;
+}
+
+void
+UA_EventLoopPOSIX_IOUring_deleteBufferRing(UA_EventLoopPOSIX *el,
+                                           UA_IOUringBufferRing *ring) {
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(struct io_uring_buf_reg));
+    reg.bgid = ring->group;
+    if(UA_EventLoopPOSIX_usesIOUring(el))
+        iouring_register(el->uring.fd, IORING_UNREGISTER_PBUF_RING, &reg, 1);
+    UA_free(ring->buffers);
+    munmap(ring->br, ring->brSize);
+    UA_free(ring);
+}
+
+UA_ByteString
+UA_EventLoopPOSIX_IOUring_getBuffer(UA_IOUringBufferRing *ring, UA_UInt16 bid) {
+    UA_ByteString buf;
+    buf.data = ring->buffers + ((size_t)bid * ring->bufferSize);
+    buf.length = ring->bufferSize;
+    return buf;
+}
+
+void
+UA_EventLoopPOSIX_IOUring_recycleBuffer(UA_IOUringBufferRing *ring, UA_UInt16 bid) {
+    /* The tail overlays a reserved field of the first entry. Don't overwrite
+     * the entire entry. */
+    struct io_uring_buf *buf = &ring->br->bufs[ring->tail & (ring->entries - 1)];
+    buf->addr = (__u64)(uintptr_t)(ring->buffers + ((size_t)bid * ring->bufferSize));
+    buf->len = (__u32)ring->bufferSize;
+    buf->bid = bid;
+    ring->tail++;
+    __atomic_store_n(&ring->br->tail, ring->tail, __ATOMIC_RELEASE);
+}
+
+#endif /* defined(UA_HAVE_IO_URING) */
@@ -12,13 +12,28 @@
 #if defined(UA_ARCHITECTURE_POSIX) && !defined(UA_ARCHITECTURE_LWIP) || defined(UA_ARCHITECTURE_WIN32)
 
 /* Configuration parameters */
-#define TCP_MANAGERPARAMS 2
+#define TCP_MANAGERPARAMS 5
+#define TCP_MANAGERPARAMINDEX_SENDQUEUELIMIT 2
+#define TCP_MANAGERPARAMINDEX_SENDQUEUECLOSE 3
+#define TCP_MANAGERPARAMINDEX_RECVBUFCOUNT 4
+
+/* Send gathered buffers with one system call */
+#ifdef __linux__
+# define TCP_HAVE_SENDMSG
+# define TCP_MAX_IOVECS 64
+#endif
 
 static UA_KeyValueRestriction tcpManagerParams[TCP_MANAGERPARAMS] = {
     {{0, UA_STRING_STATIC("recv-bufsize")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
-    {{0, UA_STRING_STATIC("send-bufsize")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false}
+    {{0, UA_STRING_STATIC("send-bufsize")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
+    {{0, UA_STRING_STATIC("send-queue-limit")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
+    {{0, UA_STRING_STATIC("send-queue-close")}, &UA_TYPES[UA_TYPES_BOOLEAN], false, true, false},
+    {{0, UA_STRING_STATIC("recv-bufcount")}, &UA_TYPES[UA_TYPES_UINT16], false, true, false}
 };
 
+/* Default number of receive buffers provided to the io_uring */
+#define TCP_IOURING_RECVBUFCOUNT 32
+
 #define TCP_PARAMETERSSIZE 5
 #define TCP_PARAMINDEX_ADDR 0
 #define TCP_PARAMINDEX_PORT 1
@@ -34,14 +49,53 @@ static UA_KeyValueRestriction tcpConnectionParams[TCP_PARAMETERSSIZE] = {
     {{0, UA_STRING_STATIC("reuse")}, &UA_TYPES[UA_TYPES_BOOLEAN], false, true, false}
 };
 
+/* Outgoing data that could not be written to the socket right away */
+typedef struct TCP_SendBuffer {
+    TAILQ_ENTRY(TCP_SendBuffer) pointers;
+    UA_ByteString buf;
+    size_t offset; /* Number of bytes from buf already sent */
+} TCP_SendBuffer;
+
 typedef struct {
     UA_RegisteredFD rfd;
 
     UA_ConnectionManager_connectionCallback applicationCB;
     void *application;
     void *context;
+
+    /* Active connection waiting for the non-blocking connect to complete */
+    UA_Boolean connecting;
+
+    /* Send queue. Flushed when the socket signals that it is writable. */
+    TAILQ_HEAD(, TCP_SendBuffer) sendQueue;
+    size_t sendQueueSize; /* Bytes in the queue not yet sent */
+
+#ifdef UA_HAVE_IO_URING
+    /* Requests in the io_uring. The connection is not freed before they have
+     * completed. At most one send is in-flight to retain the ordering. */
+    UA_IOUringRequest recvRequest;
+    UA_IOUringRequest sendRequest;
+    UA_Boolean recvArmed;
+    UA_Boolean recvCancelled;
+    UA_Boolean sendArmed;
+    UA_Boolean cancelled;
+
+    /* Multishot accept of a listen socket */
+    struct TCP_AcceptRequest *acceptRequest;
+#endif
 } TCP_FD;
 
+#ifdef UA_HAVE_IO_URING
+/* The accept request is allocated separately. A closed listen socket detaches
+ * from the request and the request is freed after its last completion. */
+typedef struct TCP_AcceptRequest {
+    UA_IOUringRequest req;
+    UA_EventLoopPOSIX *el;
+    TCP_FD *conn; /* NULL when detached */
+    UA_Boolean armed;
+} TCP_AcceptRequest;
+#endif
+
 static void
 TCP_shutdown(UA_ConnectionManager *cm, TCP_FD *conn);
 
@@ -61,6 +115,449 @@ TCP_setNoNagle(UA_FD sockfd) {
     return UA_STATUSCODE_GOOD;
 }
 
+/* Send as much of the buffer as the socket accepts without blocking. The
+ * number of bytes written is returned in the last argument. A non-good status
+ * code means that the connection has failed. */
+static UA_StatusCode
+TCP_sendNonBlocking(UA_FD fd, const UA_Byte *data, size_t length, size_t *written) {
+    *written = 0;
+    while(*written < length) {
+        UA_RESET_ERRNO;
+        ssize_t n = UA_send(fd, (const char*)data + *written,
+                            length - *written, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if(n > 0) {
+            *written += (size_t)n;
+            continue;
+        }
+        if(n < 0 && UA_ERRNO == UA_INTERRUPTED)
+            continue;
+        if(n == 0 || UA_ERRNO == UA_WOULDBLOCK || UA_ERRNO == UA_AGAIN)
+            break; /* The socket is full */
+        return UA_STATUSCODE_BADCONNECTIONCLOSED;
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+#ifdef TCP_HAVE_SENDMSG
+/* Same as TCP_sendNonBlocking for the concatenation of the buffers */
+static UA_StatusCode
+TCP_sendVectorNonBlocking(UA_FD fd, const UA_ByteString *bufs, size_t bufsSize,
+                          size_t *written) {
+    *written = 0;
+    size_t pos = 0;  /* Current buffer */
+    size_t skip = 0; /* Bytes already sent from the current buffer */
+    while(pos < bufsSize) {
+        /* Gather the remaining buffers */
+        struct iovec iov[TCP_MAX_IOVECS];
+        size_t iovSize = 0;
+        for(size_t i = pos; i < bufsSize && iovSize < TCP_MAX_IOVECS; i++) {
+            size_t offset = (i == pos) ? skip : 0;
+            if(bufs[i].length <= offset)
+                continue;
+            iov[iovSize].iov_base = bufs[i].data + offset;
+            iov[iovSize].iov_len = bufs[i].length - offset;
+            iovSize++;
+        }
+        if(iovSize == 0)
+            break;
+
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(struct msghdr));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = iovSize;
+        UA_RESET_ERRNO;
+        ssize_t n = sendmsg(fd, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if(n < 0 && UA_ERRNO == UA_INTERRUPTED)
+            continue;
+        if(n == 0 || (n < 0 && (UA_ERRNO == UA_WOULDBLOCK || UA_ERRNO == UA_AGAIN)))
+            break; /* The socket is full */
+        if(n < 0)
+            return UA_STATUSCODE_BADCONNECTIONCLOSED;
+
+        /* Advance over the sent bytes */
+        *written += (size_t)n;
+        size_t sent = (size_t)n;
+        while(pos < bufsSize && sent >= bufs[pos].length - skip) {
+            sent -= bufs[pos].length - skip;
+            skip = 0;
+            pos++;
+        }
+        skip += sent;
+    }
+    return UA_STATUSCODE_GOOD;
+}
+#endif
+
+/* The io_uring is used for receiving and sending if the buffer ring of the
+ * ConnectionManager is set up */
+static UA_Boolean
+TCP_usesIOUring(UA_POSIXConnectionManager *pcm) {
+#ifdef UA_HAVE_IO_URING
+    return (pcm->bufRing != NULL);
+#else
+    return false;
+#endif
+}
+
+#ifdef UA_HAVE_IO_URING
+static void
+TCP_IOUring_armRecv(UA_POSIXConnectionManager *pcm, TCP_FD *conn);
+
+static void
+TCP_IOUring_armSend(UA_POSIXConnectionManager *pcm, TCP_FD *conn);
+#endif
+
+/* High-water mark for the send queue of a connection (0 -> unbounded) */
+static UA_UInt32
+TCP_getSendQueueLimit(UA_ConnectionManager *cm) {
+    const UA_UInt32 *limit = (const UA_UInt32*)
+        UA_KeyValueMap_getScalar(&cm->eventSource.params,
+                                 tcpManagerParams[TCP_MANAGERPARAMINDEX_SENDQUEUELIMIT].name,
+                                 &UA_TYPES[UA_TYPES_UINT32]);
+    return (limit) ? *limit : 0;
+}
+
+/* Listen for output while the connection is being opened and while data is
+ * queued for sending. Listen for input unless the send queue has exceeded the
+ * high-water mark. Then no more input is read (and no more requests are
+ * processed) until the remote side has caught up. */
+static void
+TCP_updateListenEvents(UA_ConnectionManager *cm, TCP_FD *conn) {
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)cm->eventSource.eventLoop;
+    UA_LOCK_ASSERT(&el->elMutex);
+
+#ifdef UA_HAVE_IO_URING
+    /* The io_uring receives and sends directly. Only the opening of active
+     * connections is polled. */
+    UA_POSIXConnectionManager *pcm = (UA_POSIXConnectionManager*)cm;
+    if(TCP_usesIOUring(pcm) && !conn->connecting) {
+        UA_UInt32 limit = TCP_getSendQueueLimit(cm);
+        if(limit > 0 && conn->sendQueueSize > limit) {
+            if(conn->recvArmed && !conn->recvCancelled) {
+                UA_EventLoopPOSIX_IOUring_cancel(el, &conn->recvRequest);
+                conn->recvCancelled = true;
+            }
+        } else {
+            TCP_IOUring_armRecv(pcm, conn);
+        }
+        TCP_IOUring_armSend(pcm, conn);
+        if(conn->rfd.listenEvents != 0) {
+            conn->rfd.listenEvents = 0;
+            UA_EventLoopPOSIX_modifyFD(el, &conn->rfd);
+        }
+        return;
+    }
+#endif
+
+    short events = UA_FDEVENT_IN;
+    if(conn->connecting) {
+        events = UA_FDEVENT_OUT;
+    } else if(conn->sendQueueSize > 0) {
+        events |= UA_FDEVENT_OUT;
+        UA_UInt32 limit = TCP_getSendQueueLimit(cm);
+        if(limit > 0 && conn->sendQueueSize > limit)
+            events = UA_FDEVENT_OUT;
+    }
+
+    if(events == conn->rfd.listenEvents)
+        return;
+    conn->rfd.listenEvents = events;
+    UA_EventLoopPOSIX_modifyFD(el, &conn->rfd);
+}
+
+/* Append the unsent remainder of the buffer to the send queue. Heap-allocated
+ * buffers are taken over. The static send buffer of the ConnectionManager is
+ * reused for the next message, so the remainder gets copied. */
+static UA_StatusCode
+TCP_enqueueSend(UA_POSIXConnectionManager *pcm, TCP_FD *conn,
+                UA_ByteString *buf, size_t offset) {
+    TCP_SendBuffer *sb = (TCP_SendBuffer*)UA_malloc(sizeof(TCP_SendBuffer));
+    if(!sb)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+
+    if(buf->data == pcm->txBuffer.data) {
+        UA_StatusCode res = UA_ByteString_allocBuffer(&sb->buf, buf->length - offset);
+        if(res != UA_STATUSCODE_GOOD) {
+            UA_free(sb);
+            return res;
+        }
+        memcpy(sb->buf.data, buf->data + offset, sb->buf.length);
+        sb->offset = 0;
+        UA_EventLoopPOSIX_freeNetworkBuffer(&pcm->cm, (uintptr_t)conn->rfd.fd, buf);
+    } else {
+        sb->buf = *buf;
+        sb->offset = offset;
+        UA_ByteString_init(buf);
+    }
+
+    TAILQ_INSERT_TAIL(&conn->sendQueue, sb, pointers);
+    conn->sendQueueSize += sb->buf.length - sb->offset;
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Send from the queue until it is empty or the socket is full */
+static UA_StatusCode
+TCP_flushSendQueue(TCP_FD *conn) {
+    TCP_SendBuffer *sb;
+    while((sb = TAILQ_FIRST(&conn->sendQueue))) {
+        size_t written = 0;
+        UA_StatusCode res =
+            TCP_sendNonBlocking(conn->rfd.fd, sb->buf.data + sb->offset,
+                                sb->buf.length - sb->offset, &written);
+        sb->offset += written;
+        conn->sendQueueSize -= written;
+        if(res != UA_STATUSCODE_GOOD)
+            return res;
+        if(sb->offset < sb->buf.length)
+            break; /* The socket is full again */
+        TAILQ_REMOVE(&conn->sendQueue, sb, pointers);
+        UA_ByteString_clear(&sb->buf);
+        UA_free(sb);
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+static void
+TCP_clearSendQueue(TCP_FD *conn) {
+    TCP_SendBuffer *sb;
+    while((sb = TAILQ_FIRST(&conn->sendQueue))) {
+        TAILQ_REMOVE(&conn->sendQueue, sb, pointers);
+        UA_ByteString_clear(&sb->buf);
+        UA_free(sb);
+    }
+    conn->sendQueueSize = 0;
+}
+
+#ifdef UA_HAVE_IO_URING
+
+/********************/
+/* io_uring Sockets */
+/********************/
+
+static UA_Boolean
+TCP_IOUring_recvCallback(UA_IOUringRequest *req, int res, unsigned int flags) {
+    TCP_FD *conn = (TCP_FD*)req->context;
+    UA_ConnectionManager *cm = (UA_ConnectionManager*)conn->rfd.es;
+    UA_POSIXConnectionManager *pcm = (UA_POSIXConnectionManager*)cm;
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)cm->eventSource.eventLoop;
+    UA_LOCK_ASSERT(&el->elMutex);
+
+    /* The multishot receive has terminated */
+    if(!(flags & IORING_CQE_F_MORE))
+        conn->recvArmed = false;
+
+    /* Forward the received data and return the buffer to the kernel */
+    UA_Boolean signaled = false;
+    if(flags & IORING_CQE_F_BUFFER) {
+        UA_UInt16 bid = (UA_UInt16)(flags >> IORING_CQE_BUFFER_SHIFT);
+        if(res > 0 && !conn->rfd.dc.callback) {
+            UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                         "TCP %u\t| Received message of size %u",
+                         (unsigned)conn->rfd.fd, (unsigned)res);
+            UA_ByteString response =
+                UA_EventLoopPOSIX_IOUring_getBuffer(pcm->bufRing, bid);
+            response.length = (size_t)res;
+#ifdef UA_ENABLE_EVENTLOOP_STATISTICS
+            UA_DateTime start = el->eventLoop.dateTime_nowMonotonic(&el->eventLoop);
+#endif
+            conn->applicationCB(cm, (uintptr_t)conn->rfd.fd,
+                                conn->application, &conn->context,
+                                UA_CONNECTIONSTATE_ESTABLISHED,
+                                &UA_KEYVALUEMAP_NULL, response);
+#ifdef UA_ENABLE_EVENTLOOP_STATISTICS
+            UA_EventLoopPOSIX_recordFD(el, &conn->rfd, start);
+#endif
+            signaled = true;
+        }
+        UA_EventLoopPOSIX_IOUring_recycleBuffer(pcm->bufRing, bid);
+    }
+
+    /* Orderly shutdown or error. Running out of buffers, interruptions and
+     * cancellations (for throttling) only require re-arming. */
+    if(res == 0 || (res < 0 && res != -ENOBUFS && res != -ECANCELED &&
+                    res != -EINTR && res != -EAGAIN)) {
+        if(!conn->rfd.dc.callback) {
+            errno = (res < 0) ? -res : 0;
+            UA_LOG_SOCKET_ERRNO_WRAP(
+               UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                            "TCP %u\t| recv signaled the socket was shutdown (%s)",
+                            (unsigned)conn->rfd.fd, errno_str));
+            TCP_shutdown(cm, conn);
+            return true;
+        }
+        return signaled;
+    }
+
+    /* Re-arm unless throttled */
+    if(!conn->recvArmed && !conn->rfd.dc.callback)
+        TCP_updateListenEvents(cm, conn);
+    return signaled;
+}
+
+static UA_Boolean
+TCP_IOUring_sendCallback(UA_IOUringRequest *req, int res, unsigned int flags) {
+    TCP_FD *conn = (TCP_FD*)req->context;
+    UA_ConnectionManager *cm = (UA_ConnectionManager*)conn->rfd.es;
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)cm->eventSource.eventLoop;
+    UA_LOCK_ASSERT(&el->elMutex);
+
+    conn->sendArmed = false;
+
+    /* The send has failed */
+    if(res < 0 && res != -EINTR && res != -EAGAIN) {
+        if(res != -ECANCELED && !conn->rfd.dc.callback) {
+            errno = -res;
+            UA_LOG_SOCKET_ERRNO_WRAP(
+               UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                            "TCP %u\t| Send failed with error %s",
+                            (unsigned)conn->rfd.fd, errno_str));
+            TCP_shutdown(cm, conn);
+            return true;
+        }
+        return false;
+    }
+
+    /* Advance in the send queue */
+    TCP_SendBuffer *sb = TAILQ_FIRST(&conn->sendQueue);
+    if(res > 0 && sb) {
+        sb->offset += (size_t)res;
+        conn->sendQueueSize -= (size_t)res;
+        if(sb->offset >= sb->buf.length) {
+            TAILQ_REMOVE(&conn->sendQueue, sb, pointers);
+            UA_ByteString_clear(&sb->buf);
+            UA_free(sb);
+        }
+    }
+
+    /* Send the remainder and resume receiving if the queue was throttled.
+     * Completed sends are not signaled to the application. */
+    if(!conn->rfd.dc.callback)
+        TCP_updateListenEvents(cm, conn);
+    return false;
+}
+
+/* Multishot receive into the buffer ring of the ConnectionManager */
+static void
+TCP_IOUring_armRecv(UA_POSIXConnectionManager *pcm, TCP_FD *conn) {
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)pcm->cm.eventSource.eventLoop;
+    if(conn->recvArmed || conn->rfd.dc.callback)
+        return;
+    struct io_uring_sqe *sqe =
+        UA_EventLoopPOSIX_IOUring_getSQE(el, &conn->recvRequest);
+    if(!sqe)
+        return;
+    conn->recvRequest.callback = TCP_IOUring_recvCallback;
+    conn->recvRequest.context = conn;
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = conn->rfd.fd;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = pcm->bufRing->group;
+    UA_EventLoopPOSIX_IOUring_commitSQE(el);
+    conn->recvArmed = true;
+    conn->recvCancelled = false;
+}
+
+/* Send the head of the send queue */
+static void
+TCP_IOUring_armSend(UA_POSIXConnectionManager *pcm, TCP_FD *conn) {
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)pcm->cm.eventSource.eventLoop;
+    if(conn->sendArmed || conn->rfd.dc.callback)
+        return;
+
+    /* Skip empty buffers */
+    TCP_SendBuffer *sb;
+    while((sb = TAILQ_FIRST(&conn->sendQueue)) && sb->offset >= sb->buf.length) {
+        TAILQ_REMOVE(&conn->sendQueue, sb, pointers);
+        UA_ByteString_clear(&sb->buf);
+        UA_free(sb);
+    }
+    if(!sb)
+        return;
+
+    struct io_uring_sqe *sqe =
+        UA_EventLoopPOSIX_IOUring_getSQE(el, &conn->sendRequest);
+    if(!sqe)
+        return;
+    size_t len = sb->buf.length - sb->offset;
+    if(len > UA_UINT32_MAX)
+        len = UA_UINT32_MAX;
+    conn->sendRequest.callback = TCP_IOUring_sendCallback;
+    conn->sendRequest.context = conn;
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = conn->rfd.fd;
+    sqe->addr = (__u64)(uintptr_t)(sb->buf.data + sb->offset);
+    sqe->len = (__u32)len;
+    sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+    UA_EventLoopPOSIX_IOUring_commitSQE(el);
+    conn->sendArmed = true;
+}
+
+/* Cancel all in-flight requests of the connection */
+static void
+TCP_IOUring_cancel(UA_EventLoopPOSIX *el, TCP_FD *conn) {
+    if(conn->cancelled)
+        return;
+    struct io_uring_sqe *sqe = UA_EventLoopPOSIX_IOUring_getSQE(el, NULL);
+    if(!sqe)
+        return;
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = conn->rfd.fd;
+    sqe->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+    UA_EventLoopPOSIX_IOUring_commitSQE(el);
+    conn->cancelled = true;
+}
+
+static UA_Boolean
+TCP_IOUring_acceptCallback(UA_IOUringRequest *req, int res, unsigned int flags);
+
+/* Multishot accept on the listen socket */
+static UA_StatusCode
+TCP_IOUring_armAccept(UA_POSIXConnectionManager *pcm, TCP_FD *conn) {
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)pcm->cm.eventSource.eventLoop;
+    TCP_AcceptRequest *ar = conn->acceptRequest;
+    if(!ar) {
+        ar = (TCP_AcceptRequest*)UA_calloc(1, sizeof(TCP_AcceptRequest));
+        if(!ar)
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        ar->req.callback = TCP_IOUring_acceptCallback;
+        ar->el = el;
+        ar->conn = conn;
+        conn->acceptRequest = ar;
+    }
+    if(ar->armed)
+        return UA_STATUSCODE_GOOD;
+
+    struct io_uring_sqe *sqe = UA_EventLoopPOSIX_IOUring_getSQE(el, &ar->req);
+    if(!sqe)
+        return UA_STATUSCODE_BADINTERNALERROR;
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = conn->rfd.fd;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_NONBLOCK;
+    UA_EventLoopPOSIX_IOUring_commitSQE(el);
+    ar->armed = true;
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Detach the accept request from the listen socket before it is closed */
+static void
+TCP_IOUring_detachAccept(UA_EventLoopPOSIX *el, TCP_FD *conn) {
+    TCP_AcceptRequest *ar = conn->acceptRequest;
+    if(!ar)
+        return;
+    conn->acceptRequest = NULL;
+    ar->conn = NULL;
+    if(!ar->armed) {
+        UA_free(ar);
+        return;
+    }
+    el->uring.detached++;
+    UA_EventLoopPOSIX_IOUring_cancel(el, &ar->req);
+}
+
+#endif /* UA_HAVE_IO_URING */
+
 /* Test if the ConnectionManager can be stopped */
 static void
 TCP_checkStopped(UA_POSIXConnectionManager *pcm) {
@@ -71,6 +568,13 @@ TCP_checkStopped(UA_POSIXConnectionManager *pcm) {
         UA_LOG_DEBUG(pcm->cm.eventSource.eventLoop->logger, UA_LOGCATEGORY_NETWORK,
                      "TCP\t| All sockets closed, the EventLoop has stopped");
         pcm->cm.eventSource.state = UA_EVENTSOURCESTATE_STOPPED;
+#ifdef UA_HAVE_IO_URING
+        if(pcm->bufRing) {
+            UA_EventLoopPOSIX_IOUring_deleteBufferRing(
+                (UA_EventLoopPOSIX*)pcm->cm.eventSource.eventLoop, pcm->bufRing);
+            pcm->bufRing = NULL;
+        }
+#endif
     }
 }
 
@@ -83,7 +587,8 @@ TCP_delayedReopen(void *application, void *context) {
     UA_RegisteredFD *rfd = listenRfd->listenFd;
     TCP_FD *conn = (TCP_FD*)rfd;
 
-    UA_LOCK(&el->elMutex);
+    /* Delayed callbacks are processed with the EventLoop lock held */
+    UA_LOCK_ASSERT(&el->elMutex);
 
     UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
                  "TCP %u\t| Delayed reopen of the listen socket",
@@ -104,8 +609,6 @@ TCP_delayedReopen(void *application, void *context) {
     if(!pcm->listenFDs.lh_first) {
         el->maxSocketsLimitReached = false;
     }
-
-    UA_UNLOCK(&el->elMutex);
 }
 
 static UA_StatusCode
@@ -147,7 +650,24 @@ TCP_delayedClose(void *application, void *context) {
     UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)cm->eventSource.eventLoop;
     TCP_FD *conn = (TCP_FD*)context;
 
-    UA_LOCK(&el->elMutex);
+    /* Delayed callbacks are processed with the EventLoop lock held. Not
+     * taking the lock again ensures that the application can release it
+     * (once) in the closing callback. */
+    UA_LOCK_ASSERT(&el->elMutex);
+
+#ifdef UA_HAVE_IO_URING
+    /* Wait until the io_uring has released the connection. The cancellation
+     * usually completes right away. */
+    if(conn->recvArmed || conn->sendArmed) {
+        TCP_IOUring_cancel(el, conn);
+        UA_EventLoopPOSIX_IOUring_reap(el);
+    }
+    if(conn->recvArmed || conn->sendArmed) {
+        UA_EventLoopPOSIX_addDelayedCallback(&el->eventLoop, &conn->rfd.dc);
+        return;
+    }
+    TCP_IOUring_detachAccept(el, conn);
+#endif
 
     UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
                  "TCP %u\t| Delayed closing of the connection",
@@ -190,13 +710,12 @@ TCP_delayedClose(void *application, void *context) {
         addListenSockets(application);
     }
 
+    TCP_clearSendQueue(conn);
     UA_String_clear(&conn->rfd.hostname);
     UA_free(conn);
 
     /* Check if this was the last connection for a closing ConnectionManager */
     TCP_checkStopped(pcm);
-
-    UA_UNLOCK(&el->elMutex);
 }
 
 static int
@@ -233,6 +752,25 @@ TCP_connectionSocketCallback(UA_ConnectionManager *cm, TCP_FD *conn,
         return;
     }
 
+    /* Write-Event on an open connection. The socket can take more data from
+     * the send queue. */
+    if(event == UA_FDEVENT_OUT && !conn->connecting) {
+        UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                     "TCP %u\t| Flushing the send queue (%lu bytes pending)",
+                     (unsigned)conn->rfd.fd, (unsigned long)conn->sendQueueSize);
+        UA_RESET_ERRNO;
+        if(TCP_flushSendQueue(conn) != UA_STATUSCODE_GOOD) {
+            UA_LOG_SOCKET_ERRNO_WRAP(
+               UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                            "TCP %u\t| Send failed with error %s",
+                            (unsigned)conn->rfd.fd, errno_str));
+            TCP_shutdown(cm, conn);
+            return;
+        }
+        TCP_updateListenEvents(cm, conn);
+        return;
+    }
+
     /* Write-Event, a new connection has opened. But some errors come as an
      * out-event. For example if the remote side could not be reached to
      * initiate the connection. So we check manually for error conditions on
@@ -252,8 +790,8 @@ TCP_connectionSocketCallback(UA_ConnectionManager *cm, TCP_FD *conn,
                      (unsigned)conn->rfd.fd);
 
         /* Now we are interested in read-events. */
-        conn->rfd.listenEvents = UA_FDEVENT_IN;
-        UA_EventLoopPOSIX_modifyFD(el, &conn->rfd);
+        conn->connecting = false;
+        TCP_updateListenEvents(cm, conn);
 
         /* A new socket has opened. Signal it to the application. */
         conn->applicationCB(cm, (uintptr_t)conn->rfd.fd,
@@ -263,6 +801,21 @@ TCP_connectionSocketCallback(UA_ConnectionManager *cm, TCP_FD *conn,
         return;
     }
 
+    /* Read-events take precedence in the event reporting. Flush pending data
+     * also here so the send queue is not starved by a chatty remote side. */
+    if(!TAILQ_EMPTY(&conn->sendQueue)) {
+        UA_RESET_ERRNO;
+        if(TCP_flushSendQueue(conn) != UA_STATUSCODE_GOOD) {
+            UA_LOG_SOCKET_ERRNO_WRAP(
+               UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                            "TCP %u\t| Send failed with error %s",
+                            (unsigned)conn->rfd.fd, errno_str));
+            TCP_shutdown(cm, conn);
+            return;
+        }
+        TCP_updateListenEvents(cm, conn);
+    }
+
     UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
                  "TCP %u\t| Allocate receive buffer",
                  (unsigned)conn->rfd.fd);
@@ -339,6 +892,9 @@ removeListenSockets(void *application, UA_RegisteredFD *rfd) {
          * timeout to open a new socket for the same address and port. */
         UA_EventLoopPOSIX_setReusable(rfd->fd);
         UA_EventLoopPOSIX_deregisterFD(el, rfd);
+#ifdef UA_HAVE_IO_URING
+        TCP_IOUring_detachAccept(el, fd);
+#endif
 
         /* Deregister internally */
         ZIP_REMOVE(UA_FDTree, &pcm->fds, rfd);
@@ -373,10 +929,14 @@ removeListenSockets(void *application, UA_RegisteredFD *rfd) {
     return NULL;
 }
 
+/* Set up a connection accepted from the listen socket */
+static void
+TCP_addAcceptedConnection(UA_ConnectionManager *cm, TCP_FD *conn, UA_FD newsockfd,
+                          struct sockaddr_storage *remote);
+
 /* Gets called when a new connection opens or if the listenSocket is closed */
 static void
 TCP_listenSocketCallback(UA_ConnectionManager *cm, TCP_FD *conn, short event) {
-    UA_POSIXConnectionManager *pcm = (UA_POSIXConnectionManager*)cm;
     UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)cm->eventSource.eventLoop;
     UA_LOCK_ASSERT(&el->elMutex);
 
@@ -406,10 +966,20 @@ TCP_listenSocketCallback(UA_ConnectionManager *cm, TCP_FD *conn, short event) {
         return;
     }
 
+    TCP_addAcceptedConnection(cm, conn, newsockfd, &remote);
+}
+
+static void
+TCP_addAcceptedConnection(UA_ConnectionManager *cm, TCP_FD *conn, UA_FD newsockfd,
+                          struct sockaddr_storage *remote) {
+    UA_POSIXConnectionManager *pcm = (UA_POSIXConnectionManager*)cm;
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)cm->eventSource.eventLoop;
+    UA_LOCK_ASSERT(&el->elMutex);
+
     /* Log the name of the remote host */
     UA_RESET_ERRNO;
     char hoststr[UA_MAXHOSTNAME_LENGTH];
-    int get_res = UA_getnameinfo((struct sockaddr *)&remote, sizeof(remote),
+    int get_res = UA_getnameinfo((struct sockaddr *)remote, sizeof(*remote),
                                  hoststr, sizeof(hoststr),
                                  NULL, 0, NI_NUMERICHOST);
     if(get_res != 0) {
@@ -449,12 +1019,13 @@ TCP_listenSocketCallback(UA_ConnectionManager *cm, TCP_FD *conn, short event) {
     }
 
     newConn->rfd.fd = newsockfd;
-    newConn->rfd.listenEvents = UA_FDEVENT_IN;
+    newConn->rfd.listenEvents = (TCP_usesIOUring(pcm)) ? 0 : UA_FDEVENT_IN;
     newConn->rfd.es = &cm->eventSource;
     newConn->rfd.eventSourceCB = (UA_FDCallback)TCP_connectionSocketCallback;
     newConn->applicationCB = conn->applicationCB;
     newConn->application = conn->application;
     newConn->context = conn->context;
+    TAILQ_INIT(&newConn->sendQueue);
 
     /* Register in the EventLoop. Signal to the user if registering failed. */
     res = UA_EventLoopPOSIX_registerFD(el, &newConn->rfd);
@@ -471,6 +1042,9 @@ TCP_listenSocketCallback(UA_ConnectionManager *cm, TCP_FD *conn, short event) {
     ZIP_INSERT(UA_FDTree, &pcm->fds, &newConn->rfd);
     pcm->fdsSize++;
 
+    /* Start receiving via the io_uring */
+    TCP_updateListenEvents(cm, newConn);
+
     /* Verify whether the maximum socket limit has been exceeded.
      * If true, remove listen sockets from the socket list to stop
      * accepting additional connection requests */
@@ -499,6 +1073,66 @@ TCP_listenSocketCallback(UA_ConnectionManager *cm, TCP_FD *conn, short event) {
                            &kvm, UA_BYTESTRING_NULL);
 }
 
+#ifdef UA_HAVE_IO_URING
+static UA_Boolean
+TCP_IOUring_acceptCallback(UA_IOUringRequest *req, int res, unsigned int flags) {
+    TCP_AcceptRequest *ar = (TCP_AcceptRequest*)req;
+    UA_LOCK_ASSERT(&ar->el->elMutex);
+
+    /* The request remains armed during the processing. So it is not freed if
+     * the listen socket is closed in the meantime. */
+    TCP_FD *conn = ar->conn;
+    if(conn) {
+        UA_ConnectionManager *cm = (UA_ConnectionManager*)conn->rfd.es;
+        if(res >= 0) {
+            struct sockaddr_storage remote;
+            socklen_t remote_size = sizeof(remote);
+            memset(&remote, 0, sizeof(remote));
+            getpeername((UA_FD)res, (struct sockaddr*)&remote, &remote_size);
+#ifdef UA_ENABLE_EVENTLOOP_STATISTICS
+            UA_DateTime start = ar->el->eventLoop.dateTime_nowMonotonic(&ar->el->eventLoop);
+#endif
+            TCP_addAcceptedConnection(cm, conn, (UA_FD)res, &remote);
+#ifdef UA_ENABLE_EVENTLOOP_STATISTICS
+            UA_EventLoopPOSIX_recordFD(ar->el, &conn->rfd, start);
+#endif
+        } else if(res != -ECANCELED && res != -EAGAIN &&
+                  !UA_IS_TEMPORARY_ACCEPT_ERROR(-res)) {
+            /* Close the listen socket */
+            if(cm->eventSource.state != UA_EVENTSOURCESTATE_STOPPING) {
+                errno = -res;
+                UA_LOG_SOCKET_ERRNO_WRAP(
+                   UA_LOG_WARNING(ar->el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                                  "TCP %u\t| Error %s, closing the server socket",
+                                  (unsigned)conn->rfd.fd, errno_str));
+            }
+            TCP_shutdown(cm, conn);
+        }
+    } else if(res >= 0) {
+        UA_close((UA_FD)res); /* Detached from the listen socket */
+    }
+
+    /* The multishot accept continues */
+    UA_Boolean signaled = (conn != NULL && res != -ECANCELED);
+    if(flags & IORING_CQE_F_MORE)
+        return signaled;
+
+    /* Free if detached. Otherwise re-arm. */
+    ar->armed = false;
+    if(!ar->conn) {
+        UA_assert(ar->el->uring.detached > 0);
+        ar->el->uring.detached--;
+        UA_free(ar);
+        return signaled;
+    }
+    if(!ar->conn->rfd.dc.callback) {
+        UA_POSIXConnectionManager *pcm = (UA_POSIXConnectionManager*)ar->conn->rfd.es;
+        TCP_IOUring_armAccept(pcm, ar->conn);
+    }
+    return signaled;
+}
+#endif
+
 static UA_StatusCode
 TCP_registerListenSocket(UA_POSIXConnectionManager *pcm, struct addrinfo *ai,
                          const char *hostname, UA_UInt16 port,
@@ -660,12 +1294,13 @@ TCP_registerListenSocket(UA_POSIXConnectionManager *pcm, struct addrinfo *ai,
     }
 
     newConn->rfd.fd = listenSocket;
-    newConn->rfd.listenEvents = UA_FDEVENT_IN;
+    newConn->rfd.listenEvents = (TCP_usesIOUring(pcm)) ? 0 : UA_FDEVENT_IN;
     newConn->rfd.es = &pcm->cm.eventSource;
     newConn->rfd.eventSourceCB = (UA_FDCallback)TCP_listenSocketCallback;
     newConn->applicationCB = connectionCallback;
     newConn->application = application;
     newConn->context = context;
+    TAILQ_INIT(&newConn->sendQueue);
 
     /* Information to reopen listen socket */
     newConn->rfd.hostname = UA_String_fromChars(hostname);
@@ -688,6 +1323,16 @@ TCP_registerListenSocket(UA_POSIXConnectionManager *pcm, struct addrinfo *ai,
     ZIP_INSERT(UA_FDTree, &pcm->fds, &newConn->rfd);
     pcm->fdsSize++;
 
+#ifdef UA_HAVE_IO_URING
+    /* Accept the connections via the io_uring */
+    if(TCP_usesIOUring(pcm) &&
+       TCP_IOUring_armAccept(pcm, newConn) != UA_STATUSCODE_GOOD) {
+        UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                       "TCP %u\t| Could not submit the accept request",
+                       (unsigned)listenSocket);
+    }
+#endif
+
     /* Set up the callback parameters */
     UA_String listenAddress = UA_STRING((char*)(uintptr_t)hostname);
     UA_KeyValuePair params[2];
@@ -776,6 +1421,16 @@ TCP_shutdown(UA_ConnectionManager *cm, TCP_FD *conn) {
         return;
     }
 
+    /* Best effort to get the queued data out before the shutdown. Not if the
+     * io_uring is currently sending from the queue. */
+#ifdef UA_HAVE_IO_URING
+    if(!TAILQ_EMPTY(&conn->sendQueue) && !conn->sendArmed)
+        TCP_flushSendQueue(conn);
+#else
+    if(!TAILQ_EMPTY(&conn->sendQueue))
+        TCP_flushSendQueue(conn);
+#endif
+
     /* Shutdown the socket to cancel the current select/epoll */
     UA_shutdown(conn->rfd.fd, UA_SHUT_RDWR);
 
@@ -816,66 +1471,194 @@ TCP_shutdownConnection(UA_ConnectionManager *cm, uintptr_t connectionId) {
     return UA_STATUSCODE_GOOD;
 }
 
+/* Called after the remainder of a message was queued. Close the connection if
+ * the high-water mark is exceeded and configured accordingly. Otherwise the
+ * reading from the connection gets paused. */
+static UA_StatusCode
+TCP_checkSendQueue(UA_ConnectionManager *cm, TCP_FD *conn) {
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)cm->eventSource.eventLoop;
+    UA_LOCK_ASSERT(&el->elMutex);
+
+    UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                 "TCP %u\t| %lu bytes queued for sending",
+                 (unsigned)conn->rfd.fd, (unsigned long)conn->sendQueueSize);
+
+    UA_UInt32 limit = TCP_getSendQueueLimit(cm);
+    if(limit > 0 && conn->sendQueueSize > limit) {
+        const UA_Boolean *closeParam = (const UA_Boolean*)
+            UA_KeyValueMap_getScalar(&cm->eventSource.params,
+                                     tcpManagerParams[TCP_MANAGERPARAMINDEX_SENDQUEUECLOSE].name,
+                                     &UA_TYPES[UA_TYPES_BOOLEAN]);
+        if(closeParam && *closeParam) {
+            UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                           "TCP %u\t| The send queue exceeds the limit of %u bytes, "
+                           "closing the connection", (unsigned)conn->rfd.fd,
+                           (unsigned)limit);
+            TCP_shutdown(cm, conn);
+            return UA_STATUSCODE_BADCONNECTIONCLOSED;
+        }
+        UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                     "TCP %u\t| The send queue exceeds the limit of %u bytes, "
+                     "pause receiving", (unsigned)conn->rfd.fd, (unsigned)limit);
+    }
+
+    /* Listen for the socket to become writable */
+    TCP_updateListenEvents(cm, conn);
+    return UA_STATUSCODE_GOOD;
+}
+
 static UA_StatusCode
 TCP_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
                        const UA_KeyValueMap *params, UA_ByteString *buf) {
-    /* We may not have a lock. But we need not take it. As the connectionId is
-     * the fd, no need to do a lookup and access internal data strucures. */
-
-    /* Prevent OS signals when sending to a closed socket */
-    int flags = MSG_NOSIGNAL;
-
-    struct pollfd tmp_poll_fd;
-    tmp_poll_fd.fd = (UA_FD)connectionId;
-    tmp_poll_fd.events = UA_POLLOUT;
-
-    /* Send the full buffer. This may require several calls to send */
-    size_t nWritten = 0;
-    do {
-        ssize_t n = 0;
-        do {
-            UA_RESET_ERRNO;
-            UA_LOG_DEBUG(cm->eventSource.eventLoop->logger, UA_LOGCATEGORY_NETWORK,
-                         "TCP %u\t| Attempting to send", (unsigned)connectionId);
-            size_t bytes_to_send = buf->length - nWritten;
-            n = UA_send((UA_FD)connectionId,
-                        (const char*)buf->data + nWritten,
-                        bytes_to_send, flags);
-            if(n < 0) {
-                /* An error we cannot recover from? */
-                if(UA_ERRNO != UA_INTERRUPTED && UA_ERRNO != UA_WOULDBLOCK &&
-                   UA_ERRNO != UA_AGAIN)
-                    goto shutdown;
-
-                /* Poll for the socket resources to become available and retry
-                 * (blocking) */
-                int poll_ret;
-                do {
-                    UA_RESET_ERRNO;
-                    poll_ret = UA_poll(&tmp_poll_fd, 1, 100);
-                    if(poll_ret < 0 && UA_ERRNO != UA_INTERRUPTED)
-                        goto shutdown;
-                } while(poll_ret <= 0);
-            }
-        } while(n < 0);
-        nWritten += (size_t)n;
-    } while(nWritten < buf->length);
+    UA_POSIXConnectionManager *pcm = (UA_POSIXConnectionManager*)cm;
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)cm->eventSource.eventLoop;
+    UA_LOCK(&el->elMutex);
 
-    /* Clean up and return */
-    UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
-    return UA_STATUSCODE_GOOD;
+    /* Look up the connection */
+    UA_FD fd = (UA_FD)connectionId;
+    TCP_FD *conn = (TCP_FD*)ZIP_FIND(UA_FDTree, &pcm->fds, &fd);
+    if(!conn || conn->rfd.dc.callback) {
+        UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                       "TCP %u\t| Cannot send - the connection is closed",
+                       (unsigned)connectionId);
+        UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
+        UA_UNLOCK(&el->elMutex);
+        return UA_STATUSCODE_BADCONNECTIONCLOSED;
+    }
+
+    /* Send right away if nothing is queued. Otherwise the buffer is appended to
+     * the queue to retain the ordering. With the io_uring, all buffers go
+     * through the queue. The sends of all connections are then submitted in
+     * one batch. */
+    size_t written = 0;
+    UA_StatusCode res;
+    if(TAILQ_EMPTY(&conn->sendQueue) && !TCP_usesIOUring(pcm)) {
+        UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                     "TCP %u\t| Attempting to send", (unsigned)connectionId);
+        res = TCP_sendNonBlocking(conn->rfd.fd, buf->data, buf->length, &written);
+        if(res != UA_STATUSCODE_GOOD)
+            goto shutdown;
+        if(written == buf->length) {
+            UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
+            UA_UNLOCK(&el->elMutex);
+            return UA_STATUSCODE_GOOD;
+        }
+    }
+
+    /* The socket would block. Queue the remainder and send it out once the
+     * socket becomes writable. */
+    res = TCP_enqueueSend(pcm, conn, buf, written);
+    if(res != UA_STATUSCODE_GOOD) {
+        UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                     "TCP %u\t| Could not queue the message for sending (%s)",
+                     (unsigned)connectionId, UA_StatusCode_name(res));
+        TCP_shutdown(cm, conn);
+        UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
+        UA_UNLOCK(&el->elMutex);
+        return UA_STATUSCODE_BADCONNECTIONCLOSED;
+    }
+
+    res = TCP_checkSendQueue(cm, conn);
+    UA_UNLOCK(&el->elMutex);
+    return res;
 
  shutdown:
     /* Error -> shutdown the connection  */
     UA_LOG_SOCKET_ERRNO_WRAP(
-       UA_LOG_ERROR(cm->eventSource.eventLoop->logger, UA_LOGCATEGORY_NETWORK,
+       UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
                     "TCP %u\t| Send failed with error %s",
                     (unsigned)connectionId, errno_str));
-    TCP_shutdownConnection(cm, connectionId);
+    TCP_shutdown(cm, conn);
     UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
+    UA_UNLOCK(&el->elMutex);
     return UA_STATUSCODE_BADCONNECTIONCLOSED;
 }
 
+#ifdef TCP_HAVE_SENDMSG
+static UA_StatusCode
+TCP_sendWithConnectionVector(UA_ConnectionManager *cm, uintptr_t connectionId,
+                             const UA_KeyValueMap *params,
+                             const UA_ByteString *bufs, size_t bufsSize) {
+    UA_POSIXConnectionManager *pcm = (UA_POSIXConnectionManager*)cm;
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)cm->eventSource.eventLoop;
+    UA_LOCK(&el->elMutex);
+
+    /* Look up the connection */
+    UA_FD fd = (UA_FD)connectionId;
+    TCP_FD *conn = (TCP_FD*)ZIP_FIND(UA_FDTree, &pcm->fds, &fd);
+    if(!conn || conn->rfd.dc.callback) {
+        UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                       "TCP %u\t| Cannot send - the connection is closed",
+                       (unsigned)connectionId);
+        UA_UNLOCK(&el->elMutex);
+        return UA_STATUSCODE_BADCONNECTIONCLOSED;
+    }
+
+    size_t total = 0;
+    for(size_t i = 0; i < bufsSize; i++)
+        total += bufs[i].length;
+
+    /* Send right away with a single sendmsg if nothing is queued */
+    size_t written = 0;
+    UA_StatusCode res;
+    if(TAILQ_EMPTY(&conn->sendQueue) && !TCP_usesIOUring(pcm)) {
+        UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                     "TCP %u\t| Attempting to send from %lu buffers",
+                     (unsigned)connectionId, (unsigned long)bufsSize);
+        res = TCP_sendVectorNonBlocking(conn->rfd.fd, bufs, bufsSize, &written);
+        if(res != UA_STATUSCODE_GOOD) {
+            UA_LOG_SOCKET_ERRNO_WRAP(
+               UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                            "TCP %u\t| Send failed with error %s",
+                            (unsigned)connectionId, errno_str));
+            TCP_shutdown(cm, conn);
+            UA_UNLOCK(&el->elMutex);
+            return UA_STATUSCODE_BADCONNECTIONCLOSED;
+        }
+    }
+    if(written == total) {
+        UA_UNLOCK(&el->elMutex);
+        return UA_STATUSCODE_GOOD;
+    }
+
+    /* Copy the remainder into a single buffer for the send queue. The buffers
+     * of the caller are not valid after returning. */
+    UA_ByteString rest;
+    res = UA_ByteString_allocBuffer(&rest, total - written);
+    if(res == UA_STATUSCODE_GOOD) {
+        size_t pos = 0;
+        for(size_t i = 0; i < bufsSize; i++) {
+            const UA_Byte *data = bufs[i].data;
+            size_t length = bufs[i].length;
+            if(written >= length) {
+                written -= length;
+                continue;
+            }
+            data += written;
+            length -= written;
+            written = 0;
+            memcpy(rest.data + pos, data, length);
+            pos += length;
+        }
+        res = TCP_enqueueSend(pcm, conn, &rest, 0);
+        if(res != UA_STATUSCODE_GOOD)
+            UA_ByteString_clear(&rest);
+    }
+    if(res != UA_STATUSCODE_GOOD) {
+        UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                     "TCP %u\t| Could not queue the message for sending (%s)",
+                     (unsigned)connectionId, UA_StatusCode_name(res));
+        TCP_shutdown(cm, conn);
+        UA_UNLOCK(&el->elMutex);
+        return UA_STATUSCODE_BADCONNECTIONCLOSED;
+    }
+
+    res = TCP_checkSendQueue(cm, conn);
+    UA_UNLOCK(&el->elMutex);
+    return res;
+}
+#endif
+
 /* Create a listen-socket that waits for incoming connections */
 static UA_StatusCode
 TCP_openPassiveConnection(UA_POSIXConnectionManager *pcm, const UA_KeyValueMap *params,
@@ -1067,9 +1850,11 @@ TCP_openActiveConnection(UA_POSIXConnectionManager *pcm, const UA_KeyValueMap *p
     newConn->rfd.eventSourceCB = (UA_FDCallback)TCP_connectionSocketCallback;
     newConn->rfd.listenEvents = UA_FDEVENT_OUT; /* Switched to _IN once the
                                                  * connection is open */
+    newConn->connecting = true;
     newConn->applicationCB = connectionCallback;
     newConn->application = application;
     newConn->context = context;
+    TAILQ_INIT(&newConn->sendQueue);
 
     /* Register the fd to trigger when output is possible (the connection is open) */
     res = UA_EventLoopPOSIX_registerFD(el, &newConn->rfd);
@@ -1185,6 +1970,29 @@ TCP_eventSourceStart(UA_ConnectionManager *cm) {
     if(res != UA_STATUSCODE_GOOD)
         goto finish;
 
+#ifdef UA_HAVE_IO_URING
+    /* Receive into a ring of buffers provided to the io_uring. The sockets are
+     * polled if the buffer ring cannot be set up. */
+    if(UA_EventLoopPOSIX_usesIOUring(el) && !pcm->bufRing) {
+        UA_UInt16 count = TCP_IOURING_RECVBUFCOUNT;
+        const UA_UInt16 *countParam = (const UA_UInt16*)
+            UA_KeyValueMap_getScalar(&cm->eventSource.params,
+                                     tcpManagerParams[TCP_MANAGERPARAMINDEX_RECVBUFCOUNT].name,
+                                     &UA_TYPES[UA_TYPES_UINT16]);
+        if(countParam && *countParam > 0)
+            count = *countParam;
+        UA_UInt16 entries = 1; /* Round up to a power of two */
+        while(entries < count && entries < 0x8000)
+            entries = (UA_UInt16)(entries << 1);
+        pcm->bufRing = UA_EventLoopPOSIX_IOUring_newBufferRing(el, entries,
+                                                               pcm->rxBuffer.length);
+        if(!pcm->bufRing)
+            UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                           "TCP\t| Could not set up the io_uring receive buffers, "
+                           "polling the sockets instead");
+    }
+#endif
+
     /* Set the EventSource to the started state */
     cm->eventSource.state = UA_EVENTSOURCESTATE_STARTED;
 
@@ -1260,6 +2068,9 @@ UA_ConnectionManager_new_POSIX_TCP(const UA_String eventSourceName) {
     cm->cm.allocNetworkBuffer = UA_EventLoopPOSIX_allocNetworkBuffer;
     cm->cm.freeNetworkBuffer = UA_EventLoopPOSIX_freeNetworkBuffer;
     cm->cm.sendWithConnection = TCP_sendWithConnection;
+#ifdef TCP_HAVE_SENDMSG
+    cm->cm.sendWithConnectionVector = TCP_sendWithConnectionVector;
+#endif
     cm->cm.closeConnection = TCP_shutdownConnection;
     return &cm->cm;
 }
@@ -19,13 +19,26 @@
 
 /* Configuration parameters */
 
-#define UDP_MANAGERPARAMS 2
+#define UDP_MANAGERPARAMS 4
 
 static UA_KeyValueRestriction udpManagerParams[UDP_MANAGERPARAMS] = {
     {{0, UA_STRING_STATIC("recv-bufsize")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
-    {{0, UA_STRING_STATIC("send-bufsize")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false}
+    {{0, UA_STRING_STATIC("send-bufsize")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
+    {{0, UA_STRING_STATIC("recv-batchsize")}, &UA_TYPES[UA_TYPES_UINT16], false, true, false},
+    {{0, UA_STRING_STATIC("send-batchsize")}, &UA_TYPES[UA_TYPES_UINT16], false, true, false}
 };
 
+/* Receive and send several datagrams with one system call */
+#ifdef __linux__
+# define UDP_HAVE_MMSG
+#endif
+
+#define UDP_DEFAULT_RECV_BATCHSIZE 8
+
+/* Datagrams cannot exceed 64kB. Larger receive buffers in the batch pool would
+ * only waste memory. */
+#define UDP_MAX_DATAGRAMSIZE 65535
+
 #define UDP_PARAMETERSSIZE 9
 #define UDP_PARAMINDEX_LISTEN 0
 #define UDP_PARAMINDEX_ADDR 1
@@ -63,8 +76,40 @@ typedef struct {
 #else
     socklen_t sendAddrLength;
 #endif
+
+#ifdef UDP_HAVE_MMSG
+    /* Datagrams queued during the EventLoop processing. They are sent out with
+     * a single sendmmsg once the current callbacks have finished. The queue
+     * has the capacity of send-batchsize. */
+    UA_ByteString *sendQueue;
+    size_t sendQueueSize;
+#endif
 } UDP_FD;
 
+/* The UDP ConnectionManager carries the buffers for the batched receiving and
+ * sending in addition to the POSIX ConnectionManager */
+typedef struct {
+    UA_POSIXConnectionManager pcm;
+
+#ifdef UDP_HAVE_MMSG
+    size_t recvBatchSize;
+    size_t sendBatchSize;
+
+    /* Pool of receive buffers with the message headers pointing into it */
+    UA_Byte *rxPool;
+    struct mmsghdr *rxMsgs;
+    struct iovec *rxIovs;
+    struct sockaddr_storage *rxAddrs;
+
+    /* Message headers for sending */
+    struct mmsghdr *txMsgs;
+    struct iovec *txIovs;
+
+    /* Flush the send queues of all connections */
+    UA_DelayedCallback flushCallback;
+#endif
+} UDP_ConnectionManager;
+
 typedef enum {
     MULTICASTTYPE_NONE = 0,
     MULTICASTTYPE_IPV4,
@@ -635,6 +680,13 @@ UDP_close(UA_POSIXConnectionManager *pcm, UDP_FD *conn) {
                           (unsigned)conn->rfd.fd, errno_str));
     }
 
+#ifdef UDP_HAVE_MMSG
+    /* Drop datagrams that were not sent out */
+    for(size_t i = 0; i < conn->sendQueueSize; i++)
+        UA_ByteString_clear(&conn->sendQueue[i]);
+    UA_free(conn->sendQueue);
+#endif
+
     UA_free(conn);
 
     /* Stop if the ucm is stopping and this was the last open socket */
@@ -654,6 +706,104 @@ UDP_delayedClose(void *application, void *context) {
     UA_UNLOCK(&el->elMutex);
 }
 
+/* Forward a received datagram to the application */
+static void
+UDP_forwardMessage(UA_POSIXConnectionManager *pcm, UDP_FD *conn,
+                   const struct sockaddr_storage *source, UA_ByteString msg) {
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)pcm->cm.eventSource.eventLoop;
+
+    /* Extract message source and port */
+    char sourceAddr[64];
+    UA_UInt16 sourcePort;
+    switch(source->ss_family) {
+        case AF_INET:
+            UA_inet_ntop(AF_INET, &((const struct sockaddr_in *)source)->sin_addr,
+                    sourceAddr, 64);
+            sourcePort = htons(((const struct sockaddr_in *)source)->sin_port);
+            break;
+        case AF_INET6:
+            UA_inet_ntop(AF_INET6, &(((const struct sockaddr_in6 *)source)->sin6_addr),
+                    sourceAddr, 64);
+            sourcePort = htons(((const struct sockaddr_in6 *)source)->sin6_port);
+            break;
+        default:
+            sourceAddr[0] = 0;
+            sourcePort = 0;
+    }
+
+    UA_String sourceAddrStr = UA_STRING(sourceAddr);
+    UA_KeyValuePair kvp[2];
+    kvp[0].key = UA_QUALIFIEDNAME(0, "remote-address");
+    UA_Variant_setScalar(&kvp[0].value, &sourceAddrStr, &UA_TYPES[UA_TYPES_STRING]);
+    kvp[1].key = UA_QUALIFIEDNAME(0, "remote-port");
+    UA_Variant_setScalar(&kvp[1].value, &sourcePort, &UA_TYPES[UA_TYPES_UINT16]);
+    UA_KeyValueMap kvm = {2, kvp};
+
+    UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                 "UDP %u\t| Received message of size %u from %s on port %u",
+                 (unsigned)conn->rfd.fd, (unsigned)msg.length,
+                 sourceAddr, sourcePort);
+
+    /* Callback to the application layer */
+    conn->applicationCB(&pcm->cm, (uintptr_t)conn->rfd.fd,
+                        conn->application, &conn->context,
+                        UA_CONNECTIONSTATE_ESTABLISHED,
+                        &kvm, msg);
+}
+
+#ifdef UDP_HAVE_MMSG
+/* Drain up to recv-batchsize datagrams from the socket with a single system
+ * call. The datagrams are then forwarded one by one. */
+static void
+UDP_receiveBatch(UDP_ConnectionManager *ucm, UDP_FD *conn) {
+    UA_POSIXConnectionManager *pcm = &ucm->pcm;
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)pcm->cm.eventSource.eventLoop;
+
+    /* Reset the message headers */
+    for(size_t i = 0; i < ucm->recvBatchSize; i++) {
+        struct msghdr *hdr = &ucm->rxMsgs[i].msg_hdr;
+        hdr->msg_name = &ucm->rxAddrs[i];
+        hdr->msg_namelen = sizeof(struct sockaddr_storage);
+        hdr->msg_iov = &ucm->rxIovs[i];
+        hdr->msg_iovlen = 1;
+        hdr->msg_control = NULL;
+        hdr->msg_controllen = 0;
+        hdr->msg_flags = 0;
+        ucm->rxMsgs[i].msg_len = 0;
+    }
+
+    UA_RESET_ERRNO;
+    int ret = recvmmsg(conn->rfd.fd, ucm->rxMsgs, (unsigned int)ucm->recvBatchSize,
+                       MSG_DONTWAIT, NULL);
+
+    /* Receive has failed */
+    if(ret <= 0) {
+        if(UA_ERRNO == UA_INTERRUPTED || UA_ERRNO == UA_WOULDBLOCK ||
+           UA_ERRNO == UA_AGAIN)
+            return;
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                        "UDP %u\t| recv signaled the socket was shutdown (%s)",
+                        (unsigned)conn->rfd.fd, errno_str));
+        UDP_close(pcm, conn);
+        return;
+    }
+
+    UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                 "UDP %u\t| Received a batch of %i messages",
+                 (unsigned)conn->rfd.fd, ret);
+
+    /* Forward the messages. Stop if the application closes the connection in
+     * the callback. */
+    for(int i = 0; i < ret && !conn->rfd.dc.callback; i++) {
+        UA_ByteString msg;
+        msg.data = (UA_Byte*)ucm->rxIovs[i].iov_base;
+        msg.length = ucm->rxMsgs[i].msg_len;
+        UDP_forwardMessage(pcm, conn, &ucm->rxAddrs[i], msg);
+    }
+}
+#endif
+
 /* Gets called when a socket receives data or closes */
 static void
 UDP_connectionSocketCallback(UA_POSIXConnectionManager *pcm, UDP_FD *conn,
@@ -674,6 +824,14 @@ UDP_connectionSocketCallback(UA_POSIXConnectionManager *pcm, UDP_FD *conn,
         return;
     }
 
+#ifdef UDP_HAVE_MMSG
+    UDP_ConnectionManager *ucm = (UDP_ConnectionManager*)pcm;
+    if(ucm->recvBatchSize > 1) {
+        UDP_receiveBatch(ucm, conn);
+        return;
+    }
+#endif
+
     UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
                  "UDP %u\t| Allocate receive buffer", (unsigned)conn->rfd.fd);
 
@@ -710,44 +868,7 @@ UDP_connectionSocketCallback(UA_POSIXConnectionManager *pcm, UDP_FD *conn,
     }
 
     response.length = (size_t)ret; /* Set the length of the received buffer */
-
-    /* Extract message source and port */
-    char sourceAddr[64];
-    UA_UInt16 sourcePort;
-    switch(source.ss_family) {
-        case AF_INET:
-            UA_inet_ntop(AF_INET, &((struct sockaddr_in *)&source)->sin_addr,
-                    sourceAddr, 64);
-            sourcePort = htons(((struct sockaddr_in *)&source)->sin_port);
-            break;
-        case AF_INET6:
-            UA_inet_ntop(AF_INET6, &(((struct sockaddr_in6 *)&source)->sin6_addr),
-                    sourceAddr, 64);
-            sourcePort = htons(((struct sockaddr_in6 *)&source)->sin6_port);
-            break;
-        default:
-            sourceAddr[0] = 0;
-            sourcePort = 0;
-    }
-
-    UA_String sourceAddrStr = UA_STRING(sourceAddr);
-    UA_KeyValuePair kvp[2];
-    kvp[0].key = UA_QUALIFIEDNAME(0, "remote-address");
-    UA_Variant_setScalar(&kvp[0].value, &sourceAddrStr, &UA_TYPES[UA_TYPES_STRING]);
-    kvp[1].key = UA_QUALIFIEDNAME(0, "remote-port");
-    UA_Variant_setScalar(&kvp[1].value, &sourcePort, &UA_TYPES[UA_TYPES_UINT16]);
-    UA_KeyValueMap kvm = {2, kvp};
-
-    UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
-                 "UDP %u\t| Received message of size %u from %s on port %u",
-                 (unsigned)conn->rfd.fd, (unsigned)ret,
-                 sourceAddr, sourcePort);
-
-    /* Callback to the application layer */
-    conn->applicationCB(&pcm->cm, (uintptr_t)conn->rfd.fd,
-                        conn->application, &conn->context,
-                        UA_CONNECTIONSTATE_ESTABLISHED,
-                        &kvm, response);
+    UDP_forwardMessage(pcm, conn, &source, response);
 }
 
 static UA_StatusCode
@@ -978,6 +1099,109 @@ UDP_registerListenSockets(UA_POSIXConnectionManager *pcm, const char *hostname,
     return rv;
 }
 
+#ifdef UDP_HAVE_MMSG
+/* Send the queued datagrams with as few system calls as possible */
+static UA_StatusCode
+UDP_flushSendQueue(UDP_ConnectionManager *ucm, UDP_FD *conn) {
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)ucm->pcm.cm.eventSource.eventLoop;
+    UA_LOCK_ASSERT(&el->elMutex);
+
+    size_t queued = conn->sendQueueSize;
+    if(queued == 0)
+        return UA_STATUSCODE_GOOD;
+
+    /* Set up the message headers */
+    for(size_t i = 0; i < queued; i++) {
+        ucm->txIovs[i].iov_base = conn->sendQueue[i].data;
+        ucm->txIovs[i].iov_len = conn->sendQueue[i].length;
+        struct msghdr *hdr = &ucm->txMsgs[i].msg_hdr;
+        memset(hdr, 0, sizeof(struct msghdr));
+        hdr->msg_name = &conn->sendAddr;
+        hdr->msg_namelen = conn->sendAddrLength;
+        hdr->msg_iov = &ucm->txIovs[i];
+        hdr->msg_iovlen = 1;
+        ucm->txMsgs[i].msg_len = 0;
+    }
+
+    UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                 "UDP %u\t| Sending a batch of %u messages",
+                 (unsigned)conn->rfd.fd, (unsigned)queued);
+
+    /* Datagrams are sent as a whole. But sendmmsg can return before all
+     * datagrams in the batch are sent. */
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    size_t sent = 0;
+    while(sent < queued) {
+        /* Prevent OS signals when sending to a closed socket */
+        UA_RESET_ERRNO;
+        int n = sendmmsg(conn->rfd.fd, &ucm->txMsgs[sent],
+                         (unsigned int)(queued - sent), MSG_NOSIGNAL);
+        if(n > 0) {
+            sent += (size_t)n;
+            continue;
+        }
+        if(UA_ERRNO == UA_INTERRUPTED)
+            continue;
+
+        /* An error we cannot recover from? */
+        if(UA_ERRNO != UA_WOULDBLOCK && UA_ERRNO != UA_AGAIN) {
+            UA_LOG_SOCKET_ERRNO_WRAP(
+               UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                            "UDP %u\t| Send failed with error %s",
+                            (unsigned)conn->rfd.fd, errno_str));
+            res = UA_STATUSCODE_BADCONNECTIONCLOSED;
+            break;
+        }
+
+        /* Poll for the socket resources to become available and retry
+         * (blocking) */
+        struct pollfd tmp_poll_fd;
+        tmp_poll_fd.fd = conn->rfd.fd;
+        tmp_poll_fd.events = UA_POLLOUT;
+        UA_RESET_ERRNO;
+        int poll_ret = UA_poll(&tmp_poll_fd, 1, 100);
+        if(poll_ret < 0 && UA_ERRNO != UA_INTERRUPTED) {
+            UA_LOG_SOCKET_ERRNO_WRAP(
+               UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                            "UDP %u\t| Send failed with error %s",
+                            (unsigned)conn->rfd.fd, errno_str));
+            res = UA_STATUSCODE_BADCONNECTIONCLOSED;
+            break;
+        }
+    }
+
+    /* Free the buffers. Also the ones not sent after an error. */
+    for(size_t i = 0; i < queued; i++)
+        UA_ByteString_clear(&conn->sendQueue[i]);
+    conn->sendQueueSize = 0;
+    return res;
+}
+
+static void UDP_shutdown(UA_ConnectionManager *cm, UA_RegisteredFD *rfd);
+
+static void *
+UDP_flushCB(void *application, UA_RegisteredFD *rfd) {
+    UDP_ConnectionManager *ucm = (UDP_ConnectionManager*)application;
+    UDP_FD *conn = (UDP_FD*)rfd;
+    if(conn->sendQueueSize > 0 &&
+       UDP_flushSendQueue(ucm, conn) != UA_STATUSCODE_GOOD)
+        UDP_shutdown(&ucm->pcm.cm, rfd);
+    return NULL;
+}
+
+/* Delayed callback to send out the datagrams queued by the callbacks of the
+ * current EventLoop iteration */
+static void
+UDP_delayedFlush(void *application, void *context) {
+    UDP_ConnectionManager *ucm = (UDP_ConnectionManager*)application;
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)ucm->pcm.cm.eventSource.eventLoop;
+    (void)el;
+    UA_LOCK_ASSERT(&el->elMutex); /* Delayed callbacks run with the lock held */
+    ucm->flushCallback.callback = NULL;
+    ZIP_ITER(UA_FDTree, &ucm->pcm.fds, UDP_flushCB, ucm);
+}
+#endif
+
 /* Close the connection via a delayed callback */
 static void
 UDP_shutdown(UA_ConnectionManager *cm, UA_RegisteredFD *rfd) {
@@ -991,6 +1215,11 @@ UDP_shutdown(UA_ConnectionManager *cm, UA_RegisteredFD *rfd) {
         return;
     }
 
+#ifdef UDP_HAVE_MMSG
+    /* Best effort to get the queued datagrams out before the shutdown */
+    UDP_flushSendQueue((UDP_ConnectionManager*)cm, (UDP_FD*)rfd);
+#endif
+
     /* Shutdown the socket to cancel the current select/epoll */
     UA_shutdown(rfd->fd, UA_SHUT_RDWR);
 
@@ -1044,6 +1273,54 @@ UDP_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
         return UA_STATUSCODE_BADINTERNALERROR;
     }
 
+#ifdef UDP_HAVE_MMSG
+    /* Queue the datagram while the EventLoop is processing its callbacks. The
+     * queue is sent with a single system call from a delayed callback once
+     * the timed callbacks (e.g. the publishing of the WriterGroups) of the
+     * current iteration are done, or when the queue is full. The statically
+     * allocated send buffer cannot be queued. */
+    UDP_ConnectionManager *ucm = (UDP_ConnectionManager*)pcm;
+    if(ucm->sendBatchSize > 1 && el->executing && buf->data != pcm->txBuffer.data) {
+        if(!conn->sendQueue) {
+            conn->sendQueue = (UA_ByteString*)
+                UA_calloc(ucm->sendBatchSize, sizeof(UA_ByteString));
+            if(!conn->sendQueue) {
+                UA_UNLOCK(&el->elMutex);
+                UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
+                return UA_STATUSCODE_BADOUTOFMEMORY;
+            }
+        }
+
+        /* Take ownership of the buffer */
+        conn->sendQueue[conn->sendQueueSize++] = *buf;
+        UA_ByteString_init(buf);
+
+        UA_StatusCode res = UA_STATUSCODE_GOOD;
+        if(conn->sendQueueSize == ucm->sendBatchSize) {
+            res = UDP_flushSendQueue(ucm, conn);
+            if(res != UA_STATUSCODE_GOOD)
+                UDP_shutdown(cm, &conn->rfd);
+        } else if(!ucm->flushCallback.callback) {
+            ucm->flushCallback.callback = UDP_delayedFlush;
+            ucm->flushCallback.application = ucm;
+            ucm->flushCallback.context = NULL;
+            UA_EventLoopPOSIX_addDelayedCallback(&el->eventLoop,
+                                                 &ucm->flushCallback);
+        }
+        UA_UNLOCK(&el->elMutex);
+        return res;
+    }
+
+    /* Keep the order of the datagrams */
+    if(conn->sendQueueSize > 0 &&
+       UDP_flushSendQueue(ucm, conn) != UA_STATUSCODE_GOOD) {
+        UDP_shutdown(cm, &conn->rfd);
+        UA_UNLOCK(&el->elMutex);
+        UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
+        return UA_STATUSCODE_BADCONNECTIONCLOSED;
+    }
+#endif
+
     /* Send the full buffer. This may require several calls to send */
     size_t nWritten = 0;
     do {
@@ -1347,6 +1624,80 @@ UDP_openConnection(UA_ConnectionManager *cm, const UA_KeyValueMap *params,
     return res;
 }
 
+#ifdef UDP_HAVE_MMSG
+static void
+UDP_freeBatchBuffers(UDP_ConnectionManager *ucm) {
+    UA_free(ucm->rxPool);
+    UA_free(ucm->rxMsgs);
+    UA_free(ucm->rxIovs);
+    UA_free(ucm->rxAddrs);
+    UA_free(ucm->txMsgs);
+    UA_free(ucm->txIovs);
+    ucm->rxPool = NULL;
+    ucm->rxMsgs = NULL;
+    ucm->rxIovs = NULL;
+    ucm->rxAddrs = NULL;
+    ucm->txMsgs = NULL;
+    ucm->txIovs = NULL;
+    ucm->recvBatchSize = 1;
+    ucm->sendBatchSize = 1;
+}
+
+static size_t
+UDP_getBatchSize(UDP_ConnectionManager *ucm, const char *param, size_t defaultSize) {
+    const UA_UInt16 *batchSize = (const UA_UInt16*)
+        UA_KeyValueMap_getScalar(&ucm->pcm.cm.eventSource.params,
+                                 UA_QUALIFIEDNAME(0, (char*)(uintptr_t)param),
+                                 &UA_TYPES[UA_TYPES_UINT16]);
+    return (batchSize && *batchSize > 0) ? *batchSize : defaultSize;
+}
+
+static UA_StatusCode
+UDP_allocateBatchBuffers(UDP_ConnectionManager *ucm) {
+    UDP_freeBatchBuffers(ucm);
+
+    /* Batched receiving */
+    size_t recvBatchSize =
+        UDP_getBatchSize(ucm, "recv-batchsize", UDP_DEFAULT_RECV_BATCHSIZE);
+    if(recvBatchSize > 1) {
+        size_t entrySize = ucm->pcm.rxBuffer.length;
+        if(entrySize > UDP_MAX_DATAGRAMSIZE)
+            entrySize = UDP_MAX_DATAGRAMSIZE;
+        ucm->rxPool = (UA_Byte*)UA_malloc(recvBatchSize * entrySize);
+        ucm->rxMsgs = (struct mmsghdr*)
+            UA_calloc(recvBatchSize, sizeof(struct mmsghdr));
+        ucm->rxIovs = (struct iovec*)UA_calloc(recvBatchSize, sizeof(struct iovec));
+        ucm->rxAddrs = (struct sockaddr_storage*)
+            UA_calloc(recvBatchSize, sizeof(struct sockaddr_storage));
+        if(!ucm->rxPool || !ucm->rxMsgs || !ucm->rxIovs || !ucm->rxAddrs) {
+            UDP_freeBatchBuffers(ucm);
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        }
+
+        /* The receive buffers stay assigned to their message header */
+        for(size_t i = 0; i < recvBatchSize; i++) {
+            ucm->rxIovs[i].iov_base = &ucm->rxPool[i * entrySize];
+            ucm->rxIovs[i].iov_len = entrySize;
+        }
+        ucm->recvBatchSize = recvBatchSize;
+    }
+
+    /* Batched sending */
+    size_t sendBatchSize = UDP_getBatchSize(ucm, "send-batchsize", 1);
+    if(sendBatchSize > 1) {
+        ucm->txMsgs = (struct mmsghdr*)
+            UA_calloc(sendBatchSize, sizeof(struct mmsghdr));
+        ucm->txIovs = (struct iovec*)UA_calloc(sendBatchSize, sizeof(struct iovec));
+        if(!ucm->txMsgs || !ucm->txIovs) {
+            UDP_freeBatchBuffers(ucm);
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        }
+        ucm->sendBatchSize = sendBatchSize;
+    }
+    return UA_STATUSCODE_GOOD;
+}
+#endif
+
 static UA_StatusCode
 UDP_eventSourceStart(UA_ConnectionManager *cm) {
     UA_POSIXConnectionManager *pcm = (UA_POSIXConnectionManager*)cm;
@@ -1378,6 +1729,13 @@ UDP_eventSourceStart(UA_ConnectionManager *cm) {
     if(res != UA_STATUSCODE_GOOD)
         goto finish;
 
+#ifdef UDP_HAVE_MMSG
+    /* Allocate the buffers for batched receiving and sending */
+    res = UDP_allocateBatchBuffers((UDP_ConnectionManager*)pcm);
+    if(res != UA_STATUSCODE_GOOD)
+        goto finish;
+#endif
+
     /* Set the EventSource to the started state */
     cm->eventSource.state = UA_EVENTSOURCESTATE_STARTED;
 
@@ -1427,6 +1785,9 @@ UDP_eventSourceDelete(UA_ConnectionManager *cm) {
 
     UA_ByteString_clear(&pcm->rxBuffer);
     UA_ByteString_clear(&pcm->txBuffer);
+#ifdef UDP_HAVE_MMSG
+    UDP_freeBatchBuffers((UDP_ConnectionManager*)pcm);
+#endif
     UA_KeyValueMap_clear(&cm->eventSource.params);
     UA_String_clear(&cm->eventSource.name);
     UA_free(cm);
@@ -1439,7 +1800,7 @@ static const char *udpName = "udp";
 UA_ConnectionManager *
 UA_ConnectionManager_new_POSIX_UDP(const UA_String eventSourceName) {
     UA_POSIXConnectionManager *cm = (UA_POSIXConnectionManager*)
-        UA_calloc(1, sizeof(UA_POSIXConnectionManager));
+        UA_calloc(1, sizeof(UDP_ConnectionManager));
     if(!cm)
         return NULL;
 
@@ -29,6 +29,16 @@
 #include <float.h>
 #include <string.h>
 
+// Vector instructions that are part of the baseline instruction set of the
+// architecture. No runtime detection is required.
+#if defined(__SSE2__)
+# include <emmintrin.h>
+# define CJ5_SCAN_SSE2
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+# include <arm_neon.h>
+# define CJ5_SCAN_NEON
+#endif
+
 #if defined(_MSC_VER)
 # define CJ5_INLINE __inline
 #else
@@ -84,6 +94,78 @@ cj5__isrange(char ch, char from, char to) {
 #define cj5__islowerchar(ch) cj5__isrange(ch, 'a', 'z')
 #define cj5__isnum(ch)       cj5__isrange(ch, '0', '9')
 
+static CJ5_INLINE bool
+cj5__isspecial(uint8_t c) {
+    return c < 0x20 || c == 0x7F || c == '"' || c == '\'' || c == '\\';
+}
+
+#if !defined(CJ5_SCAN_SSE2) && !defined(CJ5_SCAN_NEON)
+// Test eight characters at once. The test is exact for the entire word. The
+// position of the match is then found in the scalar loop.
+#define CJ5__ONES 0x0101010101010101ull
+#define CJ5__HIGH 0x8080808080808080ull
+#define cj5__hasless(x, n) (((x) - CJ5__ONES * (n)) & ~(x) & CJ5__HIGH)
+#define cj5__haszero(x) cj5__hasless(x, 1)
+#define cj5__hasbyte(x, b) cj5__haszero((x) ^ (CJ5__ONES * (b)))
+#endif
+
+size_t
+cj5_scan_plain(const char *str, size_t len) {
+    const uint8_t *s = (const uint8_t*)str;
+    size_t i = 0;
+
+    // Skip blocks without special characters. The block with a special
+    // character is then handled in the scalar loop.
+#if defined(CJ5_SCAN_SSE2)
+    const __m128i ctrl = _mm_set1_epi8(0x1F);
+    const __m128i del = _mm_set1_epi8(0x7F);
+    const __m128i dquote = _mm_set1_epi8('"');
+    const __m128i squote = _mm_set1_epi8('\'');
+    const __m128i bslash = _mm_set1_epi8('\\');
+    for(; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(const void*)&s[i]);
+        __m128i m = _mm_cmpeq_epi8(_mm_max_epu8(v, ctrl), ctrl); // v <= 0x1F
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, del));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, dquote));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, squote));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, bslash));
+        if(_mm_movemask_epi8(m) != 0)
+            break;
+    }
+#elif defined(CJ5_SCAN_NEON)
+    const uint8x16_t ctrl = vdupq_n_u8(0x20);
+    const uint8x16_t del = vdupq_n_u8(0x7F);
+    const uint8x16_t dquote = vdupq_n_u8('"');
+    const uint8x16_t squote = vdupq_n_u8('\'');
+    const uint8x16_t bslash = vdupq_n_u8('\\');
+    for(; i + 16 <= len; i += 16) {
+        uint8x16_t v = vld1q_u8(&s[i]);
+        uint8x16_t m = vcltq_u8(v, ctrl);
+        m = vorrq_u8(m, vceqq_u8(v, del));
+        m = vorrq_u8(m, vceqq_u8(v, dquote));
+        m = vorrq_u8(m, vceqq_u8(v, squote));
+        m = vorrq_u8(m, vceqq_u8(v, bslash));
+        if(vmaxvq_u8(m) != 0)
+            break;
+    }
+#else
+    for(; i + 8 <= len; i += 8) {
+        uint64_t x;
+        memcpy(&x, &s[i], 8);
+        if(cj5__hasless(x, 0x20) | cj5__hasbyte(x, 0x7F) |
+           cj5__hasbyte(x, '"') | cj5__hasbyte(x, '\'') |
+           cj5__hasbyte(x, '\\'))
+            break;
+    }
+#endif
+
+    for(; i < len; i++) {
+        if(cj5__isspecial(s[i]))
+            return i;
+    }
+    return len;
+}
+
 static cj5_token *
 cj5__alloc_token(cj5__parser *parser) {
     cj5_token* token = NULL;
@@ -109,6 +191,12 @@ cj5__parse_string(cj5__parser *parser) {
 
     parser->pos++;
     for(; parser->pos < len; parser->pos++) {
+        // Skip over the plain characters
+        parser->pos += (unsigned int)
+            cj5_scan_plain(&json5[parser->pos], len - parser->pos);
+        if(parser->pos >= len)
+            break;
+
         char c = json5[parser->pos];
 
         // End of string
@@ -634,6 +722,14 @@ cj5_get_str(const cj5_result *r, unsigned int tok_index,
     const char *end = &r->json5[token->end + 1];
     unsigned int outpos = 0;
     for(; pos < end; pos++) {
+        // Copy the plain characters in bulk
+        size_t plain = cj5_scan_plain(pos, (size_t)(end - pos));
+        memcpy(buf + outpos, pos, plain);
+        outpos += (unsigned int)plain;
+        pos += plain;
+        if(pos == end)
+            break;
+
         uint8_t c = (uint8_t)*pos;
         // Unprintable ascii characters must be escaped
         if(c < ' ' || c == 127)
@@ -76,6 +76,7 @@
 # define CJ5_API
 #endif
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -149,6 +150,12 @@ CJ5_API cj5_error_code
 cj5_get_str(const cj5_result *r, unsigned int tok_index,
             char *buf, unsigned int *buflen);
 
+// Returns the offset of the first character that needs special handling in a
+// string: control characters, DEL, backslash and both quote characters. Returns
+// len if there is none. The plain runs in between can be copied in bulk.
+CJ5_API size_t
+cj5_scan_plain(const char *str, size_t len);
+
 // Skips the (nested) structure that starts at the current index. The index is
 // updated accordingly. Afterwards it points to the beginning of the following
 // structure.
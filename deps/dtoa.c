@@ -30,6 +30,10 @@
 #include <stdbool.h>
 #include <string.h>
 
+#ifdef __SIZEOF_INT128__
+__extension__ typedef unsigned __int128 dtoa_uint128;
+#endif
+
 #define mantissa_bits 52
 #define exponent_bits 11
 #define fracmask  0x000FFFFFFFFFFFFFU
@@ -172,6 +176,15 @@ static void get_normalized_boundaries(Fp* fp, Fp* lower, Fp* upper) {
 }
 
 static Fp multiply(Fp* a, Fp* b) {
+#ifdef __SIZEOF_INT128__
+    /* Same rounding as the 32-bit decomposition below */
+    dtoa_uint128 p = (dtoa_uint128)a->frac * b->frac;
+    p += (dtoa_uint128)1 << 63;
+    Fp fp;
+    fp.frac = (uint64_t)(p >> 64);
+    fp.exp = a->exp + b->exp + 64;
+    return fp;
+#else
     const uint64_t lomask = 0x00000000FFFFFFFF;
     uint64_t ah_bl = (a->frac >> 32)    * (b->frac & lomask);
     uint64_t al_bh = (a->frac & lomask) * (b->frac >> 32);
@@ -184,6 +197,7 @@ static Fp multiply(Fp* a, Fp* b) {
     fp.frac = ah_bh + (ah_bl >> 32) + (al_bh >> 32) + (tmp >> 32);
     fp.exp = a->exp + b->exp + 64;
     return fp;
+#endif
 }
 
 static void round_digit(char* digits, unsigned ndigits, uint64_t delta,
@@ -203,28 +217,35 @@ static unsigned generate_digits(Fp* fp, Fp* upper, Fp* lower, char* digits, int*
     one.frac = 1ULL << -upper->exp;
     one.exp  = upper->exp;
 
-    uint64_t part1 = upper->frac >> -one.exp;
+    /* The exponent is at least 32. So part1 fits into 32bit and the (faster)
+     * 32bit division can be used. */
+    uint32_t part1 = (uint32_t)(upper->frac >> -one.exp);
     uint64_t part2 = upper->frac & (one.frac - 1);
 
     unsigned idx = 0;
     int kappa = 10;
-    uint64_t* divp;
+    uint64_t* divp = tens + 10;
+
+    /* Skip the leading zeros. The stop condition below cannot be met before
+     * the first digit, as then tmp equals upper->frac > delta. */
+    while(kappa > 0 && *divp > part1) {
+        divp++;
+        kappa--;
+    }
 
     /* 1000000000 */
-    for(divp = tens + 10; kappa > 0; divp++) {
-        uint64_t div = *divp;
-        uint64_t digit = part1 / div;
-        if(digit || idx) {
-            digits[idx++] = (char)(digit + '0');
-        }
+    for(; kappa > 0; divp++) {
+        uint32_t div = (uint32_t)*divp;
+        uint32_t digit = part1 / div;
+        digits[idx++] = (char)(digit + '0');
 
         part1 -= digit * div;
         kappa--;
 
-        uint64_t tmp = (part1 <<-one.exp) + part2;
+        uint64_t tmp = ((uint64_t)part1 << -one.exp) + part2;
         if(tmp <= delta) {
             *K += kappa;
-            round_digit(digits, idx, delta, tmp, div << -one.exp, wfrac);
+            round_digit(digits, idx, delta, tmp, (uint64_t)div << -one.exp, wfrac);
             return idx;
         }
     }
@@ -26,7 +26,16 @@ typedef struct UA_AccessControl UA_AccessControl;
  *
  * The ``sessionId`` and ``sessionContext`` can be both NULL. This is the case
  * when, for example, a MonitoredItem (the underlying Subscription) is detached
- * from its Session but continues to run. */
+ * from its Session but continues to run.
+ *
+ * If the Nodestore supports concurrent readers (see ``concurrentRead`` in the
+ * Nodestore plugin API), the Read, Browse and TranslateBrowsePathsToNodeIds
+ * services of clients connected via the network EventLoops are processed
+ * without the server lock. Then getUserRightsMask, getUserAccessLevel,
+ * getUserExecutable and allowBrowseNode can be called from several threads in
+ * parallel, also concurrently with the other callbacks for the same
+ * ``sessionContext``. The services of clients on the main EventLoop are always
+ * processed with the server lock. */
 
 struct UA_AccessControl {
     void *context;
@@ -43,7 +52,14 @@ struct UA_AccessControl {
      *
      * Note that this callback can be called several times for a Session. For
      * example when a Session is recovered (activated) on a new
-     * SecureChannel. */
+     * SecureChannel.
+     *
+     * If the Nodestore supports concurrent readers, services for the Session
+     * can still run in other threads with the previous ``sessionContext``
+     * while it is replaced here. Then the previous context must not be freed
+     * within this callback. For example, keep it reachable from the new
+     * context and free it in closeSession. closeSession is only called once
+     * no service for the Session is running. */
     UA_StatusCode (*activateSession)(UA_Server *server, UA_AccessControl *ac,
                                      const UA_EndpointDescription *endpointDescription,
                                      const UA_ByteString *secureChannelRemoteCertificate,
@@ -403,6 +403,19 @@ struct UA_ConnectionManager {
     void
     (*freeNetworkBuffer)(UA_ConnectionManager *cm, uintptr_t connectionId,
                          UA_ByteString *buf);
+
+    /* Gathered Sending
+     * ~~~~~~~~~~~~~~~~
+     * Send a message that is gathered from several buffers (vectored I/O).
+     * This method is optional and can be NULL. The message is the
+     * concatenation of the buffers. In contrast to sendWithConnection, the
+     * buffers remain with the caller and need to be valid only during the
+     * call. What cannot be sent right away is copied internally. This allows
+     * to send large payloads without copying them into a network buffer. */
+    UA_StatusCode
+    (*sendWithConnectionVector)(UA_ConnectionManager *cm, uintptr_t connectionId,
+                                const UA_KeyValueMap *params,
+                                const UA_ByteString *bufs, size_t bufsSize);
 };
 
 /**
@@ -472,11 +485,107 @@ struct UA_InterruptManager {
  *   well. But expect accordingly longer sleep-times for timed events when the
  *   clock is set to the past. See the man-page of "clock_gettime" on how to get
  *   a clock source id for a character-device such as /dev/ptp0. (default:
- *   CLOCK_MONOTONIC_RAW) */
+ *   CLOCK_MONOTONIC_RAW)
+ *
+ * **io_uring configuration (Linux only, built with UA_ENABLE_IO_URING)**
+ *
+ * 0:io-uring [boolean]
+ *   Use an io_uring instead of epoll to wait for the sockets. The TCP
+ *   ConnectionManager then receives with multishot requests into a shared
+ *   buffer ring and sends without a system call per message. The requests are
+ *   bound to the submitting thread. So the EventLoop should always be run from
+ *   the same thread. Falls back to epoll if the kernel has no io_uring support.
+ *   Starting the EventLoop fails if the io_uring backend was not built in
+ *   (default: false). */
 
 UA_EXPORT UA_EventLoop *
 UA_EventLoop_new_POSIX(const UA_Logger *logger);
 
+#ifdef UA_ENABLE_EVENTLOOP_STATISTICS
+
+/**
+ * EventLoop Statistics
+ * ~~~~~~~~~~~~~~~~~~~~
+ * With the build option UA_ENABLE_EVENTLOOP_STATISTICS, the POSIX EventLoop
+ * measures the execution time of every timed, delayed and fd callback with the
+ * monotonic clock of the EventLoop. All times are in 100ns (UA_DateTime)
+ * resolution.
+ *
+ * The histograms have logarithmic buckets with four linear sub-buckets per
+ * power of two (similar to a HDR histogram). So the value of a bucket is known
+ * within 25%. Values from 2^33 (~14 minutes) upwards are all counted in the
+ * last bucket. */
+
+#define UA_EVENTLOOPHISTOGRAM_BUCKETS 128
+
+typedef struct {
+    UA_UInt64 count;
+    UA_DateTime total;
+    UA_DateTime max;
+    UA_UInt64 buckets[UA_EVENTLOOPHISTOGRAM_BUCKETS];
+} UA_EventLoopHistogram;
+
+/* Upper bound of the bucket with the given percentile (0.0 to 100.0) of the
+ * recorded values. Capped by the maximum value. */
+UA_EXPORT UA_DateTime
+UA_EventLoopHistogram_percentile(const UA_EventLoopHistogram *h,
+                                 UA_Double percentile);
+
+typedef struct {
+    UA_EventLoopHistogram timerCallbacks;   /* Execution time */
+    UA_EventLoopHistogram timerLag;         /* Execution after the due time */
+    UA_EventLoopHistogram delayedCallbacks; /* Execution time */
+    UA_EventLoopHistogram fdCallbacks;      /* Execution time of the callbacks
+                                             * for the events of sockets */
+    UA_EventLoopHistogram iterations;       /* Processing time per iteration of
+                                             * the EventLoop (without waiting) */
+    size_t delayedQueueLength;              /* In the last iteration */
+    size_t delayedQueueLengthMax;
+} UA_EventLoopStatistics;
+
+/* Execution times of an individual timed callback or connection */
+typedef struct {
+    UA_UInt64 count;
+    UA_DateTime total;
+    UA_DateTime max;
+} UA_EventLoopCallbackStatistics;
+
+/* Copy the statistics collected since the start or the last reset */
+UA_EXPORT void
+UA_EventLoopPOSIX_getStatistics(UA_EventLoop *el, UA_EventLoopStatistics *stats);
+
+/* Reset the statistics. Including those of the timers and connections. */
+UA_EXPORT void
+UA_EventLoopPOSIX_resetStatistics(UA_EventLoop *el);
+
+/* Iterate over the statistics of the timed callbacks. The iteration callback
+ * must not add, modify or remove timed callbacks. */
+typedef void
+(*UA_EventLoopPOSIX_TimerStatisticsCallback)(void *context, UA_UInt64 callbackId,
+                                             UA_Callback callback,
+                                             void *application, void *data,
+                                             const UA_EventLoopCallbackStatistics *stats);
+
+UA_EXPORT void
+UA_EventLoopPOSIX_iterateTimerStatistics(UA_EventLoop *el,
+                                         UA_EventLoopPOSIX_TimerStatisticsCallback cb,
+                                         void *context);
+
+/* Iterate over the statistics of the open connections (and listen sockets) of
+ * the ConnectionManagers */
+typedef void
+(*UA_EventLoopPOSIX_ConnectionStatisticsCallback)(void *context,
+                                                  UA_ConnectionManager *cm,
+                                                  uintptr_t connectionId,
+                                                  const UA_EventLoopCallbackStatistics *stats);
+
+UA_EXPORT void
+UA_EventLoopPOSIX_iterateConnectionStatistics(UA_EventLoop *el,
+                                              UA_EventLoopPOSIX_ConnectionStatisticsCallback cb,
+                                              void *context);
+
+#endif /* UA_ENABLE_EVENTLOOP_STATISTICS */
+
 /**
  * TCP Connection Manager
  * ~~~~~~~~~~~~~~~~~~~~~~
@@ -509,6 +618,23 @@ UA_EventLoop_new_POSIX(const UA_Logger *logger);
  *    becomes an upper bound for the message size. If undefined a fresh buffer
  *    is allocated for every `allocNetworkBuffer` (default: no buffer).
  *
+ * 0:send-queue-limit [uint32]
+ *    Sending does not block. Data that cannot be written to the socket right
+ *    away is queued for the connection and sent once the socket becomes
+ *    writable. This sets a high-water mark (in bytes) for the queue. While the
+ *    queue is above the limit, no more data is received from the connection.
+ *    This throttles remote sides that send requests faster than they consume
+ *    the responses (default: 0 -> unbounded).
+ *
+ * 0:send-queue-close [boolean]
+ *    Close the connection when the send queue exceeds the send-queue-limit
+ *    instead of pausing the reception (default: false).
+ *
+ * 0:recv-bufcount [uint16]
+ *    Number of recv-bufsize buffers in the buffer ring that is shared by all
+ *    connections when the EventLoop uses the io_uring. Rounded up to a power
+ *    of two (default: 32).
+ *
  * **Open Connection Parameters:**
  *
  * 0:address [string | array of string]
@@ -565,6 +691,20 @@ UA_ConnectionManager_new_POSIX_TCP(const UA_String eventSourceName);
  *    becomes an upper bound for the message size. If undefined a fresh buffer
  *    is allocated for every `allocNetworkBuffer` (default: no buffer).
  *
+ * 0:recv-batchsize [uint16]
+ *    Maximum number of datagrams drained from a socket with a single system
+ *    call (recvmmsg, Linux only). The datagrams are still forwarded to the
+ *    application one by one. Each entry of the batch has its own receive
+ *    buffer of recv-bufsize, capped at 64kB (default: 8, 1 disables batching).
+ *
+ * 0:send-batchsize [uint16]
+ *    Maximum number of datagrams sent with a single system call (sendmmsg,
+ *    Linux only). Datagrams sent from within the EventLoop (e.g. by the
+ *    WriterGroups) are queued and sent together once the timed callbacks of
+ *    the current iteration have finished. Send errors of queued datagrams then
+ *    close the connection instead of being returned by `sendWithConnection`
+ *    (default: 1, no batching).
+ *
  * **Open Connection Parameters:**
  *
  * 0:listen [boolean]
@@ -679,6 +819,18 @@ UA_ConnectionManager_new_POSIX_UDP(const UA_String eventSourceName);
  *    creating any connection but solely validating the provided parameters
  *    (default: false)
  *
+ * 0:packet-ring [bool]
+ *    Use a memory-mapped TPACKET_V3 ring shared with the kernel (Linux only,
+ *    default: false). Listen connections process the received frames directly
+ *    from the ring without a copy or a system call per frame. Send connections
+ *    write the frames into the ring and notify the kernel once per EventLoop
+ *    iteration. Frames with a txtime bypass the ring. If the ring cannot be
+ *    mapped, the connection falls back to regular socket operations.
+ *
+ * 0:packet-ring-blocks [uint32]
+ *    Number of 64kB blocks of the ring (default: 16). A block of the tx ring
+ *    holds 32 frames.
+ *
  * Sending with a txtime (for Time-Sensitive Networking) is possible on recent
  * Linux kernels, If enabled for the socket, then a txtime parameters can be
  * passed to `sendWithConnection`. Note that the clock source for txtime sending
@@ -547,6 +547,17 @@ struct UA_Nodestore {
     /* Execute a callback for every node in the nodestore. */
     void (*iterate)(UA_Nodestore *ns, UA_NodestoreVisitor visitor,
                     void *visitorCtx);
+
+    /* Set to true if _getNode, _getNodeFromPtr, _releaseNode (for nodes from
+     * _getNode), _getNodeCopy, _getReferenceTypeId and _iterate can be called
+     * from several threads at the same time and concurrently with the
+     * modifying methods. Then the server does not take its lock for the Read,
+     * Browse and TranslateBrowsePathsToNodeIds operations of the local API.
+     * The same services requested by clients connected via the network
+     * EventLoops are also processed without the server lock. Nodestore
+     * implementations that don't support this must leave the field
+     * zero-initialized. */
+    UA_Boolean concurrentRead;
 };
 
 /* Attributes must be of a matching type (VariableAttributes, ObjectAttributes,
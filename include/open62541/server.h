@@ -2104,6 +2104,29 @@ struct UA_ServerConfig {
                               * (default: 0 -> unbounded) */
     UA_Boolean tcpReuseAddr;
 
+#if UA_MULTITHREADING >= 100
+    /* Additional EventLoops that each open a listen socket on the same port
+     * (with SO_REUSEPORT) and own the SecureChannels accepted there. The
+     * operating system distributes incoming connections among the listen
+     * sockets. Every network EventLoop needs a registered "tcp"
+     * ConnectionManager and is run by the application in a thread of its own.
+     * The network EventLoops must keep running until the server has shut
+     * down. They are started by the server if required, but neither stopped
+     * nor deleted with the config.
+     *
+     * The chunk reassembly, decryption and signature verification, the
+     * decoding of requests and the encoding, signing and encryption of
+     * responses run in the thread of the network EventLoop without taking the
+     * server lock. Sending on a SecureChannel is serialized with a lock of the
+     * SecureChannel. The services are executed with the server lock. Except
+     * for Read, Browse and TranslateBrowsePathsToNodeIds if the Nodestore
+     * supports concurrent readers. So requests of different Sessions are
+     * processed in parallel. This requires SecurityPolicies that can be used
+     * from several threads in parallel. */
+    UA_EventLoop **networkEventLoops;
+    size_t networkEventLoopsSize;
+#endif
+
     /* Security and Encryption
      * ~~~~~~~~~~~~~~~~~~~~~~~ */
     size_t securityPoliciesSize;
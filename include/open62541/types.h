@@ -391,7 +391,8 @@ UA_ByteString_fromBase64(UA_ByteString *bs,
 #define UA_BYTESTRING(chars) UA_STRING(chars)
 #define UA_BYTESTRING_ALLOC(chars) UA_STRING_ALLOC(chars)
 
-/* Returns a non-cryptographic hash of a bytestring */
+/* Returns a non-cryptographic hash of a bytestring. The hash values are the
+ * same on all platforms. */
 UA_UInt32 UA_EXPORT
 UA_ByteString_hash(UA_UInt32 initialHashValue,
                    const UA_Byte *data, size_t size);
@@ -512,7 +513,8 @@ UA_EXPORT UA_NodeId UA_NODEID(const char *chars);
 UA_Order UA_EXPORT
 UA_NodeId_order(const UA_NodeId *n1, const UA_NodeId *n2);
 
-/* Returns a non-cryptographic hash for NodeId */
+/* Returns a non-cryptographic hash for NodeId. The hash values are the same
+ * on all platforms. */
 UA_UInt32 UA_EXPORT UA_NodeId_hash(const UA_NodeId *n);
 
 /**
@@ -754,10 +756,14 @@ typedef struct UA_DataType UA_DataType;
 #define UA_EMPTY_ARRAY_SENTINEL ((void*)0x01)
 
 typedef enum {
-    UA_VARIANT_DATA,         /* The data has the same lifecycle as the variant */
-    UA_VARIANT_DATA_NODELETE /* The data is "borrowed" by the variant and is
-                              * not deleted when the variant is cleared up.
-                              * The array dimensions also borrowed. */
+    UA_VARIANT_DATA,          /* The data has the same lifecycle as the variant */
+    UA_VARIANT_DATA_NODELETE, /* The data is "borrowed" by the variant and is
+                               * not deleted when the variant is cleared up.
+                               * The array dimensions also borrowed. */
+    UA_VARIANT_DATA_SHARED    /* The data is reference-counted and shared with
+                               * other variants. Copying takes a reference.
+                               * The data is deleted with the last reference.
+                               * The array dimensions are not shared. */
 } UA_VariantStorageType;
 
 typedef struct {
@@ -829,6 +835,29 @@ UA_StatusCode UA_EXPORT
 UA_Variant_setRangeCopy(UA_Variant *v, const void *array,
                         size_t arraySize, const UA_NumericRange range);
 
+/* Shared data (UA_VARIANT_DATA_SHARED) is immutable while it is referenced by
+ * more than one variant. UA_copy of such a variant only increases the
+ * reference count. UA_Variant_setRange(Copy) creates a private copy first if
+ * the data is shared (copy-on-write). Neither the data pointer nor the content
+ * of shared data may be changed otherwise. Use UA_Variant_unshare before
+ * modifying the data or taking ownership of the data pointer.
+ *
+ * Create a variant with shared data from a deep-copy of the source. If the
+ * source is shared already, a reference is taken instead. */
+UA_StatusCode UA_EXPORT
+UA_Variant_copyShared(const UA_Variant *src, UA_Variant *dst);
+
+/* Convert the variant to shared data. The data is moved (not copied) if it has
+ * the UA_VARIANT_DATA storage type. Borrowed data is copied. Empty variants are
+ * not changed. */
+UA_StatusCode UA_EXPORT
+UA_Variant_share(UA_Variant *v);
+
+/* Convert shared data to UA_VARIANT_DATA with a private copy. The data is
+ * moved if no other variant references it. */
+UA_StatusCode UA_EXPORT
+UA_Variant_unshare(UA_Variant *v);
+
 /**
  * .. _extensionobject:
  *
@@ -1262,6 +1291,20 @@ typedef struct {
     void *callocContext;
     void * (*calloc)(void *callocContext, size_t nelem, size_t elsize);
 
+    /* Strings, ByteStrings and the content of overlayable arrays (if aligned)
+     * point into the input buffer instead of being copied. The input buffer
+     * must outlive the decoded value. This is only applied together with the
+     * calloc override, as the decoded value must not be freed member-wise. */
+    UA_Boolean borrowBuffer;
+
+    /* ExtensionObjects are not decoded and keep their encoded body, also for
+     * known data types. ExtensionObjects in Variants are not unwrapped. The
+     * encoded body is written back as-is when the value is encoded again.
+     * Decode the body on demand with UA_ExtensionObject_decodeBinaryBody and
+     * UA_Variant_decodeBinaryExtensionObjects. This is opt-in for applications
+     * that decode messages themselves. The client and server do not set it. */
+    UA_Boolean lazyExtensionObjects;
+
     size_t decodedLength; /* After each successful decoding, this contains the
                            * number of decoded bytes. */
 } UA_DecodeBinaryOptions;
@@ -1274,6 +1317,21 @@ UA_decodeBinary(const UA_ByteString *inBuf,
                 void *p, const UA_DataType *type,
                 UA_DecodeBinaryOptions *options);
 
+/* Decodes the body of an ExtensionObject that was kept encoded (see the
+ * lazyExtensionObjects decoding option). The ExtensionObject stays encoded if
+ * the data type is unknown. Use the same options as for the decoding of the
+ * ExtensionObject. The memory of the encoded body is released accordingly. */
+UA_EXPORT UA_StatusCode
+UA_ExtensionObject_decodeBinaryBody(UA_ExtensionObject *eo,
+                                    UA_DecodeBinaryOptions *options);
+
+/* Decodes the bodies of the ExtensionObjects in the Variant. If all of them are
+ * decoded with the same data type, the content is unwrapped (as in the eager
+ * decoding of Variants). */
+UA_EXPORT UA_StatusCode
+UA_Variant_decodeBinaryExtensionObjects(UA_Variant *v,
+                                        UA_DecodeBinaryOptions *options);
+
 /**
  * JSON En/Decoding
  * ----------------
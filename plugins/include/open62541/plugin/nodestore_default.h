@@ -19,6 +19,75 @@ _UA_BEGIN_DECLS
  */
 UA_EXPORT UA_Nodestore * UA_Nodestore_ZipTree(void);
 
+/* The HashMap Nodestore holds all nodes in RAM in a hash-map with open
+ * addressing. The lookup time is O(1) on average. The nodes are allocated from
+ * slabs with one slab list per NodeClass. When the hash-map grows, the nodes
+ * are moved to the larger hash-map step-by-step during the following
+ * insertions and removals. So no single insertion has the linear overhead of
+ * the resizing. The memory of the slabs is released only when the Nodestore is
+ * freed.
+ *
+ * To use the HashMap Nodestore, set it in the server configuration before the
+ * default configuration is applied. */
+UA_EXPORT UA_Nodestore * UA_Nodestore_HashMap(void);
+
+/* The Concurrent Nodestore allows readers to access the nodes without taking a
+ * lock. Nodes are never modified in place. Instead, an edited copy of the node
+ * is published atomically in a hash-map (see _getEditNode and _replaceNode).
+ * The replaced versions are freed when no reader can access them anymore
+ * (epoch-based reclamation). Writers are serialized by an internal lock.
+ *
+ * The Nodestore sets the concurrentRead flag. With multithreading enabled, the
+ * server then reads, browses and translates BrowsePaths from the local API
+ * (e.g. UA_Server_read and UA_Server_browse) and for clients connected via the
+ * network EventLoops without the server lock. So several threads can read
+ * from the information model in parallel. Every
+ * modification of a node copies the node. So the Concurrent Nodestore is best
+ * suited for information models that are read much more often than they are
+ * changed. */
+UA_EXPORT UA_Nodestore * UA_Nodestore_Concurrent(void);
+
+/* The Image Nodestore serves the nodes from a pre-built, position-independent
+ * binary image. The image contains a hash index of the nodes. So opening it
+ * takes constant time, independent of the number of nodes. A node is decoded
+ * from the image when it is first accessed and then kept in a writable overlay
+ * (a HashMap Nodestore). Nodes can be added, modified and removed at runtime.
+ * The image itself is never modified.
+ *
+ * The image is created from the nodes of a running server with
+ * UA_Nodestore_Image_write (see the "image" backend of the nodeset compiler).
+ * Callbacks (DataSources, method callbacks, lifecycles) and node contexts are
+ * not stored in the image. Values of VariableNodes with an external value
+ * source are stored as a snapshot.
+ *
+ * To start a server from an image with the complete namespace zero, build with
+ * UA_NAMESPACE_ZERO=NONE and set the Nodestore in the server configuration
+ * before the default configuration is applied.
+ *
+ * The image is not copied and must outlive the Nodestore. The custom data types
+ * are used to decode the values in the image. */
+UA_EXPORT UA_Nodestore *
+UA_Nodestore_Image(const UA_ByteString *image,
+                   const UA_DataTypeArray *customTypes);
+
+#ifdef UA_ARCHITECTURE_POSIX
+/* Maps the image file read-only into memory. The pages of the image are shared
+ * between all processes using the same file. */
+UA_EXPORT UA_Nodestore *
+UA_Nodestore_ImageFile(const char *path,
+                       const UA_DataTypeArray *customTypes);
+#endif
+
+/* Writes the nodes of the server's Nodestore together with the namespace array
+ * into an image. The image is allocated and must be freed by the caller. */
+UA_EXPORT UA_StatusCode
+UA_Nodestore_Image_write(UA_Server *server, UA_ByteString *image);
+
+/* Adds the namespaces of the image (index two and above) to the server. Fails
+ * if the server already defines namespaces with different indices. */
+UA_EXPORT UA_StatusCode
+UA_Nodestore_Image_addNamespaces(UA_Nodestore *ns, UA_Server *server);
+
 _UA_END_DECLS
 
 #endif /* UA_NODESTORE_DEFAULT_H_ */
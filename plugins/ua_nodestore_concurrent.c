@@ -0,0 +1,812 @@
+/* This work is licensed under a Creative Commons CCZero 1.0 Universal License.
+ * See http://creativecommons.org/publicdomain/zero/1.0/ for more information.
+ *
+ *    Copyright 2014-2018 (c) Fraunhofer IOSB (Author: Julius Pfrommer)
+ *    Copyright 2017 (c) Julian Grothoff
+ *    Copyright 2017 (c) Stefan Profanter, fortiss GmbH
+ */
+
+#include <open62541/server.h>
+#include <open62541/plugin/nodestore.h>
+#include <open62541/plugin/nodestore_default.h>
+#include "pcg_basic.h"
+
+#ifndef container_of
+#define container_of(ptr, type, member) \
+    (type *)((uintptr_t)ptr - offsetof(type,member))
+#endif
+
+/* Readers access the nodes without taking a lock. A node is never modified
+ * after it has been inserted. Instead, a writer publishes a new version of the
+ * node by atomically exchanging the pointer in the hash-map. Writers are
+ * serialized by the writeLock.
+ *
+ * Versions that are no longer reachable from the hash-map are "retired" and
+ * freed only when no reader can hold a pointer to them anymore. The
+ * reclamation is epoch-based. The Nodestore has a global epoch (0, 1 or 2).
+ * Every thread has a record where it announces the epoch it observed when
+ * entering the critical section (the outermost _getNode). The global epoch is
+ * advanced only when all threads inside a critical section have observed the
+ * current epoch. An entry retired in epoch e is freed when the global epoch
+ * advances from e+1 to e+2. Then all threads that could have seen the entry
+ * have left their critical section.
+ *
+ * Copying a node for every edit is expensive for nodes with many references.
+ * As long as only a single thread has accessed the Nodestore (e.g. while the
+ * information model is built up), the nodes are edited in place. The thread
+ * then holds the writeLock from the first edit until it releases its last
+ * node. A second thread needs the writeLock to add its EpochRecord. After
+ * that, all edits are made on copies. */
+
+#define CNODEMAP_MINSIZE 64
+#define CNODEMAP_TOMBSTONE ((CNodeEntry*)(uintptr_t)0x01)
+#define EPOCH_COUNT 3
+
+struct CNodeEntry;
+typedef struct CNodeEntry CNodeEntry;
+
+struct CNodeEntry {
+    CNodeEntry *orig;   /* If a copy is made to replace a node, track that we
+                         * replace only the node from which the copy was made */
+    CNodeEntry *edit;   /* Pending copy returned from _getEditNode */
+    CNodeEntry *retiredNext;
+    CNodeEntry *dirtyNext; /* Edited in place */
+    UA_UInt32 nodeIdHash;
+    UA_UInt16 editCount; /* Nested _getEditNode calls for the pending copy.
+                          * Always zero for published entries. */
+    UA_Boolean dirty;
+    UA_NodeId nodeId; /* This is actually a UA_Node that also starts with a NodeId */
+};
+
+/* Hash-map with open addressing and linear probing. Removed entries leave a
+ * tombstone so that the probing of concurrent readers is not interrupted.
+ * When the table gets too full, a new table is built and published. */
+typedef struct CNodeTable {
+    struct CNodeTable *retiredNext;
+    size_t size; /* Power of two */
+    CNodeEntry **slots; /* Modified atomically */
+} CNodeTable;
+
+typedef struct EpochRecord {
+    void *epoch; /* Observed epoch + 1. Zero outside of the critical section.
+                  * Modified atomically. */
+    size_t depth; /* Nesting of the critical section (only for the owner) */
+    const void *owner; /* Address of a thread-local variable of the owner */
+    struct EpochRecord *next;
+    UA_Byte padding[64]; /* Don't share cache-lines between the threads */
+} EpochRecord;
+
+typedef struct {
+    UA_Nodestore ns;
+
+    void *table; /* The current CNodeTable (modified atomically) */
+    size_t used; /* Slots with an entry or a tombstone */
+    size_t count;
+
+    /* Epoch-based reclamation */
+    void *epoch; /* Modified atomically */
+    void *records; /* List of EpochRecords (modified atomically) */
+    uintptr_t id; /* Unique id to detect outdated thread-local records */
+    CNodeEntry *retiredEntries[EPOCH_COUNT];
+    CNodeTable *retiredTables[EPOCH_COUNT];
+
+    /* Edit in place while a single thread uses the Nodestore */
+    void *singleThread; /* Modified atomically */
+    UA_Boolean inPlaceLocked; /* The writeLock is held for in-place edits */
+    CNodeEntry *dirty;
+
+#if UA_MULTITHREADING >= 100
+    UA_Lock writeLock;
+#endif
+
+    /* Maps ReferenceTypeIndex to the NodeId of the ReferenceType */
+    UA_NodeId referenceTypeIds[UA_REFERENCETYPESET_MAX];
+    void *referenceTypeCounter; /* Modified atomically */
+} ConcurrentNodestore;
+
+/* The last record used by the thread. Its address also identifies the
+ * thread. */
+static UA_THREAD_LOCAL EpochRecord *cachedRecord;
+static UA_THREAD_LOCAL uintptr_t cachedRecordId;
+static void *nodestoreIdCounter;
+
+/***********/
+/* Entries */
+/***********/
+
+static CNodeEntry *
+cNewEntry(UA_NodeClass nodeClass) {
+    size_t size = sizeof(CNodeEntry) - sizeof(UA_NodeId);
+    switch(nodeClass) {
+    case UA_NODECLASS_OBJECT:
+        size += sizeof(UA_ObjectNode);
+        break;
+    case UA_NODECLASS_VARIABLE:
+        size += sizeof(UA_VariableNode);
+        break;
+    case UA_NODECLASS_METHOD:
+        size += sizeof(UA_MethodNode);
+        break;
+    case UA_NODECLASS_OBJECTTYPE:
+        size += sizeof(UA_ObjectTypeNode);
+        break;
+    case UA_NODECLASS_VARIABLETYPE:
+        size += sizeof(UA_VariableTypeNode);
+        break;
+    case UA_NODECLASS_REFERENCETYPE:
+        size += sizeof(UA_ReferenceTypeNode);
+        break;
+    case UA_NODECLASS_DATATYPE:
+        size += sizeof(UA_DataTypeNode);
+        break;
+    case UA_NODECLASS_VIEW:
+        size += sizeof(UA_ViewNode);
+        break;
+    default:
+        return NULL;
+    }
+    CNodeEntry *entry = (CNodeEntry*)UA_calloc(1, size);
+    if(!entry)
+        return NULL;
+    UA_Node *node = (UA_Node*)&entry->nodeId;
+    node->head.nodeClass = nodeClass;
+    return entry;
+}
+
+static void
+cDeleteEntry(CNodeEntry *entry) {
+    UA_Node_clear((UA_Node*)&entry->nodeId);
+    UA_free(entry);
+}
+
+static CNodeEntry *
+cCopyEntry(const CNodeEntry *entry) {
+    const UA_Node *node = (const UA_Node*)&entry->nodeId;
+    CNodeEntry *ne = cNewEntry(node->head.nodeClass);
+    if(!ne)
+        return NULL;
+    if(UA_Node_copy(node, (UA_Node*)&ne->nodeId) != UA_STATUSCODE_GOOD) {
+        cDeleteEntry(ne);
+        return NULL;
+    }
+    ne->nodeIdHash = entry->nodeIdHash;
+    return ne;
+}
+
+static void
+cOptimizeReferences(CNodeEntry *entry) {
+    UA_NodeHead *head = (UA_NodeHead*)&entry->nodeId;
+    for(size_t i = 0; i < head->referencesSize; i++) {
+        UA_NodeReferenceKind *rk = &head->references[i];
+        if(rk->targetsSize > 16 && !rk->hasRefTree)
+            UA_NodeReferenceKind_switch(rk);
+    }
+}
+
+/* Published entries are immutable. So the references are switched to the tree
+ * representation before the entry is published. */
+static void
+cPrepareEntry(CNodeEntry *entry) {
+    entry->orig = NULL;
+    entry->edit = NULL;
+    entry->editCount = 0;
+    cOptimizeReferences(entry);
+}
+
+/**********************/
+/* Epoch Reclamation */
+/**********************/
+
+static EpochRecord *
+getRecord(ConcurrentNodestore *cns) {
+    if(cachedRecord && cachedRecordId == cns->id)
+        return cachedRecord;
+
+    /* Look up the record of the thread */
+    const void *owner = &cachedRecord;
+    EpochRecord *rec = (EpochRecord*)UA_atomic_load(&cns->records);
+    for(; rec; rec = rec->next) {
+        if(rec->owner == owner)
+            break;
+    }
+
+    /* Add a new record. The records are freed only with the Nodestore. Wait
+     * for the in-place edits of another thread to finish. From then on, the
+     * nodes are edited on copies. */
+    if(!rec) {
+        UA_LOCK(&cns->writeLock);
+        rec = (EpochRecord*)UA_calloc(1, sizeof(EpochRecord));
+        if(!rec) {
+            UA_UNLOCK(&cns->writeLock);
+            return NULL;
+        }
+        rec->owner = owner;
+        rec->next = (EpochRecord*)cns->records;
+        UA_atomic_xchg(&cns->records, rec);
+        if(rec->next)
+            UA_atomic_xchg(&cns->singleThread, NULL);
+        UA_UNLOCK(&cns->writeLock);
+    }
+
+    cachedRecord = rec;
+    cachedRecordId = cns->id;
+    return rec;
+}
+
+/* Returns false if no record could be allocated */
+static UA_Boolean
+enterEpoch(ConcurrentNodestore *cns) {
+    EpochRecord *rec = getRecord(cns);
+    if(!rec)
+        return false;
+    if(rec->depth++ > 0)
+        return true;
+    /* The exchange is a full barrier. So the record is visible to the writers
+     * before the table is accessed. */
+    uintptr_t e = (uintptr_t)UA_atomic_load(&cns->epoch);
+    UA_atomic_xchg(&rec->epoch, (void*)(e + 1));
+    return true;
+}
+
+static void
+leaveEpoch(ConcurrentNodestore *cns) {
+    EpochRecord *rec = getRecord(cns);
+    UA_assert(rec && rec->depth > 0);
+    if(--rec->depth > 0)
+        return;
+
+    /* The thread released its last node. Finish the in-place edits. */
+    if(cns->inPlaceLocked) {
+        while(cns->dirty) {
+            CNodeEntry *entry = cns->dirty;
+            cns->dirty = entry->dirtyNext;
+            entry->dirty = false;
+            cOptimizeReferences(entry);
+        }
+        cns->inPlaceLocked = false;
+        UA_UNLOCK(&cns->writeLock);
+    }
+
+    UA_atomic_xchg(&rec->epoch, NULL);
+}
+
+static void
+freeRetired(ConcurrentNodestore *cns, uintptr_t e) {
+    while(cns->retiredEntries[e]) {
+        CNodeEntry *entry = cns->retiredEntries[e];
+        cns->retiredEntries[e] = entry->retiredNext;
+        cDeleteEntry(entry);
+    }
+    while(cns->retiredTables[e]) {
+        CNodeTable *t = cns->retiredTables[e];
+        cns->retiredTables[e] = t->retiredNext;
+        UA_free(t);
+    }
+}
+
+/* Called by the writer. Advance the epoch if all threads in the critical
+ * section have observed the current epoch. */
+static void
+tryAdvanceEpoch(ConcurrentNodestore *cns) {
+    uintptr_t e = (uintptr_t)UA_atomic_load(&cns->epoch);
+    EpochRecord *rec = (EpochRecord*)UA_atomic_load(&cns->records);
+    for(; rec; rec = rec->next) {
+        uintptr_t re = (uintptr_t)UA_atomic_load(&rec->epoch);
+        if(re != 0 && re != e + 1)
+            return;
+    }
+
+    /* Free the entries retired in e-1 (the same index as e+2) */
+    uintptr_t next = (e + 1) % EPOCH_COUNT;
+    freeRetired(cns, (e + 2) % EPOCH_COUNT);
+    UA_atomic_xchg(&cns->epoch, (void*)next);
+}
+
+static void
+retireEntry(ConcurrentNodestore *cns, CNodeEntry *entry) {
+    /* A pending edit of the entry can no longer be published */
+    if(entry->edit)
+        entry->edit->orig = NULL;
+    uintptr_t e = (uintptr_t)UA_atomic_load(&cns->epoch);
+    entry->retiredNext = cns->retiredEntries[e];
+    cns->retiredEntries[e] = entry;
+    tryAdvanceEpoch(cns);
+}
+
+/*************/
+/* Hash-Map */
+/*************/
+
+static CNodeTable *
+newTable(size_t size) {
+    CNodeTable *t = (CNodeTable*)
+        UA_calloc(1, sizeof(CNodeTable) + size * sizeof(CNodeEntry*));
+    if(!t)
+        return NULL;
+    t->size = size;
+    t->slots = (CNodeEntry**)&t[1];
+    return t;
+}
+
+/* Returns the entry and its slot index. Tombstones are skipped. */
+static CNodeEntry *
+findEntry(const CNodeTable *t, const UA_NodeId *nodeId,
+          UA_UInt32 hash, size_t *index) {
+    size_t mask = t->size - 1;
+    size_t i = hash & mask;
+    for(size_t n = 0; n < t->size; n++, i = (i + 1) & mask) {
+        CNodeEntry *entry = (CNodeEntry*)UA_atomic_load((void**)&t->slots[i]);
+        if(!entry)
+            return NULL;
+        if(entry == CNODEMAP_TOMBSTONE || entry->nodeIdHash != hash ||
+           !UA_NodeId_equal(&entry->nodeId, nodeId))
+            continue;
+        if(index)
+            *index = i;
+        return entry;
+    }
+    return NULL;
+}
+
+/* Build a new table without tombstones and publish it. The old table is
+ * retired as readers can still access it. */
+static UA_StatusCode
+resizeTable(ConcurrentNodestore *cns) {
+    size_t size = CNODEMAP_MINSIZE;
+    while(size < (cns->count + 1) * 2)
+        size <<= 1;
+    CNodeTable *t = newTable(size);
+    if(!t)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+
+    CNodeTable *old = (CNodeTable*)cns->table;
+    if(old) {
+        for(size_t i = 0; i < old->size; i++) {
+            CNodeEntry *entry = old->slots[i];
+            if(!entry || entry == CNODEMAP_TOMBSTONE)
+                continue;
+            size_t j = entry->nodeIdHash & (size - 1);
+            while(t->slots[j])
+                j = (j + 1) & (size - 1);
+            t->slots[j] = entry;
+        }
+    }
+    cns->used = cns->count;
+
+    UA_atomic_xchg(&cns->table, t);
+    if(old) {
+        uintptr_t e = (uintptr_t)UA_atomic_load(&cns->epoch);
+        old->retiredNext = cns->retiredTables[e];
+        cns->retiredTables[e] = old;
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Publish a new entry. The NodeId must not exist already. */
+static UA_StatusCode
+publishEntry(ConcurrentNodestore *cns, CNodeEntry *entry) {
+    CNodeTable *t = (CNodeTable*)cns->table;
+    if((cns->used + 1) * 4 > t->size * 3) {
+        UA_StatusCode res = resizeTable(cns);
+        if(res != UA_STATUSCODE_GOOD)
+            return res;
+        t = (CNodeTable*)cns->table;
+    }
+
+    /* Take the first free slot or tombstone */
+    size_t mask = t->size - 1;
+    size_t i = entry->nodeIdHash & mask;
+    while(t->slots[i] && t->slots[i] != CNODEMAP_TOMBSTONE)
+        i = (i + 1) & mask;
+    if(!t->slots[i])
+        cns->used++;
+    cns->count++;
+    UA_atomic_xchg((void**)&t->slots[i], entry);
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Replace the current version with an edited copy. Called with the writeLock
+ * held. The copy is deleted if the original is no longer current. */
+static UA_StatusCode
+replaceEntry(ConcurrentNodestore *cns, CNodeEntry *entry) {
+    UA_Node *node = (UA_Node*)&entry->nodeId;
+    CNodeTable *t = (CNodeTable*)cns->table;
+    size_t index = 0;
+    UA_UInt32 hash = UA_NodeId_hash(&node->head.nodeId);
+    CNodeEntry *current = findEntry(t, &node->head.nodeId, hash, &index);
+    if(!current) {
+        cDeleteEntry(entry);
+        return UA_STATUSCODE_BADNODEIDUNKNOWN;
+    }
+
+    /* The node was already updated since the copy was made */
+    if(current != entry->orig) {
+        cDeleteEntry(entry);
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+
+    cPrepareEntry(entry);
+    entry->nodeIdHash = hash;
+    UA_atomic_xchg((void**)&t->slots[index], entry);
+    /* A pending edit other than the published entry is invalidated when the
+     * current version is retired */
+    if(current->edit == entry)
+        current->edit = NULL;
+    retireEntry(cns, current);
+    return UA_STATUSCODE_GOOD;
+}
+
+/***********************/
+/* Interface functions */
+/***********************/
+
+/* Not yet inserted into the Nodestore */
+static UA_Node *
+cNsNewNode(UA_Nodestore *_, UA_NodeClass nodeClass) {
+    CNodeEntry *entry = cNewEntry(nodeClass);
+    if(!entry)
+        return NULL;
+    return (UA_Node*)&entry->nodeId;
+}
+
+/* Not yet inserted into the Nodestore */
+static void
+cNsDeleteNode(UA_Nodestore *_, UA_Node *node) {
+    cDeleteEntry(container_of(node, CNodeEntry, nodeId));
+}
+
+static const UA_Node *
+cNsGetNode(UA_Nodestore *ns, const UA_NodeId *nodeId,
+           UA_UInt32 attributeMask,
+           UA_ReferenceTypeSet references,
+           UA_BrowseDirection referenceDirections) {
+    ConcurrentNodestore *cns = (ConcurrentNodestore*)ns;
+    if(!enterEpoch(cns))
+        return NULL;
+    CNodeTable *t = (CNodeTable*)UA_atomic_load(&cns->table);
+    CNodeEntry *entry = findEntry(t, nodeId, UA_NodeId_hash(nodeId), NULL);
+    if(!entry) {
+        leaveEpoch(cns);
+        return NULL;
+    }
+    return (const UA_Node*)&entry->nodeId;
+}
+
+static const UA_Node *
+cNsGetNodeFromPtr(UA_Nodestore *ns, UA_NodePointer ptr,
+                  UA_UInt32 attributeMask,
+                  UA_ReferenceTypeSet references,
+                  UA_BrowseDirection referenceDirections) {
+    if(!UA_NodePointer_isLocal(ptr))
+        return NULL;
+    UA_NodeId id = UA_NodePointer_toNodeId(ptr);
+    return cNsGetNode(ns, &id, attributeMask,
+                      references, referenceDirections);
+}
+
+/* Returns a private copy of the node. The copy is published when it is
+ * released. The writeLock is held until then. If only one thread uses the
+ * Nodestore, the node is edited in place instead. */
+static UA_Node *
+cNsGetEditNode(UA_Nodestore *ns, const UA_NodeId *nodeId,
+               UA_UInt32 attributeMask,
+               UA_ReferenceTypeSet references,
+               UA_BrowseDirection referenceDirections) {
+    ConcurrentNodestore *cns = (ConcurrentNodestore*)ns;
+    if(!enterEpoch(cns))
+        return NULL;
+    UA_LOCK(&cns->writeLock);
+    CNodeEntry *entry = findEntry((CNodeTable*)cns->table, nodeId,
+                                  UA_NodeId_hash(nodeId), NULL);
+    if(!entry) {
+        UA_UNLOCK(&cns->writeLock);
+        leaveEpoch(cns);
+        return NULL;
+    }
+
+    /* Edit in place. The node is released like a node from _getNode. The
+     * writeLock is held until the thread has released all nodes. */
+    if(UA_atomic_load(&cns->singleThread)) {
+        if(cns->inPlaceLocked) {
+            UA_UNLOCK(&cns->writeLock);
+        }
+        cns->inPlaceLocked = true;
+        if(!entry->dirty) {
+            entry->dirty = true;
+            entry->dirtyNext = cns->dirty;
+            cns->dirty = entry;
+        }
+        return (UA_Node*)&entry->nodeId;
+    }
+    leaveEpoch(cns);
+
+    /* Nested edit of the same node */
+    if(entry->edit) {
+        entry->edit->editCount++;
+        return (UA_Node*)&entry->edit->nodeId;
+    }
+
+    CNodeEntry *copy = cCopyEntry(entry);
+    if(!copy) {
+        UA_UNLOCK(&cns->writeLock);
+        return NULL;
+    }
+    copy->orig = entry;
+    copy->editCount = 1;
+    entry->edit = copy;
+    return (UA_Node*)&copy->nodeId;
+}
+
+static UA_Node *
+cNsGetEditNodeFromPtr(UA_Nodestore *ns, UA_NodePointer ptr,
+                      UA_UInt32 attributeMask,
+                      UA_ReferenceTypeSet references,
+                      UA_BrowseDirection referenceDirections) {
+    if(!UA_NodePointer_isLocal(ptr))
+        return NULL;
+    UA_NodeId id = UA_NodePointer_toNodeId(ptr);
+    return cNsGetEditNode(ns, &id, attributeMask,
+                          references, referenceDirections);
+}
+
+static void
+cNsReleaseNode(UA_Nodestore *ns, const UA_Node *node) {
+    if(!node)
+        return;
+    ConcurrentNodestore *cns = (ConcurrentNodestore*)ns;
+    CNodeEntry *entry = container_of(node, CNodeEntry, nodeId);
+
+    /* Leave the critical section of the reader (or the in-place edit) */
+    if(entry->editCount == 0) {
+        leaveEpoch(cns);
+        return;
+    }
+
+    /* Publish the edited copy. If the original was replaced or removed in the
+     * meantime (orig is NULL), the edit is discarded. */
+    if(--entry->editCount == 0) {
+        if(entry->orig)
+            replaceEntry(cns, entry);
+        else
+            cDeleteEntry(entry);
+    }
+    UA_UNLOCK(&cns->writeLock);
+}
+
+static UA_StatusCode
+cNsGetNodeCopy(UA_Nodestore *ns, const UA_NodeId *nodeId,
+               UA_Node **outNode) {
+    ConcurrentNodestore *cns = (ConcurrentNodestore*)ns;
+    if(!enterEpoch(cns))
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    CNodeTable *t = (CNodeTable*)UA_atomic_load(&cns->table);
+    CNodeEntry *entry = findEntry(t, nodeId, UA_NodeId_hash(nodeId), NULL);
+    if(!entry) {
+        leaveEpoch(cns);
+        return UA_STATUSCODE_BADNODEIDUNKNOWN;
+    }
+
+    CNodeEntry *ne = cCopyEntry(entry);
+    leaveEpoch(cns);
+    if(!ne)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    ne->orig = entry;
+    *outNode = (UA_Node*)&ne->nodeId;
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+cNsInsertNode(UA_Nodestore *ns, UA_Node *node, UA_NodeId *addedNodeId) {
+    CNodeEntry *entry = container_of(node, CNodeEntry, nodeId);
+    ConcurrentNodestore *cns = (ConcurrentNodestore*)ns;
+    UA_LOCK(&cns->writeLock);
+    CNodeTable *t = (CNodeTable*)cns->table;
+
+    /* Ensure that the NodeId is unique. If the NodeId is ns=xx;i=0, then the
+     * numeric identifier is replaced with a random unused int32. The generated
+     * identifiers are stable after a restart (see the ZipTree Nodestore). */
+    UA_StatusCode retval = UA_STATUSCODE_GOOD;
+    if(node->head.nodeId.identifierType == UA_NODEIDTYPE_NUMERIC &&
+       node->head.nodeId.identifier.numeric == 0) {
+        CNodeEntry *found;
+        UA_UInt32 mask = 0x2F;
+        pcg32_random_t rng;
+        pcg32_srandom_r(&rng, cns->count, 0);
+        do {
+            UA_UInt32 numId = (pcg32_random_r(&rng) & mask) + 50000;
+#if SIZE_MAX <= UA_UINT32_MAX
+            if(numId >= (0x01 << 24))
+                numId = numId % (0x01 << 24);
+#endif
+            node->head.nodeId.identifier.numeric = numId;
+            found = findEntry(t, &node->head.nodeId,
+                              UA_NodeId_hash(&node->head.nodeId), NULL);
+            if(found) {
+                UA_NodeHead *nh = (UA_NodeHead*)&found->nodeId;
+                pcg32_srandom_r(&rng, rng.state,
+                                UA_QualifiedName_hash(&nh->browseName));
+                mask = (mask << 1) | 0x01;
+            }
+        } while(found);
+    } else if(findEntry(t, &node->head.nodeId,
+                        UA_NodeId_hash(&node->head.nodeId), NULL)) {
+        retval = UA_STATUSCODE_BADNODEIDEXISTS;
+        goto errout;
+    }
+
+    /* Copy the NodeId */
+    if(addedNodeId) {
+        retval = UA_NodeId_copy(&node->head.nodeId, addedNodeId);
+        if(retval != UA_STATUSCODE_GOOD)
+            goto errout;
+    }
+
+    /* For new ReferencetypeNodes add to the index map. The NodeId is set before
+     * the counter is increased for concurrent readers. */
+    if(node->head.nodeClass == UA_NODECLASS_REFERENCETYPE) {
+        UA_ReferenceTypeNode *refNode = &node->referenceTypeNode;
+        uintptr_t counter = (uintptr_t)cns->referenceTypeCounter;
+        if(counter >= UA_REFERENCETYPESET_MAX) {
+            retval = UA_STATUSCODE_BADINTERNALERROR;
+            goto errout_addedNodeId;
+        }
+        retval = UA_NodeId_copy(&node->head.nodeId,
+                                &cns->referenceTypeIds[counter]);
+        if(retval != UA_STATUSCODE_GOOD) {
+            retval = UA_STATUSCODE_BADINTERNALERROR;
+            goto errout_addedNodeId;
+        }
+        refNode->referenceTypeIndex = (UA_Byte)counter;
+        refNode->subTypes = UA_REFTYPESET((UA_Byte)counter);
+        UA_atomic_xchg(&cns->referenceTypeCounter, (void*)(counter + 1));
+    }
+
+    /* Insert the node */
+    cPrepareEntry(entry);
+    entry->nodeIdHash = UA_NodeId_hash(&node->head.nodeId);
+    retval = publishEntry(cns, entry);
+    if(retval != UA_STATUSCODE_GOOD)
+        goto errout_addedNodeId;
+    UA_UNLOCK(&cns->writeLock);
+    return UA_STATUSCODE_GOOD;
+
+ errout_addedNodeId:
+    if(addedNodeId)
+        UA_NodeId_clear(addedNodeId);
+ errout:
+    cDeleteEntry(entry);
+    UA_UNLOCK(&cns->writeLock);
+    return retval;
+}
+
+static UA_StatusCode
+cNsReplaceNode(UA_Nodestore *ns, UA_Node *node) {
+    ConcurrentNodestore *cns = (ConcurrentNodestore*)ns;
+    UA_LOCK(&cns->writeLock);
+    UA_StatusCode res = replaceEntry(cns, container_of(node, CNodeEntry, nodeId));
+    UA_UNLOCK(&cns->writeLock);
+    return res;
+}
+
+static UA_StatusCode
+cNsRemoveNode(UA_Nodestore *ns, const UA_NodeId *nodeId) {
+    ConcurrentNodestore *cns = (ConcurrentNodestore*)ns;
+    UA_LOCK(&cns->writeLock);
+    CNodeTable *t = (CNodeTable*)cns->table;
+    size_t index = 0;
+    CNodeEntry *entry = findEntry(t, nodeId, UA_NodeId_hash(nodeId), &index);
+    if(!entry) {
+        UA_UNLOCK(&cns->writeLock);
+        return UA_STATUSCODE_BADNODEIDUNKNOWN;
+    }
+    UA_atomic_xchg((void**)&t->slots[index], CNODEMAP_TOMBSTONE);
+    cns->count--;
+    retireEntry(cns, entry);
+    UA_UNLOCK(&cns->writeLock);
+    return UA_STATUSCODE_GOOD;
+}
+
+static const UA_NodeId *
+cNsGetReferenceTypeId(UA_Nodestore *ns, UA_Byte refTypeIndex) {
+    ConcurrentNodestore *cns = (ConcurrentNodestore*)ns;
+    if(refTypeIndex >= (uintptr_t)UA_atomic_load(&cns->referenceTypeCounter))
+        return NULL;
+    return &cns->referenceTypeIds[refTypeIndex];
+}
+
+static void
+cNsIterate(UA_Nodestore *ns, UA_NodestoreVisitor visitor,
+           void *visitorCtx) {
+    ConcurrentNodestore *cns = (ConcurrentNodestore*)ns;
+    if(!enterEpoch(cns))
+        return;
+    CNodeTable *t = (CNodeTable*)UA_atomic_load(&cns->table);
+    for(size_t i = 0; i < t->size; i++) {
+        CNodeEntry *entry = (CNodeEntry*)UA_atomic_load((void**)&t->slots[i]);
+        if(!entry || entry == CNODEMAP_TOMBSTONE)
+            continue;
+        visitor(visitorCtx, (UA_Node*)&entry->nodeId);
+    }
+    leaveEpoch(cns);
+}
+
+/***********************/
+/* Nodestore Lifecycle */
+/***********************/
+
+static void
+cNsFree(UA_Nodestore *ns) {
+    ConcurrentNodestore *cns = (ConcurrentNodestore*)ns;
+
+    /* Delete the nodes */
+    CNodeTable *t = (CNodeTable*)cns->table;
+    for(size_t i = 0; i < t->size; i++) {
+        CNodeEntry *entry = t->slots[i];
+        if(entry && entry != CNODEMAP_TOMBSTONE)
+            cDeleteEntry(entry);
+    }
+    UA_free(t);
+
+    /* Delete the retired entries and tables */
+    for(uintptr_t e = 0; e < EPOCH_COUNT; e++)
+        freeRetired(cns, e);
+
+    /* Delete the epoch records */
+    EpochRecord *rec = (EpochRecord*)cns->records;
+    while(rec) {
+        EpochRecord *next = rec->next;
+        UA_free(rec);
+        rec = next;
+    }
+    if(cachedRecordId == cns->id)
+        cachedRecord = NULL;
+
+    /* Clean up the ReferenceTypes index array */
+    uintptr_t counter = (uintptr_t)cns->referenceTypeCounter;
+    for(size_t i = 0; i < counter; i++)
+        UA_NodeId_clear(&cns->referenceTypeIds[i]);
+
+    UA_LOCK_DESTROY(&cns->writeLock);
+    UA_free(cns);
+}
+
+UA_Nodestore *
+UA_Nodestore_Concurrent(void) {
+    /* Allocate and initialize the context */
+    ConcurrentNodestore *cns = (ConcurrentNodestore*)
+        UA_calloc(1, sizeof(ConcurrentNodestore));
+    if(!cns)
+        return NULL;
+    if(resizeTable(cns) != UA_STATUSCODE_GOOD) {
+        UA_free(cns);
+        return NULL;
+    }
+    UA_LOCK_INIT(&cns->writeLock);
+    cns->singleThread = (void*)0x01;
+
+    /* Unique id for the thread-local record cache. Zero is never used. */
+    void *id;
+    do {
+        id = UA_atomic_load(&nodestoreIdCounter);
+    } while(UA_atomic_cmpxchg(&nodestoreIdCounter, id,
+                              (void*)((uintptr_t)id + 1)) != id);
+    cns->id = (uintptr_t)id + 1;
+
+    /* Populate the nodestore */
+    cns->ns.free = cNsFree;
+    cns->ns.newNode = cNsNewNode;
+    cns->ns.deleteNode = cNsDeleteNode;
+    cns->ns.getNode = cNsGetNode;
+    cns->ns.getNodeFromPtr = cNsGetNodeFromPtr;
+    cns->ns.getEditNode = cNsGetEditNode;
+    cns->ns.getEditNodeFromPtr = cNsGetEditNodeFromPtr;
+    cns->ns.releaseNode = cNsReleaseNode;
+    cns->ns.getNodeCopy = cNsGetNodeCopy;
+    cns->ns.insertNode = cNsInsertNode;
+    cns->ns.replaceNode = cNsReplaceNode;
+    cns->ns.removeNode = cNsRemoveNode;
+    cns->ns.getReferenceTypeId = cNsGetReferenceTypeId;
+    cns->ns.iterate = cNsIterate;
+    cns->ns.concurrentRead = true;
+    return &cns->ns;
+}
@@ -0,0 +1,654 @@
+/* This work is licensed under a Creative Commons CCZero 1.0 Universal License.
+ * See http://creativecommons.org/publicdomain/zero/1.0/ for more information.
+ *
+ *    Copyright 2014-2018 (c) Fraunhofer IOSB (Author: Julius Pfrommer)
+ *    Copyright 2017 (c) Julian Grothoff
+ *    Copyright 2017 (c) Stefan Profanter, fortiss GmbH
+ */
+
+#include <open62541/server.h>
+#include <open62541/plugin/nodestore.h>
+#include <open62541/plugin/nodestore_default.h>
+#include "pcg_basic.h"
+
+#ifndef container_of
+#define container_of(ptr, type, member) \
+    (type *)((uintptr_t)ptr - offsetof(type,member))
+#endif
+
+/* The nodes are allocated from slabs with one slab list per NodeClass. So
+ * nodes of the same NodeClass are close together in memory and no malloc is
+ * required for every new node. The memory of a slab is released only when
+ * the Nodestore is freed. */
+#define NODESLAB_SIZE (1 << 14)
+#define NODESLAB_MINENTRIES 16
+#define NODECLASS_COUNT 8
+
+/* The index is a hash-table with open addressing and Robin Hood hashing. The
+ * table is resized when the load factor is above 4/5. The entries are then
+ * migrated step-by-step to the new table during the following insertions and
+ * removals. Lookups search both tables while the migration is ongoing. */
+#define NODEMAP_MINCAPACITY 64
+#define NODEMAP_MIGRATESTEPS 4
+
+struct MapEntry;
+typedef struct MapEntry MapEntry;
+
+struct MapEntry {
+    UA_UInt16 refCount; /* How many consumers have a reference to the node? */
+    UA_Boolean deleted; /* Node was marked as deleted and can be deleted when refCount == 0 */
+    UA_Byte slab;       /* Index of the slab list (depends on the NodeClass) */
+    MapEntry *orig;    /* If a copy is made to replace a node, track that we
+                         * replace only the node from which the copy was made.
+                         * Important for concurrent operations. While the entry
+                         * is unused, this points to the next free entry. */
+    UA_NodeId nodeId; /* This is actually a UA_Node that also starts with a NodeId */
+};
+
+typedef struct NodeSlab {
+    struct NodeSlab *next;
+    /* The entries follow here */
+} NodeSlab;
+
+typedef struct {
+    size_t entrySize;
+    size_t entriesPerSlab;
+    NodeSlab *slabs;
+    MapEntry *free;
+} NodeSlabList;
+
+typedef struct {
+    UA_UInt32 nodeIdHash;
+    UA_UInt32 distance; /* Distance from the ideal position + 1. Zero if the
+                         * slot is empty. */
+    MapEntry *entry;   /* NULL for a tombstone in the table that is migrated */
+} NodeMapSlot;
+
+typedef struct {
+    NodeMapSlot *slots;
+    size_t capacity; /* Power of two */
+    size_t count;
+} NodeMapTable;
+
+typedef struct {
+    UA_Nodestore ns;
+
+    /* The current table and the previous table during the migration */
+    NodeMapTable table;
+    NodeMapTable old;
+    size_t migrateIndex;
+
+    NodeSlabList slabs[NODECLASS_COUNT];
+
+    /* Maps ReferenceTypeIndex to the NodeId of the ReferenceType */
+    UA_NodeId referenceTypeIds[UA_REFERENCETYPESET_MAX];
+    UA_Byte referenceTypeCounter;
+} HashMapNodestore;
+
+/*********/
+/* Slabs */
+/*********/
+
+static UA_Byte
+slabIndex(UA_NodeClass nodeClass) {
+    switch(nodeClass) {
+    case UA_NODECLASS_OBJECT: return 0;
+    case UA_NODECLASS_VARIABLE: return 1;
+    case UA_NODECLASS_METHOD: return 2;
+    case UA_NODECLASS_OBJECTTYPE: return 3;
+    case UA_NODECLASS_VARIABLETYPE: return 4;
+    case UA_NODECLASS_REFERENCETYPE: return 5;
+    case UA_NODECLASS_DATATYPE: return 6;
+    case UA_NODECLASS_VIEW: return 7;
+    default: return NODECLASS_COUNT;
+    }
+}
+
+static const size_t nodeSizes[NODECLASS_COUNT] = {
+    sizeof(UA_ObjectNode), sizeof(UA_VariableNode), sizeof(UA_MethodNode),
+    sizeof(UA_ObjectTypeNode), sizeof(UA_VariableTypeNode),
+    sizeof(UA_ReferenceTypeNode), sizeof(UA_DataTypeNode), sizeof(UA_ViewNode)
+};
+
+static void
+initSlabs(HashMapNodestore *hns) {
+    for(size_t i = 0; i < NODECLASS_COUNT; i++) {
+        NodeSlabList *sl = &hns->slabs[i];
+        /* Round up to keep the alignment of the entries */
+        size_t align = 2 * sizeof(void*);
+        sl->entrySize = sizeof(MapEntry) - sizeof(UA_NodeId) + nodeSizes[i];
+        sl->entrySize = (sl->entrySize + align - 1) & ~(align - 1);
+        sl->entriesPerSlab = NODESLAB_SIZE / sl->entrySize;
+        if(sl->entriesPerSlab < NODESLAB_MINENTRIES)
+            sl->entriesPerSlab = NODESLAB_MINENTRIES;
+    }
+}
+
+static MapEntry *
+newMapEntry(HashMapNodestore *hns, UA_NodeClass nodeClass) {
+    UA_Byte si = slabIndex(nodeClass);
+    if(si >= NODECLASS_COUNT)
+        return NULL;
+    NodeSlabList *sl = &hns->slabs[si];
+
+    /* Allocate a new slab and put its entries into the free list */
+    if(!sl->free) {
+        size_t offset = (sizeof(NodeSlab) + 2 * sizeof(void*) - 1) &
+            ~(2 * sizeof(void*) - 1);
+        NodeSlab *slab = (NodeSlab*)
+            UA_malloc(offset + sl->entriesPerSlab * sl->entrySize);
+        if(!slab)
+            return NULL;
+        slab->next = sl->slabs;
+        sl->slabs = slab;
+        uintptr_t pos = (uintptr_t)slab + offset + sl->entrySize * sl->entriesPerSlab;
+        for(size_t i = 0; i < sl->entriesPerSlab; i++) {
+            pos -= sl->entrySize;
+            MapEntry *e = (MapEntry*)pos;
+            e->orig = sl->free;
+            sl->free = e;
+        }
+    }
+
+    /* Take from the free list */
+    MapEntry *entry = sl->free;
+    sl->free = entry->orig;
+    memset(entry, 0, sl->entrySize);
+    entry->slab = si;
+    UA_Node *node = (UA_Node*)&entry->nodeId;
+    node->head.nodeClass = nodeClass;
+    return entry;
+}
+
+static void
+deleteMapEntry(HashMapNodestore *hns, MapEntry *entry) {
+    UA_Node_clear((UA_Node*)&entry->nodeId);
+    NodeSlabList *sl = &hns->slabs[entry->slab];
+    entry->orig = sl->free;
+    sl->free = entry;
+}
+
+static void
+cleanupMapEntry(HashMapNodestore *hns, MapEntry *entry) {
+    if(entry->refCount > 0)
+        return;
+    if(entry->deleted) {
+        deleteMapEntry(hns, entry);
+        return;
+    }
+    UA_NodeHead *head = (UA_NodeHead*)&entry->nodeId;
+    for(size_t i = 0; i < head->referencesSize; i++) {
+        UA_NodeReferenceKind *rk = &head->references[i];
+        if(rk->targetsSize > 16 && !rk->hasRefTree)
+            UA_NodeReferenceKind_switch(rk);
+    }
+}
+
+/*********/
+/* Index */
+/*********/
+
+static NodeMapSlot *
+findSlot(const NodeMapTable *t, UA_UInt32 hash, const UA_NodeId *nodeId) {
+    if(t->count == 0)
+        return NULL;
+    size_t mask = t->capacity - 1;
+    size_t idx = hash & mask;
+    for(UA_UInt32 distance = 1; ; distance++) {
+        NodeMapSlot *slot = &t->slots[idx];
+        /* With Robin Hood hashing, the entry would have displaced a slot that
+         * is closer to its ideal position */
+        if(slot->distance < distance)
+            return NULL;
+        if(slot->nodeIdHash == hash && slot->entry &&
+           UA_NodeId_equal(&slot->entry->nodeId, nodeId))
+            return slot;
+        idx = (idx + 1) & mask;
+    }
+}
+
+/* The table must have a free slot */
+static void
+insertSlot(NodeMapTable *t, UA_UInt32 hash, MapEntry *entry) {
+    NodeMapSlot ins = {hash, 1, entry};
+    size_t mask = t->capacity - 1;
+    size_t idx = hash & mask;
+    for(;; ins.distance++) {
+        NodeMapSlot *slot = &t->slots[idx];
+        if(slot->distance == 0) {
+            *slot = ins;
+            break;
+        }
+        /* Take the slot from an entry that is closer to its ideal position */
+        if(slot->distance < ins.distance) {
+            NodeMapSlot tmp = *slot;
+            *slot = ins;
+            ins = tmp;
+        }
+        idx = (idx + 1) & mask;
+    }
+    t->count++;
+}
+
+/* Backward-shift the following entries instead of leaving a tombstone */
+static void
+removeSlot(NodeMapTable *t, NodeMapSlot *slot) {
+    size_t mask = t->capacity - 1;
+    size_t idx = (size_t)(slot - t->slots);
+    while(true) {
+        size_t next = (idx + 1) & mask;
+        NodeMapSlot *ns = &t->slots[next];
+        if(ns->distance <= 1)
+            break;
+        t->slots[idx] = *ns;
+        t->slots[idx].distance--;
+        idx = next;
+    }
+    memset(&t->slots[idx], 0, sizeof(NodeMapSlot));
+    t->count--;
+}
+
+/* Look up in the current table and in the table that is being migrated */
+static NodeMapSlot *
+findNode(const HashMapNodestore *hns, UA_UInt32 hash, const UA_NodeId *nodeId,
+         UA_Boolean *inOld) {
+    *inOld = false;
+    NodeMapSlot *slot = findSlot(&hns->table, hash, nodeId);
+    if(slot || !hns->old.slots)
+        return slot;
+    *inOld = true;
+    return findSlot(&hns->old, hash, nodeId);
+}
+
+/* Move the entries of a few slots from the old into the current table. The
+ * moved slots become tombstones so that the probing in the old table still
+ * works. */
+static void
+migrateSlots(HashMapNodestore *hns, size_t steps) {
+    NodeMapTable *old = &hns->old;
+    for(; steps > 0 && hns->migrateIndex < old->capacity; steps--) {
+        NodeMapSlot *slot = &old->slots[hns->migrateIndex++];
+        if(!slot->entry)
+            continue;
+        insertSlot(&hns->table, slot->nodeIdHash, slot->entry);
+        slot->entry = NULL;
+        old->count--;
+    }
+    if(hns->migrateIndex < old->capacity)
+        return;
+    UA_free(old->slots);
+    memset(old, 0, sizeof(NodeMapTable));
+    hns->migrateIndex = 0;
+}
+
+/* Make room for one more entry in the current table */
+static UA_StatusCode
+reserveSlot(HashMapNodestore *hns) {
+    if(hns->old.slots)
+        migrateSlots(hns, NODEMAP_MIGRATESTEPS);
+
+    NodeMapTable *t = &hns->table;
+    if((t->count + 1) * 5 <= t->capacity * 4)
+        return UA_STATUSCODE_GOOD;
+
+    /* Finish an ongoing migration first. Not reached with the default
+     * parameters, as the migration completes before the new table fills. */
+    if(hns->old.slots)
+        migrateSlots(hns, hns->old.capacity);
+
+    size_t capacity = (t->capacity == 0) ? NODEMAP_MINCAPACITY : t->capacity * 2;
+    NodeMapSlot *slots = (NodeMapSlot*)UA_calloc(capacity, sizeof(NodeMapSlot));
+    if(!slots)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+
+    /* The current table becomes the old table */
+    hns->old = *t;
+    hns->migrateIndex = 0;
+    t->slots = slots;
+    t->capacity = capacity;
+    t->count = 0;
+    if(hns->old.count == 0) {
+        /* Nothing to migrateSlots */
+        UA_free(hns->old.slots);
+        memset(&hns->old, 0, sizeof(NodeMapTable));
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+/***********************/
+/* Interface functions */
+/***********************/
+
+/* Not yet inserted into the HashMap */
+static UA_Node *
+hashMapNsNewNode(UA_Nodestore *ns, UA_NodeClass nodeClass) {
+    MapEntry *entry = newMapEntry((HashMapNodestore*)ns, nodeClass);
+    if(!entry)
+        return NULL;
+    return (UA_Node*)&entry->nodeId;
+}
+
+/* Not yet inserted into the HashMap */
+static void
+hashMapNsDeleteNode(UA_Nodestore *ns, UA_Node *node) {
+    deleteMapEntry((HashMapNodestore*)ns, container_of(node, MapEntry, nodeId));
+}
+
+static const UA_Node *
+hashMapNsGetNode(UA_Nodestore *ns, const UA_NodeId *nodeId,
+                 UA_UInt32 attributeMask,
+                 UA_ReferenceTypeSet references,
+                 UA_BrowseDirection referenceDirections) {
+    UA_Boolean inOld;
+    NodeMapSlot *slot = findNode((HashMapNodestore*)ns,
+                                 UA_NodeId_hash(nodeId), nodeId, &inOld);
+    if(!slot)
+        return NULL;
+    ++slot->entry->refCount;
+    return (const UA_Node*)&slot->entry->nodeId;
+}
+
+static const UA_Node *
+hashMapNsGetNodeFromPtr(UA_Nodestore *ns, UA_NodePointer ptr,
+                        UA_UInt32 attributeMask,
+                        UA_ReferenceTypeSet references,
+                        UA_BrowseDirection referenceDirections) {
+    if(!UA_NodePointer_isLocal(ptr))
+        return NULL;
+    UA_NodeId id = UA_NodePointer_toNodeId(ptr);
+    return hashMapNsGetNode(ns, &id, attributeMask,
+                            references, referenceDirections);
+}
+
+static void
+hashMapNsReleaseNode(UA_Nodestore *ns, const UA_Node *node) {
+    if(!node)
+        return;
+    MapEntry *entry = container_of(node, MapEntry, nodeId);
+    UA_assert(entry->refCount > 0);
+    --entry->refCount;
+    cleanupMapEntry((HashMapNodestore*)ns, entry);
+}
+
+static UA_StatusCode
+hashMapNsGetNodeCopy(UA_Nodestore *ns, const UA_NodeId *nodeId,
+                     UA_Node **outNode) {
+    /* Get the node (with all attributes and references, the mask and refs are
+       currently noy evaluated within the plugin.) */
+    const UA_Node *node =
+        hashMapNsGetNode(ns, nodeId, UA_NODEATTRIBUTESMASK_ALL,
+                         UA_REFERENCETYPESET_ALL, UA_BROWSEDIRECTION_BOTH);
+    if(!node)
+        return UA_STATUSCODE_BADNODEIDUNKNOWN;
+
+    /* Create the new entry */
+    HashMapNodestore *hns = (HashMapNodestore*)ns;
+    MapEntry *ne = newMapEntry(hns, node->head.nodeClass);
+    if(!ne) {
+        hashMapNsReleaseNode(ns, node);
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    }
+
+    /* Copy the node content */
+    UA_Node *nnode = (UA_Node*)&ne->nodeId;
+    UA_StatusCode retval = UA_Node_copy(node, nnode);
+    hashMapNsReleaseNode(ns, node);
+    if(retval != UA_STATUSCODE_GOOD) {
+        deleteMapEntry(hns, ne);
+        return retval;
+    }
+
+    ne->orig = container_of(node, MapEntry, nodeId);
+    *outNode = nnode;
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+hashMapNsInsertNode(UA_Nodestore *ns, UA_Node *node, UA_NodeId *addedNodeId) {
+    MapEntry *entry = container_of(node, MapEntry, nodeId);
+    HashMapNodestore *hns = (HashMapNodestore*)ns;
+
+    /* Ensure that the NodeId is unique by testing their presence. If the NodeId
+     * is ns=xx;i=0, then the numeric identifier is replaced with a random
+     * unused int32. It is ensured that the created identifiers are stable after
+     * a server restart (assuming that Nodes are created in the same order and
+     * with the same BrowseName). */
+    UA_Boolean inOld;
+    UA_UInt32 hash;
+    if(node->head.nodeId.identifierType == UA_NODEIDTYPE_NUMERIC &&
+       node->head.nodeId.identifier.numeric == 0) {
+        NodeMapSlot *found;
+        UA_UInt32 mask = 0x2F;
+        pcg32_random_t rng;
+        pcg32_srandom_r(&rng, hns->table.count + hns->old.count, 0);
+        do {
+            /* Generate a random NodeId. Favor "easy" NodeIds.
+             * Always above 50000. */
+            UA_UInt32 numId = (pcg32_random_r(&rng) & mask) + 50000;
+
+#if SIZE_MAX <= UA_UINT32_MAX
+            /* The compressed "immediate" representation of nodes does not
+             * support the full range on 32bit systems. Generate smaller
+             * identifiers as they can be stored more compactly. */
+            if(numId >= (0x01 << 24))
+                numId = numId % (0x01 << 24);
+#endif
+            node->head.nodeId.identifier.numeric = numId;
+
+            /* Look up the current NodeId */
+            hash = UA_NodeId_hash(&node->head.nodeId);
+            found = findNode(hns, hash, &node->head.nodeId, &inOld);
+
+            if(found) {
+                /* Reseed the rng using the browseName of the existing node.
+                 * This ensures that different information models end up with
+                 * different NodeId sequences, but still stable after a
+                 * restart. */
+                UA_NodeHead *nh = (UA_NodeHead*)&found->entry->nodeId;
+                pcg32_srandom_r(&rng, rng.state, UA_QualifiedName_hash(&nh->browseName));
+
+                /* Make the mask less strict when the NodeId already exists */
+                mask = (mask << 1) | 0x01;
+            }
+        } while(found);
+    } else {
+        hash = UA_NodeId_hash(&node->head.nodeId);
+        if(findNode(hns, hash, &node->head.nodeId, &inOld)) { /* The nodeid exists */
+            deleteMapEntry(hns, entry);
+            return UA_STATUSCODE_BADNODEIDEXISTS;
+        }
+    }
+
+    /* Make room in the index */
+    UA_StatusCode retval = reserveSlot(hns);
+    if(retval != UA_STATUSCODE_GOOD) {
+        deleteMapEntry(hns, entry);
+        return retval;
+    }
+
+    /* Copy the NodeId */
+    if(addedNodeId) {
+        retval = UA_NodeId_copy(&node->head.nodeId, addedNodeId);
+        if(retval != UA_STATUSCODE_GOOD) {
+            deleteMapEntry(hns, entry);
+            return retval;
+        }
+    }
+
+    /* For new ReferencetypeNodes add to the index map */
+    if(node->head.nodeClass == UA_NODECLASS_REFERENCETYPE) {
+        UA_ReferenceTypeNode *refNode = &node->referenceTypeNode;
+        if(hns->referenceTypeCounter >= UA_REFERENCETYPESET_MAX) {
+            deleteMapEntry(hns, entry);
+            return UA_STATUSCODE_BADINTERNALERROR;
+        }
+
+        retval = UA_NodeId_copy(&node->head.nodeId,
+                                &hns->referenceTypeIds[hns->referenceTypeCounter]);
+        if(retval != UA_STATUSCODE_GOOD) {
+            deleteMapEntry(hns, entry);
+            return UA_STATUSCODE_BADINTERNALERROR;
+        }
+
+        /* Assign the ReferenceTypeIndex to the new ReferenceTypeNode */
+        refNode->referenceTypeIndex = hns->referenceTypeCounter;
+        refNode->subTypes = UA_REFTYPESET(hns->referenceTypeCounter);
+        hns->referenceTypeCounter++;
+    }
+
+    /* Insert the node */
+    insertSlot(&hns->table, hash, entry);
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+hashMapNsReplaceNode(UA_Nodestore *ns, UA_Node *node) {
+    /* Find the node */
+    HashMapNodestore *hns = (HashMapNodestore*)ns;
+    MapEntry *entry = container_of(node, MapEntry, nodeId);
+    UA_Boolean inOld;
+    NodeMapSlot *slot = findNode(hns, UA_NodeId_hash(&node->head.nodeId),
+                                 &node->head.nodeId, &inOld);
+    if(!slot) {
+        deleteMapEntry(hns, entry);
+        return UA_STATUSCODE_BADNODEIDUNKNOWN;
+    }
+
+    /* Test if the copy is current */
+    MapEntry *oldEntry = slot->entry;
+    if(oldEntry != entry->orig) {
+        /* The node was already updated since the copy was made */
+        deleteMapEntry(hns, entry);
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+
+    /* Replace in-situ. The NodeId and its hash remain the same. */
+    slot->entry = entry;
+    oldEntry->deleted = true;
+    cleanupMapEntry(hns, oldEntry);
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+hashMapNsRemoveNode(UA_Nodestore *ns, const UA_NodeId *nodeId) {
+    HashMapNodestore *hns = (HashMapNodestore*)ns;
+    UA_Boolean inOld;
+    NodeMapSlot *slot = findNode(hns, UA_NodeId_hash(nodeId), nodeId, &inOld);
+    if(!slot)
+        return UA_STATUSCODE_BADNODEIDUNKNOWN;
+    MapEntry *entry = slot->entry;
+    if(inOld) {
+        /* Leave a tombstone that is skipped by the migration */
+        slot->entry = NULL;
+        hns->old.count--;
+    } else {
+        removeSlot(&hns->table, slot);
+    }
+    entry->deleted = true;
+    cleanupMapEntry(hns, entry);
+    if(hns->old.slots)
+        migrateSlots(hns, NODEMAP_MIGRATESTEPS);
+    return UA_STATUSCODE_GOOD;
+}
+
+static const UA_NodeId *
+hashMapNsGetReferenceTypeId(UA_Nodestore *ns, UA_Byte refTypeIndex) {
+    HashMapNodestore *hns = (HashMapNodestore*)ns;
+    if(refTypeIndex >= hns->referenceTypeCounter)
+        return NULL;
+    return &hns->referenceTypeIds[refTypeIndex];
+}
+
+static void
+iterateTable(NodeMapTable *t, UA_NodestoreVisitor visitor, void *visitorCtx) {
+    for(size_t i = 0; i < t->capacity; i++) {
+        MapEntry *entry = t->slots[i].entry;
+        if(entry)
+            visitor(visitorCtx, (UA_Node*)&entry->nodeId);
+    }
+}
+
+static void
+hashMapNsIterate(UA_Nodestore *ns, UA_NodestoreVisitor visitor,
+                 void *visitorCtx) {
+    HashMapNodestore *hns = (HashMapNodestore*)ns;
+    iterateTable(&hns->table, visitor, visitorCtx);
+    iterateTable(&hns->old, visitor, visitorCtx);
+}
+
+/***********************/
+/* Nodestore Lifecycle */
+/***********************/
+
+static void
+deleteTable(HashMapNodestore *hns, NodeMapTable *t) {
+    for(size_t i = 0; i < t->capacity; i++) {
+        if(t->slots[i].entry)
+            UA_Node_clear((UA_Node*)&t->slots[i].entry->nodeId);
+    }
+    UA_free(t->slots);
+}
+
+static void
+hashMapNsFree(UA_Nodestore *ns) {
+    HashMapNodestore *hns = (HashMapNodestore*)ns;
+    deleteTable(hns, &hns->table);
+    deleteTable(hns, &hns->old);
+
+    /* Free the slabs */
+    for(size_t i = 0; i < NODECLASS_COUNT; i++) {
+        NodeSlab *slab = hns->slabs[i].slabs;
+        while(slab) {
+            NodeSlab *next = slab->next;
+            UA_free(slab);
+            slab = next;
+        }
+    }
+
+    /* Clean up the ReferenceTypes index array */
+    for(size_t i = 0; i < hns->referenceTypeCounter; i++)
+        UA_NodeId_clear(&hns->referenceTypeIds[i]);
+
+    UA_free(hns);
+}
+
+UA_Nodestore *
+UA_Nodestore_HashMap(void) {
+    /* Allocate and initialize the context */
+    HashMapNodestore *hns = (HashMapNodestore*)
+        UA_calloc(1, sizeof(HashMapNodestore));
+    if(!hns)
+        return NULL;
+
+    initSlabs(hns);
+    hns->referenceTypeCounter = 0;
+
+    /* Populate the nodestore */
+    hns->ns.free = hashMapNsFree;
+    hns->ns.newNode = hashMapNsNewNode;
+    hns->ns.deleteNode = hashMapNsDeleteNode;
+    hns->ns.getNode = hashMapNsGetNode;
+    hns->ns.getNodeFromPtr = hashMapNsGetNodeFromPtr;
+    hns->ns.releaseNode = hashMapNsReleaseNode;
+    hns->ns.getNodeCopy = hashMapNsGetNodeCopy;
+    hns->ns.insertNode = hashMapNsInsertNode;
+    hns->ns.replaceNode = hashMapNsReplaceNode;
+    hns->ns.removeNode = hashMapNsRemoveNode;
+    hns->ns.getReferenceTypeId = hashMapNsGetReferenceTypeId;
+    hns->ns.iterate = hashMapNsIterate;
+
+    /* All nodes are stored in RAM. Changes are made in-situ. GetEditNode is
+     * identical to GetNode -- but the Node pointer is non-const. */
+    hns->ns.getEditNode =
+        (UA_Node * (*)(UA_Nodestore *ns, const UA_NodeId *nodeId,
+                       UA_UInt32 attributeMask,
+                       UA_ReferenceTypeSet references,
+                       UA_BrowseDirection referenceDirections))hashMapNsGetNode;
+    hns->ns.getEditNodeFromPtr =
+        (UA_Node * (*)(UA_Nodestore *ns, UA_NodePointer ptr,
+                       UA_UInt32 attributeMask,
+                       UA_ReferenceTypeSet references,
+                       UA_BrowseDirection referenceDirections))hashMapNsGetNodeFromPtr;
+
+    return &hns->ns;
+}
@@ -0,0 +1,1007 @@
+/* This work is licensed under a Creative Commons CCZero 1.0 Universal License.
+ * See http://creativecommons.org/publicdomain/zero/1.0/ for more information.
+ */
+
+#include <open62541/server.h>
+#include <open62541/plugin/nodestore.h>
+#include <open62541/plugin/nodestore_default.h>
+#include "pcg_basic.h"
+
+#ifdef UA_ARCHITECTURE_POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/* Layout of the image. All integers are little-endian. The image contains no
+ * pointers and can be mapped at any address.
+ *
+ *   Header
+ *     UInt32 magic ("UAIM")
+ *     UInt32 version
+ *     UInt32 hashCheck  (the NodeId hash must be identical to the writer's)
+ *     UInt32 nodesSize
+ *     UInt32 indexSize  (power of two)
+ *     UInt32 indexOffset
+ *     NodeId[] referenceTypeIds (indexed by the ReferenceTypeIndex)
+ *     String[] namespaces
+ *   Index (at indexOffset)
+ *     indexSize x {UInt32 nodeIdHash, UInt32 recordOffset (0 if empty)}
+ *   Records
+ *     One binary-encoded node per record. The record starts with the NodeId.
+ *
+ * The index is a hash-map with linear probing. It is computed when the image
+ * is written. So opening an image requires no work proportional to the number
+ * of nodes. */
+
+#define IMAGE_MAGIC 0x4D494155 /* "UAIM" */
+#define IMAGE_VERSION 1
+#define IMAGE_HEADERSIZE 24
+#define IMAGE_SLOTSIZE 8
+
+typedef struct {
+    UA_Nodestore ns;
+
+    /* The nodes are decoded from the image into the overlay when they are
+     * first accessed. Nodes added at runtime are only in the overlay. */
+    UA_Nodestore *overlay;
+
+    UA_ByteString image;
+    UA_Boolean mapped; /* The image is mmap'ed and unmapped in _free */
+    UA_DecodeBinaryOptions decodeOptions;
+
+    size_t indexSize;
+    size_t indexOffset;
+    size_t namespacesOffset;
+
+    /* Bitmap for the index slots. Set when the node was decoded into the
+     * overlay or removed. The overlay is authoritative for these nodes. */
+    UA_Byte *materialized;
+
+    /* Maps ReferenceTypeIndex to the NodeId of the ReferenceType. The indices
+     * of the ReferenceTypes in the image are retained. */
+    UA_NodeId referenceTypeIds[UA_REFERENCETYPESET_MAX];
+    UA_Byte referenceTypeCounter;
+
+    UA_UInt32 insertCounter; /* Seeds the random NodeIds */
+} ImageNodestore;
+
+static UA_UInt32
+readUInt32(const UA_Byte *p) {
+    return (UA_UInt32)p[0] | ((UA_UInt32)p[1] << 8) |
+        ((UA_UInt32)p[2] << 16) | ((UA_UInt32)p[3] << 24);
+}
+
+static void
+writeUInt32(UA_Byte *p, UA_UInt32 v) {
+    p[0] = (UA_Byte)v;
+    p[1] = (UA_Byte)(v >> 8);
+    p[2] = (UA_Byte)(v >> 16);
+    p[3] = (UA_Byte)(v >> 24);
+}
+
+/* Detect images written by a library with a different NodeId hash */
+static UA_UInt32
+hashCheck(void) {
+    UA_NodeId numeric = UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER);
+    UA_NodeId string = UA_NODEID_STRING(1, "open62541");
+    return UA_NodeId_hash(&numeric) ^ UA_NodeId_hash(&string);
+}
+
+/****************/
+/* Image Writer */
+/****************/
+
+typedef struct {
+    UA_ByteString buf; /* Allocated size */
+    size_t pos;
+} ImageWriter;
+
+static UA_StatusCode
+reserveImage(ImageWriter *w, size_t len) {
+    if(w->pos + len <= w->buf.length)
+        return UA_STATUSCODE_GOOD;
+    size_t newLength = w->buf.length * 2;
+    if(newLength < w->pos + len)
+        newLength = w->pos + len;
+    UA_Byte *data = (UA_Byte*)UA_realloc(w->buf.data, newLength);
+    if(!data)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    memset(&data[w->buf.length], 0, newLength - w->buf.length);
+    w->buf.data = data;
+    w->buf.length = newLength;
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+writeField(ImageWriter *w, const void *p, const UA_DataType *type) {
+    size_t len = UA_calcSizeBinary(p, type, NULL);
+    if(len == 0)
+        return UA_STATUSCODE_BADENCODINGERROR;
+    UA_StatusCode res = reserveImage(w, len);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    UA_ByteString out = {len, &w->buf.data[w->pos]};
+    res = UA_encodeBinary(p, type, &out, NULL);
+    w->pos += out.length;
+    return res;
+}
+
+static UA_StatusCode
+writeArray(ImageWriter *w, const void *array, size_t arraySize,
+           const UA_DataType *type) {
+    UA_UInt32 size = (UA_UInt32)arraySize;
+    UA_StatusCode res = writeField(w, &size, &UA_TYPES[UA_TYPES_UINT32]);
+    uintptr_t ptr = (uintptr_t)array;
+    for(size_t i = 0; i < arraySize && res == UA_STATUSCODE_GOOD; i++) {
+        res = writeField(w, (const void*)ptr, type);
+        ptr += type->memSize;
+    }
+    return res;
+}
+
+static UA_StatusCode
+writeLocalizedTexts(ImageWriter *w, const UA_LocalizedTextListEntry *lt) {
+    UA_UInt32 size = 0;
+    for(const UA_LocalizedTextListEntry *e = lt; e; e = e->next)
+        size++;
+    UA_StatusCode res = writeField(w, &size, &UA_TYPES[UA_TYPES_UINT32]);
+    for(; lt && res == UA_STATUSCODE_GOOD; lt = lt->next)
+        res = writeField(w, &lt->localizedText, &UA_TYPES[UA_TYPES_LOCALIZEDTEXT]);
+    return res;
+}
+
+typedef struct {
+    ImageWriter *w;
+    UA_StatusCode res;
+} TargetWriter;
+
+static void *
+writeTarget(void *context, UA_ReferenceTarget *t) {
+    TargetWriter *tw = (TargetWriter*)context;
+    UA_ExpandedNodeId target = UA_NodePointer_toExpandedNodeId(t->targetId);
+    tw->res |= writeField(tw->w, &target, &UA_TYPES[UA_TYPES_EXPANDEDNODEID]);
+    tw->res |= writeField(tw->w, &t->targetNameHash, &UA_TYPES[UA_TYPES_UINT32]);
+    return NULL;
+}
+
+static UA_StatusCode
+writeVariableAttributes(ImageWriter *w, const UA_Node *node) {
+    /* VariableNode and VariableTypeNode share the layout of the attributes */
+    const UA_VariableNode *vn = &node->variableNode;
+    UA_StatusCode res = writeField(w, &vn->dataType, &UA_TYPES[UA_TYPES_NODEID]);
+    res |= writeField(w, &vn->valueRank, &UA_TYPES[UA_TYPES_INT32]);
+    res |= writeArray(w, vn->arrayDimensions, vn->arrayDimensionsSize,
+                      &UA_TYPES[UA_TYPES_UINT32]);
+
+    /* Callbacks cannot be stored in the image. Only the current value of
+     * external value sources is kept. */
+    UA_DataValue empty;
+    UA_DataValue_init(&empty);
+    const UA_DataValue *value = &empty;
+    if(vn->valueSourceType == UA_VALUESOURCETYPE_INTERNAL)
+        value = &vn->valueSource.internal.value;
+    else if(vn->valueSourceType == UA_VALUESOURCETYPE_EXTERNAL &&
+            vn->valueSource.external.value && *vn->valueSource.external.value)
+        value = *vn->valueSource.external.value;
+    res |= writeField(w, value, &UA_TYPES[UA_TYPES_DATAVALUE]);
+    return res;
+}
+
+static UA_StatusCode
+writeNode(ImageWriter *w, const UA_Node *node) {
+    const UA_NodeHead *head = &node->head;
+    UA_StatusCode res = writeField(w, &head->nodeId, &UA_TYPES[UA_TYPES_NODEID]);
+    res |= writeField(w, &head->nodeClass, &UA_TYPES[UA_TYPES_NODECLASS]);
+    res |= writeField(w, &head->browseName, &UA_TYPES[UA_TYPES_QUALIFIEDNAME]);
+    res |= writeLocalizedTexts(w, head->displayName);
+    res |= writeLocalizedTexts(w, head->description);
+    res |= writeField(w, &head->writeMask, &UA_TYPES[UA_TYPES_UINT32]);
+    res |= writeField(w, &head->constructed, &UA_TYPES[UA_TYPES_BOOLEAN]);
+
+    /* References */
+    UA_UInt32 refsSize = (UA_UInt32)head->referencesSize;
+    res |= writeField(w, &refsSize, &UA_TYPES[UA_TYPES_UINT32]);
+    for(size_t i = 0; i < head->referencesSize; i++) {
+        UA_NodeReferenceKind *rk = &head->references[i];
+        UA_UInt32 targetsSize = (UA_UInt32)rk->targetsSize;
+        res |= writeField(w, &rk->referenceTypeIndex, &UA_TYPES[UA_TYPES_BYTE]);
+        res |= writeField(w, &rk->isInverse, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        res |= writeField(w, &targetsSize, &UA_TYPES[UA_TYPES_UINT32]);
+        TargetWriter tw = {w, UA_STATUSCODE_GOOD};
+        UA_NodeReferenceKind_iterate(rk, writeTarget, &tw);
+        res |= tw.res;
+    }
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+
+    /* NodeClass-specific attributes */
+    switch(head->nodeClass) {
+    case UA_NODECLASS_VARIABLE:
+        res |= writeVariableAttributes(w, node);
+        res |= writeField(w, &node->variableNode.accessLevel, &UA_TYPES[UA_TYPES_BYTE]);
+        res |= writeField(w, &node->variableNode.minimumSamplingInterval,
+                          &UA_TYPES[UA_TYPES_DOUBLE]);
+        res |= writeField(w, &node->variableNode.historizing, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        res |= writeField(w, &node->variableNode.isDynamic, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        break;
+    case UA_NODECLASS_VARIABLETYPE:
+        res |= writeVariableAttributes(w, node);
+        res |= writeField(w, &node->variableTypeNode.isAbstract, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        break;
+    case UA_NODECLASS_METHOD:
+        res |= writeField(w, &node->methodNode.executable, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        break;
+    case UA_NODECLASS_OBJECT:
+        res |= writeField(w, &node->objectNode.eventNotifier, &UA_TYPES[UA_TYPES_BYTE]);
+        break;
+    case UA_NODECLASS_OBJECTTYPE:
+        res |= writeField(w, &node->objectTypeNode.isAbstract, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        break;
+    case UA_NODECLASS_REFERENCETYPE:
+        res |= writeField(w, &node->referenceTypeNode.isAbstract, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        res |= writeField(w, &node->referenceTypeNode.symmetric, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        res |= writeField(w, &node->referenceTypeNode.inverseName,
+                          &UA_TYPES[UA_TYPES_LOCALIZEDTEXT]);
+        res |= writeField(w, &node->referenceTypeNode.referenceTypeIndex,
+                          &UA_TYPES[UA_TYPES_BYTE]);
+        for(size_t i = 0; i < UA_REFERENCETYPESET_MAX / 32; i++)
+            res |= writeField(w, &node->referenceTypeNode.subTypes.bits[i],
+                              &UA_TYPES[UA_TYPES_UINT32]);
+        break;
+    case UA_NODECLASS_DATATYPE:
+        res |= writeField(w, &node->dataTypeNode.isAbstract, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        break;
+    case UA_NODECLASS_VIEW:
+        res |= writeField(w, &node->viewNode.eventNotifier, &UA_TYPES[UA_TYPES_BYTE]);
+        res |= writeField(w, &node->viewNode.containsNoLoops, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        break;
+    default:
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+    return res;
+}
+
+typedef struct {
+    const UA_Node **nodes;
+    size_t nodesSize;
+    size_t nodesCapacity;
+    UA_StatusCode res;
+} NodeCollector;
+
+static void
+collectNode(void *context, const UA_Node *node) {
+    NodeCollector *nc = (NodeCollector*)context;
+    if(nc->nodesSize == nc->nodesCapacity) {
+        size_t capacity = (nc->nodesCapacity == 0) ? 1024 : nc->nodesCapacity * 2;
+        const UA_Node **nodes = (const UA_Node**)
+            UA_realloc((void*)nc->nodes, capacity * sizeof(UA_Node*));
+        if(!nodes) {
+            nc->res = UA_STATUSCODE_BADOUTOFMEMORY;
+            return;
+        }
+        nc->nodes = nodes;
+        nc->nodesCapacity = capacity;
+    }
+    nc->nodes[nc->nodesSize++] = node;
+}
+
+UA_StatusCode
+UA_Nodestore_Image_write(UA_Server *server, UA_ByteString *image) {
+    UA_Nodestore *ns = UA_Server_getConfig(server)->nodestore;
+    if(!ns || !ns->iterate)
+        return UA_STATUSCODE_BADINTERNALERROR;
+
+    /* Collect the nodes */
+    NodeCollector nc;
+    memset(&nc, 0, sizeof(NodeCollector));
+    ns->iterate(ns, collectNode, &nc);
+    if(nc.res != UA_STATUSCODE_GOOD) {
+        UA_free((void*)nc.nodes);
+        return nc.res;
+    }
+
+    /* Header with the ReferenceTypes and namespaces */
+    ImageWriter w;
+    memset(&w, 0, sizeof(ImageWriter));
+    UA_StatusCode res = reserveImage(&w, IMAGE_HEADERSIZE);
+    w.pos = IMAGE_HEADERSIZE;
+    UA_UInt32 refTypesSize = 0;
+    while(refTypesSize < UA_REFERENCETYPESET_MAX &&
+          ns->getReferenceTypeId(ns, (UA_Byte)refTypesSize))
+        refTypesSize++;
+    res |= writeField(&w, &refTypesSize, &UA_TYPES[UA_TYPES_UINT32]);
+    for(UA_UInt32 i = 0; i < refTypesSize; i++)
+        res |= writeField(&w, ns->getReferenceTypeId(ns, (UA_Byte)i),
+                          &UA_TYPES[UA_TYPES_NODEID]);
+
+    UA_UInt32 namespacesSize = 0;
+    UA_String uri;
+    while(UA_Server_getNamespaceByIndex(server, namespacesSize, &uri) ==
+          UA_STATUSCODE_GOOD) {
+        UA_String_clear(&uri);
+        namespacesSize++;
+    }
+    res |= writeField(&w, &namespacesSize, &UA_TYPES[UA_TYPES_UINT32]);
+    for(UA_UInt32 i = 0; i < namespacesSize; i++) {
+        UA_String_init(&uri);
+        res |= UA_Server_getNamespaceByIndex(server, i, &uri);
+        res |= writeField(&w, &uri, &UA_TYPES[UA_TYPES_STRING]);
+        UA_String_clear(&uri);
+    }
+
+    /* Reserve the index with a load factor of at most 1/2 */
+    size_t indexSize = 16;
+    while(indexSize < nc.nodesSize * 2)
+        indexSize <<= 1;
+    w.pos = (w.pos + 7) & ~(size_t)7;
+    size_t indexOffset = w.pos;
+    res |= reserveImage(&w, indexSize * IMAGE_SLOTSIZE);
+    w.pos += indexSize * IMAGE_SLOTSIZE;
+
+    /* Write the records and insert them into the index */
+    for(size_t i = 0; i < nc.nodesSize && res == UA_STATUSCODE_GOOD; i++) {
+        const UA_Node *node = nc.nodes[i];
+        if(w.pos > UA_UINT32_MAX) {
+            res = UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
+            break;
+        }
+        UA_UInt32 recordOffset = (UA_UInt32)w.pos;
+        res = writeNode(&w, node);
+        if(res != UA_STATUSCODE_GOOD)
+            break;
+        UA_UInt32 hash = UA_NodeId_hash(&node->head.nodeId);
+        size_t slot = hash & (indexSize - 1);
+        UA_Byte *s = &w.buf.data[indexOffset + slot * IMAGE_SLOTSIZE];
+        while(readUInt32(&s[4]) != 0) {
+            slot = (slot + 1) & (indexSize - 1);
+            s = &w.buf.data[indexOffset + slot * IMAGE_SLOTSIZE];
+        }
+        writeUInt32(s, hash);
+        writeUInt32(&s[4], recordOffset);
+    }
+    UA_free((void*)nc.nodes);
+
+    if(res != UA_STATUSCODE_GOOD || w.pos > UA_UINT32_MAX) {
+        UA_ByteString_clear(&w.buf);
+        return (res != UA_STATUSCODE_GOOD) ? res : UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
+    }
+
+    /* Finish the header */
+    writeUInt32(w.buf.data, IMAGE_MAGIC);
+    writeUInt32(&w.buf.data[4], IMAGE_VERSION);
+    writeUInt32(&w.buf.data[8], hashCheck());
+    writeUInt32(&w.buf.data[12], (UA_UInt32)nc.nodesSize);
+    writeUInt32(&w.buf.data[16], (UA_UInt32)indexSize);
+    writeUInt32(&w.buf.data[20], (UA_UInt32)indexOffset);
+
+    w.buf.length = w.pos;
+    *image = w.buf;
+    return UA_STATUSCODE_GOOD;
+}
+
+/****************/
+/* Image Reader */
+/****************/
+
+typedef struct {
+    const ImageNodestore *ins;
+    size_t pos;
+} ImageReader;
+
+static UA_StatusCode
+readField(ImageReader *r, void *p, const UA_DataType *type) {
+    const UA_ByteString *image = &r->ins->image;
+    if(r->pos >= image->length)
+        return UA_STATUSCODE_BADDECODINGERROR;
+    UA_ByteString in = {image->length - r->pos, &image->data[r->pos]};
+    UA_DecodeBinaryOptions opts = r->ins->decodeOptions;
+    UA_StatusCode res = UA_decodeBinary(&in, p, type, &opts);
+    if(res == UA_STATUSCODE_GOOD)
+        r->pos += opts.decodedLength;
+    return res;
+}
+
+static UA_StatusCode
+readArray(ImageReader *r, void **array, size_t *arraySize,
+          const UA_DataType *type) {
+    UA_UInt32 size;
+    UA_StatusCode res = readField(r, &size, &UA_TYPES[UA_TYPES_UINT32]);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    if(size == 0)
+        return UA_STATUSCODE_GOOD;
+    if(size > r->ins->image.length - r->pos)
+        return UA_STATUSCODE_BADDECODINGERROR; /* Implausible size */
+    *array = UA_Array_new(size, type);
+    if(!*array)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    *arraySize = size;
+    uintptr_t ptr = (uintptr_t)*array;
+    for(size_t i = 0; i < size && res == UA_STATUSCODE_GOOD; i++) {
+        res = readField(r, (void*)ptr, type);
+        ptr += type->memSize;
+    }
+    return res;
+}
+
+static UA_StatusCode
+readLocalizedTexts(ImageReader *r, UA_LocalizedTextListEntry **list) {
+    UA_UInt32 size;
+    UA_StatusCode res = readField(r, &size, &UA_TYPES[UA_TYPES_UINT32]);
+    /* Append to retain the order of the list */
+    for(UA_UInt32 i = 0; i < size && res == UA_STATUSCODE_GOOD; i++) {
+        UA_LocalizedTextListEntry *lt = (UA_LocalizedTextListEntry*)
+            UA_calloc(1, sizeof(UA_LocalizedTextListEntry));
+        if(!lt)
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        *list = lt;
+        list = &lt->next;
+        res = readField(r, &lt->localizedText, &UA_TYPES[UA_TYPES_LOCALIZEDTEXT]);
+    }
+    return res;
+}
+
+static UA_StatusCode
+readReferences(ImageReader *r, UA_Node *node) {
+    UA_UInt32 refsSize;
+    UA_StatusCode res = readField(r, &refsSize, &UA_TYPES[UA_TYPES_UINT32]);
+    for(UA_UInt32 i = 0; i < refsSize && res == UA_STATUSCODE_GOOD; i++) {
+        UA_Byte refTypeIndex;
+        UA_Boolean isInverse;
+        UA_UInt32 targetsSize;
+        res |= readField(r, &refTypeIndex, &UA_TYPES[UA_TYPES_BYTE]);
+        res |= readField(r, &isInverse, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        res |= readField(r, &targetsSize, &UA_TYPES[UA_TYPES_UINT32]);
+        for(UA_UInt32 j = 0; j < targetsSize && res == UA_STATUSCODE_GOOD; j++) {
+            UA_ExpandedNodeId target;
+            UA_UInt32 nameHash;
+            res = readField(r, &target, &UA_TYPES[UA_TYPES_EXPANDEDNODEID]);
+            if(res != UA_STATUSCODE_GOOD)
+                break;
+            res = readField(r, &nameHash, &UA_TYPES[UA_TYPES_UINT32]);
+            if(res == UA_STATUSCODE_GOOD)
+                res = UA_Node_addReference(node, refTypeIndex, !isInverse,
+                                           &target, nameHash);
+            UA_ExpandedNodeId_clear(&target);
+        }
+    }
+    return res;
+}
+
+static UA_StatusCode
+readVariableAttributes(ImageReader *r, UA_Node *node) {
+    UA_VariableNode *vn = &node->variableNode;
+    UA_StatusCode res = readField(r, &vn->dataType, &UA_TYPES[UA_TYPES_NODEID]);
+    res |= readField(r, &vn->valueRank, &UA_TYPES[UA_TYPES_INT32]);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    res = readArray(r, (void**)&vn->arrayDimensions, &vn->arrayDimensionsSize,
+                    &UA_TYPES[UA_TYPES_UINT32]);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    vn->valueSourceType = UA_VALUESOURCETYPE_INTERNAL;
+    res = readField(r, &vn->valueSource.internal.value, &UA_TYPES[UA_TYPES_DATAVALUE]);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    /* The server keeps the values of VariableNodes as shared data */
+    return UA_Variant_share(&vn->valueSource.internal.value.value);
+}
+
+static UA_StatusCode
+readNodeAttributes(ImageReader *r, UA_Node *node) {
+    UA_NodeHead *head = &node->head;
+    UA_StatusCode res = readField(r, &head->browseName, &UA_TYPES[UA_TYPES_QUALIFIEDNAME]);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    res = readLocalizedTexts(r, &head->displayName);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    res = readLocalizedTexts(r, &head->description);
+    res |= readField(r, &head->writeMask, &UA_TYPES[UA_TYPES_UINT32]);
+    res |= readField(r, &head->constructed, &UA_TYPES[UA_TYPES_BOOLEAN]);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    res = readReferences(r, node);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+
+    switch(head->nodeClass) {
+    case UA_NODECLASS_VARIABLE:
+        res = readVariableAttributes(r, node);
+        res |= readField(r, &node->variableNode.accessLevel, &UA_TYPES[UA_TYPES_BYTE]);
+        res |= readField(r, &node->variableNode.minimumSamplingInterval,
+                         &UA_TYPES[UA_TYPES_DOUBLE]);
+        res |= readField(r, &node->variableNode.historizing, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        res |= readField(r, &node->variableNode.isDynamic, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        break;
+    case UA_NODECLASS_VARIABLETYPE:
+        res = readVariableAttributes(r, node);
+        res |= readField(r, &node->variableTypeNode.isAbstract, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        break;
+    case UA_NODECLASS_METHOD:
+        res = readField(r, &node->methodNode.executable, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        break;
+    case UA_NODECLASS_OBJECT:
+        res = readField(r, &node->objectNode.eventNotifier, &UA_TYPES[UA_TYPES_BYTE]);
+        break;
+    case UA_NODECLASS_OBJECTTYPE:
+        res = readField(r, &node->objectTypeNode.isAbstract, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        break;
+    case UA_NODECLASS_REFERENCETYPE:
+        res = readField(r, &node->referenceTypeNode.isAbstract, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        res |= readField(r, &node->referenceTypeNode.symmetric, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        res |= readField(r, &node->referenceTypeNode.inverseName,
+                         &UA_TYPES[UA_TYPES_LOCALIZEDTEXT]);
+        res |= readField(r, &node->referenceTypeNode.referenceTypeIndex,
+                         &UA_TYPES[UA_TYPES_BYTE]);
+        for(size_t i = 0; i < UA_REFERENCETYPESET_MAX / 32; i++)
+            res |= readField(r, &node->referenceTypeNode.subTypes.bits[i],
+                             &UA_TYPES[UA_TYPES_UINT32]);
+        break;
+    case UA_NODECLASS_DATATYPE:
+        res = readField(r, &node->dataTypeNode.isAbstract, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        break;
+    case UA_NODECLASS_VIEW:
+        res = readField(r, &node->viewNode.eventNotifier, &UA_TYPES[UA_TYPES_BYTE]);
+        res |= readField(r, &node->viewNode.containsNoLoops, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        break;
+    default:
+        return UA_STATUSCODE_BADDECODINGERROR;
+    }
+    return res;
+}
+
+/*********/
+/* Index */
+/*********/
+
+static UA_Boolean
+isMaterialized(const ImageNodestore *ins, size_t slot) {
+    return (ins->materialized[slot / 8] & (1 << (slot % 8))) != 0;
+}
+
+static void
+setMaterialized(ImageNodestore *ins, size_t slot) {
+    ins->materialized[slot / 8] |= (UA_Byte)(1 << (slot % 8));
+}
+
+/* Look up the NodeId in the index of the image. The encoded NodeId is compared
+ * with the beginning of the record. */
+static UA_Boolean
+findImageSlot(const ImageNodestore *ins, const UA_NodeId *nodeId,
+              size_t *outSlot, size_t *outOffset) {
+    UA_Byte stackBuf[64];
+    UA_ByteString enc = {sizeof(stackBuf), stackBuf};
+    size_t encLen = UA_calcSizeBinary(nodeId, &UA_TYPES[UA_TYPES_NODEID], NULL);
+    if(encLen > sizeof(stackBuf)) {
+        enc.data = (UA_Byte*)UA_malloc(encLen);
+        if(!enc.data)
+            return false;
+        enc.length = encLen;
+    }
+    UA_Boolean found = false;
+    if(UA_encodeBinary(nodeId, &UA_TYPES[UA_TYPES_NODEID], &enc, NULL) !=
+       UA_STATUSCODE_GOOD)
+        goto out;
+
+    UA_UInt32 hash = UA_NodeId_hash(nodeId);
+    size_t mask = ins->indexSize - 1;
+    for(size_t slot = hash & mask, i = 0; i < ins->indexSize;
+        slot = (slot + 1) & mask, i++) {
+        const UA_Byte *s = &ins->image.data[ins->indexOffset + slot * IMAGE_SLOTSIZE];
+        UA_UInt32 offset = readUInt32(&s[4]);
+        if(offset == 0)
+            break;
+        if(readUInt32(s) != hash || offset > ins->image.length - enc.length ||
+           memcmp(&ins->image.data[offset], enc.data, enc.length) != 0)
+            continue;
+        *outSlot = slot;
+        *outOffset = offset;
+        found = true;
+        break;
+    }
+
+ out:
+    if(enc.data != stackBuf)
+        UA_free(enc.data);
+    return found;
+}
+
+/* Decode the node from the image and insert it into the overlay */
+static UA_StatusCode
+materializeSlot(ImageNodestore *ins, size_t slot, size_t offset) {
+    UA_Nodestore *ov = ins->overlay;
+    ImageReader r = {ins, offset};
+    UA_NodeId nodeId;
+    UA_NodeClass nodeClass;
+    UA_StatusCode res = readField(&r, &nodeId, &UA_TYPES[UA_TYPES_NODEID]);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    res = readField(&r, &nodeClass, &UA_TYPES[UA_TYPES_NODECLASS]);
+    UA_Node *node = (res == UA_STATUSCODE_GOOD) ? ov->newNode(ov, nodeClass) : NULL;
+    if(!node) {
+        UA_NodeId_clear(&nodeId);
+        return (res != UA_STATUSCODE_GOOD) ? res : UA_STATUSCODE_BADDECODINGERROR;
+    }
+    node->head.nodeId = nodeId;
+    res = readNodeAttributes(&r, node);
+    if(res != UA_STATUSCODE_GOOD) {
+        ov->deleteNode(ov, node);
+        return res;
+    }
+
+    /* The overlay assigns a new ReferenceTypeIndex. Restore the index from the
+     * image. */
+    UA_Byte refTypeIndex = 0;
+    UA_ReferenceTypeSet subTypes;
+    if(nodeClass == UA_NODECLASS_REFERENCETYPE) {
+        refTypeIndex = node->referenceTypeNode.referenceTypeIndex;
+        subTypes = node->referenceTypeNode.subTypes;
+    }
+    res = ov->insertNode(ov, node, NULL);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    if(nodeClass == UA_NODECLASS_REFERENCETYPE) {
+        node->referenceTypeNode.referenceTypeIndex = refTypeIndex;
+        node->referenceTypeNode.subTypes = subTypes;
+    }
+    setMaterialized(ins, slot);
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+materializeNode(ImageNodestore *ins, const UA_NodeId *nodeId) {
+    size_t slot, offset;
+    if(!findImageSlot(ins, nodeId, &slot, &offset) || isMaterialized(ins, slot))
+        return UA_STATUSCODE_BADNODEIDUNKNOWN;
+    return materializeSlot(ins, slot, offset);
+}
+
+/* Is the node in the overlay or (not yet decoded) in the image? */
+static UA_Boolean
+nodeExists(ImageNodestore *ins, const UA_NodeId *nodeId) {
+    UA_Nodestore *ov = ins->overlay;
+    const UA_Node *node = ov->getNode(ov, nodeId, 0, UA_REFERENCETYPESET_NONE,
+                                      UA_BROWSEDIRECTION_INVALID);
+    if(node) {
+        ov->releaseNode(ov, node);
+        return true;
+    }
+    size_t slot, offset;
+    return findImageSlot(ins, nodeId, &slot, &offset) && !isMaterialized(ins, slot);
+}
+
+/***********************/
+/* Interface functions */
+/***********************/
+
+static UA_Node *
+imageNsNewNode(UA_Nodestore *ns, UA_NodeClass nodeClass) {
+    UA_Nodestore *ov = ((ImageNodestore*)ns)->overlay;
+    return ov->newNode(ov, nodeClass);
+}
+
+static void
+imageNsDeleteNode(UA_Nodestore *ns, UA_Node *node) {
+    UA_Nodestore *ov = ((ImageNodestore*)ns)->overlay;
+    ov->deleteNode(ov, node);
+}
+
+static const UA_Node *
+imageNsGetNode(UA_Nodestore *ns, const UA_NodeId *nodeId,
+               UA_UInt32 attributeMask,
+               UA_ReferenceTypeSet references,
+               UA_BrowseDirection referenceDirections) {
+    ImageNodestore *ins = (ImageNodestore*)ns;
+    UA_Nodestore *ov = ins->overlay;
+    const UA_Node *node = ov->getNode(ov, nodeId, attributeMask,
+                                      references, referenceDirections);
+    if(node || materializeNode(ins, nodeId) != UA_STATUSCODE_GOOD)
+        return node;
+    return ov->getNode(ov, nodeId, attributeMask, references, referenceDirections);
+}
+
+static const UA_Node *
+imageNsGetNodeFromPtr(UA_Nodestore *ns, UA_NodePointer ptr,
+                      UA_UInt32 attributeMask,
+                      UA_ReferenceTypeSet references,
+                      UA_BrowseDirection referenceDirections) {
+    if(!UA_NodePointer_isLocal(ptr))
+        return NULL;
+    UA_NodeId id = UA_NodePointer_toNodeId(ptr);
+    return imageNsGetNode(ns, &id, attributeMask, references, referenceDirections);
+}
+
+static void
+imageNsReleaseNode(UA_Nodestore *ns, const UA_Node *node) {
+    UA_Nodestore *ov = ((ImageNodestore*)ns)->overlay;
+    ov->releaseNode(ov, node);
+}
+
+static UA_StatusCode
+imageNsGetNodeCopy(UA_Nodestore *ns, const UA_NodeId *nodeId,
+                   UA_Node **outNode) {
+    ImageNodestore *ins = (ImageNodestore*)ns;
+    materializeNode(ins, nodeId);
+    return ins->overlay->getNodeCopy(ins->overlay, nodeId, outNode);
+}
+
+static UA_StatusCode
+imageNsInsertNode(UA_Nodestore *ns, UA_Node *node, UA_NodeId *addedNodeId) {
+    ImageNodestore *ins = (ImageNodestore*)ns;
+    UA_Nodestore *ov = ins->overlay;
+
+    /* Ensure that the NodeId is unique in the image and in the overlay. For
+     * NodeIds ns=xx;i=0 a random unused numeric identifier is generated. The
+     * identifiers are stable after a restart if the nodes are created in the
+     * same order. */
+    ins->insertCounter++;
+    if(node->head.nodeId.identifierType == UA_NODEIDTYPE_NUMERIC &&
+       node->head.nodeId.identifier.numeric == 0) {
+        UA_UInt32 mask = 0x2F;
+        pcg32_random_t rng;
+        pcg32_srandom_r(&rng, ins->insertCounter, 0);
+        do {
+            /* Favor "easy" NodeIds. Always above 50000. */
+            UA_UInt32 numId = (pcg32_random_r(&rng) & mask) + 50000;
+#if SIZE_MAX <= UA_UINT32_MAX
+            /* The compressed "immediate" representation of nodes does not
+             * support the full range on 32bit systems. */
+            if(numId >= (0x01 << 24))
+                numId = numId % (0x01 << 24);
+#endif
+            node->head.nodeId.identifier.numeric = numId;
+            mask = (mask << 1) | 0x01;
+        } while(nodeExists(ins, &node->head.nodeId));
+    } else {
+        size_t slot, offset;
+        if(findImageSlot(ins, &node->head.nodeId, &slot, &offset) &&
+           !isMaterialized(ins, slot)) {
+            ov->deleteNode(ov, node);
+            return UA_STATUSCODE_BADNODEIDEXISTS;
+        }
+    }
+
+    /* Check the ReferenceTypeIndex before the node is inserted */
+    UA_Boolean isRefType = (node->head.nodeClass == UA_NODECLASS_REFERENCETYPE);
+    if(isRefType && ins->referenceTypeCounter >= UA_REFERENCETYPESET_MAX) {
+        ov->deleteNode(ov, node);
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+
+    UA_StatusCode res = ov->insertNode(ov, node, addedNodeId);
+    if(res != UA_STATUSCODE_GOOD || !isRefType)
+        return res;
+
+    /* Assign the ReferenceTypeIndex after those from the image */
+    res = UA_NodeId_copy(&node->head.nodeId,
+                         &ins->referenceTypeIds[ins->referenceTypeCounter]);
+    if(res != UA_STATUSCODE_GOOD) {
+        ov->removeNode(ov, &node->head.nodeId);
+        return res;
+    }
+    node->referenceTypeNode.referenceTypeIndex = ins->referenceTypeCounter;
+    node->referenceTypeNode.subTypes = UA_REFTYPESET(ins->referenceTypeCounter);
+    ins->referenceTypeCounter++;
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+imageNsReplaceNode(UA_Nodestore *ns, UA_Node *node) {
+    /* Copies are only made from nodes in the overlay */
+    UA_Nodestore *ov = ((ImageNodestore*)ns)->overlay;
+    return ov->replaceNode(ov, node);
+}
+
+static UA_StatusCode
+imageNsRemoveNode(UA_Nodestore *ns, const UA_NodeId *nodeId) {
+    ImageNodestore *ins = (ImageNodestore*)ns;
+    size_t slot, offset;
+    if(findImageSlot(ins, nodeId, &slot, &offset) && !isMaterialized(ins, slot)) {
+        /* Mark as removed without decoding */
+        setMaterialized(ins, slot);
+        return UA_STATUSCODE_GOOD;
+    }
+    return ins->overlay->removeNode(ins->overlay, nodeId);
+}
+
+static const UA_NodeId *
+imageNsGetReferenceTypeId(UA_Nodestore *ns, UA_Byte refTypeIndex) {
+    ImageNodestore *ins = (ImageNodestore*)ns;
+    if(refTypeIndex >= ins->referenceTypeCounter)
+        return NULL;
+    return &ins->referenceTypeIds[refTypeIndex];
+}
+
+/* Decodes all remaining nodes from the image */
+static void
+imageNsIterate(UA_Nodestore *ns, UA_NodestoreVisitor visitor,
+               void *visitorCtx) {
+    ImageNodestore *ins = (ImageNodestore*)ns;
+    for(size_t slot = 0; slot < ins->indexSize; slot++) {
+        if(isMaterialized(ins, slot))
+            continue;
+        const UA_Byte *s = &ins->image.data[ins->indexOffset + slot * IMAGE_SLOTSIZE];
+        UA_UInt32 offset = readUInt32(&s[4]);
+        if(offset != 0)
+            materializeSlot(ins, slot, offset);
+    }
+    ins->overlay->iterate(ins->overlay, visitor, visitorCtx);
+}
+
+/***********************/
+/* Nodestore Lifecycle */
+/***********************/
+
+static void
+imageNsFree(UA_Nodestore *ns) {
+    ImageNodestore *ins = (ImageNodestore*)ns;
+    if(ins->overlay)
+        ins->overlay->free(ins->overlay);
+    for(size_t i = 0; i < ins->referenceTypeCounter; i++)
+        UA_NodeId_clear(&ins->referenceTypeIds[i]);
+    UA_free(ins->materialized);
+#ifdef UA_ARCHITECTURE_POSIX
+    if(ins->mapped)
+        munmap(ins->image.data, ins->image.length);
+#endif
+    UA_free(ins);
+}
+
+static UA_StatusCode
+openImage(ImageNodestore *ins) {
+    /* Check the header */
+    const UA_ByteString *image = &ins->image;
+    if(image->length < IMAGE_HEADERSIZE ||
+       readUInt32(image->data) != IMAGE_MAGIC ||
+       readUInt32(&image->data[4]) != IMAGE_VERSION ||
+       readUInt32(&image->data[8]) != hashCheck())
+        return UA_STATUSCODE_BADDECODINGERROR;
+    ins->indexSize = readUInt32(&image->data[16]);
+    ins->indexOffset = readUInt32(&image->data[20]);
+    if(ins->indexSize == 0 || (ins->indexSize & (ins->indexSize - 1)) != 0 ||
+       ins->indexOffset > image->length ||
+       ins->indexSize > (image->length - ins->indexOffset) / IMAGE_SLOTSIZE)
+        return UA_STATUSCODE_BADDECODINGERROR;
+
+    ins->materialized = (UA_Byte*)UA_calloc((ins->indexSize + 7) / 8, 1);
+    if(!ins->materialized)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+
+    /* Decode the ReferenceTypes. The namespaces are skipped. */
+    ImageReader r = {ins, IMAGE_HEADERSIZE};
+    UA_UInt32 refTypesSize;
+    UA_StatusCode res = readField(&r, &refTypesSize, &UA_TYPES[UA_TYPES_UINT32]);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    if(refTypesSize > UA_REFERENCETYPESET_MAX)
+        return UA_STATUSCODE_BADDECODINGERROR;
+    for(; ins->referenceTypeCounter < refTypesSize; ins->referenceTypeCounter++) {
+        res = readField(&r, &ins->referenceTypeIds[ins->referenceTypeCounter],
+                        &UA_TYPES[UA_TYPES_NODEID]);
+        if(res != UA_STATUSCODE_GOOD)
+            return res;
+    }
+    ins->namespacesOffset = r.pos;
+
+    /* The overlay holds the decoded and the added nodes */
+    ins->overlay = UA_Nodestore_HashMap();
+    return (ins->overlay) ? UA_STATUSCODE_GOOD : UA_STATUSCODE_BADOUTOFMEMORY;
+}
+
+static ImageNodestore *
+newImageNodestore(const UA_ByteString *image, const UA_DataTypeArray *customTypes) {
+    ImageNodestore *ins = (ImageNodestore*)UA_calloc(1, sizeof(ImageNodestore));
+    if(!ins)
+        return NULL;
+    ins->image = *image;
+    ins->decodeOptions.customTypes = customTypes;
+
+    ins->ns.free = imageNsFree;
+    ins->ns.newNode = imageNsNewNode;
+    ins->ns.deleteNode = imageNsDeleteNode;
+    ins->ns.getNode = imageNsGetNode;
+    ins->ns.getNodeFromPtr = imageNsGetNodeFromPtr;
+    ins->ns.releaseNode = imageNsReleaseNode;
+    ins->ns.getNodeCopy = imageNsGetNodeCopy;
+    ins->ns.insertNode = imageNsInsertNode;
+    ins->ns.replaceNode = imageNsReplaceNode;
+    ins->ns.removeNode = imageNsRemoveNode;
+    ins->ns.getReferenceTypeId = imageNsGetReferenceTypeId;
+    ins->ns.iterate = imageNsIterate;
+
+    /* The nodes are edited in-situ in the overlay. GetEditNode is identical to
+     * GetNode -- but the Node pointer is non-const. */
+    ins->ns.getEditNode =
+        (UA_Node * (*)(UA_Nodestore *ns, const UA_NodeId *nodeId,
+                       UA_UInt32 attributeMask,
+                       UA_ReferenceTypeSet references,
+                       UA_BrowseDirection referenceDirections))imageNsGetNode;
+    ins->ns.getEditNodeFromPtr =
+        (UA_Node * (*)(UA_Nodestore *ns, UA_NodePointer ptr,
+                       UA_UInt32 attributeMask,
+                       UA_ReferenceTypeSet references,
+                       UA_BrowseDirection referenceDirections))imageNsGetNodeFromPtr;
+    return ins;
+}
+
+UA_Nodestore *
+UA_Nodestore_Image(const UA_ByteString *image,
+                   const UA_DataTypeArray *customTypes) {
+    ImageNodestore *ins = newImageNodestore(image, customTypes);
+    if(!ins)
+        return NULL;
+    if(openImage(ins) != UA_STATUSCODE_GOOD) {
+        imageNsFree(&ins->ns);
+        return NULL;
+    }
+    return &ins->ns;
+}
+
+#ifdef UA_ARCHITECTURE_POSIX
+UA_Nodestore *
+UA_Nodestore_ImageFile(const char *path,
+                       const UA_DataTypeArray *customTypes) {
+    int fd = open(path, O_RDONLY);
+    if(fd < 0)
+        return NULL;
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return NULL;
+    }
+
+    /* The pages are read-only and shared between processes mapping the same
+     * file */
+    UA_ByteString image;
+    image.length = (size_t)st.st_size;
+    image.data = (UA_Byte*)mmap(NULL, image.length, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(image.data == (UA_Byte*)MAP_FAILED)
+        return NULL;
+
+    ImageNodestore *ins = newImageNodestore(&image, customTypes);
+    if(!ins) {
+        munmap(image.data, image.length);
+        return NULL;
+    }
+    ins->mapped = true;
+    if(openImage(ins) != UA_STATUSCODE_GOOD) {
+        imageNsFree(&ins->ns);
+        return NULL;
+    }
+    return &ins->ns;
+}
+#endif
+
+UA_StatusCode
+UA_Nodestore_Image_addNamespaces(UA_Nodestore *ns, UA_Server *server) {
+    if(ns->free != imageNsFree)
+        return UA_STATUSCODE_BADINVALIDARGUMENT;
+    ImageNodestore *ins = (ImageNodestore*)ns;
+
+    UA_String *namespaces = NULL;
+    size_t namespacesSize = 0;
+    ImageReader r = {ins, ins->namespacesOffset};
+    UA_StatusCode res = readArray(&r, (void**)&namespaces, &namespacesSize,
+                                  &UA_TYPES[UA_TYPES_STRING]);
+
+    /* Namespace 0 and the application namespace 1 are always defined */
+    for(size_t i = 2; i < namespacesSize && res == UA_STATUSCODE_GOOD; i++) {
+        char *uri = (char*)UA_malloc(namespaces[i].length + 1);
+        if(!uri) {
+            res = UA_STATUSCODE_BADOUTOFMEMORY;
+            break;
+        }
+        memcpy(uri, namespaces[i].data, namespaces[i].length);
+        uri[namespaces[i].length] = 0;
+        if(UA_Server_addNamespace(server, uri) != i)
+            res = UA_STATUSCODE_BADINVALIDSTATE; /* The index does not match */
+        UA_free(uri);
+    }
+
+    UA_Array_delete(namespaces, namespacesSize, &UA_TYPES[UA_TYPES_STRING]);
+    return res;
+}
@@ -1955,7 +1955,8 @@ __Client_networkCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
         /* Abort after synchronous processing of a message.
          * Add a delayed callback to process the remaining buffer ASAP. */
         if(res == UA_STATUSCODE_GOODCOMPLETESASYNCHRONOUSLY) {
-            if(client->channel.unprocessed.length > client->channel.unprocessedOffset &&
+            if((client->channel.unprocessed.length > client->channel.unprocessedOffset ||
+                client->channel.unprocessedNext.length > 0) &&
                client->channel.unprocessedDelayed.callback == NULL) {
                 client->channel.unprocessedDelayed.callback = delayedNetworkCallback;
                 client->channel.unprocessedDelayed.application = client;
@@ -435,6 +435,11 @@ struct UA_DataSetReader {
 
     /* MessageReceiveTimeout handling */
     UA_UInt64 msgRcvTimeoutTimerId;
+
+    /* Layout of the received KeyFrames if all fields have a fixed-size type.
+     * Prepared while the reader is enabled. Empty (fieldsSize == 0)
+     * otherwise. */
+    UA_DataSetMessage_DecodePlan decodePlan;
 };
 
 UA_DataSetReader *
@@ -28,9 +28,39 @@ typedef struct {
     UA_PubSubOffsetTable *ot;
 } PubSubEncodeCtx;
 
+/* Precomputed layout of a DataSetMessage whose fields all have a fixed-size
+ * scalar type. KeyFrames in the RawData and Variant field encoding are then
+ * decoded at known offsets into a single allocation. */
+typedef struct {
+    const UA_DataType *rawType;     /* Type in the RawData encoding */
+    const UA_DataType *variantType; /* Builtin type in the Variant encoding */
+    size_t memOffset;               /* Position of the decoded value */
+} UA_DataSetMessage_DecodeField;
+
+typedef struct {
+    size_t fieldsSize;
+    UA_DataSetMessage_DecodeField *fields;
+    size_t rawSize;     /* Encoded size of the RawData payload */
+    size_t variantSize; /* Encoded size of the Variant payload with FieldCount */
+    size_t memSize;     /* Size of the DataValue array and the decoded values */
+} UA_DataSetMessage_DecodePlan;
+
+/* Returns UA_STATUSCODE_BADNOTSUPPORTED if a field does not have a fixed-size
+ * scalar type */
+UA_StatusCode
+UA_DataSetMessage_DecodePlan_init(UA_DataSetMessage_DecodePlan *plan,
+                                  const UA_FieldMetaData *fields, size_t fieldsSize,
+                                  const UA_DataTypeArray *customTypes);
+
+void
+UA_DataSetMessage_DecodePlan_clear(UA_DataSetMessage_DecodePlan *plan);
+
 typedef struct {
     Ctx ctx;
     UA_NetworkMessage_EncodingOptions eo;
+    /* Optional DecodePlans with the same indices as the eo.metaData. Entries
+     * can be NULL. */
+    const UA_DataSetMessage_DecodePlan **plans;
 } PubSubDecodeCtx;
 
 typedef struct {
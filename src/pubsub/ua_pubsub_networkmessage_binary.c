@@ -1443,20 +1443,28 @@ UA_DataSetMessage_encodeBinary(PubSubEncodeCtx *ctx,
     return UA_STATUSCODE_GOOD;
 }
 
+static const UA_DataType *
+getFieldDataType(const UA_FieldMetaData *fmd,
+                 const UA_DataTypeArray *customTypes) {
+    const UA_DataType *type =
+        UA_findDataTypeWithCustom(&fmd->dataType, customTypes);
+    if(type)
+        return type;
+    if(fmd->builtInType == 0 ||
+       fmd->builtInType > UA_DATATYPEKIND_DIAGNOSTICINFO + 1)
+        return NULL;
+    return &UA_TYPES[fmd->builtInType - 1];
+}
+
 static UA_StatusCode
 decodeRawField(PubSubDecodeCtx *ctx,
                const UA_FieldMetaData *fmd,
                UA_DataValue *value) {
     if(!fmd)
         return UA_STATUSCODE_BADDECODINGERROR;
-    const UA_DataType *type =
-        UA_findDataTypeWithCustom(&fmd->dataType, ctx->ctx.opts.customTypes);
-    if(!type) {
-        if(fmd->builtInType == 0 ||
-           fmd->builtInType > UA_DATATYPEKIND_DIAGNOSTICINFO + 1)
-            return UA_STATUSCODE_BADDECODINGERROR;
-        type = &UA_TYPES[fmd->builtInType - 1];
-    }
+    const UA_DataType *type = getFieldDataType(fmd, ctx->ctx.opts.customTypes);
+    if(!type)
+        return UA_STATUSCODE_BADDECODINGERROR;
 
     /* The ValueRank must be scalar or a defined dimensionality */
     if(fmd->valueRank < -1 || fmd->valueRank == 0)
@@ -1510,12 +1518,156 @@ decodeRawField(PubSubDecodeCtx *ctx,
     return rv;
 }
 
+/* Types whose binary encoding has the same size as the decoded value */
+static UA_Boolean
+isFixedSizeType(const UA_DataType *type) {
+    switch(type->typeKind) {
+    case UA_DATATYPEKIND_BOOLEAN:
+    case UA_DATATYPEKIND_SBYTE:
+    case UA_DATATYPEKIND_BYTE:
+    case UA_DATATYPEKIND_INT16:
+    case UA_DATATYPEKIND_UINT16:
+    case UA_DATATYPEKIND_INT32:
+    case UA_DATATYPEKIND_UINT32:
+    case UA_DATATYPEKIND_INT64:
+    case UA_DATATYPEKIND_UINT64:
+    case UA_DATATYPEKIND_FLOAT:
+    case UA_DATATYPEKIND_DOUBLE:
+    case UA_DATATYPEKIND_DATETIME:
+    case UA_DATATYPEKIND_GUID:
+    case UA_DATATYPEKIND_STATUSCODE:
+    case UA_DATATYPEKIND_ENUM:
+        return true;
+    default:
+        return false;
+    }
+}
+
+UA_StatusCode
+UA_DataSetMessage_DecodePlan_init(UA_DataSetMessage_DecodePlan *plan,
+                                  const UA_FieldMetaData *fields, size_t fieldsSize,
+                                  const UA_DataTypeArray *customTypes) {
+    memset(plan, 0, sizeof(UA_DataSetMessage_DecodePlan));
+    if(fieldsSize == 0 || fieldsSize > UA_UINT16_MAX)
+        return UA_STATUSCODE_BADNOTSUPPORTED;
+
+    plan->fields = (UA_DataSetMessage_DecodeField*)
+        UA_calloc(fieldsSize, sizeof(UA_DataSetMessage_DecodeField));
+    if(!plan->fields)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    plan->fieldsSize = fieldsSize;
+
+    /* The decoded values follow the array of DataValues. Each value is
+     * aligned to eight bytes. */
+    plan->variantSize = sizeof(UA_UInt16); /* FieldCount */
+    plan->memSize = fieldsSize * sizeof(UA_DataValue);
+    for(size_t i = 0; i < fieldsSize; i++) {
+        const UA_FieldMetaData *fmd = &fields[i];
+        const UA_DataType *type = getFieldDataType(fmd, customTypes);
+        if(!type || fmd->valueRank != -1 || !isFixedSizeType(type)) {
+            UA_DataSetMessage_DecodePlan_clear(plan);
+            return UA_STATUSCODE_BADNOTSUPPORTED;
+        }
+        UA_DataSetMessage_DecodeField *f = &plan->fields[i];
+        f->rawType = type;
+        f->variantType = (type->typeKind == UA_DATATYPEKIND_ENUM) ?
+            &UA_TYPES[UA_TYPES_INT32] : &UA_TYPES[type->typeKind];
+        f->memOffset = plan->memSize;
+        plan->memSize += (type->memSize + 7) & ~(size_t)7;
+        plan->rawSize += type->memSize;
+        plan->variantSize += 1 + type->memSize; /* EncodingMask + value */
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+void
+UA_DataSetMessage_DecodePlan_clear(UA_DataSetMessage_DecodePlan *plan) {
+    UA_free(plan->fields);
+    memset(plan, 0, sizeof(UA_DataSetMessage_DecodePlan));
+}
+
+/* Decode a KeyFrame at the offsets of the DecodePlan. The DataValues and the
+ * decoded values are put into a single allocation. The values are not freed
+ * separately (UA_VARIANT_DATA_NODELETE). Returns UA_STATUSCODE_BADNOTSUPPORTED
+ * without consuming the input if the message does not have the expected
+ * layout. */
+static UA_StatusCode
+decodeKeyFrameWithPlan(PubSubDecodeCtx *ctx,
+                       const UA_DataSetMessage_DecodePlan *plan,
+                       UA_DataSetMessage *dsm) {
+    UA_Boolean raw = (dsm->header.fieldEncoding == UA_FIELDENCODING_RAWDATA);
+    if(!raw && dsm->header.fieldEncoding != UA_FIELDENCODING_VARIANT)
+        return UA_STATUSCODE_BADNOTSUPPORTED;
+    size_t payloadSize = (raw) ? plan->rawSize : plan->variantSize;
+    if((size_t)(ctx->ctx.end - ctx->ctx.pos) < payloadSize)
+        return UA_STATUSCODE_BADNOTSUPPORTED;
+
+    /* Validate the FieldCount and the EncodingMask of the Variants */
+    UA_Byte *pos = ctx->ctx.pos;
+    if(!raw) {
+        UA_UInt16 fieldCount = (UA_UInt16)(pos[0] | (pos[1] << 8));
+        if(fieldCount != plan->fieldsSize)
+            return UA_STATUSCODE_BADNOTSUPPORTED;
+        pos += sizeof(UA_UInt16);
+        for(size_t i = 0; i < plan->fieldsSize; i++) {
+            const UA_DataType *type = plan->fields[i].variantType;
+            if(*pos != type->typeKind + 1)
+                return UA_STATUSCODE_BADNOTSUPPORTED;
+            pos += 1 + type->memSize;
+        }
+        pos = ctx->ctx.pos + sizeof(UA_UInt16);
+    }
+
+    UA_Byte *mem = (UA_Byte*)ctxCalloc(&ctx->ctx, 1, plan->memSize);
+    if(!mem)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    UA_DataValue *values = (UA_DataValue*)mem;
+
+    /* Decode the fields */
+    UA_StatusCode rv = UA_STATUSCODE_GOOD;
+    for(size_t i = 0; i < plan->fieldsSize; i++) {
+        const UA_DataSetMessage_DecodeField *f = &plan->fields[i];
+        const UA_DataType *type = (raw) ? f->rawType : f->variantType;
+        void *data = mem + f->memOffset;
+        values[i].hasValue = true;
+        values[i].value.type = type;
+        values[i].value.storageType = UA_VARIANT_DATA_NODELETE;
+        values[i].value.data = data;
+        if(!raw)
+            pos++; /* Skip the EncodingMask */
+        if(type->overlayable) {
+            memcpy(data, pos, type->memSize);
+            pos += type->memSize;
+        } else {
+            ctx->ctx.pos = pos;
+            rv |= decodeBinaryJumpTable[type->typeKind](&ctx->ctx, data, type);
+            pos = ctx->ctx.pos;
+        }
+    }
+    ctx->ctx.pos = pos;
+
+    dsm->fieldCount = (UA_UInt16)plan->fieldsSize;
+    dsm->data.keyFrameFields = values;
+    return rv;
+}
+
 static UA_StatusCode
 UA_DataSetMessage_keyFrame_decodeBinary(PubSubDecodeCtx *ctx,
                                         const UA_DataSetMessage_EncodingMetaData *emd,
                                         UA_DataSetMessage *dsm) {
     UA_StatusCode rv = UA_STATUSCODE_GOOD;
 
+    /* Fast path with the precomputed layout */
+    if(emd && ctx->plans) {
+        const UA_DataSetMessage_DecodePlan *plan = ctx->plans[emd - ctx->eo.metaData];
+        if(plan) {
+            rv = decodeKeyFrameWithPlan(ctx, plan, dsm);
+            if(rv != UA_STATUSCODE_BADNOTSUPPORTED)
+                return rv;
+            rv = UA_STATUSCODE_GOOD;
+        }
+    }
+
     /* Part 14: The FieldCount shall be omitted if RawData field encoding is set */
     if(dsm->header.fieldEncoding != UA_FIELDENCODING_RAWDATA) {
         rv = _DECODE_BINARY(&dsm->fieldCount, UINT16);
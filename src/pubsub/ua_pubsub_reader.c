@@ -380,6 +380,7 @@ UA_DataSetReader_remove(UA_PubSubManager *psm, UA_DataSetReader *dsr) {
 
     UA_LOG_INFO_PUBSUB(psm->logging, dsr, "DataSetReader deleted");
 
+    UA_DataSetMessage_DecodePlan_clear(&dsr->decodePlan);
     UA_DataSetReaderConfig_clear(&dsr->config);
     UA_PubSubComponentHead_clear(&dsr->head);
     UA_free(dsr);
@@ -428,6 +429,25 @@ UA_DataSetReaderConfig_clear(UA_DataSetReaderConfig *cfg) {
     }
 }
 
+/* The DecodePlan depends only on the DataSetMetaData. That cannot change while
+ * the reader is enabled. */
+static void
+UA_DataSetReader_updateDecodePlan(UA_PubSubManager *psm, UA_DataSetReader *dsr) {
+    if(!UA_PubSubState_isEnabled(dsr->head.state)) {
+        UA_DataSetMessage_DecodePlan_clear(&dsr->decodePlan);
+        return;
+    }
+    if(dsr->decodePlan.fieldsSize > 0)
+        return;
+    const UA_DataSetMetaDataType *md = &dsr->config.dataSetMetaData;
+    UA_StatusCode res =
+        UA_DataSetMessage_DecodePlan_init(&dsr->decodePlan, md->fields, md->fieldsSize,
+                                          psm->sc.server->config.customDataTypes);
+    if(res == UA_STATUSCODE_GOOD)
+        UA_LOG_DEBUG_PUBSUB(psm->logging, dsr, "KeyFrames with fixed-size fields "
+                            "are decoded with a precomputed layout");
+}
+
 UA_StatusCode
 UA_DataSetReader_setPubSubState(UA_PubSubManager *psm, UA_DataSetReader *dsr,
                                 UA_PubSubState targetState, UA_StatusCode errorReason) {
@@ -497,6 +517,8 @@ UA_DataSetReader_setPubSubState(UA_PubSubManager *psm, UA_DataSetReader *dsr,
     if(dsr->head.state == oldState)
         return res;
 
+    UA_DataSetReader_updateDecodePlan(psm, dsr);
+
     UA_LOG_INFO_PUBSUB(psm->logging, dsr, "%s -> %s",
                        UA_PubSubState_name(oldState),
                        UA_PubSubState_name(dsr->head.state));
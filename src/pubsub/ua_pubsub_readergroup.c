@@ -530,13 +530,16 @@ UA_ReaderGroup_decodeNetworkMessage(UA_PubSubManager *psm,
      * DataSetMessages */
     size_t i = 0;
     UA_STACKARRAY(UA_DataSetMessage_EncodingMetaData, emd, rg->readersCount);
+    UA_STACKARRAY(const UA_DataSetMessage_DecodePlan *, plans, rg->readersCount);
     memset(emd, 0, sizeof(UA_DataSetMessage_EncodingMetaData) * rg->readersCount);
     ctx.eo.metaData = emd;
     ctx.eo.metaDataSize = rg->readersCount;
+    ctx.plans = plans;
     LIST_FOREACH(dsr, &rg->readers, listEntry) {
         emd[i].dataSetWriterId = dsr->config.dataSetWriterId;
         emd[i].fields = dsr->config.dataSetMetaData.fields;
         emd[i].fieldsSize = dsr->config.dataSetMetaData.fieldsSize;
+        plans[i] = (dsr->decodePlan.fieldsSize > 0) ? &dsr->decodePlan : NULL;
         i++;
     }
 
@@ -760,7 +760,7 @@ copyCommonVariableAttributes(UA_VariableNode *node,
 
     /* Copy the value */
     node->valueSourceType = UA_VALUESOURCETYPE_INTERNAL;
-    retval = UA_Variant_copy(&attr->value, &node->valueSource.internal.value.value);
+    retval = UA_Variant_copyShared(&attr->value, &node->valueSource.internal.value.value);
     node->valueSource.internal.value.hasValue =
         (node->valueSource.internal.value.value.type != NULL);
 
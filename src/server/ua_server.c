@@ -1422,12 +1422,16 @@ UA_Server_run_shutdown(UA_Server *server) {
     UA_Server_run_iterate(server, true);
     lockServer(server);
 
-    /* Iterate the EventLoop until the server is stopped */
+    /* Iterate the EventLoop until the server is stopped. Release the server
+     * lock while iterating. The connections of the network EventLoops are
+     * closed from their own threads. */
     UA_StatusCode res = UA_STATUSCODE_GOOD;
     UA_EventLoop *el = server->config.eventLoop;
     while(!testStoppedCondition(server) &&
           res == UA_STATUSCODE_GOOD) {
+        unlockServer(server);
         res = el->run(el, 100);
+        lockServer(server);
     }
 
     /* Stop the EventLoop. Iterate until stopped. */
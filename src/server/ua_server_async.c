@@ -317,6 +317,7 @@ UA_AsyncManager_init(UA_AsyncManager *am, UA_Server *server) {
     TAILQ_INIT(&am->readyResponses);
     TAILQ_INIT(&am->waitingOps);
     TAILQ_INIT(&am->readyOps);
+    LIST_INIT(&am->pendingReads);
 }
 
 void UA_AsyncManager_start(UA_AsyncManager *am, UA_Server *server) {
@@ -349,6 +350,9 @@ UA_AsyncManager_clear(UA_AsyncManager *am, UA_Server *server) {
     /* This sends out/notifies and removes all direct operations and async requests */
     UA_AsyncManager_processReady(server, am);
     UA_assert(am->opsCount == 0);
+
+    /* Pending reads are always removed by the read that added them */
+    UA_assert(LIST_EMPTY(&am->pendingReads));
 }
 
 UA_UInt32
@@ -379,6 +383,34 @@ UA_AsyncManager_cancel(UA_Server *server, UA_Session *session, UA_UInt32 request
     return count;
 }
 
+UA_StatusCode
+async_addPendingRead(UA_Server *server, const UA_DataValue *value) {
+    UA_LOCK_ASSERT(&server->serviceMutex);
+    UA_PendingRead *pr = (UA_PendingRead*)UA_malloc(sizeof(UA_PendingRead));
+    if(!pr)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    pr->value = value;
+    pr->ready = false;
+    LIST_INSERT_HEAD(&server->asyncManager.pendingReads, pr, pointers);
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_Boolean
+async_removePendingRead(UA_Server *server, const UA_DataValue *value) {
+    UA_LOCK_ASSERT(&server->serviceMutex);
+    UA_PendingRead *pr;
+    LIST_FOREACH(pr, &server->asyncManager.pendingReads, pointers) {
+        if(pr->value == value)
+            break;
+    }
+    if(!pr)
+        return false;
+    UA_Boolean ready = pr->ready;
+    LIST_REMOVE(pr, pointers);
+    UA_free(pr);
+    return ready;
+}
+
 static void
 persistAsyncResponse(UA_Server *server, UA_Session *session,
                      void *response, UA_AsyncResponse *ar) {
@@ -386,9 +418,9 @@ persistAsyncResponse(UA_Server *server, UA_Session *session,
     UA_AsyncManager *am = &server->asyncManager;
 
     /* Pending results, attach the AsyncResponse to the AsyncManager. RequestId
-     * and -Handle are set in the AsyncManager before processing the request. */
-    ar->requestId = am->currentRequestId;
-    ar->requestHandle = am->currentRequestHandle;
+     * and -Handle are set in the Session before processing the request. */
+    ar->requestId = session->currentRequestId;
+    ar->requestHandle = session->currentRequestHandle;
     ar->sessionId = session->sessionId;
     ar->timeout = UA_INT64_MAX;
 
@@ -519,7 +551,7 @@ UA_Boolean
 Service_Read(UA_Server *server, UA_Session *session, const UA_ReadRequest *request,
              UA_ReadResponse *response) {
     UA_LOG_DEBUG_SESSION(server->config.logging, session, "Processing ReadRequest");
-    UA_LOCK_ASSERT(&server->serviceMutex);
+    UA_LOCK_ASSERT_READ(server);
 
     /* Check if the timestampstoreturn is valid */
     if(request->timestampsToReturn > UA_TIMESTAMPSTORETURN_NEITHER) {
@@ -559,25 +591,65 @@ Service_Read(UA_Server *server, UA_Session *session, const UA_ReadRequest *reque
     }
     response->resultsSize = request->nodesToReadSize;
 
-    /* Execute the operations */
+    /* Copy the values into the arena of the SecureChannel. The arena is reset
+     * after the response was sent. This avoids a heap allocation (and free)
+     * per value for the common case of scalars and numerical arrays. (The
+     * fuzzing build uses the heap to let the sanitizers see every
+     * allocation.) */
+    UA_Arena *arena = NULL;
+#ifndef FUZZING_BUILD_MODE_UNSAFE_FOR_PRODUCTION
+    if(session->channel)
+        arena = &session->channel->decodeArena;
+#endif
+
+    /* Execute the operations. The lock is taken for the first async operation
+     * and kept until the response is persisted. Otherwise a result could be
+     * set for an operation whose response is not yet enqueued. */
+    UA_Boolean locked = false;
     UA_AsyncResponse *ar = (UA_AsyncResponse*)&response->results[response->resultsSize];
     UA_AsyncOperation *aopArray = (UA_AsyncOperation*)&ar[1];
     for(size_t i = 0; i < request->nodesToReadSize; i++) {
         UA_Boolean done = Operation_Read(server, session, request->timestampsToReturn,
-                                         &request->nodesToRead[i], &response->results[i]);
-        if(!done)
-            persistAsyncResponseOperation(server, &aopArray[i],
-                                          UA_ASYNCOPERATIONTYPE_READ_REQUEST,
-                                          ar, &response->results[i]);
+                                         &request->nodesToRead[i], &response->results[i],
+                                         arena);
+        if(done)
+            continue;
+        if(!locked) {
+            lockServerInRead(server);
+            locked = true;
+        }
+        /* The result was already set after the callback returned */
+        if(async_removePendingRead(server, &response->results[i]))
+            continue;
+        persistAsyncResponseOperation(server, &aopArray[i],
+                                      UA_ASYNCOPERATIONTYPE_READ_REQUEST,
+                                      ar, &response->results[i]);
     }
 
     /* If async operations are pending, persist them and signal the service is
      * not done */
     if(ar->opCountdown > 0) {
+        /* The response outlives the arena. Move the values to the heap. */
+        for(size_t i = 0; arena && i < response->resultsSize; i++) {
+            UA_DataValue *dv = &response->results[i];
+            if(dv->value.storageType != UA_VARIANT_DATA_NODELETE)
+                continue;
+            UA_DataValue tmp;
+            UA_StatusCode res = UA_DataValue_copy(dv, &tmp);
+            if(res != UA_STATUSCODE_GOOD) {
+                UA_DataValue_init(&tmp);
+                tmp.hasStatus = true;
+                tmp.status = res;
+            }
+            *dv = tmp;
+        }
         ar->responseType = &UA_TYPES[UA_TYPES_READRESPONSE];
         persistAsyncResponse(server, session, response, ar);
     }
-    return (ar->opCountdown == 0);
+    UA_Boolean done = (ar->opCountdown == 0);
+    if(locked)
+        unlockServerInRead(server);
+    return done;
 }
 
 UA_StatusCode
@@ -598,10 +670,21 @@ read_async(UA_Server *server, UA_Session *session, const UA_ReadValueId *operati
     }
 
     /* Call the operation */
-    UA_Boolean done = Operation_Read(server, session, ttr, operation, &op->output.directRead);
-    if(!done)
-        return persistAsyncDirectOperation(server, op, UA_ASYNCOPERATIONTYPE_READ_DIRECT,
-                                           context, (uintptr_t)callback, timeoutDate);
+    UA_Boolean done = Operation_Read(server, session, ttr, operation,
+                                     &op->output.directRead, NULL);
+    if(!done) {
+        lockServerInRead(server);
+        done = async_removePendingRead(server, &op->output.directRead);
+        UA_StatusCode res = UA_STATUSCODE_GOOD;
+        if(!done)
+            res = persistAsyncDirectOperation(server, op,
+                                              UA_ASYNCOPERATIONTYPE_READ_DIRECT,
+                                              context, (uintptr_t)callback,
+                                              timeoutDate);
+        unlockServerInRead(server);
+        if(!done)
+            return res;
+    }
 
     callback(server, context, &op->output.directRead);
     UA_DataValue_clear(&op->output.directRead);
@@ -631,8 +714,19 @@ UA_Server_setAsyncReadResult(UA_Server *server, UA_DataValue *result) {
             break;
         }
     }
+
+    /* The read callback has returned but the operation is not yet persisted */
+    UA_PendingRead *pr = NULL;
+    if(!op) {
+        LIST_FOREACH(pr, &am->pendingReads, pointers) {
+            if(pr->value == result) {
+                pr->ready = true;
+                break;
+            }
+        }
+    }
     unlockServer(server);
-    return (op) ? UA_STATUSCODE_GOOD : UA_STATUSCODE_BADNOTFOUND;
+    return (op || pr) ? UA_STATUSCODE_GOOD : UA_STATUSCODE_BADNOTFOUND;
 }
 
 /*********/
@@ -94,12 +94,17 @@ struct UA_AsyncResponse {
     } response;
 };
 
-typedef struct {
-    /* Forward the request id here as the "UA_Service" method signature does not
-     * contain it */
-    UA_UInt32 currentRequestId;
-    UA_UInt32 currentRequestHandle;
+/* An async read callback has returned, but the operation is not yet persisted.
+ * With a concurrentRead Nodestore the server lock is released in between. A
+ * result that is set in the meantime is remembered until the operation is
+ * persisted. */
+typedef struct UA_PendingRead {
+    LIST_ENTRY(UA_PendingRead) pointers;
+    const UA_DataValue *value;
+    UA_Boolean ready;
+} UA_PendingRead;
 
+typedef struct {
     /* Async responses */
     TAILQ_HEAD(, UA_AsyncResponse) waitingResponses;
     TAILQ_HEAD(, UA_AsyncResponse) readyResponses;
@@ -109,6 +114,8 @@ typedef struct {
     TAILQ_HEAD(, UA_AsyncOperation) readyOps;
     size_t opsCount; /* Both waiting and ready */
 
+    LIST_HEAD(, UA_PendingRead) pendingReads;
+
     UA_UInt64 checkTimeoutCallbackId; /* Registered repeated callbacks */
 
     UA_DelayedCallback dc; /* Delayed callback to have the main thread handle
@@ -140,6 +147,15 @@ UA_StatusCode
 call_async(UA_Server *server, UA_Session *session, const UA_CallMethodRequest *operation,
            UA_ServerAsyncMethodResultCallback callback, void *context, UA_UInt32 timeout);
 
+/* Register the output of an async read callback before the server lock is
+ * released. Remove it again when the operation is persisted (or abandoned).
+ * Returns whether the result was already set in between. */
+UA_StatusCode
+async_addPendingRead(UA_Server *server, const UA_DataValue *value);
+
+UA_Boolean
+async_removePendingRead(UA_Server *server, const UA_DataValue *value);
+
 void
 async_cancel(UA_Server *server, void *context, UA_StatusCode status,
              UA_Boolean cancelSynchronous);
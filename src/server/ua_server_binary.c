@@ -104,6 +104,23 @@ setBinaryProtocolManagerState(UA_BinaryProtocolManager *bpm,
         bpm->sc.notifyState(&bpm->sc, state);
 }
 
+#if UA_MULTITHREADING >= 100
+/* The SecureChannel was accepted by one of the additional network EventLoops.
+ * Messages are received only in the thread of that EventLoop. Sending from
+ * other threads is serialized with the lock of the SecureChannel. */
+UA_Boolean
+isNetworkLoopChannel(UA_Server *server, const UA_SecureChannel *channel) {
+    if(!channel->connectionManager)
+        return false;
+    UA_EventLoop *el = channel->connectionManager->eventSource.eventLoop;
+    for(size_t i = 0; i < server->config.networkEventLoopsSize; i++) {
+        if(server->config.networkEventLoops[i] == el)
+            return true;
+    }
+    return false;
+}
+#endif
+
 static void
 deleteServerSecureChannel(UA_BinaryProtocolManager *bpm,
                           UA_SecureChannel *channel) {
@@ -159,6 +176,7 @@ deleteServerSecureChannel(UA_BinaryProtocolManager *bpm,
     /* Clean up the SecureChannel. This is the only place where
      * UA_SecureChannel_clear must be called within the server code-base. */
     UA_SecureChannel_clear(channel);
+    UA_LOCK_DESTROY(&channel->lock);
     UA_free(channel);
 }
 
@@ -181,8 +199,11 @@ sendServiceFault(UA_Server *server, UA_SecureChannel *channel,
 
     /* Send error message. Message type is MSG and not ERR, since we are on a
      * SecureChannel! */
-    return UA_SecureChannel_sendMSG(channel, requestId, &response,
-                                    &UA_TYPES[UA_TYPES_SERVICEFAULT]);
+    UA_LOCK(&channel->lock);
+    UA_StatusCode res = UA_SecureChannel_sendMSG(channel, requestId, &response,
+                                                 &UA_TYPES[UA_TYPES_SERVICEFAULT]);
+    UA_UNLOCK(&channel->lock);
+    return res;
 }
 
 /* This is not an ERR message, the connection is not closed afterwards */
@@ -193,8 +214,8 @@ decodeHeaderSendServiceFault(UA_Server *server, UA_SecureChannel *channel,
                              UA_StatusCode error) {
     UA_RequestHeader requestHeader;
     UA_StatusCode retval =
-        UA_decodeBinaryInternal(msg, &offset, &requestHeader,
-                                &UA_TYPES[UA_TYPES_REQUESTHEADER], NULL);
+        UA_SecureChannel_decodeMessage(channel, msg, offset, &requestHeader,
+                                       &UA_TYPES[UA_TYPES_REQUESTHEADER], NULL);
     if(retval != UA_STATUSCODE_GOOD)
         return retval;
     retval = sendServiceFault(server, channel, requestId,
@@ -322,7 +343,9 @@ processOPN(UA_Server *server, UA_SecureChannel *channel,
     /* Call the service */
     UA_OpenSecureChannelResponse openScResponse;
     UA_OpenSecureChannelResponse_init(&openScResponse);
+    UA_LOCK(&channel->lock); /* A renewal replaces the nonces and the token */
     Service_OpenSecureChannel(server, channel, &openSecureChannelRequest, &openScResponse);
+    UA_UNLOCK(&channel->lock);
     UA_OpenSecureChannelRequest_clear(&openSecureChannelRequest);
     if(openScResponse.responseHeader.serviceResult != UA_STATUSCODE_GOOD) {
         UA_LOG_WARNING_CHANNEL(server->config.logging, channel,
@@ -332,9 +355,21 @@ processOPN(UA_Server *server, UA_SecureChannel *channel,
         return openScResponse.responseHeader.serviceResult;
     }
 
-    /* Send the response */
+    /* Send the response. Sign and encrypt without the server lock if the
+     * channel is not served from the main EventLoop. */
+#if UA_MULTITHREADING >= 100
+    UA_Boolean unlocked = isNetworkLoopChannel(server, channel);
+    if(unlocked)
+        unlockServer(server);
+#endif
+    UA_LOCK(&channel->lock);
     retval = UA_SecureChannel_sendOPN(channel, requestId, &openScResponse,
                                       &UA_TYPES[UA_TYPES_OPENSECURECHANNELRESPONSE]);
+    UA_UNLOCK(&channel->lock);
+#if UA_MULTITHREADING >= 100
+    if(unlocked)
+        lockServer(server);
+#endif
     UA_OpenSecureChannelResponse_clear(&openScResponse);
     if(retval != UA_STATUSCODE_GOOD) {
         UA_LOG_WARNING_CHANNEL(server->config.logging, channel,
@@ -364,10 +399,13 @@ sendResponse(UA_Server *server, UA_SecureChannel *channel, UA_UInt32 requestId,
     response->responseHeader.timestamp = el->dateTime_now(el);
 
     /* Start the message context */
+    UA_LOCK(&channel->lock);
     UA_MessageContext mc;
     UA_StatusCode retval = UA_MessageContext_begin(&mc, channel, requestId, UA_MESSAGETYPE_MSG);
-    if(retval != UA_STATUSCODE_GOOD)
+    if(retval != UA_STATUSCODE_GOOD) {
+        UA_UNLOCK(&channel->lock);
         return retval;
+    }
 
     /* Assert's required for clang-analyzer */
     UA_assert(mc.buf_pos == &mc.messageBuffer.data[UA_SECURECHANNEL_SYMMETRIC_HEADER_TOTALLENGTH]);
@@ -376,16 +414,16 @@ sendResponse(UA_Server *server, UA_SecureChannel *channel, UA_UInt32 requestId,
     /* Encode the response type */
     retval = UA_MessageContext_encode(&mc, &responseType->binaryEncodingId,
                                       &UA_TYPES[UA_TYPES_NODEID]);
-    if(retval != UA_STATUSCODE_GOOD)
-        return retval;
 
     /* Encode the response */
-    retval = UA_MessageContext_encode(&mc, response, responseType);
-    if(retval != UA_STATUSCODE_GOOD)
-        return retval;
+    if(retval == UA_STATUSCODE_GOOD)
+        retval = UA_MessageContext_encode(&mc, response, responseType);
 
     /* Finish / send out */
-    return UA_MessageContext_finish(&mc);
+    if(retval == UA_STATUSCODE_GOOD)
+        retval = UA_MessageContext_finish(&mc);
+    UA_UNLOCK(&channel->lock);
+    return retval;
 }
 
 /* A Session is "bound" to a SecureChannel if it was created by the
@@ -428,13 +466,11 @@ getBoundSession(UA_Server *server, const UA_SecureChannel *channel,
         UA_STATUSCODE_BADSESSIONIDINVALID;
 }
 
+/* Decoding and encoding/sending is done without the server lock. The MSG chunks
+ * were validated for an open SecureChannel. */
 static UA_StatusCode
 processMSG(UA_Server *server, UA_SecureChannel *channel,
            UA_UInt32 requestId, const UA_ByteString *msg) {
-    UA_LOCK_ASSERT(&server->serviceMutex);
-
-    if(channel->state != UA_SECURECHANNELSTATE_OPEN)
-        return UA_STATUSCODE_BADINTERNALERROR;
     /* Decode the nodeid */
     size_t offset = 0;
     UA_NodeId requestTypeId;
@@ -465,16 +501,34 @@ processMSG(UA_Server *server, UA_SecureChannel *channel,
 
     /* Decode the request */
     UA_Request request;
-    size_t requestPos = offset; /* Store the offset (for sendServiceFault) */
     UA_DecodeBinaryOptions opt;
     memset(&opt, 0, sizeof(UA_DecodeBinaryOptions));
     opt.customTypes = server->config.customDataTypes;
-    retval = UA_decodeBinaryInternal(msg, &offset, &request, sd->requestType, &opt);
+#ifndef FUZZING_BUILD_MODE_UNSAFE_FOR_PRODUCTION
+    /* Decode into the arena of the SecureChannel. The request is released at
+     * once with an arena reset instead of freeing every member. (The fuzzing
+     * build modifies the request in-place and uses the heap to let the
+     * sanitizers see every allocation.)
+     *
+     * Strings, ByteStrings and overlayable arrays are borrowed from the message
+     * buffer. Large requests are decoded directly from their chunks. The
+     * SecureChannel keeps the buffer and chunks until processMSG returns. So
+     * the request stays valid until the response is sent. Async operations
+     * copy their part of the request. */
+    opt.calloc = UA_Arena_calloc;
+    opt.callocContext = &channel->decodeArena;
+    opt.borrowBuffer = true;
+#endif
+    retval = UA_SecureChannel_decodeMessage(channel, msg, offset, &request,
+                                            sd->requestType, &opt);
     if(retval != UA_STATUSCODE_GOOD) {
         UA_LOG_DEBUG_CHANNEL(server->config.logging, channel,
                              "Could not decode the request with StatusCode %s",
                              UA_StatusCode_name(retval));
-        return decodeHeaderSendServiceFault(server, channel, msg, requestPos,
+#ifndef FUZZING_BUILD_MODE_UNSAFE_FOR_PRODUCTION
+        UA_Arena_reset(&channel->decodeArena);
+#endif
+        return decodeHeaderSendServiceFault(server, channel, msg, offset,
                                             sd->responseType, requestId, retval);
     }
 
@@ -483,39 +537,49 @@ processMSG(UA_Server *server, UA_SecureChannel *channel,
     UA_init(&response, sd->responseType);
     response.responseHeader.requestHandle = request.requestHeader.requestHandle;
 
+    /* Process the request. The SecureChannel might have been shut down by
+     * another thread in the meantime. */
+    UA_Boolean done = true;
     lockServer(server);
-
-    /* Process the request */
-    UA_Boolean done = processRequest(server, channel, requestId, sd, &request, &response);
+    if(UA_LIKELY(channel->state == UA_SECURECHANNELSTATE_OPEN))
+        done = processRequest(server, channel, requestId, sd, &request, &response);
+    else
+        retval = UA_STATUSCODE_BADINTERNALERROR;
+    unlockServer(server);
 
     /* Send response if not async */
-    if(UA_LIKELY(done))
+    if(UA_LIKELY(retval == UA_STATUSCODE_GOOD && done))
         retval = sendResponse(server, channel, requestId, &response, sd->responseType);
 
-    unlockServer(server);
-
     /* Clean up */
+#ifndef FUZZING_BUILD_MODE_UNSAFE_FOR_PRODUCTION
+    UA_Arena_reset(&channel->decodeArena);
+#else
     UA_clear(&request, sd->requestType);
+#endif
     UA_clear(&response, sd->responseType);
     return retval;
 }
 
-/* Takes decoded messages starting at the nodeid of the content type. */
+/* Takes decoded messages starting at the nodeid of the content type. The
+ * server lock is taken as needed. MSG messages are processed mostly without. */
 static UA_StatusCode
 processSecureChannelMessage(UA_Server *server, UA_SecureChannel *channel,
                             UA_MessageType messagetype, UA_UInt32 requestId,
                             UA_ByteString *message) {
-    UA_LOCK_ASSERT(&server->serviceMutex);
-
     UA_StatusCode retval = UA_STATUSCODE_GOOD;
     switch(messagetype) {
     case UA_MESSAGETYPE_HEL:
         UA_LOG_TRACE_CHANNEL(server->config.logging, channel, "Process a HEL message");
+        lockServer(server);
         retval = processHEL(server, channel, message);
+        unlockServer(server);
         break;
     case UA_MESSAGETYPE_OPN:
         UA_LOG_TRACE_CHANNEL(server->config.logging, channel, "Process an OPN message");
+        lockServer(server);
         retval = processOPN(server, channel, requestId, message);
+        unlockServer(server);
         break;
     case UA_MESSAGETYPE_MSG:
         UA_LOG_TRACE_CHANNEL(server->config.logging, channel, "Process a MSG");
@@ -523,21 +587,24 @@ processSecureChannelMessage(UA_Server *server, UA_SecureChannel *channel,
         break;
     case UA_MESSAGETYPE_CLO:
         UA_LOG_TRACE_CHANNEL(server->config.logging, channel, "Process a CLO");
+        lockServer(server);
         Service_CloseSecureChannel(server, channel); /* Regular close */
+        unlockServer(server);
         break;
     default:
         UA_LOG_TRACE_CHANNEL(server->config.logging, channel, "Invalid message type");
         retval = UA_STATUSCODE_BADTCPMESSAGETYPEINVALID;
         break;
     }
-    if(retval != UA_STATUSCODE_GOOD) {
-        if(!UA_SecureChannel_isConnected(channel)) {
-            UA_LOG_INFO_CHANNEL(server->config.logging, channel,
-                                "Processing the message failed. Channel already closed "
-                                "with StatusCode %s. ", UA_StatusCode_name(retval));
-            return retval;
-        }
+    if(retval == UA_STATUSCODE_GOOD)
+        return retval;
 
+    lockServer(server);
+    if(!UA_SecureChannel_isConnected(channel)) {
+        UA_LOG_INFO_CHANNEL(server->config.logging, channel,
+                            "Processing the message failed. Channel already closed "
+                            "with StatusCode %s. ", UA_StatusCode_name(retval));
+    } else {
         UA_LOG_INFO_CHANNEL(server->config.logging, channel,
                             "Processing the message failed with StatusCode %s. "
                             "Closing the channel.", UA_StatusCode_name(retval));
@@ -561,7 +628,7 @@ processSecureChannelMessage(UA_Server *server, UA_SecureChannel *channel,
         }
         UA_SecureChannel_shutdown(channel, reason);
     }
-
+    unlockServer(server);
     return retval;
 }
 
@@ -634,9 +701,11 @@ createServerSecureChannel(UA_BinaryProtocolManager *bpm, UA_ConnectionManager *c
 
     /* Set up the new SecureChannel */
     UA_SecureChannel_init(channel);
+    UA_LOCK_INIT(&channel->lock);
     channel->config = connConfig;
     channel->processOPNHeader = processOPN_AsymHeader;
     channel->processOPNHeaderApplication = server;
+    channel->streamMessages = true; /* Decode requests directly from the chunks */
     channel->connectionManager = cm;
     channel->connectionId = connectionId;
 
@@ -864,12 +933,97 @@ serverNetworkCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
     unlockServer(bpm->sc.server);
 }
 
-static UA_StatusCode
-createServerConnection(UA_BinaryProtocolManager *bpm, const UA_String *serverUrl) {
+#if UA_MULTITHREADING >= 100
+/* Callback of a TCP socket of one of the additional network EventLoops. This is
+ * called from the thread of the network EventLoop. Other threads send on the
+ * SecureChannels while holding the lock of the SecureChannel. The mutex of the
+ * network EventLoop is taken for sending. So it is released before the server
+ * lock and the SecureChannel lock are taken. */
+static void
+networkLoopCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
+                    void *application, void **connectionContext,
+                    UA_ConnectionState state, const UA_KeyValueMap *params,
+                    UA_ByteString msg) {
+    UA_BinaryProtocolManager *bpm = (UA_BinaryProtocolManager*)application;
     UA_Server *server = bpm->sc.server;
-    UA_ServerConfig *config = &server->config;
+    UA_EventLoop *el = cm->eventSource.eventLoop;
+    el->unlock(el);
+    lockServer(server);
 
-    UA_LOCK_ASSERT(&server->serviceMutex);
+    /* Registering server sockets, accepting and closing connections use the
+     * common (locked) path */
+    UA_ServerConnection *sc = (UA_ServerConnection*)*connectionContext;
+    UA_SecureChannel *channel = (UA_SecureChannel*)*connectionContext;
+    if(!channel || state != UA_CONNECTIONSTATE_ESTABLISHED ||
+       (sc >= bpm->serverConnections &&
+        sc < &bpm->serverConnections[UA_MAXSERVERCONNECTIONS])) {
+        serverNetworkCallbackLocked(cm, connectionId, application,
+                                    connectionContext, state, params, msg);
+        unlockServer(server);
+        el->lock(el);
+        return;
+    }
+    unlockServer(server);
+
+    /* Reassemble, decrypt and verify the chunks without the server lock. Only
+     * this thread receives on the channel and frees it (in the closing
+     * callback). The lock of the SecureChannel is held while the chunks are
+     * processed, as a SecurityToken rollover changes the keys for sending.
+     * Until the SecurityPolicy is set, no other thread sends on the channel.
+     * And the first OPN header is processed with the server lock (which must
+     * not be taken after the lock of the SecureChannel). The SecurityToken
+     * lifetime is checked against the clock of the server EventLoop. The
+     * messages are processed with the server lock taken only where required.
+     * So the requests of Sessions on different network EventLoops are
+     * processed in parallel. */
+    UA_EventLoop *sel = server->config.eventLoop;
+    UA_DateTime nowMonotonic = sel->dateTime_nowMonotonic(sel);
+    UA_StatusCode retval = UA_SecureChannel_loadBuffer(channel, msg);
+    while(UA_LIKELY(retval == UA_STATUSCODE_GOOD)) {
+        UA_MessageType messageType;
+        UA_UInt32 requestId = 0;
+        UA_ByteString payload = UA_BYTESTRING_NULL;
+        UA_Boolean copied = false;
+        UA_Boolean channelLocked = (channel->securityPolicy != NULL);
+        if(channelLocked)
+            UA_LOCK(&channel->lock);
+        retval = UA_SecureChannel_getCompleteMessage(channel, &messageType, &requestId,
+                                                     &payload, &copied, nowMonotonic);
+        if(channelLocked)
+            UA_UNLOCK(&channel->lock);
+        if(retval != UA_STATUSCODE_GOOD || payload.length == 0)
+            break;
+        retval = processSecureChannelMessage(server, channel, messageType,
+                                             requestId, &payload);
+        if(copied)
+            UA_ByteString_clear(&payload);
+    }
+    retval |= UA_SecureChannel_persistBuffer(channel);
+
+    if(retval != UA_STATUSCODE_GOOD) {
+        lockServer(server);
+        UA_LOG_WARNING_CHANNEL(bpm->logging, channel,
+                               "Processing the message failed with error %s",
+                               UA_StatusCode_name(retval));
+
+        /* Send an ERR message and close the connection */
+        UA_TcpErrorMessage error;
+        error.error = retval;
+        error.reason = UA_STRING_NULL;
+        UA_SecureChannel_sendERR(channel, &error);
+        UA_SecureChannel_shutdown(channel, UA_SHUTDOWNREASON_ABORT);
+        unlockServer(server);
+    }
+
+    el->lock(el);
+}
+#endif
+
+static UA_StatusCode
+createServerConnection(UA_BinaryProtocolManager *bpm, UA_EventLoop *el,
+                       UA_ConnectionManager_connectionCallback callback,
+                       UA_Boolean reuse, const UA_String *serverUrl) {
+    UA_LOCK_ASSERT(&bpm->sc.server->serviceMutex);
 
     /* Extract the protocol, hostname and port from the url */
     UA_String hostname = UA_STRING_NULL;
@@ -880,8 +1034,7 @@ createServerConnection(UA_BinaryProtocolManager *bpm, const UA_String *serverUrl
         return res;
 
     UA_String tcpString = UA_STRING("tcp");
-    for(UA_EventSource *es = config->eventLoop->eventSources;
-        es != NULL; es = es->next) {
+    for(UA_EventSource *es = el->eventSources; es != NULL; es = es->next) {
         /* Is this a usable connection manager? */
         if(es->eventSourceType != UA_EVENTSOURCETYPE_CONNECTIONMANAGER)
             continue;
@@ -900,9 +1053,8 @@ createServerConnection(UA_BinaryProtocolManager *bpm, const UA_String *serverUrl
         params[1].key = UA_QUALIFIEDNAME(0, "listen");
         UA_Variant_setScalar(&params[1].value, &listen, &UA_TYPES[UA_TYPES_BOOLEAN]);
 
-        UA_Boolean reuseaddr = config->tcpReuseAddr;
         params[2].key = UA_QUALIFIEDNAME(0, "reuse");
-        UA_Variant_setScalar(&params[2].value, &reuseaddr, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        UA_Variant_setScalar(&params[2].value, &reuse, &UA_TYPES[UA_TYPES_BOOLEAN]);
 
         /* The hostname is non-empty */
         if(hostname.length > 0) {
@@ -916,7 +1068,7 @@ createServerConnection(UA_BinaryProtocolManager *bpm, const UA_String *serverUrl
         paramsMap.mapSize = paramsSize;
 
         /* Open the server connection */
-        res = cm->openConnection(cm, &paramsMap, bpm, NULL, serverNetworkCallback);
+        res = cm->openConnection(cm, &paramsMap, bpm, NULL, callback);
         if(res == UA_STATUSCODE_GOOD)
             return res;
     }
@@ -935,11 +1087,14 @@ secureChannelHouseKeeping(UA_Server *server, void *context) {
 
     UA_SecureChannel *channel;
     TAILQ_FOREACH(channel, &bpm->channels, componentEntry) {
+        /* The SecurityToken rollover changes the keys of the channel */
+        UA_LOCK(&channel->lock);
         UA_Boolean timeout = UA_SecureChannel_checkTimeout(channel, nowMonotonic);
         if(timeout) {
             UA_LOG_INFO_CHANNEL(bpm->logging, channel, "SecureChannel has timed out");
             UA_SecureChannel_shutdown(channel, UA_SHUTDOWNREASON_TIMEOUT);
         }
+        UA_UNLOCK(&channel->lock);
     }
     unlockServer(server);
 }
@@ -1359,24 +1514,58 @@ UA_BinaryProtocolManager_start(UA_ServerComponent *sc, UA_Server *server) {
     if(retVal != UA_STATUSCODE_GOOD)
         return retVal;
 
+    /* The listen sockets of the network EventLoops share the port */
+    UA_Boolean reuse = config->tcpReuseAddr;
+#if UA_MULTITHREADING >= 100
+    if(config->networkEventLoopsSize > 0)
+        reuse = true;
+#endif
+
     /* Open server sockets */
     UA_Boolean haveServerSocket = false;
-    if(config->serverUrlsSize == 0) {
+    UA_String defaultUrl = UA_STRING("opc.tcp://:4840");
+    const UA_String *serverUrls = config->serverUrls;
+    size_t serverUrlsSize = config->serverUrlsSize;
+    if(serverUrlsSize == 0) {
         /* Empty hostname -> listen on all devices */
         UA_LOG_WARNING(config->logging, UA_LOGCATEGORY_SERVER,
                        "No Server URL configured. Using \"opc.tcp://:4840\" "
                        "to configure the listen socket.");
-        UA_String defaultUrl = UA_STRING("opc.tcp://:4840");
-        retVal = createServerConnection(bpm, &defaultUrl);
+        serverUrls = &defaultUrl;
+        serverUrlsSize = 1;
+    }
+    for(size_t i = 0; i < serverUrlsSize; i++) {
+        retVal = createServerConnection(bpm, config->eventLoop, serverNetworkCallback,
+                                        reuse, &serverUrls[i]);
         if(retVal == UA_STATUSCODE_GOOD)
             haveServerSocket = true;
-    } else {
-        for(size_t i = 0; i < config->serverUrlsSize; i++) {
-            retVal = createServerConnection(bpm, &config->serverUrls[i]);
-            if(retVal == UA_STATUSCODE_GOOD)
-                haveServerSocket = true;
+    }
+
+#if UA_MULTITHREADING >= 100
+    /* Open the listen sockets of the network EventLoops */
+    for(size_t i = 0; i < config->networkEventLoopsSize; i++) {
+        UA_EventLoop *nel = config->networkEventLoops[i];
+        if(nel->state == UA_EVENTLOOPSTATE_FRESH ||
+           nel->state == UA_EVENTLOOPSTATE_STOPPED) {
+            retVal = nel->start(nel);
+            if(retVal != UA_STATUSCODE_GOOD) {
+                UA_LOG_WARNING(config->logging, UA_LOGCATEGORY_SERVER,
+                               "Could not start the network EventLoop %u",
+                               (unsigned)i);
+                continue;
+            }
+        }
+        for(size_t j = 0; j < serverUrlsSize; j++) {
+            retVal = createServerConnection(bpm, nel, networkLoopCallback,
+                                            true, &serverUrls[j]);
+            if(retVal != UA_STATUSCODE_GOOD)
+                UA_LOG_WARNING(config->logging, UA_LOGCATEGORY_SERVER,
+                               "Could not open the server socket %S "
+                               "in the network EventLoop %u",
+                               serverUrls[j], (unsigned)i);
         }
     }
+#endif
 
     if(!haveServerSocket) {
         UA_LOG_ERROR(config->logging, UA_LOGCATEGORY_SERVER,
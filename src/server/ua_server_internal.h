@@ -187,6 +187,11 @@ getServerComponentByName(UA_Server *server, UA_String name);
 typedef struct session_list_entry {
     UA_DelayedCallback cleanupCallback;
     LIST_ENTRY(session_list_entry) pointers;
+#if UA_MULTITHREADING >= 100
+    size_t pins; /* Services executed without the server lock for the Session.
+                  * The memory is not freed while the Session is pinned. */
+    UA_Boolean closeDeferred; /* AccessControl closeSession not yet called */
+#endif
     UA_Session session;
 } session_list_entry;
 
@@ -465,6 +470,12 @@ UA_StatusCode
 sendResponse(UA_Server *server, UA_SecureChannel *channel, UA_UInt32 requestId,
              UA_Response *response, const UA_DataType *responseType);
 
+#if UA_MULTITHREADING >= 100
+/* The SecureChannel is served by one of the configured network EventLoops */
+UA_Boolean
+isNetworkLoopChannel(UA_Server *server, const UA_SecureChannel *channel);
+#endif
+
 typedef void (*UA_ServiceOperation)(UA_Server *server, UA_Session *session,
                                     const void *context,
                                     const void *requestOperation,
@@ -492,6 +503,44 @@ allocProcessServiceOperations(UA_Server *server, UA_Session *session,
 void lockServer(UA_Server *server);
 void unlockServer(UA_Server *server);
 
+/* If the Nodestore supports concurrent readers, then the Read, Browse and
+ * TranslateBrowsePathsToNodeIds operations of the local API run without the
+ * server lock. The lock is then taken only around user-defined callbacks and
+ * changes to the server state (e.g. persisting a ContinuationPoint). */
+static UA_INLINE void
+lockServerRead(UA_Server *server) {
+    if(!server->config.nodestore->concurrentRead)
+        lockServer(server);
+}
+
+static UA_INLINE void
+unlockServerRead(UA_Server *server) {
+    if(!server->config.nodestore->concurrentRead)
+        unlockServer(server);
+}
+
+/* Take the lock within a read operation. The lock is already held if the
+ * Nodestore does not support concurrent readers. */
+static UA_INLINE void
+lockServerInRead(UA_Server *server) {
+    if(server->config.nodestore->concurrentRead)
+        lockServer(server);
+}
+
+static UA_INLINE void
+unlockServerInRead(UA_Server *server) {
+    if(server->config.nodestore->concurrentRead)
+        unlockServer(server);
+}
+
+#if UA_MULTITHREADING >= 100
+# define UA_LOCK_ASSERT_READ(server)                                \
+    UA_assert((server)->config.nodestore->concurrentRead ||         \
+              (server)->serviceMutex.count > 0)
+#else
+# define UA_LOCK_ASSERT_READ(server)
+#endif
+
 /******************************************/
 /* Internal function calls, without locks */
 /******************************************/
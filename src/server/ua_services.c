@@ -29,14 +29,18 @@ UA_NodeId unsafe_fuzz_authenticationToken = {0, UA_NODEIDTYPE_NUMERIC, {0}};
 #endif
 
 /* The counterOffset is the offset of the UA_ServiceCounterDataType for the
- * service in the UA_ SessionDiagnosticsDataType. */
+ * service in the UA_ SessionDiagnosticsDataType. The _CONCURRENT variant marks
+ * services that only read from the information model. */
 #ifdef UA_ENABLE_DIAGNOSTICS
-# define UA_SERVICECOUNTER_OFFSET_NONE(requiresSession) 0, requiresSession
+# define UA_SERVICECOUNTER_OFFSET_NONE(requiresSession) 0, requiresSession, false
 # define UA_SERVICECOUNTER_OFFSET(X, requiresSession) \
-    offsetof(UA_SessionDiagnosticsDataType, X), requiresSession
+    offsetof(UA_SessionDiagnosticsDataType, X), requiresSession, false
+# define UA_SERVICECOUNTER_OFFSET_CONCURRENT(X) \
+    offsetof(UA_SessionDiagnosticsDataType, X), true, true
 #else
-# define UA_SERVICECOUNTER_OFFSET_NONE(requiresSession) requiresSession
-# define UA_SERVICECOUNTER_OFFSET(X, requiresSession) requiresSession
+# define UA_SERVICECOUNTER_OFFSET_NONE(requiresSession) requiresSession, false
+# define UA_SERVICECOUNTER_OFFSET(X, requiresSession) requiresSession, false
+# define UA_SERVICECOUNTER_OFFSET_CONCURRENT(X) true, true
 #endif
 
 static UA_ServiceDescription serviceDescriptions[] = {
@@ -72,13 +76,13 @@ static UA_ServiceDescription serviceDescriptions[] = {
      UA_SERVICECOUNTER_OFFSET_NONE(true), (UA_Service)Service_Cancel,
      &UA_TYPES[UA_TYPES_CANCELREQUEST], &UA_TYPES[UA_TYPES_CANCELRESPONSE]},
     {UA_NS0ID_READREQUEST_ENCODING_DEFAULTBINARY,
-     UA_SERVICECOUNTER_OFFSET(readCount, true), (UA_Service)Service_Read,
+     UA_SERVICECOUNTER_OFFSET_CONCURRENT(readCount), (UA_Service)Service_Read,
      &UA_TYPES[UA_TYPES_READREQUEST], &UA_TYPES[UA_TYPES_READRESPONSE]},
     {UA_NS0ID_WRITEREQUEST_ENCODING_DEFAULTBINARY,
      UA_SERVICECOUNTER_OFFSET(writeCount, true), (UA_Service)Service_Write,
      &UA_TYPES[UA_TYPES_WRITEREQUEST], &UA_TYPES[UA_TYPES_WRITERESPONSE]},
     {UA_NS0ID_BROWSEREQUEST_ENCODING_DEFAULTBINARY,
-     UA_SERVICECOUNTER_OFFSET(browseCount, true), (UA_Service)Service_Browse,
+     UA_SERVICECOUNTER_OFFSET_CONCURRENT(browseCount), (UA_Service)Service_Browse,
      &UA_TYPES[UA_TYPES_BROWSEREQUEST], &UA_TYPES[UA_TYPES_BROWSERESPONSE]},
     {UA_NS0ID_BROWSENEXTREQUEST_ENCODING_DEFAULTBINARY,
      UA_SERVICECOUNTER_OFFSET(browseNextCount, true), (UA_Service)Service_BrowseNext,
@@ -90,7 +94,7 @@ static UA_ServiceDescription serviceDescriptions[] = {
      UA_SERVICECOUNTER_OFFSET(unregisterNodesCount, true), (UA_Service)Service_UnregisterNodes,
      &UA_TYPES[UA_TYPES_UNREGISTERNODESREQUEST], &UA_TYPES[UA_TYPES_UNREGISTERNODESRESPONSE]},
     {UA_NS0ID_TRANSLATEBROWSEPATHSTONODEIDSREQUEST_ENCODING_DEFAULTBINARY,
-     UA_SERVICECOUNTER_OFFSET(translateBrowsePathsToNodeIdsCount, true), (UA_Service)Service_TranslateBrowsePathsToNodeIds,
+     UA_SERVICECOUNTER_OFFSET_CONCURRENT(translateBrowsePathsToNodeIdsCount), (UA_Service)Service_TranslateBrowsePathsToNodeIds,
      &UA_TYPES[UA_TYPES_TRANSLATEBROWSEPATHSTONODEIDSREQUEST], &UA_TYPES[UA_TYPES_TRANSLATEBROWSEPATHSTONODEIDSRESPONSE]},
 #ifdef UA_ENABLE_SUBSCRIPTIONS
     {UA_NS0ID_CREATESUBSCRIPTIONREQUEST_ENCODING_DEFAULTBINARY,
@@ -200,6 +204,54 @@ allocProcessServiceOperations(UA_Server *server, UA_Session *session,
     return UA_STATUSCODE_GOOD;
 }
 
+#if UA_MULTITHREADING >= 100
+/* Execute a service that only reads from the information model without the
+ * server lock. Only for SecureChannels of the network EventLoops. Clients on
+ * the main EventLoop keep the previous locking (also for the AccessControl
+ * callbacks). Other threads can change the Session in the meantime (e.g.
+ * ActivateSession on a different SecureChannel). So the service runs on a
+ * shallow copy of the Session with a private copy of the LocaleIds. The Session
+ * is pinned so that its memory is not freed and closeSession is not called
+ * before the service returns. ActivateSession can still replace the
+ * AccessControl context. The plugin must keep the previous context valid (see
+ * the AccessControl plugin API).
+ *
+ * The server lock is released only if it is held exactly once. Then no caller
+ * further up the stack relies on it. */
+static UA_Boolean
+processServiceUnlocked(UA_Server *server, UA_SecureChannel *channel,
+                       UA_Session *session, UA_ServiceDescription *sd,
+                       const UA_Request *request, UA_Response *response,
+                       UA_Boolean *done) {
+    UA_LOCK_ASSERT(&server->serviceMutex);
+    if(!sd->concurrent || !server->config.nodestore->concurrentRead ||
+       server->serviceMutex.count != 1 || session == &server->adminSession ||
+       !isNetworkLoopChannel(server, channel))
+        return false;
+
+    UA_Session tmpSession = *session;
+    tmpSession.next = NULL;
+    tmpSession.channel = channel;
+    UA_StatusCode res =
+        UA_Array_copy(session->localeIds, session->localeIdsSize,
+                      (void**)&tmpSession.localeIds, &UA_TYPES[UA_TYPES_STRING]);
+    if(res != UA_STATUSCODE_GOOD)
+        return false;
+
+    session_list_entry *sentry = container_of(session, session_list_entry, session);
+    sentry->pins++;
+    unlockServer(server);
+
+    *done = sd->serviceCallback(server, &tmpSession, request, response);
+
+    lockServer(server);
+    sentry->pins--;
+    UA_Array_delete(tmpSession.localeIds, tmpSession.localeIdsSize,
+                    &UA_TYPES[UA_TYPES_STRING]);
+    return true;
+}
+#endif
+
 static UA_Boolean
 processServiceInternal(UA_Server *server, UA_SecureChannel *channel, UA_Session *session,
                        UA_UInt32 requestId, UA_ServiceDescription *sd,
@@ -283,10 +335,15 @@ processServiceInternal(UA_Server *server, UA_SecureChannel *channel, UA_Session
     UA_Session_updateLifetime(session, now, nowMonotonic);
 
     /* Store the request id -- will be used to create async responses */
-    server->asyncManager.currentRequestId = requestId;
-    server->asyncManager.currentRequestHandle = request->requestHeader.requestHandle;
+    session->currentRequestId = requestId;
+    session->currentRequestHandle = request->requestHeader.requestHandle;
 
     /* Execute the service */
+#if UA_MULTITHREADING >= 100
+    UA_Boolean done;
+    if(processServiceUnlocked(server, channel, session, sd, request, response, &done))
+        return done;
+#endif
     return sd->serviceCallback(server, session, request, response);
 }
 
@@ -34,6 +34,9 @@ typedef struct {
     UA_UInt16 counterOffset;
 #endif
     UA_Boolean sessionRequired;
+    UA_Boolean concurrent; /* Only reads from the information model. Can be
+                            * executed without the server lock if the
+                            * Nodestore supports concurrent readers. */
     UA_Service serviceCallback;
     const UA_DataType *requestType;
     const UA_DataType *responseType;
@@ -161,10 +164,13 @@ Service_Read(UA_Server *server, UA_Session *session,
              const UA_ReadRequest *request,
              UA_ReadResponse *response);
 
+/* Values without pointers are copied into the arena if it is non-NULL. They
+ * have the UA_VARIANT_DATA_NODELETE storage type and are valid until the arena
+ * is reset. */
 UA_Boolean
 Operation_Read(UA_Server *server, UA_Session *session,
                UA_TimestampsToReturn ttr,
-               const UA_ReadValueId *rvi, UA_DataValue *dv);
+               const UA_ReadValueId *rvi, UA_DataValue *dv, UA_Arena *arena);
 
 UA_Boolean
 Service_Write(UA_Server *server, UA_Session *session,
@@ -74,9 +74,9 @@ attributeId2AttributeMask(UA_AttributeId id) {
 static UA_UInt32
 getUserWriteMask(UA_Server *server, const UA_Session *session,
                  const UA_NodeHead *head) {
-    UA_LOCK_ASSERT(&server->serviceMutex);
     if(session == &server->adminSession)
         return 0xFFFFFFFF; /* the local admin user has all rights */
+    UA_LOCK_ASSERT_READ(server);
     return head->writeMask & server->config.accessControl.
         getUserRightsMask(server, &server->config.accessControl,
                           session ? &session->sessionId : NULL,
@@ -87,9 +87,9 @@ getUserWriteMask(UA_Server *server, const UA_Session *session,
 static UA_Byte
 getUserAccessLevel(UA_Server *server, const UA_Session *session,
                    const UA_VariableNode *node) {
-    UA_LOCK_ASSERT(&server->serviceMutex);
     if(session == &server->adminSession)
         return 0xFF; /* the local admin user has all rights */
+    UA_LOCK_ASSERT_READ(server);
     return node->accessLevel & server->config.accessControl.
         getUserAccessLevel(server, &server->config.accessControl,
                            session ? &session->sessionId : NULL,
@@ -100,9 +100,9 @@ getUserAccessLevel(UA_Server *server, const UA_Session *session,
 static UA_Boolean
 getUserExecutable(UA_Server *server, const UA_Session *session,
                   const UA_MethodNode *node) {
-    UA_LOCK_ASSERT(&server->serviceMutex);
     if(session == &server->adminSession)
         return true; /* the local admin user has all rights */
+    UA_LOCK_ASSERT_READ(server);
     return node->executable & server->config.accessControl.
         getUserExecutable(server, &server->config.accessControl,
                           session ? &session->sessionId : NULL,
@@ -137,18 +137,54 @@ readIsAbstractAttribute(const UA_Node *node, UA_Variant *v) {
     return UA_Variant_setScalarCopy(v, isAbstract, &UA_TYPES[UA_TYPES_BOOLEAN]);
 }
 
+/* Shared values only get a reference. Values of a type without pointers are
+ * copied into the arena (if defined) with a single allocation for the data and
+ * the ArrayDimensions each. They are marked as UA_VARIANT_DATA_NODELETE and
+ * released together with the arena. Everything else is deep-copied onto the
+ * heap. */
+static UA_StatusCode
+copyValueAttribute(const UA_DataValue *src, UA_DataValue *dst,
+                   UA_NumericRange *rangeptr, UA_Arena *arena) {
+    if(rangeptr)
+        return UA_DataValue_copyRange(src, dst, *rangeptr);
+    const UA_Variant *sv = &src->value;
+    if(!arena || sv->storageType == UA_VARIANT_DATA_SHARED ||
+       !sv->type || !sv->type->pointerFree || sv->data <= UA_EMPTY_ARRAY_SENTINEL)
+        return UA_DataValue_copy(src, dst);
+
+    size_t length = (UA_Variant_isScalar(sv)) ? 1 : sv->arrayLength;
+    void *data = UA_Arena_calloc(arena, length, sv->type->memSize);
+    UA_UInt32 *dims = NULL;
+    if(sv->arrayDimensionsSize > 0)
+        dims = (UA_UInt32*)UA_Arena_calloc(arena, sv->arrayDimensionsSize,
+                                           sizeof(UA_UInt32));
+    if(!data || (sv->arrayDimensionsSize > 0 && !dims))
+        return UA_DataValue_copy(src, dst);
+
+    memcpy(data, sv->data, length * sv->type->memSize);
+    if(dims)
+        memcpy(dims, sv->arrayDimensions, sv->arrayDimensionsSize * sizeof(UA_UInt32));
+    *dst = *src;
+    dst->value.data = data;
+    dst->value.arrayDimensions = dims;
+    dst->value.storageType = UA_VARIANT_DATA_NODELETE;
+    return UA_STATUSCODE_GOOD;
+}
+
 static UA_StatusCode
 readInternalValueAttribute(UA_Server *server, UA_Session *session,
                            const UA_VariableNode *vn, UA_DataValue *v,
-                           UA_NumericRange *rangeptr) {
-    UA_LOCK_ASSERT(&server->serviceMutex);
+                           UA_NumericRange *rangeptr, UA_Arena *arena) {
+    UA_LOCK_ASSERT_READ(server);
 
     /* Update the value by the user callback */
     if(vn->valueSource.internal.notifications.onRead) {
+        lockServerInRead(server);
         vn->valueSource.internal.notifications.
             onRead(server, session ? &session->sessionId : NULL,
                    session ? session->context : NULL, &vn->head.nodeId,
                    vn->head.context, rangeptr, &vn->valueSource.internal.value);
+        unlockServerInRead(server);
         vn = (const UA_VariableNode*)
             UA_NODESTORE_GET_SELECTIVE(server, &vn->head.nodeId,
                                        UA_NODEATTRIBUTESMASK_VALUE,
@@ -159,9 +195,8 @@ readInternalValueAttribute(UA_Server *server, UA_Session *session,
     }
 
     /* Set the result */
-    UA_StatusCode retval = (!rangeptr) ?
-        UA_DataValue_copy(&vn->valueSource.internal.value, v) :
-        UA_DataValue_copyRange(&vn->valueSource.internal.value, v, *rangeptr);
+    UA_StatusCode retval =
+        copyValueAttribute(&vn->valueSource.internal.value, v, rangeptr, arena);
 
     /* Clean up */
     if(vn->valueSource.internal.notifications.onRead)
@@ -172,41 +207,57 @@ readInternalValueAttribute(UA_Server *server, UA_Session *session,
 static UA_StatusCode
 readExternalValueAttribute(UA_Server *server, UA_Session *session,
                            const UA_VariableNode *vn, UA_DataValue *v,
-                           UA_NumericRange *rangeptr) {
-    UA_LOCK_ASSERT(&server->serviceMutex);
+                           UA_NumericRange *rangeptr, UA_Arena *arena) {
+    UA_LOCK_ASSERT_READ(server);
 
     /* Update the value by the user callback */
-    if(vn->valueSource.internal.notifications.onRead)
+    if(vn->valueSource.internal.notifications.onRead) {
+        lockServerInRead(server);
         vn->valueSource.internal.notifications.
             onRead(server, session ? &session->sessionId : NULL,
                    session ? session->context : NULL, &vn->head.nodeId,
                    vn->head.context, rangeptr, *vn->valueSource.external.value);
+        unlockServerInRead(server);
+    }
 
     /* Reload the value pointer */
     const UA_DataValue *val = (const UA_DataValue*)
         UA_atomic_load((void**)vn->valueSource.external.value);
 
     /* Set the result */
-    return (!rangeptr) ? UA_DataValue_copy(val, v) : UA_DataValue_copyRange(val, v, *rangeptr);
+    return copyValueAttribute(val, v, rangeptr, arena);
 }
 
+/* If the callback completes asynchronously, the output is registered as a
+ * pending read before the lock is released. The caller either persists the
+ * async operation or abandons it. */
 static UA_StatusCode
 readCallbackValueAttribute(UA_Server *server, UA_Session *session,
                            const UA_VariableNode *vn, UA_DataValue *v,
                            UA_TimestampsToReturn timestamps,
                            UA_NumericRange *rangeptr) {
-    UA_LOCK_ASSERT(&server->serviceMutex);
+    UA_LOCK_ASSERT_READ(server);
 
     if(!vn->valueSource.callback.read)
         return UA_STATUSCODE_BADINTERNALERROR;
     UA_Boolean sourceTimeStamp = (timestamps == UA_TIMESTAMPSTORETURN_SOURCE ||
                                   timestamps == UA_TIMESTAMPSTORETURN_BOTH);
+    lockServerInRead(server);
     UA_StatusCode retval = vn->valueSource.callback.
         read(server,
              session ? &session->sessionId : NULL,
              session ? session->context : NULL,
              &vn->head.nodeId, vn->head.context,
              sourceTimeStamp, rangeptr, v);
+    if(retval == UA_STATUSCODE_GOODCOMPLETESASYNCHRONOUSLY &&
+       async_addPendingRead(server, v) != UA_STATUSCODE_GOOD) {
+        if(server->config.asyncOperationCancelCallback)
+            server->config.asyncOperationCancelCallback(server, v);
+        retval = UA_STATUSCODE_BADOUTOFMEMORY;
+    }
+    unlockServerInRead(server);
+    if(retval == UA_STATUSCODE_GOODCOMPLETESASYNCHRONOUSLY)
+        return retval;
     if(retval == UA_STATUSCODE_GOOD && v->hasValue &&
        v->value.storageType == UA_VARIANT_DATA_NODELETE) {
         UA_DataValue v2;
@@ -219,7 +270,8 @@ readCallbackValueAttribute(UA_Server *server, UA_Session *session,
 static UA_StatusCode
 readValueAttributeComplete(UA_Server *server, UA_Session *session,
                            const UA_VariableNode *vn, UA_TimestampsToReturn timestamps,
-                           const UA_String *indexRange, UA_DataValue *v) {
+                           const UA_String *indexRange, UA_DataValue *v,
+                           UA_Arena *arena) {
     UA_EventLoop *el = server->config.eventLoop;
 
     /* Parse the index range */
@@ -236,10 +288,10 @@ readValueAttributeComplete(UA_Server *server, UA_Session *session,
     /* Read from the value souce */
     switch(vn->valueSourceType) {
     case UA_VALUESOURCETYPE_INTERNAL:
-        retval = readInternalValueAttribute(server, session, vn, v, rangeptr);
+        retval = readInternalValueAttribute(server, session, vn, v, rangeptr, arena);
         break;
     case UA_VALUESOURCETYPE_EXTERNAL:
-        retval = readExternalValueAttribute(server, session, vn, v, rangeptr);
+        retval = readExternalValueAttribute(server, session, vn, v, rangeptr, arena);
         break;
     case UA_VALUESOURCETYPE_CALLBACK:
         retval = readCallbackValueAttribute(server, session, vn, v, timestamps, rangeptr);
@@ -262,11 +314,29 @@ readValueAttributeComplete(UA_Server *server, UA_Session *session,
     return retval;
 }
 
+/* Remove an async read that is not persisted as an operation. Returns whether
+ * the result was already set. Otherwise the application is notified that the
+ * result can no longer be set. */
+static UA_Boolean
+abandonAsyncRead(UA_Server *server, UA_DataValue *v) {
+    lockServerInRead(server);
+    UA_Boolean ready = async_removePendingRead(server, v);
+    if(!ready && server->config.asyncOperationCancelCallback)
+        server->config.asyncOperationCancelCallback(server, v);
+    unlockServerInRead(server);
+    return ready;
+}
+
 UA_StatusCode
 readValueAttribute(UA_Server *server, UA_Session *session,
                    const UA_VariableNode *vn, UA_DataValue *v) {
-    return readValueAttributeComplete(server, session, vn,
-                                      UA_TIMESTAMPSTORETURN_NEITHER, NULL, v);
+    UA_StatusCode res =
+        readValueAttributeComplete(server, session, vn,
+                                   UA_TIMESTAMPSTORETURN_NEITHER, NULL, v, NULL);
+    if(res == UA_STATUSCODE_GOODCOMPLETESASYNCHRONOUSLY)
+        res = (abandonAsyncRead(server, v)) ?
+            UA_STATUSCODE_GOOD : UA_STATUSCODE_BADWAITINGFORRESPONSE;
+    return res;
 }
 
 static const UA_String binEncoding = {sizeof("Default Binary")-1, (UA_Byte*)"Default Binary"};
@@ -280,11 +350,12 @@ static const UA_String jsonEncoding = {sizeof("Default JSON")-1, (UA_Byte*)"Defa
     }
 
 /* Returns whether the operation is done or an async operation has been
- * triggered. */
+ * triggered. Values can be copied into the arena (can be NULL). */
 static UA_Boolean
 ReadWithNodeMaybeAsync(const UA_Node *node, UA_Server *server, UA_Session *session,
                        UA_TimestampsToReturn timestampsToReturn,
-                       const UA_ReadValueId *id, UA_DataValue *v) {
+                       const UA_ReadValueId *id, UA_DataValue *v,
+                       UA_Arena *arena) {
     UA_LOG_TRACE_SESSION(server->config.logging, session,
                          "Read attribute %"PRIi32 " of Node %N",
                          id->attributeId, node->head.nodeId);
@@ -392,7 +463,8 @@ ReadWithNodeMaybeAsync(const UA_Node *node, UA_Server *server, UA_Session *sessi
             }
         }
         retval = readValueAttributeComplete(server, session, &node->variableNode,
-                                            timestampsToReturn, &id->indexRange, v);
+                                            timestampsToReturn, &id->indexRange, v,
+                                            arena);
         break;
     }
     case UA_ATTRIBUTEID_DATATYPE:
@@ -547,7 +619,7 @@ ReadWithNodeMaybeAsync(const UA_Node *node, UA_Server *server, UA_Session *sessi
 UA_Boolean
 Operation_Read(UA_Server *server, UA_Session *session,
                UA_TimestampsToReturn ttr,
-               const UA_ReadValueId *rvi, UA_DataValue *dv) {
+               const UA_ReadValueId *rvi, UA_DataValue *dv, UA_Arena *arena) {
     /* Get the node (with only the selected attribute if the NodeStore supports that) */
     UA_UInt32 attrMask = attributeId2AttributeMask((UA_AttributeId)rvi->attributeId);
     const UA_Node *node =
@@ -560,7 +632,7 @@ Operation_Read(UA_Server *server, UA_Session *session,
     }
 
     /* Perform the read operation */
-    UA_Boolean done = ReadWithNodeMaybeAsync(node, server, session, ttr, rvi, dv);
+    UA_Boolean done = ReadWithNodeMaybeAsync(node, server, session, ttr, rvi, dv, arena);
     UA_NODESTORE_RELEASE(server, node);
     return done;
 }
@@ -569,7 +641,7 @@ UA_DataValue
 readWithSession(UA_Server *server, UA_Session *session,
                 const UA_ReadValueId *item,
                 UA_TimestampsToReturn ttr) {
-    UA_LOCK_ASSERT(&server->serviceMutex);
+    UA_LOCK_ASSERT_READ(server);
 
     UA_DataValue dv;
     UA_DataValue_init(&dv);
@@ -582,10 +654,8 @@ readWithSession(UA_Server *server, UA_Session *session,
         return dv;
     }
 
-    UA_Boolean done = Operation_Read(server, session, ttr, item, &dv);
-    if(!done) {
-        if(server->config.asyncOperationCancelCallback)
-            server->config.asyncOperationCancelCallback(server, &dv);
+    UA_Boolean done = Operation_Read(server, session, ttr, item, &dv, NULL);
+    if(!done && !abandonAsyncRead(server, &dv)) {
         dv.hasStatus = true;
         dv.status = UA_STATUSCODE_BADWAITINGFORRESPONSE;
     }
@@ -595,7 +665,7 @@ readWithSession(UA_Server *server, UA_Session *session,
 UA_StatusCode
 readWithReadValue(UA_Server *server, const UA_NodeId *nodeId,
                   const UA_AttributeId attributeId, void *v) {
-    UA_LOCK_ASSERT(&server->serviceMutex);
+    UA_LOCK_ASSERT_READ(server);
 
     /* Call the read service */
     UA_ReadValueId item;
@@ -618,7 +688,12 @@ readWithReadValue(UA_Server *server, const UA_NodeId *nodeId,
 
     if(attributeId == UA_ATTRIBUTEID_VALUE ||
        attributeId == UA_ATTRIBUTEID_ARRAYDIMENSIONS) {
-        /* Return the entire variant */
+        /* Return the entire variant. The caller owns the data. */
+        retval = UA_Variant_unshare(&dv.value);
+        if(retval != UA_STATUSCODE_GOOD) {
+            UA_DataValue_clear(&dv);
+            return retval;
+        }
         memcpy(v, &dv.value, sizeof(UA_Variant));
     } else {
         /* Return the variant content only */
@@ -632,9 +707,17 @@ readWithReadValue(UA_Server *server, const UA_NodeId *nodeId,
 UA_DataValue
 UA_Server_read(UA_Server *server, const UA_ReadValueId *item,
                UA_TimestampsToReturn timestamps) {
-    lockServer(server);
+    lockServerRead(server);
     UA_DataValue dv = readWithSession(server, &server->adminSession, item, timestamps);
-    unlockServer(server);
+    unlockServerRead(server);
+
+    /* The caller owns the data */
+    UA_StatusCode res = UA_Variant_unshare(&dv.value);
+    if(res != UA_STATUSCODE_GOOD) {
+        UA_DataValue_clear(&dv);
+        dv.hasStatus = true;
+        dv.status = res;
+    }
     return dv;
 }
 
@@ -643,9 +726,9 @@ UA_Server_read(UA_Server *server, const UA_ReadValueId *item,
 static UA_StatusCode
 __Server_read(UA_Server *server, const UA_NodeId *nodeId,
                  const UA_AttributeId attributeId, void *v) {
-   lockServer(server);
+   lockServerRead(server);
    UA_StatusCode retval = readWithReadValue(server, nodeId, attributeId, v);
-   unlockServer(server);
+   unlockServerRead(server);
    return retval;
 }
 
@@ -753,7 +836,7 @@ UA_StatusCode
 readObjectProperty(UA_Server *server, const UA_NodeId objectId,
                    const UA_QualifiedName propertyName,
                    UA_Variant *value) {
-    UA_LOCK_ASSERT(&server->serviceMutex);
+    UA_LOCK_ASSERT_READ(server);
 
     /* Create a BrowsePath to get the target NodeId */
     UA_RelativePathElement rpe;
@@ -790,9 +873,9 @@ UA_StatusCode
 UA_Server_readObjectProperty(UA_Server *server, const UA_NodeId objectId,
                              const UA_QualifiedName propertyName,
                              UA_Variant *value) {
-    lockServer(server);
+    lockServerRead(server);
     UA_StatusCode retval = readObjectProperty(server, objectId, propertyName, value);
-    unlockServer(server);
+    unlockServerRead(server);
     return retval;
 }
 
@@ -1352,8 +1435,10 @@ writeInternalValueAttribute(UA_DataValue *oldValue,
         UA_DataValue tmpValue = *value;
 
         /* If possible memcpy the new value over the old value without
-         * a malloc. For this the value needs to be "pointerfree". */
-        if(oldValue->hasValue && oldValue->value.type &&
+         * a malloc. For this the value needs to be "pointerfree" and not
+         * shared with other variants. */
+        if(oldValue->hasValue && UA_Variant_isExclusive(&oldValue->value) &&
+           oldValue->value.type &&
            oldValue->value.type->pointerFree && value->hasValue &&
            value->value.type && value->value.type->pointerFree &&
            oldValue->value.type->memSize == value->value.type->memSize) {
@@ -1384,8 +1469,9 @@ writeInternalValueAttribute(UA_DataValue *oldValue,
             }
         }
 
-        /* Make a deep copy of the value and replace when this succeeds */
-        retval = UA_Variant_copy(&value->value, &tmpValue.value);
+        /* Make a deep copy of the value and replace when this succeeds. The
+         * copy is shared with the readers of the value. */
+        retval = UA_Variant_copyShared(&value->value, &tmpValue.value);
         if(retval != UA_STATUSCODE_GOOD)
             return retval;
         UA_DataValue_clear(oldValue);
@@ -1604,10 +1690,8 @@ triggerImmediateDataChange(UA_Server *server, UA_Session *session,
         UA_DataValue_init(&value);
         UA_Boolean done =
             ReadWithNodeMaybeAsync(node, server, session, mon->timestampsToReturn,
-                                   &mon->itemToMonitor, &value);
-        if(!done) {
-            if(server->config.asyncOperationCancelCallback)
-                server->config.asyncOperationCancelCallback(server, &value);
+                                   &mon->itemToMonitor, &value, NULL);
+        if(!done && !abandonAsyncRead(server, &value)) {
             value.hasStatus = true;
             value.status = UA_STATUSCODE_BADWAITINGFORRESPONSE;
         }
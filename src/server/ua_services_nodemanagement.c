@@ -2547,7 +2547,8 @@ setInternalValueSourceCB(UA_Server *server, UA_Session *session,
     UA_DataValue val;
     UA_StatusCode res = UA_STATUSCODE_GOOD;
     if(ivc->value) {
-        res = UA_DataValue_copy(ivc->value, &val);
+        val = *ivc->value;
+        res = UA_Variant_copyShared(&ivc->value->value, &val.value);
         if(res != UA_STATUSCODE_GOOD)
             return res;
     }
@@ -24,14 +24,12 @@
  * - Process the OpenSecureChannelRequest (here, via standard service call logic)
  */
 
-UA_StatusCode
-processOPN_AsymHeader(void *application, UA_SecureChannel *channel,
-                      const UA_AsymmetricAlgorithmSecurityHeader *asymHeader) {
-    if(channel->securityPolicy)
-        return UA_STATUSCODE_GOOD;
+static UA_StatusCode
+processOPN_AsymHeaderLocked(UA_Server *server, UA_SecureChannel *channel,
+                            const UA_AsymmetricAlgorithmSecurityHeader *asymHeader) {
+    UA_LOCK_ASSERT(&server->serviceMutex);
 
     /* Iterate over available endpoints and choose the correct one */
-    UA_Server *server = (UA_Server *)application;
     UA_ServerConfig *sc = &server->config;
     UA_SecurityPolicy *securityPolicy = NULL;
     for(size_t i = 0; i < sc->securityPoliciesSize; ++i) {
@@ -79,6 +77,21 @@ processOPN_AsymHeader(void *application, UA_SecureChannel *channel,
     return UA_SecureChannel_setSecurityPolicy(channel, securityPolicy, &appInstCert);
 }
 
+UA_StatusCode
+processOPN_AsymHeader(void *application, UA_SecureChannel *channel,
+                      const UA_AsymmetricAlgorithmSecurityHeader *asymHeader) {
+    if(channel->securityPolicy)
+        return UA_STATUSCODE_GOOD;
+
+    /* Can be called without the server lock from the network EventLoops. The
+     * lock is reentrant. */
+    UA_Server *server = (UA_Server *)application;
+    lockServer(server);
+    UA_StatusCode res = processOPN_AsymHeaderLocked(server, channel, asymHeader);
+    unlockServer(server);
+    return res;
+}
+
 void
 Service_OpenSecureChannel(UA_Server *server, UA_SecureChannel *channel,
                           UA_OpenSecureChannelRequest *request,
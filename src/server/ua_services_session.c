@@ -65,6 +65,21 @@ notifySession(UA_Server *server, UA_Session *session,
 static void
 removeSessionCallback(UA_Server *server, session_list_entry *entry) {
     lockServer(server);
+#if UA_MULTITHREADING >= 100
+    /* A service for the Session is still executed without the server lock.
+     * Try again in the next EventLoop iteration. */
+    if(entry->pins > 0) {
+        UA_EventLoop *el = server->config.eventLoop;
+        el->addDelayedCallback(el, &entry->cleanupCallback);
+        unlockServer(server);
+        return;
+    }
+    if(entry->closeDeferred && server->config.accessControl.closeSession) {
+        server->config.accessControl.
+            closeSession(server, &server->config.accessControl,
+                         &entry->session.sessionId, entry->session.context);
+    }
+#endif
     UA_Session_clear(&entry->session, server);
     unlockServer(server);
     UA_free(entry);
@@ -89,8 +104,16 @@ UA_Session_remove(UA_Server *server, UA_Session *session,
     }
 #endif
 
-    /* Callback into userland access control */
-    if(server->config.accessControl.closeSession) {
+    /* Callback into userland access control. Deferred until the Session is no
+     * longer pinned, as the services executed without the server lock can
+     * still use the session context. */
+    session_list_entry *sentry = container_of(session, session_list_entry, session);
+    UA_Boolean closeNow = true;
+#if UA_MULTITHREADING >= 100
+    sentry->closeDeferred = (sentry->pins > 0);
+    closeNow = !sentry->closeDeferred;
+#endif
+    if(closeNow && server->config.accessControl.closeSession) {
         server->config.accessControl.
             closeSession(server, &server->config.accessControl,
                          &session->sessionId, session->context);
@@ -107,7 +130,6 @@ UA_Session_remove(UA_Server *server, UA_Session *session,
 
     /* Detach the session from the session manager and make the capacity
      * available */
-    session_list_entry *sentry = container_of(session, session_list_entry, session);
     LIST_REMOVE(sentry, pointers);
     server->sessionCount--;
 
@@ -379,6 +401,10 @@ UA_Session_create(UA_Server *server, UA_SecureChannel *channel,
         return UA_STATUSCODE_BADOUTOFMEMORY;
 
     /* Initialize the Session */
+#if UA_MULTITHREADING >= 100
+    newentry->pins = 0;
+    newentry->closeDeferred = false;
+#endif
     UA_Session_init(&newentry->session);
     newentry->session.sessionId = UA_NODEID_GUID(1, UA_Guid_random());
     newentry->session.authenticationToken = UA_NODEID_GUID(1, UA_Guid_random());
@@ -299,7 +299,7 @@ Service_Publish(UA_Server *server, UA_Session *session,
                 UA_PublishResponse *response) {
     UA_LOG_DEBUG_SESSION(server->config.logging, session,
                          "Processing PublishRequest with RequestId %u",
-                         server->asyncManager.currentRequestId);
+                         session->currentRequestId);
     UA_LOCK_ASSERT(&server->serviceMutex);
 
     /* Return an error if the session has no subscription */
@@ -340,7 +340,7 @@ Service_Publish(UA_Server *server, UA_Session *session,
 
     /* <--- Async response from here on ---> */
 
-    entry->requestId = server->asyncManager.currentRequestId;
+    entry->requestId = session->currentRequestId;
     entry_response->responseHeader.requestHandle = request->requestHeader.requestHandle;
 
     /* Delete Acknowledged Subscription Messages */
@@ -468,14 +468,14 @@ browseRecursiveRefTree(UA_Server *server, RefTree *rt, UA_BrowseDirection browse
 UA_StatusCode
 UA_Server_browseRecursive(UA_Server *server, const UA_BrowseDescription *bd,
                           size_t *resultsSize, UA_ExpandedNodeId **results) {
-    lockServer(server);
+    lockServerRead(server);
 
     /* Set the list of relevant reference types */
     UA_ReferenceTypeSet refTypes;
     UA_StatusCode retval = referenceTypeIndices(server, &bd->referenceTypeId,
                                                 &refTypes, bd->includeSubtypes);
     if(retval != UA_STATUSCODE_GOOD) {
-        unlockServer(server);
+        unlockServerRead(server);
         return retval;
     }
 
@@ -483,7 +483,7 @@ UA_Server_browseRecursive(UA_Server *server, const UA_BrowseDescription *bd,
     retval = browseRecursive(server, 1, &bd->nodeId, bd->browseDirection,
                              &refTypes, bd->nodeClassMask, false, resultsSize, results);
 
-    unlockServer(server);
+    unlockServerRead(server);
     return retval;
 }
 
@@ -820,7 +820,7 @@ browse(struct BrowseContext *bc) {
 
     /* Check AccessControl rights */
     if(bc->session != &bc->server->adminSession) {
-        UA_LOCK_ASSERT(&bc->server->serviceMutex);
+        UA_LOCK_ASSERT_READ(bc->server);
         if(!bc->server->config.accessControl.
            allowBrowseNode(bc->server, &bc->server->config.accessControl,
                            &bc->session->sessionId, bc->session->context,
@@ -928,12 +928,23 @@ Operation_Browse(UA_Server *server, UA_Session *session, const UA_UInt32 *maxref
     if(bc.done)
         return;
 
-    /* Persist the continuation point */
+    /* Persist the continuation point. This changes the session. */
 
+    lockServerInRead(server);
     ContinuationPoint *cp2 = NULL;
     UA_Guid *ident = NULL;
     UA_StatusCode retval = UA_STATUSCODE_GOOD;
 
+    /* With concurrent readers the service can run on a copy of the session.
+     * Attach the continuation point to the session itself. */
+    if(server->config.nodestore->concurrentRead) {
+        session = getSessionById(server, &session->sessionId);
+        if(!session) {
+            retval = UA_STATUSCODE_BADSESSIONIDINVALID;
+            goto cleanup;
+        }
+    }
+
     /* Enough space for the continuation point? */
     if(session->availableContinuationPoints == 0) {
         retval = UA_STATUSCODE_BADNOCONTINUATIONPOINTS;
@@ -977,6 +988,7 @@ Operation_Browse(UA_Server *server, UA_Session *session, const UA_UInt32 *maxref
     cp2->next = session->continuationPoints;
     session->continuationPoints = cp2;
     --session->availableContinuationPoints;
+    unlockServerInRead(server);
     return;
 
  cleanup:
@@ -984,6 +996,7 @@ Operation_Browse(UA_Server *server, UA_Session *session, const UA_UInt32 *maxref
         ContinuationPoint_clear(cp2);
         UA_free(cp2);
     }
+    unlockServerInRead(server);
     UA_NodePointer_clear(&cp.lastTarget);
     UA_BrowseResult_clear(result);
     result->statusCode = retval;
@@ -993,7 +1006,7 @@ UA_Boolean
 Service_Browse(UA_Server *server, UA_Session *session,
                const UA_BrowseRequest *request, UA_BrowseResponse *response) {
     UA_LOG_DEBUG_SESSION(server->config.logging, session, "Processing BrowseRequest");
-    UA_LOCK_ASSERT(&server->serviceMutex);
+    UA_LOCK_ASSERT_READ(server);
 
     /* Test the number of operations in the request */
     if(server->config.maxNodesPerBrowse != 0 &&
@@ -1024,9 +1037,9 @@ UA_Server_browse(UA_Server *server, UA_UInt32 maxReferences,
                  const UA_BrowseDescription *bd) {
     UA_BrowseResult result;
     UA_BrowseResult_init(&result);
-    lockServer(server);
+    lockServerRead(server);
     Operation_Browse(server, &server->adminSession, &maxReferences, bd, &result);
-    unlockServer(server);
+    unlockServerRead(server);
     return result;
 }
 
@@ -1270,7 +1283,7 @@ Operation_TranslateBrowsePathToNodeIds(UA_Server *server, UA_Session *session,
                                        const UA_UInt32 *nodeClassMask,
                                        const UA_BrowsePath *path,
                                        UA_BrowsePathResult *result) {
-    UA_LOCK_ASSERT(&server->serviceMutex);
+    UA_LOCK_ASSERT_READ(server);
 
     if(path->relativePath.elementsSize == 0) {
         result->statusCode = UA_STATUSCODE_BADNOTHINGTODO;
@@ -1397,7 +1410,7 @@ Operation_TranslateBrowsePathToNodeIds(UA_Server *server, UA_Session *session,
 UA_BrowsePathResult
 translateBrowsePathToNodeIds(UA_Server *server,
                              const UA_BrowsePath *browsePath) {
-    UA_LOCK_ASSERT(&server->serviceMutex);
+    UA_LOCK_ASSERT_READ(server);
     UA_BrowsePathResult result;
     UA_BrowsePathResult_init(&result);
     UA_UInt32 nodeClassMask = 0; /* All node classes */
@@ -1409,9 +1422,9 @@ translateBrowsePathToNodeIds(UA_Server *server,
 UA_BrowsePathResult
 UA_Server_translateBrowsePathToNodeIds(UA_Server *server,
                                        const UA_BrowsePath *browsePath) {
-    lockServer(server);
+    lockServerRead(server);
     UA_BrowsePathResult result = translateBrowsePathToNodeIds(server, browsePath);
-    unlockServer(server);
+    unlockServerRead(server);
     return result;
 }
 
@@ -1421,7 +1434,7 @@ Service_TranslateBrowsePathsToNodeIds(UA_Server *server, UA_Session *session,
                                       UA_TranslateBrowsePathsToNodeIdsResponse *response) {
     UA_LOG_DEBUG_SESSION(server->config.logging, session,
                          "Processing TranslateBrowsePathsToNodeIdsRequest");
-    UA_LOCK_ASSERT(&server->serviceMutex);
+    UA_LOCK_ASSERT_READ(server);
 
     /* Test the number of operations in the request */
     if(server->config.maxNodesPerTranslateBrowsePathsToNodeIds != 0 &&
@@ -1443,7 +1456,7 @@ Service_TranslateBrowsePathsToNodeIds(UA_Server *server, UA_Session *session,
 UA_BrowsePathResult
 browseSimplifiedBrowsePath(UA_Server *server, const UA_NodeId origin,
                            size_t browsePathSize, const UA_QualifiedName *browsePath) {
-    UA_LOCK_ASSERT(&server->serviceMutex);
+    UA_LOCK_ASSERT_READ(server);
 
     UA_BrowsePathResult bpr;
     UA_BrowsePathResult_init(&bpr);
@@ -1479,9 +1492,9 @@ browseSimplifiedBrowsePath(UA_Server *server, const UA_NodeId origin,
 UA_BrowsePathResult
 UA_Server_browseSimplifiedBrowsePath(UA_Server *server, const UA_NodeId origin,
                            size_t browsePathSize, const UA_QualifiedName *browsePath) {
-    lockServer(server);
+    lockServerRead(server);
     UA_BrowsePathResult bpr = browseSimplifiedBrowsePath(server, origin, browsePathSize, browsePath);
-    unlockServer(server);
+    unlockServerRead(server);
     return bpr;
 }
 
@@ -72,6 +72,12 @@ struct UA_Session {
     UA_UInt32 maxRequestMessageSize;
     UA_UInt32 maxResponseMessageSize;
 
+    /* Forward the request id here as the "UA_Service" method signature does not
+     * contain it. Kept in the Session as requests of different Sessions can be
+     * processed in parallel. */
+    UA_UInt32 currentRequestId;
+    UA_UInt32 currentRequestHandle;
+
     UA_UInt16         availableContinuationPoints;
     ContinuationPoint *continuationPoints;
 
@@ -30,6 +30,8 @@ UA_SecureChannel_init(UA_SecureChannel *channel) {
     /* Normal linked lists are initialized by zeroing out */
     memset(channel, 0, sizeof(UA_SecureChannel));
     TAILQ_INIT(&channel->chunks);
+    TAILQ_INIT(&channel->messageChunks);
+    UA_Arena_init(&channel->decodeArena);
 }
 
 UA_StatusCode
@@ -165,11 +167,26 @@ deleteChunks(UA_SecureChannel *channel) {
     channel->chunksLength = 0;
 }
 
+/* Release the chunks of the last message that was not assembled */
+static void
+deleteMessageChunks(UA_SecureChannel *channel) {
+    UA_Chunk *chunk, *chunk_tmp;
+    TAILQ_FOREACH_SAFE(chunk, &channel->messageChunks, pointers, chunk_tmp) {
+        TAILQ_REMOVE(&channel->messageChunks, chunk, pointers);
+        UA_Chunk_delete(chunk);
+    }
+    channel->messageChunksLength = 0;
+    channel->messageChunksNext = NULL;
+}
+
 void
 UA_SecureChannel_deleteBuffered(UA_SecureChannel *channel) {
     deleteChunks(channel);
-    if(channel->unprocessedCopied)
-        UA_ByteString_clear(&channel->unprocessed);
+    deleteMessageChunks(channel);
+    UA_ByteString_clear(&channel->reassembly);
+    UA_ByteString_init(&channel->unprocessed);
+    UA_ByteString_init(&channel->unprocessedNext);
+    channel->unprocessedOffset = 0;
 }
 
 void
@@ -227,6 +244,7 @@ UA_SecureChannel_clear(UA_SecureChannel *channel) {
 
     /* Delete remaining chunks */
     UA_SecureChannel_deleteBuffered(channel);
+    UA_Arena_clear(&channel->decodeArena);
 
     /* Clean up namespace mapping */
     UA_NamespaceMapping_delete(channel->namespaceMapping);
@@ -411,6 +429,39 @@ encodeHeadersSym(UA_MessageContext *mc, size_t totalLength) {
     return res;
 }
 
+/* Send the chunk from the messageBuffer and the referenced memory with a
+ * single gathering send. Then release the messageBuffer. */
+static UA_StatusCode
+sendSymmetricChunkGathered(UA_MessageContext *mc) {
+    UA_SecureChannel *channel = mc->channel;
+    UA_ConnectionManager *cm = channel->connectionManager;
+    UA_ByteString bufs[2 * UA_SECURECHANNEL_GATHER_MAX + 1];
+    size_t bufsSize = 0;
+    size_t pos = 0;
+    for(size_t i = 0; i < mc->gatherSize; i++) {
+        if(mc->gatherOffset[i] > pos) {
+            bufs[bufsSize].data = &mc->messageBuffer.data[pos];
+            bufs[bufsSize].length = mc->gatherOffset[i] - pos;
+            bufsSize++;
+            pos = mc->gatherOffset[i];
+        }
+        bufs[bufsSize++] = mc->gather[i];
+    }
+    if(mc->messageBuffer.length > pos) {
+        bufs[bufsSize].data = &mc->messageBuffer.data[pos];
+        bufs[bufsSize].length = mc->messageBuffer.length - pos;
+        bufsSize++;
+    }
+
+    UA_StatusCode res =
+        cm->sendWithConnectionVector(cm, channel->connectionId,
+                                     &UA_KEYVALUEMAP_NULL, bufs, bufsSize);
+    cm->freeNetworkBuffer(cm, channel->connectionId, &mc->messageBuffer);
+    mc->gatherSize = 0;
+    mc->gatherLength = 0;
+    return res;
+}
+
 static UA_StatusCode
 sendSymmetricChunk(UA_MessageContext *mc) {
     UA_SecureChannel *channel = mc->channel;
@@ -419,9 +470,10 @@ sendSymmetricChunk(UA_MessageContext *mc) {
     if(!UA_SecureChannel_isConnected(channel))
         return UA_STATUSCODE_BADCONNECTIONCLOSED;
 
-    /* The size of the message payload */
+    /* The size of the message payload (including the referenced memory) */
     size_t bodyLength = (uintptr_t)mc->buf_pos -
         (uintptr_t)&mc->messageBuffer.data[UA_SECURECHANNEL_SYMMETRIC_HEADER_TOTALLENGTH];
+    bodyLength += mc->gatherLength;
 
     /* Early-declare variables so we can use a goto in the error case */
     size_t total_length = 0;
@@ -446,7 +498,7 @@ sendSymmetricChunk(UA_MessageContext *mc) {
 
     /* Compute the total message length */
     pre_sig_length = (uintptr_t)mc->buf_pos - (uintptr_t)mc->messageBuffer.data;
-    total_length = pre_sig_length;
+    total_length = pre_sig_length + mc->gatherLength;
     if(channel->securityMode == UA_MESSAGESECURITYMODE_SIGN ||
        channel->securityMode == UA_MESSAGESECURITYMODE_SIGNANDENCRYPT)
         total_length += sp->symSignatureAlgorithm.
@@ -461,8 +513,11 @@ sendSymmetricChunk(UA_MessageContext *mc) {
     /* Space for the padding and the signature have been reserved in setBufPos() */
     UA_assert(total_length <= channel->config.sendBufferSize);
 
-    /* Adjust the buffer size of the network layer */
-    mc->messageBuffer.length = total_length;
+    /* Adjust the buffer size of the network layer. Referenced memory is only
+     * gathered without message security. */
+    UA_assert(mc->gatherSize == 0 ||
+              channel->securityMode == UA_MESSAGESECURITYMODE_NONE);
+    mc->messageBuffer.length = total_length - mc->gatherLength;
 
     /* Generate and encode the header for symmetric messages */
     res = encodeHeadersSym(mc, total_length);
@@ -475,8 +530,11 @@ sendSymmetricChunk(UA_MessageContext *mc) {
     /* Send the chunk. The buffer is freed in the network layer. If sending goes
      * wrong, the connection is removed in the next iteration of the
      * SecureChannel. Set the SecureChannel to closing already. */
-    res = cm->sendWithConnection(cm, channel->connectionId,
-                                 &UA_KEYVALUEMAP_NULL, &mc->messageBuffer);
+    if(mc->gatherSize > 0)
+        res = sendSymmetricChunkGathered(mc);
+    else
+        res = cm->sendWithConnection(cm, channel->connectionId,
+                                     &UA_KEYVALUEMAP_NULL, &mc->messageBuffer);
     if(res != UA_STATUSCODE_GOOD && UA_SecureChannel_isConnected(channel))
         channel->state = UA_SECURECHANNELSTATE_CLOSING;
     return res;
@@ -484,9 +542,31 @@ sendSymmetricChunk(UA_MessageContext *mc) {
  error:
     /* Free the unused message buffer */
     cm->freeNetworkBuffer(cm, channel->connectionId, &mc->messageBuffer);
+    mc->gatherSize = 0;
+    mc->gatherLength = 0;
     return res;
 }
 
+/* Callback from the encoding layer. Reference large array contents from the
+ * chunk instead of copying them into the message buffer. */
+static UA_StatusCode
+gatherSymmetricEncodingCallback(void *data, UA_Byte *buf_pos,
+                                const UA_Byte **buf_end,
+                                const UA_Byte *content, size_t length) {
+    UA_MessageContext *mc = (UA_MessageContext *)data;
+    if(length < UA_SECURECHANNEL_GATHER_MIN_LENGTH ||
+       mc->gatherSize >= UA_SECURECHANNEL_GATHER_MAX)
+        return UA_STATUSCODE_BADRESOURCEUNAVAILABLE;
+    mc->gather[mc->gatherSize].data = (UA_Byte*)(uintptr_t)content;
+    mc->gather[mc->gatherSize].length = length;
+    mc->gatherOffset[mc->gatherSize] =
+        (uintptr_t)buf_pos - (uintptr_t)mc->messageBuffer.data;
+    mc->gatherSize++;
+    mc->gatherLength += length;
+    *buf_end -= length; /* The referenced memory counts towards the chunk size */
+    return UA_STATUSCODE_GOOD;
+}
+
 /* Callback from the encoding layer. Send the chunk and replace the buffer. */
 static UA_StatusCode
 sendSymmetricEncodingCallback(void *data, UA_Byte **buf_pos,
@@ -535,6 +615,8 @@ UA_MessageContext_begin(UA_MessageContext *mc, UA_SecureChannel *channel,
     mc->final = false;
     mc->messageBuffer = UA_BYTESTRING_NULL;
     mc->messageType = messageType;
+    mc->gatherSize = 0;
+    mc->gatherLength = 0;
 
     /* Allocate the message buffer */
     UA_StatusCode res =
@@ -554,9 +636,19 @@ UA_MessageContext_encode(UA_MessageContext *mc, const void *content,
     UA_EncodeBinaryOptions encOpts;
     memset(&encOpts, 0, sizeof(UA_EncodeBinaryOptions));
     encOpts.namespaceMapping = mc->channel->namespaceMapping;
+
+    /* Large array contents are sent directly from the source memory if the
+     * chunks are neither signed nor encrypted */
+    UA_referenceEncodeBuffer gatherCallback = NULL;
+    if(mc->channel->securityMode == UA_MESSAGESECURITYMODE_NONE &&
+       mc->channel->connectionManager->sendWithConnectionVector)
+        gatherCallback = gatherSymmetricEncodingCallback;
+
     UA_StatusCode res =
-        UA_encodeBinaryInternal(content, contentType, &mc->buf_pos, &mc->buf_end,
-                                &encOpts, sendSymmetricEncodingCallback, mc);
+        UA_encodeBinaryInternalReference(content, contentType,
+                                         &mc->buf_pos, &mc->buf_end, &encOpts,
+                                         sendSymmetricEncodingCallback,
+                                         gatherCallback, mc);
     if(res != UA_STATUSCODE_GOOD && mc->messageBuffer.length > 0)
         UA_MessageContext_abort(mc);
     return res;
@@ -769,6 +861,15 @@ unpackPayloadMSG(UA_SecureChannel *channel, UA_Chunk *chunk,
 static UA_StatusCode
 extractCompleteChunk(UA_SecureChannel *channel, UA_Chunk *chunk,
                      UA_DateTime nowMonotonic) {
+    /* The chunk in the reassembly buffer is done. Continue with the remainder
+     * of the network buffer. */
+    if(channel->unprocessedOffset == channel->unprocessed.length &&
+       channel->unprocessedNext.length > 0) {
+        channel->unprocessed = channel->unprocessedNext;
+        channel->unprocessedOffset = 0;
+        UA_ByteString_init(&channel->unprocessedNext);
+    }
+
     /* At least 8 byte needed for the header */
     size_t offset = channel->unprocessedOffset;
     size_t remaining = channel->unprocessed.length - offset;
@@ -849,27 +950,98 @@ extractCompleteChunk(UA_SecureChannel *channel, UA_Chunk *chunk,
     return res;
 }
 
+/* Read the MessageSize from the header at pos (little-endian) */
+static UA_UInt32
+peekMessageSize(const UA_ByteString *buf, size_t pos) {
+    const UA_Byte *p = &buf->data[pos + 4];
+    return (UA_UInt32)p[0] | ((UA_UInt32)p[1] << 8) |
+        ((UA_UInt32)p[2] << 16) | ((UA_UInt32)p[3] << 24);
+}
+
+/* Grow the reassembly buffer that holds the unprocessed bytes */
+static UA_StatusCode
+growReassembly(UA_SecureChannel *channel, size_t size) {
+    UA_ByteString *r = &channel->reassembly;
+    if(size <= r->length)
+        return UA_STATUSCODE_GOOD;
+    UA_Byte *t = (UA_Byte*)UA_realloc(r->data, size);
+    if(!t)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    r->data = t;
+    r->length = size;
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Copy bytes from the buffer to the reassembly buffer until it holds "target"
+ * bytes. Returns the number of bytes taken from the buffer. */
+static size_t
+fillReassembly(UA_SecureChannel *channel, const UA_ByteString *buffer,
+               size_t taken, size_t target) {
+    if(target <= channel->unprocessed.length)
+        return 0;
+    size_t missing = target - channel->unprocessed.length;
+    if(missing > buffer->length - taken)
+        missing = buffer->length - taken;
+    if(missing == 0)
+        return 0;
+    memcpy(channel->unprocessed.data + channel->unprocessed.length,
+           buffer->data + taken, missing);
+    channel->unprocessed.length += missing;
+    return missing;
+}
+
 UA_StatusCode
 UA_SecureChannel_loadBuffer(UA_SecureChannel *channel, const UA_ByteString buffer) {
-    /* Append to the previous unprocessed buffer */
-    if(channel->unprocessed.length > 0) {
-        UA_assert(channel->unprocessedCopied == true);
-
-        UA_Byte *t = (UA_Byte*)
-            UA_realloc(channel->unprocessed.data,
-                       channel->unprocessed.length + buffer.length);
-        if(!t)
-            return UA_STATUSCODE_BADOUTOFMEMORY;
-
-        memcpy(t + channel->unprocessed.length, buffer.data, buffer.length);
-        channel->unprocessed.data = t;
-        channel->unprocessed.length += buffer.length;
+    /* Use the new buffer directly */
+    if(channel->unprocessed.length == 0) {
+        channel->unprocessed = buffer;
+        channel->unprocessedOffset = 0;
+        UA_ByteString_init(&channel->unprocessedNext);
         return UA_STATUSCODE_GOOD;
     }
 
-    /* Use the new buffer directly */
-    channel->unprocessed = buffer;
-    channel->unprocessedCopied = false;
+    /* The unprocessed bytes were persisted at the beginning of the reassembly
+     * buffer. Skip the complete chunks (if processing was stopped early) to
+     * find the trailing partial chunk. */
+    UA_assert(channel->unprocessed.data == channel->reassembly.data);
+    UA_assert(channel->unprocessedOffset == 0);
+    size_t pos = 0;
+    while(channel->unprocessed.length - pos >= UA_SECURECHANNEL_MESSAGEHEADER_LENGTH) {
+        UA_UInt32 size = peekMessageSize(&channel->unprocessed, pos);
+        if(size < UA_SECURECHANNEL_MESSAGE_MIN_LENGTH ||
+           size > channel->unprocessed.length - pos)
+            break; /* Invalid chunks are reported during the extraction */
+        pos += size;
+    }
+
+    /* Copy the missing header bytes */
+    UA_StatusCode res =
+        growReassembly(channel, pos + UA_SECURECHANNEL_MESSAGEHEADER_LENGTH);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    channel->unprocessed.data = channel->reassembly.data;
+    size_t taken = fillReassembly(channel, &buffer, 0,
+                                  pos + UA_SECURECHANNEL_MESSAGEHEADER_LENGTH);
+
+    /* Copy only the missing bytes to complete the chunk. Too large chunks are
+     * rejected during the extraction. */
+    if(channel->unprocessed.length - pos >= UA_SECURECHANNEL_MESSAGEHEADER_LENGTH) {
+        UA_UInt32 size = peekMessageSize(&channel->unprocessed, pos);
+        if(size >= UA_SECURECHANNEL_MESSAGE_MIN_LENGTH &&
+           size <= channel->config.recvBufferSize) {
+            res = growReassembly(channel, pos + size);
+            if(res != UA_STATUSCODE_GOOD)
+                return res;
+            channel->unprocessed.data = channel->reassembly.data;
+            taken += fillReassembly(channel, &buffer, taken, pos + size);
+        }
+    }
+
+    /* Continue with the remainder of the buffer after the reassembled chunk */
+    if(taken < buffer.length) {
+        channel->unprocessedNext.data = buffer.data + taken;
+        channel->unprocessedNext.length = buffer.length - taken;
+    }
     return UA_STATUSCODE_GOOD;
 }
 
@@ -881,6 +1053,9 @@ UA_SecureChannel_getCompleteMessage(UA_SecureChannel *channel,
     UA_Chunk chunk, *pchunk;
     UA_StatusCode res = UA_STATUSCODE_GOOD;
 
+    /* The previous message was processed */
+    deleteMessageChunks(channel);
+
  extract_chunk:
     /* Extract+decode the next chunk from the buffer */
     memset(&chunk, 0, sizeof(UA_Chunk));
@@ -951,8 +1126,43 @@ UA_SecureChannel_getCompleteMessage(UA_SecureChannel *channel,
         return UA_STATUSCODE_BADTCPMESSAGETOOLARGE;
     }
 
-    /* Assemble the full payload and store it in chunk.bytes */
-    if(messageSize > chunk.bytes.length) {
+    /* Return the first chunk as the payload and keep the following chunks for
+     * the decoding. This avoids the copy into a buffer for the full message. */
+    if(messageSize > chunk.bytes.length && channel->streamMessages &&
+       chunk.messageType == UA_MESSAGETYPE_MSG) {
+        UA_assert(first != NULL);
+        UA_Chunk *last = (UA_Chunk*)UA_malloc(sizeof(UA_Chunk));
+        if(!last) {
+            if(chunk.copied)
+                UA_ByteString_clear(&chunk.bytes);
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        }
+        *last = chunk;
+
+        /* Move the intermediate chunks and the final chunk */
+        UA_Chunk *next;
+        for(pchunk = TAILQ_NEXT(first, pointers); pchunk; pchunk = next) {
+            next = TAILQ_NEXT(pchunk, pointers);
+            if(chunk.requestId != pchunk->requestId)
+                continue;
+            channel->chunksCount--;
+            channel->chunksLength -= pchunk->bytes.length;
+            TAILQ_REMOVE(&channel->chunks, pchunk, pointers);
+            TAILQ_INSERT_TAIL(&channel->messageChunks, pchunk, pointers);
+            channel->messageChunksLength += pchunk->bytes.length;
+        }
+        TAILQ_INSERT_TAIL(&channel->messageChunks, last, pointers);
+        channel->messageChunksLength += last->bytes.length;
+
+        /* Take the first chunk */
+        chunk.bytes = first->bytes;
+        chunk.copied = first->copied;
+        channel->chunksCount--;
+        channel->chunksLength -= first->bytes.length;
+        TAILQ_REMOVE(&channel->chunks, first, pointers);
+        UA_free(first);
+    } else if(messageSize > chunk.bytes.length) {
+        /* Assemble the full payload and store it in chunk.bytes */
         UA_assert(first != NULL);
 
         /* Allocate the full memory and initialize with the first chunk content.
@@ -1015,10 +1225,36 @@ UA_SecureChannel_getCompleteMessage(UA_SecureChannel *channel,
     return UA_STATUSCODE_GOOD;
 }
 
+static UA_StatusCode
+nextMessageChunk(void *handle, UA_Byte **bufPos, const UA_Byte **bufEnd) {
+    UA_SecureChannel *channel = (UA_SecureChannel*)handle;
+    UA_Chunk *chunk = channel->messageChunksNext;
+    if(!chunk)
+        return UA_STATUSCODE_BADDECODINGERROR;
+    channel->messageChunksNext = TAILQ_NEXT(chunk, pointers);
+    *bufPos = chunk->bytes.data;
+    *bufEnd = chunk->bytes.data + chunk->bytes.length;
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_StatusCode
+UA_SecureChannel_decodeMessage(UA_SecureChannel *channel, const UA_ByteString *payload,
+                               size_t offset, void *dst, const UA_DataType *type,
+                               UA_DecodeBinaryOptions *options) {
+    if(TAILQ_EMPTY(&channel->messageChunks))
+        return UA_decodeBinaryInternal(payload, &offset, dst, type, options);
+    channel->messageChunksNext = TAILQ_FIRST(&channel->messageChunks);
+    return UA_decodeBinaryInternalStream(payload, &offset, channel->messageChunksLength,
+                                         dst, type, options, nextMessageChunk, channel);
+}
+
 UA_StatusCode
 UA_SecureChannel_persistBuffer(UA_SecureChannel *channel) {
     UA_StatusCode res = UA_STATUSCODE_GOOD;
 
+    /* The message chunks are not needed after the processing */
+    deleteMessageChunks(channel);
+
     /* Persist the chunks */
     UA_Chunk *chunk;
     TAILQ_FOREACH(chunk, &channel->chunks, pointers) {
@@ -1030,28 +1266,44 @@ UA_SecureChannel_persistBuffer(UA_SecureChannel *channel) {
         chunk->copied = true;
     }
 
-    /* No unprocessed bytes remaining */
+    /* The remaining bytes are the rest of the current buffer and (if the
+     * extraction stopped before reaching it) the remainder of the network
+     * buffer */
     UA_assert(channel->unprocessed.length >= channel->unprocessedOffset);
-    if(channel->unprocessed.length == channel->unprocessedOffset) {
-        if(channel->unprocessedCopied)
-            UA_ByteString_clear(&channel->unprocessed);
-        else
-            UA_ByteString_init(&channel->unprocessed);
+    UA_ByteString *r = &channel->reassembly;
+    size_t len1 = channel->unprocessed.length - channel->unprocessedOffset;
+    size_t len2 = channel->unprocessedNext.length;
+    UA_Byte *next = channel->unprocessedNext.data;
+    UA_ByteString_init(&channel->unprocessedNext);
+    if(len1 + len2 == 0) {
+        UA_ByteString_init(&channel->unprocessed);
         channel->unprocessedOffset = 0;
         return res;
     }
 
-    /* Allocate a new unprocessed ByteString.
-     * tmp is the empty string if malloc fails. */
-    UA_ByteString tmp = UA_BYTESTRING_NULL;
-    UA_ByteString remaining = channel->unprocessed;
-    remaining.data += channel->unprocessedOffset;
-    remaining.length -= channel->unprocessedOffset;
-    res |= UA_ByteString_copy(&remaining, &tmp);
-    if(channel->unprocessedCopied)
-        UA_ByteString_clear(&channel->unprocessed);
-    channel->unprocessed = tmp;
+    /* Move the remaining bytes to the beginning of the reassembly buffer. The
+     * chunks no longer point into it. Allocate it with the receive buffer size
+     * so that it does not need to grow for the next chunk. */
+    UA_Boolean inPlace = (r->data && channel->unprocessed.data == r->data);
+    if(inPlace)
+        memmove(r->data, r->data + channel->unprocessedOffset, len1);
+    else if(r->length < len1 + len2)
+        UA_ByteString_clear(r);
+    size_t size = len1 + len2;
+    if(size < channel->config.recvBufferSize)
+        size = channel->config.recvBufferSize;
+    UA_StatusCode res2 = growReassembly(channel, size);
+    if(res2 != UA_STATUSCODE_GOOD) {
+        UA_ByteString_init(&channel->unprocessed);
+        channel->unprocessedOffset = 0;
+        return res | res2;
+    }
+    if(!inPlace)
+        memcpy(r->data, channel->unprocessed.data + channel->unprocessedOffset, len1);
+    if(len2 > 0)
+        memcpy(r->data + len1, next, len2);
+    channel->unprocessed.data = r->data;
+    channel->unprocessed.length = len1 + len2;
     channel->unprocessedOffset = 0;
-    channel->unprocessedCopied = true;
     return res;
 }
@@ -60,6 +60,12 @@ typedef struct UA_Session UA_Session;
 /* Minimum length of a valid message (ERR message with an empty reason) */
 #define UA_SECURECHANNEL_MESSAGE_MIN_LENGTH 16
 
+/* Without message security, array contents of at least this length that span
+ * several chunks are sent directly from the source memory (max. number of
+ * references per chunk) */
+#define UA_SECURECHANNEL_GATHER_MIN_LENGTH 1024
+#define UA_SECURECHANNEL_GATHER_MAX 8
+
 /* For chunked requests */
 typedef struct UA_Chunk {
     TAILQ_ENTRY(UA_Chunk) pointers;
@@ -153,12 +159,40 @@ struct UA_SecureChannel {
     size_t chunksCount;
     size_t chunksLength;
 
-    /* Received buffer from which no chunks have been extracted so far */
+    /* Multi-chunk MSG messages are not assembled into a single buffer if
+     * enabled. The first chunk is returned as the payload. The following chunks
+     * are kept here until the next message is requested. The payload is
+     * decoded with UA_SecureChannel_decodeMessage. */
+    UA_Boolean streamMessages;
+    UA_ChunkQueue messageChunks;
+    size_t messageChunksLength;
+    UA_Chunk *messageChunksNext; /* Decoding position */
+
+    /* Received buffer from which no chunks have been extracted so far. Points
+     * either to the network buffer or to the reassembly buffer. */
     UA_ByteString unprocessed;
     size_t unprocessedOffset;
-    UA_Boolean unprocessedCopied;
     UA_DelayedCallback unprocessedDelayed;
 
+    /* Remainder of the network buffer. Processed after the chunk that was
+     * completed in the reassembly buffer. */
+    UA_ByteString unprocessedNext;
+
+    /* Chunks that are split over several network buffers are assembled here.
+     * Allocated once with the (negotiated) receive buffer size. */
+    UA_ByteString reassembly;
+
+    /* The service requests are decoded into the arena. It is reset after the
+     * response was sent. */
+    UA_Arena decodeArena;
+
+#if UA_MULTITHREADING >= 100
+    /* Serializes sending on the channel with the processing of received chunks
+     * (which can roll over the SecurityToken). Only used in the server. Taken
+     * after the server lock and before the EventLoop lock. */
+    UA_Lock lock;
+#endif
+
     void *processOPNHeaderApplication;
     UA_StatusCode (*processOPNHeader)(void *application, UA_SecureChannel *channel,
                                       const UA_AsymmetricAlgorithmSecurityHeader *asymHeader);
@@ -253,6 +287,13 @@ typedef struct {
     UA_Byte *buf_pos;
     const UA_Byte *buf_end;
 
+    /* Memory referenced by the current chunk. It is sent after the bytes of
+     * the messageBuffer before the offset. */
+    UA_ByteString gather[UA_SECURECHANNEL_GATHER_MAX];
+    size_t gatherOffset[UA_SECURECHANNEL_GATHER_MAX];
+    size_t gatherSize;
+    size_t gatherLength;
+
     UA_Boolean final;
 } UA_MessageContext;
 
@@ -263,7 +304,9 @@ UA_MessageContext_begin(UA_MessageContext *mc, UA_SecureChannel *channel,
 
 /* Encode the content and send out full chunks. If the return code is good, then
  * the ChunkInfo contains encoded content that has not been sent. If the return
- * code is bad, then the ChunkInfo has been cleaned up internally. */
+ * code is bad, then the ChunkInfo has been cleaned up internally. Large array
+ * contents can be referenced without copying. So the content must remain
+ * valid until _finish. */
 UA_StatusCode
 UA_MessageContext_encode(UA_MessageContext *mc, const void *content,
                          const UA_DataType *contentType);
@@ -286,11 +329,15 @@ UA_MessageContext_abort(UA_MessageContext *mc);
 /* Process a received buffer. This always has these three steps:
  *
  * 1. loadBuffer: The chunks in the SecureChannel are cut into chunks.
- *    The chunks can still point to the buffer.
+ *    The chunks can still point to the buffer. If a partial chunk remains from
+ *    the previous buffer, only the missing bytes are copied to complete it in
+ *    the reassembly buffer.
  * 2. getCompleteMessage: Assemble chunks into a complete message. This is
- *    repeated until an error occours or an empty message is returned.
- * 3. persistBuffer: Make a copy of the remaining unpprocessed bytestring. So
- *    that the NetworkManager can reuse or free the packet memory.
+ *    repeated until an error occours or an empty message is returned. With
+ *    streamMessages, the chunks of a MSG are decoded without assembling them.
+ *    They are valid until the next call.
+ * 3. persistBuffer: Move the remaining unprocessed bytes into the reassembly
+ *    buffer. So that the NetworkManager can reuse or free the packet memory.
  *
  * Note that only MSG and CLO messages are decrypted. HEL/ACK/OPN/... are
  * forwarded verbatim to the application. */
@@ -306,6 +353,15 @@ UA_SecureChannel_getCompleteMessage(UA_SecureChannel *channel,
 UA_StatusCode
 UA_SecureChannel_persistBuffer(UA_SecureChannel *channel);
 
+/* Decode a payload returned by getCompleteMessage starting at the offset. If
+ * the message was not assembled (see streamMessages), the decoding continues in
+ * the following chunks of the message. Can be called several times for the
+ * same message. */
+UA_StatusCode
+UA_SecureChannel_decodeMessage(UA_SecureChannel *channel, const UA_ByteString *payload,
+                               size_t offset, void *dst, const UA_DataType *type,
+                               UA_DecodeBinaryOptions *options);
+
 /* Internal methods in ua_securechannel_crypto.h */
 
 void
@@ -869,30 +869,132 @@ UA_NODEID_BYTESTRING_ALLOC(UA_UInt16 nsIndex,
     return id;
 }
 
-/* sdbm-hash (http://www.cse.yorku.ca/~oz/hash.html) */
+/* Word-at-a-time hash in the style of wyhash
+ * (https://github.com/wangyi-fudan/wyhash) with a fixed seed. The input is
+ * read as little-endian words. So the hash values are the same on all
+ * platforms. */
+
+#define UA_HASH_SEED 0xa0761d6478bd642fULL
+#define UA_HASH_P0   0xe7037ed1a0b428dbULL
+#define UA_HASH_P1   0x8ebc6af09c88c6e3ULL
+
+/* 64x64 -> 128bit multiplication. The low word is returned in a and the high
+ * word in b. */
+static UA_INLINE void
+hashMum(u64 *a, u64 *b) {
+#ifdef __SIZEOF_INT128__
+    __extension__ unsigned __int128 r = *a;
+    r *= *b;
+    *a = (u64)r;
+    *b = (u64)(r >> 64);
+#else
+    u64 ha = *a >> 32, hb = *b >> 32, la = (u32)*a, lb = (u32)*b;
+    u64 rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    u64 t = rl + (rm0 << 32);
+    u64 c = (t < rl);
+    u64 lo = t + (rm1 << 32);
+    c += (lo < t);
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+static UA_INLINE u64
+hashMix(u64 a, u64 b) {
+    hashMum(&a, &b);
+    return a ^ b;
+}
+
+static UA_INLINE u64
+hashRead64(const u8 *p) {
+#if UA_LITTLE_ENDIAN
+    u64 v;
+    memcpy(&v, p, 8);
+    return v;
+#else
+    return (u64)p[0] | ((u64)p[1] << 8) | ((u64)p[2] << 16) | ((u64)p[3] << 24) |
+        ((u64)p[4] << 32) | ((u64)p[5] << 40) | ((u64)p[6] << 48) | ((u64)p[7] << 56);
+#endif
+}
+
+static UA_INLINE u64
+hashRead32(const u8 *p) {
+#if UA_LITTLE_ENDIAN
+    u32 v;
+    memcpy(&v, p, 4);
+    return v;
+#else
+    return (u64)p[0] | ((u64)p[1] << 8) | ((u64)p[2] << 16) | ((u64)p[3] << 24);
+#endif
+}
+
+/* Mix the last two words of the input into the hash */
+static UA_INLINE u64
+hashFinal(u64 seed, u64 a, u64 b, u64 len) {
+    a ^= UA_HASH_P1;
+    b ^= seed;
+    hashMum(&a, &b);
+    return hashMix(a ^ UA_HASH_P0 ^ len, b ^ UA_HASH_P1);
+}
+
+static u64
+hashBytes(u64 seed, const u8 *p, size_t len) {
+    seed ^= hashMix(seed ^ UA_HASH_P0, UA_HASH_P1);
+    u64 a, b;
+    if(len <= 16) {
+        if(len >= 4) {
+            /* Two overlapping reads of 4 byte from the front and the back */
+            size_t k = (len >> 3) << 2;
+            a = (hashRead32(p) << 32) | hashRead32(p + k);
+            b = (hashRead32(p + len - 4) << 32) | hashRead32(p + len - 4 - k);
+        } else if(len > 0) {
+            a = ((u64)p[0] << 16) | ((u64)p[len >> 1] << 8) | p[len - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        for(; i > 16; i -= 16, p += 16)
+            seed = hashMix(hashRead64(p) ^ UA_HASH_P1, hashRead64(p + 8) ^ seed);
+        a = hashRead64(p + i - 16);
+        b = hashRead64(p + i - 8);
+    }
+    return hashFinal(seed, a, b, len);
+}
+
+static UA_INLINE u32
+hashFold(u64 h) {
+    return (u32)(h ^ (h >> 32));
+}
+
 u32
 UA_ByteString_hash(u32 initialHashValue,
                    const u8 *data, size_t size) {
-    u32 h = initialHashValue;
-    for(size_t i = 0; i < size; i++)
-        h = data[i] + (h << 6) + (h << 16) - h;
-    return h;
+    return hashFold(hashBytes(UA_HASH_SEED ^ initialHashValue, data, size));
 }
 
 u32
 UA_NodeId_hash(const UA_NodeId *n) {
+    u64 a, b;
     switch(n->identifierType) {
     case UA_NODEIDTYPE_NUMERIC:
     default:
-        return UA_ByteString_hash(n->namespaceIndex, (const u8*)&n->identifier.numeric,
-                                  sizeof(UA_UInt32));
+        /* Fast path with a single multiplication. The namespace index and the
+         * numeric identifier fit into one word. */
+        a = ((u64)n->namespaceIndex << 32) | n->identifier.numeric;
+        return hashFold(hashMix(a ^ UA_HASH_P0, UA_HASH_SEED));
     case UA_NODEIDTYPE_STRING:
     case UA_NODEIDTYPE_BYTESTRING:
         return UA_ByteString_hash(n->namespaceIndex, n->identifier.string.data,
                                   n->identifier.string.length);
     case UA_NODEIDTYPE_GUID:
-        return UA_ByteString_hash(n->namespaceIndex, (const u8*)&n->identifier.guid,
-                                  sizeof(UA_Guid));
+        /* Compose the words from the fields (not the memory layout of the
+         * struct) to be independent of the platform */
+        a = ((u64)n->identifier.guid.data1 << 32) |
+            ((u64)n->identifier.guid.data2 << 16) | n->identifier.guid.data3;
+        b = hashRead64(n->identifier.guid.data4);
+        return hashFold(hashFinal(UA_HASH_SEED ^ n->namespaceIndex, a, b, 16));
     }
 }
 
@@ -1143,7 +1245,7 @@ u32
 UA_ExpandedNodeId_hash(const UA_ExpandedNodeId *n) {
     u32 h = UA_NodeId_hash(&n->nodeId);
     if(n->serverIndex != 0)
-        h = UA_ByteString_hash(h, (const UA_Byte*)&n->serverIndex, 4);
+        h = hashFold(hashFinal(UA_HASH_SEED ^ h, n->serverIndex, 0, 4));
     if(n->namespaceUri.length != 0)
         h = UA_ByteString_hash(h, n->namespaceUri.data, n->namespaceUri.length);
     return h;
@@ -1349,6 +1451,201 @@ UA_Variant_hasArrayType(const UA_Variant *v, const UA_DataType *type) {
     return (!UA_Variant_isScalar(v)) && type == v->type;
 }
 
+/* Shared variant data (UA_VARIANT_DATA_SHARED) has a header in front of the
+ * data. The type and length are stored there for the cleanup when the last
+ * reference is released. The header size keeps the data aligned. */
+typedef struct {
+    void *refCount; /* Modified atomically */
+    const UA_DataType *type;
+    size_t length;
+} UA_VariantShared;
+
+#define UA_VARIANTSHARED_HEADER \
+    ((sizeof(UA_VariantShared) + 15) & ~(size_t)15)
+
+static UA_VariantShared *
+variantShared(const void *data) {
+    return (UA_VariantShared*)((uintptr_t)data - UA_VARIANTSHARED_HEADER);
+}
+
+/* Returns the new reference count */
+static uintptr_t
+variantSharedAdd(UA_VariantShared *vs, uintptr_t diff) {
+    void *oldCount, *newCount;
+    do {
+        oldCount = UA_atomic_load(&vs->refCount);
+        newCount = (void*)((uintptr_t)oldCount + diff);
+    } while(UA_atomic_cmpxchg(&vs->refCount, oldCount, newCount) != oldCount);
+    return (uintptr_t)newCount;
+}
+
+static void *
+variantSharedAlloc(size_t length, const UA_DataType *type) {
+    if(type->memSize > 0 &&
+       length > (SIZE_MAX - UA_VARIANTSHARED_HEADER) / type->memSize)
+        return NULL;
+    UA_VariantShared *vs = (UA_VariantShared*)
+        UA_malloc(UA_VARIANTSHARED_HEADER + (length * type->memSize));
+    if(!vs)
+        return NULL;
+    vs->refCount = (void*)(uintptr_t)1;
+    vs->type = type;
+    vs->length = length;
+    return (UA_Byte*)vs + UA_VARIANTSHARED_HEADER;
+}
+
+static void
+variantSharedRelease(void *data) {
+    UA_VariantShared *vs = variantShared(data);
+    if(variantSharedAdd(vs, (uintptr_t)-1) > 0)
+        return;
+    if(!vs->type->pointerFree) {
+        uintptr_t ptr = (uintptr_t)data;
+        for(size_t i = 0; i < vs->length; i++) {
+            clearJumpTable[vs->type->typeKind]((void*)ptr, vs->type);
+            ptr += vs->type->memSize;
+        }
+    }
+    UA_free(vs);
+}
+
+/* Deep-copy the data into a new shared allocation */
+static UA_StatusCode
+variantSharedCopy(const void *src, size_t length, const UA_DataType *type,
+                  void **dst) {
+    void *data = variantSharedAlloc(length, type);
+    if(!data)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    if(type->pointerFree) {
+        memcpy(data, src, length * type->memSize);
+        *dst = data;
+        return UA_STATUSCODE_GOOD;
+    }
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    uintptr_t ptrs = (uintptr_t)src;
+    uintptr_t ptrd = (uintptr_t)data;
+    for(size_t i = 0; i < length; i++) {
+        res |= UA_copy((void*)ptrs, (void*)ptrd, type); /* Clean on failure */
+        ptrs += type->memSize;
+        ptrd += type->memSize;
+    }
+    if(res != UA_STATUSCODE_GOOD) {
+        variantSharedRelease(data);
+        return res;
+    }
+    *dst = data;
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_Boolean
+UA_Variant_isExclusive(const UA_Variant *v) {
+    if(v->storageType == UA_VARIANT_DATA)
+        return true;
+    if(v->storageType != UA_VARIANT_DATA_SHARED)
+        return false;
+    if(v->data <= UA_EMPTY_ARRAY_SENTINEL)
+        return true;
+    return (UA_atomic_load(&variantShared(v->data)->refCount) == (void*)(uintptr_t)1);
+}
+
+/* Copy-on-write. Replace shared data that is referenced elsewhere with a
+ * private copy. */
+static UA_StatusCode
+variantMakeExclusive(UA_Variant *v) {
+    if(v->storageType != UA_VARIANT_DATA_SHARED || UA_Variant_isExclusive(v))
+        return UA_STATUSCODE_GOOD;
+    UA_VariantShared *vs = variantShared(v->data);
+    void *data;
+    UA_StatusCode res = variantSharedCopy(v->data, vs->length, vs->type, &data);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    variantSharedRelease(v->data);
+    v->data = data;
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_StatusCode
+UA_Variant_copyShared(const UA_Variant *src, UA_Variant *dst) {
+    if(src->storageType == UA_VARIANT_DATA_SHARED || !src->type ||
+       src->data <= UA_EMPTY_ARRAY_SENTINEL)
+        return UA_Variant_copy(src, dst);
+
+    UA_Variant_init(dst);
+    size_t length = (UA_Variant_isScalar(src)) ? 1 : src->arrayLength;
+    UA_StatusCode res = variantSharedCopy(src->data, length, src->type, &dst->data);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    dst->storageType = UA_VARIANT_DATA_SHARED;
+    dst->type = src->type;
+    dst->arrayLength = src->arrayLength;
+    if(src->arrayDimensions) {
+        res = UA_Array_copy(src->arrayDimensions, src->arrayDimensionsSize,
+                            (void**)&dst->arrayDimensions, &UA_TYPES[UA_TYPES_UINT32]);
+        if(res != UA_STATUSCODE_GOOD) {
+            UA_Variant_clear(dst);
+            return res;
+        }
+        dst->arrayDimensionsSize = src->arrayDimensionsSize;
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_StatusCode
+UA_Variant_share(UA_Variant *v) {
+    if(v->storageType == UA_VARIANT_DATA_SHARED || !v->type ||
+       v->data <= UA_EMPTY_ARRAY_SENTINEL)
+        return UA_STATUSCODE_GOOD;
+
+    /* Borrowed data is copied */
+    if(v->storageType == UA_VARIANT_DATA_NODELETE) {
+        UA_Variant tmp;
+        UA_StatusCode res = UA_Variant_copyShared(v, &tmp);
+        if(res == UA_STATUSCODE_GOOD)
+            *v = tmp;
+        return res;
+    }
+
+    /* Move the members into the shared allocation */
+    size_t length = (UA_Variant_isScalar(v)) ? 1 : v->arrayLength;
+    void *data = variantSharedAlloc(length, v->type);
+    if(!data)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    memcpy(data, v->data, length * v->type->memSize);
+    UA_free(v->data);
+    v->data = data;
+    v->storageType = UA_VARIANT_DATA_SHARED;
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_StatusCode
+UA_Variant_unshare(UA_Variant *v) {
+    if(v->storageType != UA_VARIANT_DATA_SHARED)
+        return UA_STATUSCODE_GOOD;
+    if(v->data <= UA_EMPTY_ARRAY_SENTINEL) {
+        v->storageType = UA_VARIANT_DATA;
+        return UA_STATUSCODE_GOOD;
+    }
+
+    UA_VariantShared *vs = variantShared(v->data);
+    void *data;
+    if(UA_Variant_isExclusive(v)) {
+        /* Move the members out of the shared allocation */
+        data = UA_malloc(vs->length * vs->type->memSize);
+        if(!data)
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        memcpy(data, v->data, vs->length * vs->type->memSize);
+        UA_free(vs);
+    } else {
+        UA_StatusCode res = UA_Array_copy(v->data, vs->length, &data, vs->type);
+        if(res != UA_STATUSCODE_GOOD)
+            return res;
+        variantSharedRelease(v->data);
+    }
+    v->data = data;
+    v->storageType = UA_VARIANT_DATA;
+    return UA_STATUSCODE_GOOD;
+}
+
 static void
 Variant_clear(UA_Variant *p, const UA_DataType *_) {
     /* The content is "borrowed" */
@@ -1357,9 +1654,13 @@ Variant_clear(UA_Variant *p, const UA_DataType *_) {
 
     /* Delete the value */
     if(p->type && p->data > UA_EMPTY_ARRAY_SENTINEL) {
-        if(p->arrayLength == 0)
-            p->arrayLength = 1;
-        UA_Array_delete(p->data, p->arrayLength, p->type);
+        if(p->storageType == UA_VARIANT_DATA_SHARED) {
+            variantSharedRelease(p->data);
+        } else {
+            if(p->arrayLength == 0)
+                p->arrayLength = 1;
+            UA_Array_delete(p->data, p->arrayLength, p->type);
+        }
         p->data = NULL;
     }
 
@@ -1370,13 +1671,21 @@ Variant_clear(UA_Variant *p, const UA_DataType *_) {
 
 static UA_StatusCode
 Variant_copy(UA_Variant const *src, UA_Variant *dst, const UA_DataType *_) {
-    size_t length = src->arrayLength;
-    if(UA_Variant_isScalar(src))
-        length = 1;
-    UA_StatusCode retval = UA_Array_copy(src->data, length,
-                                         &dst->data, src->type);
-    if(retval != UA_STATUSCODE_GOOD)
-        return retval;
+    UA_StatusCode retval = UA_STATUSCODE_GOOD;
+    if(src->storageType == UA_VARIANT_DATA_SHARED &&
+       src->type && src->data > UA_EMPTY_ARRAY_SENTINEL) {
+        /* Take a reference instead of copying */
+        variantSharedAdd(variantShared(src->data), 1);
+        dst->data = src->data;
+        dst->storageType = UA_VARIANT_DATA_SHARED;
+    } else {
+        size_t length = src->arrayLength;
+        if(UA_Variant_isScalar(src))
+            length = 1;
+        retval = UA_Array_copy(src->data, length, &dst->data, src->type);
+        if(retval != UA_STATUSCODE_GOOD)
+            return retval;
+    }
     dst->arrayLength = src->arrayLength;
     dst->type = src->type;
     if(src->arrayDimensions) {
@@ -1732,6 +2041,11 @@ Variant_setRange(UA_Variant *v, void *array, size_t arraySize,
     if(count != arraySize)
         return UA_STATUSCODE_BADINDEXRANGEINVALID;
 
+    /* Don't modify shared data that is referenced elsewhere */
+    retval = variantMakeExclusive(v);
+    if(retval != UA_STATUSCODE_GOOD)
+        return retval;
+
     /* Move/copy the elements */
     size_t block_count = count / block;
     size_t elem_size = v->type->memSize;
@@ -2227,6 +2541,17 @@ stringOrder(const UA_String *p1, const UA_String *p2, const UA_DataType *type) {
 
 static UA_Order
 nodeIdOrder(const UA_NodeId *p1, const UA_NodeId *p2, const UA_DataType *_) {
+    /* Fast path for numeric identifiers. The namespace index and the identifier
+     * combined into a single word have the same ordering. */
+    if(p1->identifierType == UA_NODEIDTYPE_NUMERIC &&
+       p2->identifierType == UA_NODEIDTYPE_NUMERIC) {
+        u64 k1 = ((u64)p1->namespaceIndex << 32) | p1->identifier.numeric;
+        u64 k2 = ((u64)p2->namespaceIndex << 32) | p2->identifier.numeric;
+        if(k1 == k2)
+            return UA_ORDER_EQ;
+        return (k1 < k2) ? UA_ORDER_LESS : UA_ORDER_MORE;
+    }
+
     /* Compare namespaceIndex */
     if(p1->namespaceIndex != p2->namespaceIndex)
         return (p1->namespaceIndex < p2->namespaceIndex) ? UA_ORDER_LESS : UA_ORDER_MORE;
@@ -2355,7 +2680,9 @@ variantOrder(const UA_Variant *p1, const UA_Variant *p2, const UA_DataType *_) {
         UA_Boolean s2 = UA_Variant_isScalar(p2);
         if(s1 != s2)
             return s1 ? UA_ORDER_LESS : UA_ORDER_MORE;
-        if(s1) {
+        if(p1->data == p2->data && p1->arrayLength == p2->arrayLength) {
+            o = UA_ORDER_EQ; /* Shared data or the same pointer */
+        } else if(s1) {
             o = orderJumpTable[p1->type->typeKind](p1->data, p2->data, p1->type);
         } else {
             /* Mismatching array length? */
@@ -22,6 +22,10 @@
 #include "ua_types_encoding_binary.h"
 #include "util/ua_util_internal.h"
 
+#ifdef UA_ENABLE_TYPES_BINARY_CODECS
+#include <open62541/transport_generated.h>
+#endif
+
 /**
  * Type Encoding and Decoding
  * --------------------------
@@ -32,10 +36,107 @@
  * Breaking a message up into chunks is integrated with the encoding. When the
  * end of a buffer is reached, a callback is executed that sends the current
  * buffer as a chunk and exchanges the encoding buffer "underneath" the ongoing
- * encoding. This reduces the RAM requirements and unnecessary copying. */
+ * encoding. This reduces the RAM requirements and unnecessary copying.
+ *
+ * Symmetrically, the decoding can continue in a sequence of buffers (e.g. the
+ * chunks of a message) without assembling them first. A value that spans the
+ * boundary between two buffers is copied into a small stitch buffer inside the
+ * context and decoded from there. */
+
+/*********/
+/* Arena */
+/*********/
+
+struct UA_ArenaBlock {
+    UA_ArenaBlock *next;
+    size_t size;
+    size_t used;
+};
+
+/* Alignment of the allocations. Also for the start of the memory after the
+ * block header. */
+#define UA_ARENA_ALIGN 8
+#define UA_ARENA_ALIGNED(x) (((x) + (UA_ARENA_ALIGN - 1)) & ~(size_t)(UA_ARENA_ALIGN - 1))
+#define UA_ARENA_HEADER UA_ARENA_ALIGNED(sizeof(UA_ArenaBlock))
+
+void
+UA_Arena_init(UA_Arena *arena) {
+    arena->blocks = NULL;
+    arena->blockSize = UA_ARENA_BLOCKSIZE;
+    arena->used = 0;
+}
+
+void *
+UA_Arena_calloc(void *context, size_t nelem, size_t elsize) {
+    UA_Arena *arena = (UA_Arena*)context;
+    if(elsize > 0 && nelem > (SIZE_MAX - UA_ARENA_HEADER - UA_ARENA_ALIGN) / elsize)
+        return NULL;
+    size_t size = UA_ARENA_ALIGNED(nelem * elsize);
+    if(size == 0)
+        size = UA_ARENA_ALIGN; /* Return distinct pointers */
+
+    UA_ArenaBlock *b = arena->blocks;
+    if(!b || b->size - b->used < size) {
+        /* Allocate a new block. Allocations larger than the block size get a
+         * dedicated block behind the current block. So the remaining space of
+         * the current block can still be used. */
+        UA_Boolean dedicated = (b && size > arena->blockSize);
+        size_t blockSize = (size > arena->blockSize) ? size : arena->blockSize;
+        UA_ArenaBlock *nb = (UA_ArenaBlock*)UA_malloc(UA_ARENA_HEADER + blockSize);
+        if(!nb)
+            return NULL;
+        nb->size = blockSize;
+        nb->used = 0;
+        if(dedicated) {
+            nb->next = b->next;
+            b->next = nb;
+        } else {
+            nb->next = b;
+            arena->blocks = nb;
+        }
+        b = nb;
+    }
+
+    void *p = (UA_Byte*)b + UA_ARENA_HEADER + b->used;
+    b->used += size;
+    arena->used += size;
+    memset(p, 0, size);
+    return p;
+}
+
+void
+UA_Arena_reset(UA_Arena *arena) {
+    UA_ArenaBlock *b = arena->blocks;
+    if(b && !b->next && b->size <= UA_ARENA_MAXRETAIN) {
+        b->used = 0;
+        arena->used = 0;
+        return;
+    }
+
+    /* Several blocks were needed. Free them and allocate a single block for
+     * the entire size the next time. */
+    size_t used = arena->used;
+    UA_Arena_clear(arena);
+    if(used > arena->blockSize)
+        arena->blockSize = (used < UA_ARENA_MAXRETAIN) ?
+            UA_ARENA_ALIGNED(used) : UA_ARENA_MAXRETAIN;
+}
+
+void
+UA_Arena_clear(UA_Arena *arena) {
+    UA_ArenaBlock *b = arena->blocks;
+    while(b) {
+        UA_ArenaBlock *next = b->next;
+        UA_free(b);
+        b = next;
+    }
+    arena->blocks = NULL;
+    arena->used = 0;
+}
 
-/* Part 6 §5.1.5: Decoders shall support at least 100 nesting levels */
-#define UA_ENCODING_MAX_RECURSION 100
+/************/
+/* Decoding */
+/************/
 
 void *
 ctxCalloc(Ctx *ctx, size_t nelem, size_t elsize) {
@@ -85,16 +186,119 @@ ctxClearNodeId(Ctx *ctx, UA_NodeId *p) {
             return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED; \
     } else                                                  \
 
+/* Ensure that n bytes can be decoded from the current position */
+#define CHECK_DECODE_BUFSIZE(n)                             \
+    if(UA_UNLIKELY(ctx->pos + (n) > ctx->end)) {            \
+        status bufret = nextDecodeBuffer(ctx, n);           \
+        UA_CHECK_STATUS(bufret, return bufret);             \
+    }
+
 /* Send the current chunk and replace the buffer */
-static status exchangeBuffer(Ctx *ctx) {
+status exchangeBuffer(Ctx *ctx) {
     if(!ctx->exchangeBufferCallback)
         return UA_STATUSCODE_BADENCODINGERROR;
     return ctx->exchangeBufferCallback(ctx->exchangeBufferCallbackHandle,
                                        &ctx->pos, &ctx->end);
 }
 
-/* If encoding fails, exchange the buffer and try again. */
+/* Bytes left for decoding in the current and all following buffers */
+static size_t
+decodeAvailable(const Ctx *ctx) {
+    if(ctx->pos > ctx->end)
+        return 0;
+    size_t avail = (size_t)(ctx->end - ctx->pos) + ctx->remaining;
+    if(ctx->resumePos)
+        avail += (size_t)(ctx->resumeEnd - ctx->resumePos);
+    return avail;
+}
+
+/* Continue in the next buffer. After the stitch buffer was consumed, resume in
+ * the buffer where the stitching stopped. */
 static status
+takeDecodeBuffer(Ctx *ctx) {
+    if(ctx->resumePos) {
+        ctx->pos = ctx->resumePos;
+        ctx->end = ctx->resumeEnd;
+        ctx->resumePos = NULL;
+        ctx->resumeEnd = NULL;
+        return UA_STATUSCODE_GOOD;
+    }
+    status ret = ctx->nextBufferCallback(ctx->exchangeBufferCallbackHandle,
+                                         &ctx->pos, &ctx->end);
+    UA_CHECK_STATUS(ret, return ret);
+    size_t len = (size_t)(ctx->end - ctx->pos);
+    ctx->remaining = (len < ctx->remaining) ? ctx->remaining - len : 0;
+    return UA_STATUSCODE_GOOD;
+}
+
+status
+nextDecodeBuffer(Ctx *ctx, size_t n) {
+    if(!ctx->nextBufferCallback || ctx->pos > ctx->end ||
+       n > UA_DECODE_STITCH_MAX || n > decodeAvailable(ctx))
+        return UA_STATUSCODE_BADDECODINGERROR;
+
+    /* Move the rest of the current buffer to the front of the stitch buffer.
+     * The current buffer can be the stitch buffer itself. */
+    size_t have = (size_t)(ctx->end - ctx->pos);
+    memmove(ctx->stitch, ctx->pos, have);
+
+    /* Fill up the stitch buffer */
+    while(have < n) {
+        status ret = takeDecodeBuffer(ctx);
+        UA_CHECK_STATUS(ret, return ret);
+        size_t len = (size_t)(ctx->end - ctx->pos);
+        if(have == 0 && len >= n)
+            return UA_STATUSCODE_GOOD; /* No need to stitch */
+        size_t take = (n - have < len) ? n - have : len;
+        memcpy(&ctx->stitch[have], ctx->pos, take);
+        ctx->pos += take;
+        have += take;
+    }
+
+    /* Decode from the stitch buffer */
+    ctx->resumePos = ctx->pos;
+    ctx->resumeEnd = ctx->end;
+    ctx->pos = ctx->stitch;
+    ctx->end = &ctx->stitch[n];
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Copy n bytes that may span several buffers */
+static status
+decodeCopy(Ctx *ctx, u8 *dst, size_t n) {
+    while(n > 0) {
+        if(ctx->pos == ctx->end) {
+            status ret = nextDecodeBuffer(ctx, 1);
+            UA_CHECK_STATUS(ret, return ret);
+        }
+        size_t len = (size_t)(ctx->end - ctx->pos);
+        if(len > n)
+            len = n;
+        memcpy(dst, ctx->pos, len);
+        ctx->pos += len;
+        dst += len;
+        n -= len;
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+#ifdef UA_ENABLE_TYPES_BINARY_CODECS
+/* Look up the generated codec in the side table of the type array. Types
+ * defined outside of the library have no codec. */
+static UA_INLINE const UA_DataTypeBinaryCodec *
+getBinaryCodec(const UA_DataType *type) {
+    uintptr_t t = (uintptr_t)type;
+    if(t >= (uintptr_t)UA_TYPES && t < (uintptr_t)&UA_TYPES[UA_TYPES_COUNT])
+        return UA_TYPES_BINARYCODECS[type - UA_TYPES];
+    if(t >= (uintptr_t)UA_TRANSPORT &&
+       t < (uintptr_t)&UA_TRANSPORT[UA_TRANSPORT_COUNT])
+        return UA_TRANSPORT_BINARYCODECS[type - UA_TRANSPORT];
+    return NULL;
+}
+#endif
+
+/* If encoding fails, exchange the buffer and try again. */
+status
 encodeWithExchangeBuffer(Ctx *ctx, const void *ptr, const UA_DataType *type) {
     u8 *oldpos = ctx->pos; /* Last known good position */
 /**
@@ -109,13 +313,19 @@ encodeWithExchangeBuffer(Ctx *ctx, const void *ptr, const UA_DataType *type) {
     const u8 *oldend = ctx->end;
     (void)oldend; /* For compilers who don't understand NDEBUG... */
 #endif
-    status ret = encodeBinaryJumpTable[type->typeKind](ctx, ptr, type);
+    encodeBinarySignature encodeFunc = encodeBinaryJumpTable[type->typeKind];
+#ifdef UA_ENABLE_TYPES_BINARY_CODECS
+    const UA_DataTypeBinaryCodec *codec = getBinaryCodec(type);
+    if(codec)
+        encodeFunc = codec->encodeBinary;
+#endif
+    status ret = encodeFunc(ctx, ptr, type);
     if(ret == UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED) {
         UA_assert(ctx->end == oldend);
         ctx->pos = oldpos; /* Set to the last known good position and exchange */
         ret = exchangeBuffer(ctx);
         UA_CHECK_STATUS(ret, return ret);
-        ret = encodeBinaryJumpTable[type->typeKind](ctx, ptr, type);
+        ret = encodeFunc(ctx, ptr, type);
     }
     return ret;
 }
@@ -188,7 +398,7 @@ FUNC_ENCODE_BINARY(Boolean) {
 }
 
 FUNC_DECODE_BINARY(Boolean) {
-    UA_CHECK(ctx->pos + 1 <= ctx->end, return UA_STATUSCODE_BADDECODINGERROR);
+    CHECK_DECODE_BUFSIZE(1);
     *dst = (*ctx->pos > 0) ? true : false;
     ++ctx->pos;
     return UA_STATUSCODE_GOOD;
@@ -204,8 +414,7 @@ FUNC_ENCODE_BINARY(Byte) {
 }
 
 FUNC_DECODE_BINARY(Byte) {
-    UA_CHECK(ctx->pos + sizeof(u8) <= ctx->end,
-             return UA_STATUSCODE_BADDECODINGERROR);
+    CHECK_DECODE_BUFSIZE(sizeof(u8));
     *dst = *ctx->pos;
     ++ctx->pos;
     return UA_STATUSCODE_GOOD;
@@ -225,8 +434,7 @@ FUNC_ENCODE_BINARY(UInt16) {
 }
 
 FUNC_DECODE_BINARY(UInt16) {
-    UA_CHECK(ctx->pos + sizeof(u16) <= ctx->end,
-             return UA_STATUSCODE_BADDECODINGERROR);
+    CHECK_DECODE_BUFSIZE(sizeof(u16));
 #if UA_BINARY_OVERLAYABLE_INTEGER
     memcpy(dst, ctx->pos, sizeof(u16));
 #else
@@ -250,8 +458,7 @@ FUNC_ENCODE_BINARY(UInt32) {
 }
 
 FUNC_DECODE_BINARY(UInt32) {
-    UA_CHECK(ctx->pos + sizeof(u32) <= ctx->end,
-             return UA_STATUSCODE_BADDECODINGERROR);
+    CHECK_DECODE_BUFSIZE(sizeof(u32));
 #if UA_BINARY_OVERLAYABLE_INTEGER
     memcpy(dst, ctx->pos, sizeof(u32));
 #else
@@ -275,8 +482,7 @@ FUNC_ENCODE_BINARY(UInt64) {
 }
 
 FUNC_DECODE_BINARY(UInt64) {
-    UA_CHECK(ctx->pos + sizeof(u64) <= ctx->end,
-             return UA_STATUSCODE_BADDECODINGERROR);
+    CHECK_DECODE_BUFSIZE(sizeof(u64));
 #if UA_BINARY_OVERLAYABLE_INTEGER
     memcpy(dst, ctx->pos, sizeof(u64));
 #else
@@ -429,19 +635,32 @@ Array_encodeBinaryOverlayable(Ctx *ctx, uintptr_t ptr, size_t memSize) {
         return UA_STATUSCODE_GOOD;
     }
 
-    /* Loop as long as more elements remain than fit into the chunk */
+    /* Loop as long as more elements remain than fit into the chunk. The
+     * content is referenced instead of copied if the callback accepts. Once the
+     * buffer gets exchanged, the encoding is no longer rolled back to an
+     * earlier position that would invalidate the reference. */
+    UA_Boolean exchanged = false;
     while(ctx->end < ctx->pos + memSize) {
         size_t possible = ((uintptr_t)ctx->end - (uintptr_t)ctx->pos);
-        memcpy(ctx->pos, (void*)ptr, possible);
-        ctx->pos += possible;
+        if(!ctx->referenceCallback ||
+           ctx->referenceCallback(ctx->exchangeBufferCallbackHandle, ctx->pos,
+                                  &ctx->end, (const u8*)ptr, possible) != UA_STATUSCODE_GOOD) {
+            memcpy(ctx->pos, (void*)ptr, possible);
+            ctx->pos += possible;
+        }
         ptr += possible;
         status ret = exchangeBuffer(ctx);
         UA_assert(ret != UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED);
         UA_CHECK_STATUS(ret, return ret);
         memSize -= possible;
+        exchanged = true;
     }
 
     /* Encode the remaining elements */
+    if(exchanged && ctx->referenceCallback &&
+       ctx->referenceCallback(ctx->exchangeBufferCallbackHandle, ctx->pos,
+                              &ctx->end, (const u8*)ptr, memSize) == UA_STATUSCODE_GOOD)
+        return UA_STATUSCODE_GOOD;
     memcpy(ctx->pos, (void*)ptr, memSize);
     ctx->pos += memSize;
     return UA_STATUSCODE_GOOD;
@@ -460,7 +679,7 @@ Array_encodeBinaryComplex(Ctx *ctx, uintptr_t ptr, size_t length,
     return UA_STATUSCODE_GOOD;
 }
 
-static status
+status
 Array_encodeBinary(Ctx *ctx, const void *src, size_t length, const UA_DataType *type) {
     /* Check and convert the array length to int32 */
     i32 signed_length = -1;
@@ -487,7 +706,7 @@ Array_encodeBinary(Ctx *ctx, const void *src, size_t length, const UA_DataType *
     return ret;
 }
 
-static status
+status
 Array_decodeBinary(Ctx *ctx, void *UA_RESTRICT *UA_RESTRICT dst,
                    size_t *out_length, const UA_DataType *type) {
     /* Decode the length */
@@ -513,27 +732,62 @@ Array_decodeBinary(Ctx *ctx, void *UA_RESTRICT *UA_RESTRICT dst,
      * sizeof(UA_DataValue) == 80 and an empty DataValue is encoded with just
      * one byte. We use 128 as the smallest power of 2 larger than 80. */
     size_t length = (size_t)signed_length;
-    UA_CHECK(ctx->pos + ((type->memSize * length) / 128) <= ctx->end,
+    UA_CHECK((type->memSize * length) / 128 <= decodeAvailable(ctx),
              return UA_STATUSCODE_BADDECODINGERROR);
 
-    /* Allocate memory */
-    *dst = ctxCalloc(ctx, length, type->memSize);
-    UA_CHECK_MEM(*dst, return UA_STATUSCODE_BADOUTOFMEMORY);
-
     if(type->overlayable) {
-        /* memcpy overlayable array */
-        if(ctx->pos + (type->memSize * length) > ctx->end){
-            ctxFree(ctx, *dst);
-            *dst = NULL;
-            return UA_STATUSCODE_BADDECODINGERROR;
+        size_t size = type->memSize * length;
+        if(ctx->pos + size > ctx->end) {
+            /* The content spans several buffers. Copy piecewise. */
+            UA_CHECK(size <= decodeAvailable(ctx),
+                     return UA_STATUSCODE_BADDECODINGERROR);
+            *dst = ctxCalloc(ctx, length, type->memSize);
+            UA_CHECK_MEM(*dst, return UA_STATUSCODE_BADOUTOFMEMORY);
+            ret = decodeCopy(ctx, (u8*)*dst, size);
+            if(ret != UA_STATUSCODE_GOOD) {
+                ctxFree(ctx, *dst);
+                *dst = NULL;
+                return ret;
+            }
+            *out_length = length;
+            return UA_STATUSCODE_GOOD;
+        }
+
+        /* Borrow the array content from the input buffer. Only if the position
+         * is aligned for the member type and not in the stitch buffer. The
+         * lowest set bit of memSize is a multiple of the alignment of the
+         * type. */
+        size_t align = type->memSize & (~type->memSize + 1);
+        if(align > 8)
+            align = 8;
+        if(ctx->opts.borrowBuffer && ctx->opts.calloc && !ctx->resumePos &&
+           ((uintptr_t)ctx->pos & (align - 1)) == 0) {
+            *dst = ctx->pos;
+            ctx->pos += size;
+            *out_length = length;
+            return UA_STATUSCODE_GOOD;
         }
-        memcpy(*dst, ctx->pos, type->memSize * length);
-        ctx->pos += type->memSize * length;
+
+        /* memcpy overlayable array */
+        *dst = ctxCalloc(ctx, length, type->memSize);
+        UA_CHECK_MEM(*dst, return UA_STATUSCODE_BADOUTOFMEMORY);
+        memcpy(*dst, ctx->pos, size);
+        ctx->pos += size;
     } else {
+        /* Allocate memory */
+        *dst = ctxCalloc(ctx, length, type->memSize);
+        UA_CHECK_MEM(*dst, return UA_STATUSCODE_BADOUTOFMEMORY);
+
         /* Decode array members */
+        decodeBinarySignature decodeFunc = decodeBinaryJumpTable[type->typeKind];
+#ifdef UA_ENABLE_TYPES_BINARY_CODECS
+        const UA_DataTypeBinaryCodec *codec = getBinaryCodec(type);
+        if(codec)
+            decodeFunc = codec->decodeBinary;
+#endif
         uintptr_t ptr = (uintptr_t)*dst;
         for(size_t i = 0; i < length; ++i) {
-            ret = decodeBinaryJumpTable[type->typeKind](ctx, (void*)ptr, type);
+            ret = decodeFunc(ctx, (void*)ptr, type);
             if(ret != UA_STATUSCODE_GOOD) {
                 if(!ctx->opts.calloc) {
                     /* +1 because last element is also already initialized */
@@ -579,8 +833,8 @@ FUNC_DECODE_BINARY(Guid) {
     ret |= DECODE_DIRECT(&dst->data1, UInt32);
     ret |= DECODE_DIRECT(&dst->data2, UInt16);
     ret |= DECODE_DIRECT(&dst->data3, UInt16);
-    UA_CHECK(ctx->pos + (8*sizeof(u8)) <= ctx->end,
-             return UA_STATUSCODE_BADDECODINGERROR);
+    UA_CHECK_STATUS(ret, return ret);
+    CHECK_DECODE_BUFSIZE(8*sizeof(u8));
     memcpy(dst->data4, ctx->pos, 8*sizeof(u8));
     ctx->pos += 8;
     return ret;
@@ -752,7 +1006,7 @@ FUNC_ENCODE_BINARY(ExpandedNodeId) {
 
 FUNC_DECODE_BINARY(ExpandedNodeId) {
     /* Decode the encoding mask */
-    UA_CHECK(ctx->pos + 1 <= ctx->end, return UA_STATUSCODE_BADDECODINGERROR);
+    CHECK_DECODE_BUFSIZE(1);
     u8 encoding = *ctx->pos;
 
     /* Decode the NodeId */
@@ -769,7 +1023,7 @@ FUNC_DECODE_BINARY(ExpandedNodeId) {
                                               dst->namespaceUri,
                                               &dst->nodeId.namespaceIndex);
             if(foundNsUri == UA_STATUSCODE_GOOD)
-                UA_String_clear(&dst->namespaceUri);
+                ctxClear(ctx, &dst->namespaceUri, &UA_TYPES[UA_TYPES_STRING]);
         }
     }
 
@@ -935,8 +1189,10 @@ FUNC_ENCODE_BINARY(ExtensionObject) {
 static status
 ExtensionObject_decodeBinaryContent(Ctx *ctx, UA_ExtensionObject *dst,
                                     const UA_NodeId *typeId) {
-    /* Lookup the datatype */
-    const UA_DataType *type = UA_findDataTypeByBinaryInternal(ctx, typeId);
+    /* Lookup the datatype. Not done for lazy decoding. */
+    const UA_DataType *type = NULL;
+    if(!ctx->opts.lazyExtensionObjects)
+        type = UA_findDataTypeByBinaryInternal(ctx, typeId);
 
     /* Unknown type, just take the binary content */
     if(!type) {
@@ -945,54 +1201,175 @@ ExtensionObject_decodeBinaryContent(Ctx *ctx, UA_ExtensionObject *dst,
         return DECODE_DIRECT(&dst->content.encoded.body, String); /* ByteString */
     }
 
+    /* Jump over the length field (TODO: check if the decoded length matches) */
+    u32 length;
+    status ret = DECODE_DIRECT(&length, UInt32);
+    UA_CHECK_STATUS(ret, return ret);
+
     /* Allocate memory */
     dst->content.decoded.data = ctxCalloc(ctx, 1, type->memSize);
     UA_CHECK_MEM(dst->content.decoded.data, return UA_STATUSCODE_BADOUTOFMEMORY);
 
-    /* Jump over the length field (TODO: check if the decoded length matches) */
-    ctx->pos += 4;
-
     /* Decode */
     dst->encoding = UA_EXTENSIONOBJECT_DECODED;
     dst->content.decoded.type = type;
     return decodeBinaryJumpTable[type->typeKind](ctx, dst->content.decoded.data, type);
 }
 
-FUNC_DECODE_BINARY(ExtensionObject) {
-    u8 encoding = 0;
-    UA_NodeId binTypeId;
-    UA_NodeId_init(&binTypeId);
-
+/* Decode the ExtensionObject after the header with the type NodeId and the
+ * encoding byte was read. Takes ownership of the type NodeId. */
+static status
+ExtensionObject_decodeBinaryAfterHeader(Ctx *ctx, UA_ExtensionObject *dst,
+                                        UA_NodeId *binTypeId, u8 encoding) {
     status ret = UA_STATUSCODE_GOOD;
-    ret |= DECODE_DIRECT(&binTypeId, NodeId);
-    ret |= DECODE_DIRECT(&encoding, Byte);
-    UA_CHECK_STATUS(ret, ctxClearNodeId(ctx, &binTypeId); return ret);
-
     switch(encoding) {
     case UA_EXTENSIONOBJECT_ENCODED_BYTESTRING:
-        ret = ExtensionObject_decodeBinaryContent(ctx, dst, &binTypeId);
-        ctxClearNodeId(ctx, &binTypeId);
+        ret = ExtensionObject_decodeBinaryContent(ctx, dst, binTypeId);
+        ctxClearNodeId(ctx, binTypeId);
         break;
     case UA_EXTENSIONOBJECT_ENCODED_NOBODY:
         dst->encoding = (UA_ExtensionObjectEncoding)encoding;
-        dst->content.encoded.typeId = binTypeId; /* move to dst */
+        dst->content.encoded.typeId = *binTypeId; /* move to dst */
         dst->content.encoded.body = UA_BYTESTRING_NULL;
         break;
     case UA_EXTENSIONOBJECT_ENCODED_XML:
         dst->encoding = (UA_ExtensionObjectEncoding)encoding;
-        dst->content.encoded.typeId = binTypeId; /* move to dst */
+        dst->content.encoded.typeId = *binTypeId; /* move to dst */
         ret = DECODE_DIRECT(&dst->content.encoded.body, String); /* ByteString */
         UA_CHECK_STATUS(ret, ctxClearNodeId(ctx, &dst->content.encoded.typeId));
         break;
     default:
-        ctxClearNodeId(ctx, &binTypeId);
+        ctxClearNodeId(ctx, binTypeId);
         ret = UA_STATUSCODE_BADDECODINGERROR;
         break;
     }
-
     return ret;
 }
 
+FUNC_DECODE_BINARY(ExtensionObject) {
+    u8 encoding = 0;
+    UA_NodeId binTypeId;
+    UA_NodeId_init(&binTypeId);
+
+    status ret = UA_STATUSCODE_GOOD;
+    ret |= DECODE_DIRECT(&binTypeId, NodeId);
+    ret |= DECODE_DIRECT(&encoding, Byte);
+    UA_CHECK_STATUS(ret, ctxClearNodeId(ctx, &binTypeId); return ret);
+
+    return ExtensionObject_decodeBinaryAfterHeader(ctx, dst, &binTypeId, encoding);
+}
+
+/* Decode the body of an ExtensionObject that was kept encoded */
+static status
+ExtensionObject_decodeBinaryBody(Ctx *ctx, UA_ExtensionObject *eo) {
+    if(eo->encoding != UA_EXTENSIONOBJECT_ENCODED_BYTESTRING)
+        return UA_STATUSCODE_GOOD;
+
+    /* Unknown type, the ExtensionObject stays encoded */
+    const UA_DataType *type =
+        UA_findDataTypeByBinaryInternal(ctx, &eo->content.encoded.typeId);
+    if(!type)
+        return UA_STATUSCODE_GOOD;
+
+    void *data = ctxCalloc(ctx, 1, type->memSize);
+    UA_CHECK_MEM(data, return UA_STATUSCODE_BADOUTOFMEMORY);
+
+    /* Decode from the body */
+    UA_ByteString *body = &eo->content.encoded.body;
+    ctx->pos = body->data;
+    ctx->end = body->data + body->length;
+    ctx->depth = 0;
+    status ret = decodeBinaryJumpTable[type->typeKind](ctx, data, type);
+    if(ret != UA_STATUSCODE_GOOD) {
+        ctxClear(ctx, data, type);
+        ctxFree(ctx, data);
+        return ret;
+    }
+
+    /* Release the encoded content. If the body was borrowed, then also the
+     * decoded content is allocated without freeing. */
+    ctxClearNodeId(ctx, &eo->content.encoded.typeId);
+    if(body->data > (u8*)UA_EMPTY_ARRAY_SENTINEL)
+        ctxFree(ctx, body->data);
+    eo->encoding = UA_EXTENSIONOBJECT_DECODED;
+    eo->content.decoded.type = type;
+    eo->content.decoded.data = data;
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_StatusCode
+UA_ExtensionObject_decodeBinaryBody(UA_ExtensionObject *eo,
+                                    UA_DecodeBinaryOptions *options) {
+    Ctx ctx;
+    memset(&ctx, 0, sizeof(Ctx));
+    if(options)
+        ctx.opts = *options;
+    return ExtensionObject_decodeBinaryBody(&ctx, eo);
+}
+
+/* Unwrap the ExtensionObjects of a variant if all members are decoded with the
+ * same type. This gives the same result as the eager decoding. */
+static status
+Variant_unwrapDecodedExtensionObjects(Ctx *ctx, UA_Variant *v) {
+    if(v->type != &UA_TYPES[UA_TYPES_EXTENSIONOBJECT] ||
+       v->data <= UA_EMPTY_ARRAY_SENTINEL)
+        return UA_STATUSCODE_GOOD;
+
+    UA_ExtensionObject *eo = (UA_ExtensionObject*)v->data;
+    size_t length = (UA_Variant_isScalar(v)) ? 1 : v->arrayLength;
+    const UA_DataType *type = eo[0].content.decoded.type;
+    for(size_t i = 0; i < length; i++) {
+        if(eo[i].encoding != UA_EXTENSIONOBJECT_DECODED ||
+           eo[i].content.decoded.type != type)
+            return UA_STATUSCODE_GOOD;
+    }
+
+    /* Unwrap a scalar */
+    if(UA_Variant_isScalar(v)) {
+        v->data = eo->content.decoded.data;
+        v->type = type;
+        ctxFree(ctx, eo);
+        return UA_STATUSCODE_GOOD;
+    }
+
+    /* Move the members into an unwrapped array */
+    u8 *unwrapped = (u8*)ctxCalloc(ctx, length, type->memSize);
+    UA_CHECK_MEM(unwrapped, return UA_STATUSCODE_BADOUTOFMEMORY);
+    for(size_t i = 0; i < length; i++) {
+        memcpy(unwrapped + (i * type->memSize),
+               eo[i].content.decoded.data, type->memSize);
+        ctxFree(ctx, eo[i].content.decoded.data);
+    }
+    ctxFree(ctx, eo);
+    v->data = unwrapped;
+    v->type = type;
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_StatusCode
+UA_Variant_decodeBinaryExtensionObjects(UA_Variant *v,
+                                        UA_DecodeBinaryOptions *options) {
+    if(v->type != &UA_TYPES[UA_TYPES_EXTENSIONOBJECT] ||
+       v->storageType != UA_VARIANT_DATA ||
+       v->data <= UA_EMPTY_ARRAY_SENTINEL)
+        return UA_STATUSCODE_GOOD;
+
+    Ctx ctx;
+    memset(&ctx, 0, sizeof(Ctx));
+    if(options)
+        ctx.opts = *options;
+
+    /* Decode the bodies */
+    UA_ExtensionObject *eo = (UA_ExtensionObject*)v->data;
+    size_t length = (UA_Variant_isScalar(v)) ? 1 : v->arrayLength;
+    for(size_t i = 0; i < length; i++) {
+        status ret = ExtensionObject_decodeBinaryBody(&ctx, &eo[i]);
+        UA_CHECK_STATUS(ret, return ret);
+    }
+
+    return Variant_unwrapDecodedExtensionObjects(&ctx, v);
+}
+
 /* Variant */
 
 static status
@@ -1094,10 +1471,6 @@ FUNC_ENCODE_BINARY(Variant) {
 
 static status
 Variant_decodeBinaryUnwrapExtensionObject(Ctx *ctx, UA_Variant *dst) {
-    /* Save the position in the ByteString. If unwrapping is not possible, start
-     * from here to decode a normal ExtensionObject. */
-    u8 *old_pos = ctx->pos;
-
     /* Decode the DataType */
     UA_NodeId typeId;
     UA_NodeId_init(&typeId);
@@ -1109,24 +1482,37 @@ Variant_decodeBinaryUnwrapExtensionObject(Ctx *ctx, UA_Variant *dst) {
     ret = DECODE_DIRECT(&encoding, Byte);
     UA_CHECK_STATUS(ret, ctxClearNodeId(ctx, &typeId); return ret);
 
-    /* Search for the datatype. Default to ExtensionObject. */
+    /* Search for the datatype */
+    const UA_DataType *type = NULL;
     if(encoding == UA_EXTENSIONOBJECT_ENCODED_BYTESTRING &&
-       (dst->type = UA_findDataTypeByBinaryInternal(ctx, &typeId)) != NULL) {
-        /* Jump over the length field (TODO: check if length matches) */
-        ctx->pos += 4;
-    } else {
-        /* Reset and decode as ExtensionObject */
+       !ctx->opts.lazyExtensionObjects)
+        type = UA_findDataTypeByBinaryInternal(ctx, &typeId);
+
+    /* Unknown type. Continue decoding as an ExtensionObject after the header.
+     * This does not rewind so that the decoding never goes back to a previous
+     * buffer. */
+    if(!type) {
         dst->type = &UA_TYPES[UA_TYPES_EXTENSIONOBJECT];
-        ctx->pos = old_pos;
+        dst->data = ctxCalloc(ctx, 1, dst->type->memSize);
+        UA_CHECK_MEM(dst->data, ctxClearNodeId(ctx, &typeId);
+                     return UA_STATUSCODE_BADOUTOFMEMORY);
+        return ExtensionObject_decodeBinaryAfterHeader(ctx, (UA_ExtensionObject*)dst->data,
+                                                       &typeId, encoding);
     }
     ctxClearNodeId(ctx, &typeId);
 
+    /* Jump over the length field (TODO: check if length matches) */
+    u32 length;
+    ret = DECODE_DIRECT(&length, UInt32);
+    UA_CHECK_STATUS(ret, return ret);
+
     /* Allocate memory */
-    dst->data = ctxCalloc(ctx, 1, dst->type->memSize);
+    dst->data = ctxCalloc(ctx, 1, type->memSize);
     UA_CHECK_MEM(dst->data, return UA_STATUSCODE_BADOUTOFMEMORY);
+    dst->type = type;
 
     /* Decode the content */
-    return decodeBinaryJumpTable[dst->type->typeKind](ctx, dst->data, dst->type);
+    return decodeBinaryJumpTable[type->typeKind](ctx, dst->data, type);
 }
 
 /* Unwraps all ExtensionObjects in an array if they have the same type.
@@ -1270,8 +1656,15 @@ FUNC_DECODE_BINARY(Variant) {
         }
     } else {
         /* Decode array */
-        if(typeKind != UA_DATATYPEKIND_EXTENSIONOBJECT) {
+        if(typeKind != UA_DATATYPEKIND_EXTENSIONOBJECT ||
+           ctx->opts.lazyExtensionObjects) {
+            ret = Array_decodeBinary(ctx, &dst->data, &dst->arrayLength, dst->type);
+        } else if(ctx->nextBufferCallback) {
+            /* The header comparison looks ahead and cannot go back to a
+             * previous buffer. Unwrap after decoding the ExtensionObjects. */
             ret = Array_decodeBinary(ctx, &dst->data, &dst->arrayLength, dst->type);
+            if(ret == UA_STATUSCODE_GOOD)
+                ret = Variant_unwrapDecodedExtensionObjects(ctx, dst);
         } else {
             ret = Variant_decodeBinaryUnwrapExtensionObjectArray(ctx, &dst->data,
                                                                  &dst->arrayLength, &dst->type);
@@ -1480,6 +1873,13 @@ FUNC_DECODE_BINARY(DiagnosticInfo) {
 
 static status
 encodeBinaryStruct(Ctx *ctx, const void *src, const UA_DataType *type) {
+#ifdef UA_ENABLE_TYPES_BINARY_CODECS
+    /* Use the generated encoding */
+    const UA_DataTypeBinaryCodec *codec = getBinaryCodec(type);
+    if(codec)
+        return codec->encodeBinary(ctx, src, type);
+#endif
+
     /* Check the recursion limit */
     UA_CHECK(ctx->depth <= UA_ENCODING_MAX_RECURSION,
              return UA_STATUSCODE_BADENCODINGERROR);
@@ -1672,6 +2072,17 @@ UA_encodeBinaryInternal(const void *src, const UA_DataType *type,
                         UA_EncodeBinaryOptions *options,
                         UA_exchangeEncodeBuffer exchangeCallback,
                         void *exchangeHandle) {
+    return UA_encodeBinaryInternalReference(src, type, bufPos, bufEnd, options,
+                                            exchangeCallback, NULL, exchangeHandle);
+}
+
+status
+UA_encodeBinaryInternalReference(const void *src, const UA_DataType *type,
+                                 u8 **bufPos, const u8 **bufEnd,
+                                 UA_EncodeBinaryOptions *options,
+                                 UA_exchangeEncodeBuffer exchangeCallback,
+                                 UA_referenceEncodeBuffer referenceCallback,
+                                 void *exchangeHandle) {
     if(!type || !src)
         return UA_STATUSCODE_BADENCODINGERROR;
 
@@ -1682,6 +2093,7 @@ UA_encodeBinaryInternal(const void *src, const UA_DataType *type,
     ctx.end = *bufEnd;
     ctx.depth = 0;
     ctx.exchangeBufferCallback = exchangeCallback;
+    ctx.referenceCallback = referenceCallback;
     ctx.exchangeBufferCallbackHandle = exchangeHandle;
     if(options)
         ctx.opts.namespaceMapping = options->namespaceMapping;
@@ -1733,6 +2145,13 @@ decodeBinaryNotImplemented(Ctx *ctx, void *dst, const UA_DataType *type) {
 
 static status
 decodeBinaryStructure(Ctx *ctx, void *dst, const UA_DataType *type) {
+#ifdef UA_ENABLE_TYPES_BINARY_CODECS
+    /* Use the generated decoding */
+    const UA_DataTypeBinaryCodec *codec = getBinaryCodec(type);
+    if(codec)
+        return codec->decodeBinary(ctx, dst, type);
+#endif
+
     /* Check the recursion limit */
     UA_CHECK(ctx->depth <= UA_ENCODING_MAX_RECURSION,
              return UA_STATUSCODE_BADENCODINGERROR);
@@ -1899,6 +2318,9 @@ UA_decodeBinaryInternal(const UA_ByteString *src, size_t *offset,
     ctx.pos = &src->data[*offset];
     ctx.end = &src->data[src->length];
     ctx.depth = 0;
+    ctx.nextBufferCallback = NULL;
+    ctx.remaining = 0;
+    ctx.resumePos = NULL;
     if(options)
         ctx.opts = *options;
     else
@@ -1921,6 +2343,41 @@ UA_decodeBinaryInternal(const UA_ByteString *src, size_t *offset,
     return ret;
 }
 
+status
+UA_decodeBinaryInternalStream(const UA_ByteString *src, size_t *offset,
+                              size_t remaining, void *dst, const UA_DataType *type,
+                              UA_DecodeBinaryOptions *options,
+                              UA_exchangeDecodeBuffer nextBufferCallback,
+                              void *handle) {
+    /* Set up the context */
+    Ctx ctx;
+    memset(&ctx, 0, sizeof(Ctx));
+    ctx.pos = &src->data[*offset];
+    ctx.end = &src->data[src->length];
+    ctx.nextBufferCallback = nextBufferCallback;
+    ctx.exchangeBufferCallbackHandle = handle;
+    ctx.remaining = remaining;
+    if(options)
+        ctx.opts = *options;
+    size_t available = decodeAvailable(&ctx);
+
+    /* Decode */
+    memset(dst, 0, type->memSize); /* Initialize the value */
+    status ret = decodeBinaryJumpTable[type->typeKind](&ctx, dst, type);
+
+    if(UA_LIKELY(ret == UA_STATUSCODE_GOOD)) {
+        /* Advance the offset by the decoded length */
+        *offset += available - decodeAvailable(&ctx);
+        if(options)
+            options->decodedLength = *offset;
+    } else {
+        /* Clean up */
+        ctxClear(&ctx, dst, type);
+    }
+
+    return ret;
+}
+
 UA_StatusCode
 UA_decodeBinary(const UA_ByteString *inBuf,
                 void *p, const UA_DataType *type,
@@ -16,9 +16,33 @@
 
 _UA_BEGIN_DECLS
 
+/* Part 6 §5.1.5: Decoders shall support at least 100 nesting levels */
+#define UA_ENCODING_MAX_RECURSION 100
+
 typedef UA_StatusCode (*UA_exchangeEncodeBuffer)(void *handle, UA_Byte **bufPos,
                                                  const UA_Byte **bufEnd);
 
+/* Called for the content of large overlayable arrays (e.g. ByteStrings) that
+ * spans several buffers. If the callback returns Good, the memory is referenced
+ * at the current buffer position instead of being copied into the buffer. The
+ * callback then reduces *bufEnd by the referenced length. Otherwise the content
+ * is copied. The referenced memory has to remain valid until the buffer is
+ * exchanged or the encoding has finished. */
+typedef UA_StatusCode (*UA_referenceEncodeBuffer)(void *handle, UA_Byte *bufPos,
+                                                  const UA_Byte **bufEnd,
+                                                  const UA_Byte *data,
+                                                  size_t length);
+
+/* Returns the next buffer when decoding from a sequence of buffers. The
+ * buffers have to remain valid until the decoding has finished. */
+typedef UA_StatusCode (*UA_exchangeDecodeBuffer)(void *handle, UA_Byte **bufPos,
+                                                 const UA_Byte **bufEnd);
+
+/* Decoding from a sequence of buffers copies values that span the boundary
+ * between two buffers into the stitch buffer. The generated codecs decode runs
+ * of fixed-size members up to that length at once. */
+#define UA_DECODE_STITCH_MAX 64
+
 typedef struct {
     /* Pointers to the current and last buffer position */
     UA_Byte *pos;
@@ -30,9 +54,47 @@ typedef struct {
     UA_DecodeBinaryOptions opts;
 
     UA_exchangeEncodeBuffer exchangeBufferCallback;
+    UA_referenceEncodeBuffer referenceCallback; /* Uses the same handle */
     void *exchangeBufferCallbackHandle;
+
+    /* Decoding from a sequence of buffers. Uses the same handle. */
+    UA_exchangeDecodeBuffer nextBufferCallback;
+    size_t remaining;          /* Length of the buffers not yet returned */
+    UA_Byte *resumePos;        /* Continue here after the stitch buffer */
+    const UA_Byte *resumeEnd;
+    UA_Byte stitch[UA_DECODE_STITCH_MAX];
 } Ctx;
 
+/* Bump allocator for the calloc decoding option. The memory of all values
+ * decoded into the arena is released at once when the arena is reset. So the
+ * values must not be _clear'ed. The memory is not initialized when the arena
+ * is reset. Only the requested memory is zeroed during the allocation. */
+typedef struct UA_ArenaBlock UA_ArenaBlock;
+
+typedef struct {
+    UA_ArenaBlock *blocks; /* The block with the current position is first */
+    size_t blockSize;      /* Size of the next allocated block */
+    size_t used;           /* Allocated since the last reset */
+} UA_Arena;
+
+/* Initial size of the blocks. If a reset finds that several blocks were
+ * needed, the next block is allocated for the entire size. Blocks larger than
+ * UA_ARENA_MAXRETAIN are not kept after a reset. */
+#define UA_ARENA_BLOCKSIZE (1 << 14)
+#define UA_ARENA_MAXRETAIN (1 << 20)
+
+void UA_Arena_init(UA_Arena *arena);
+
+/* Has the signature of the calloc decoding option */
+void * UA_Arena_calloc(void *arena, size_t nelem, size_t elsize);
+
+/* Release all allocated memory at once. This is O(1) unless the previous
+ * allocations did not fit into a single block. */
+void UA_Arena_reset(UA_Arena *arena);
+
+/* Free the blocks */
+void UA_Arena_clear(UA_Arena *arena);
+
 void * ctxCalloc(Ctx *ctx, size_t nelem, size_t elsize);
 void ctxFree(Ctx *ctx, void *p);
 void ctxClear(Ctx *ctx, void *p, const UA_DataType *type);
@@ -56,6 +118,111 @@ extern const decodeBinarySignature decodeBinaryJumpTable[UA_DATATYPEKINDS];
 #define ENCODE_BINARY(VAR, TYPE)                                    \
     encodeBinaryJumpTable[UA_DATATYPEKIND_##TYPE](ctx, VAR, NULL);
 
+/* Send the current chunk and replace the buffer */
+UA_StatusCode
+exchangeBuffer(Ctx *ctx);
+
+/* Encode a scalar. If the buffer is full, exchange the buffer and try again. */
+UA_StatusCode
+encodeWithExchangeBuffer(Ctx *ctx, const void *ptr, const UA_DataType *type);
+
+UA_StatusCode
+Array_encodeBinary(Ctx *ctx, const void *src, size_t length,
+                   const UA_DataType *type);
+
+/* Called when fewer than n bytes remain in the buffer. Switches to the next
+ * buffer and, if the n bytes span the boundary, to the stitch buffer. Fails if
+ * not decoding from a sequence of buffers. n must not exceed
+ * UA_DECODE_STITCH_MAX. */
+UA_StatusCode
+nextDecodeBuffer(Ctx *ctx, size_t n);
+
+UA_StatusCode
+Array_decodeBinary(Ctx *ctx, void *UA_RESTRICT *UA_RESTRICT dst,
+                   size_t *out_length, const UA_DataType *type);
+
+/**
+ * Generated Codecs
+ * ----------------
+ * With UA_ENABLE_TYPES_BINARY_CODECS, generate_datatypes.py emits straight-line
+ * en-/decoding functions for the structures in the library. They access the
+ * members directly instead of walking the UA_DataTypeMember descriptions. The
+ * generic structure handling dispatches to them. The size computation uses the
+ * encoding function with a NULL buffer end.
+ *
+ * The codecs are kept in side tables next to the type description arrays. So
+ * the public UA_DataType structure is the same with and without the codecs. */
+
+typedef struct {
+    encodeBinarySignature encodeBinary;
+    decodeBinarySignature decodeBinary;
+} UA_DataTypeBinaryCodec;
+
+#ifdef UA_ENABLE_TYPES_BINARY_CODECS
+
+/* Indexed like UA_TYPES and UA_TRANSPORT. NULL for the types without a
+ * generated codec. */
+extern const UA_DataTypeBinaryCodec *UA_TYPES_BINARYCODECS[];
+extern const UA_DataTypeBinaryCodec *UA_TRANSPORT_BINARYCODECS[];
+
+#endif
+
+/* Same as encodeWithExchangeBuffer. But the encoding function is known by the
+ * caller and can be called directly. */
+static UA_INLINE UA_StatusCode
+encodeWithExchangeBufferFunc(Ctx *ctx, encodeBinarySignature encodeFunc,
+                             const void *ptr, const UA_DataType *type) {
+    UA_Byte *oldpos = ctx->pos; /* Last known good position */
+    UA_StatusCode ret = encodeFunc(ctx, ptr, type);
+    if(ret != UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED)
+        return ret;
+    ctx->pos = oldpos;
+    ret = exchangeBuffer(ctx);
+    if(ret != UA_STATUSCODE_GOOD)
+        return ret;
+    return encodeFunc(ctx, ptr, type);
+}
+
+/* Used by the generated codecs for runs of fixed-size integer members. The
+ * buffer length has to be checked beforehand. The shifts are merged into a
+ * single load/store by the compiler on little-endian architectures. */
+static UA_INLINE void
+encodeFixed16(UA_Byte *pos, UA_UInt16 v) {
+    pos[0] = (UA_Byte)v;
+    pos[1] = (UA_Byte)(v >> 8);
+}
+
+static UA_INLINE void
+encodeFixed32(UA_Byte *pos, UA_UInt32 v) {
+    pos[0] = (UA_Byte)v;
+    pos[1] = (UA_Byte)(v >> 8);
+    pos[2] = (UA_Byte)(v >> 16);
+    pos[3] = (UA_Byte)(v >> 24);
+}
+
+static UA_INLINE void
+encodeFixed64(UA_Byte *pos, UA_UInt64 v) {
+    encodeFixed32(pos, (UA_UInt32)v);
+    encodeFixed32(pos + 4, (UA_UInt32)(v >> 32));
+}
+
+static UA_INLINE UA_UInt16
+decodeFixed16(const UA_Byte *pos) {
+    return (UA_UInt16)(pos[0] | (pos[1] << 8));
+}
+
+static UA_INLINE UA_UInt32
+decodeFixed32(const UA_Byte *pos) {
+    return (UA_UInt32)pos[0] | ((UA_UInt32)pos[1] << 8) |
+        ((UA_UInt32)pos[2] << 16) | ((UA_UInt32)pos[3] << 24);
+}
+
+static UA_INLINE UA_UInt64
+decodeFixed64(const UA_Byte *pos) {
+    return (UA_UInt64)decodeFixed32(pos) |
+        ((UA_UInt64)decodeFixed32(pos + 4) << 32);
+}
+
 /* Encodes the scalar value described by type in the binary encoding. Encoding
  * is thread-safe if thread-local variables are enabled. Encoding is also
  * reentrant and can be safely called from signal handlers or interrupts.
@@ -82,6 +249,17 @@ UA_encodeBinaryInternal(const void *src, const UA_DataType *type,
                         void *exchangeHandle)
     UA_INTERNAL_FUNC_ATTR_WARN_UNUSED_RESULT;
 
+/* Same as UA_encodeBinaryInternal. The referenceCallback (with the
+ * exchangeHandle) can take over large array contents without copying. */
+UA_StatusCode
+UA_encodeBinaryInternalReference(const void *src, const UA_DataType *type,
+                                 UA_Byte **bufPos, const UA_Byte **bufEnd,
+                                 UA_EncodeBinaryOptions *options,
+                                 UA_exchangeEncodeBuffer exchangeCallback,
+                                 UA_referenceEncodeBuffer referenceCallback,
+                                 void *exchangeHandle)
+    UA_INTERNAL_FUNC_ATTR_WARN_UNUSED_RESULT;
+
 /* Decodes a scalar value described by type from binary encoding. Decoding is
  * reentrant and can be safely called from signal handlers or interrupts.
  *
@@ -104,6 +282,19 @@ UA_decodeBinaryInternal(const UA_ByteString *src, size_t *offset,
                         UA_DecodeBinaryOptions *options)
     UA_INTERNAL_FUNC_ATTR_WARN_UNUSED_RESULT;
 
+/* Decode from a sequence of buffers. Starts at the offset in src and continues
+ * in the buffers returned by the callback. The remaining argument is the total
+ * length of those buffers. Values are only borrowed from the buffers (with the
+ * borrowBuffer option) if they do not span a boundary. On success, the offset
+ * is advanced by the decoded length as if the buffers were concatenated. */
+UA_StatusCode
+UA_decodeBinaryInternalStream(const UA_ByteString *src, size_t *offset,
+                              size_t remaining, void *dst, const UA_DataType *type,
+                              UA_DecodeBinaryOptions *options,
+                              UA_exchangeDecodeBuffer nextBufferCallback,
+                              void *handle)
+    UA_INTERNAL_FUNC_ATTR_WARN_UNUSED_RESULT;
+
 const UA_DataType *
 UA_findDataTypeByBinary(const UA_NodeId *typeId);
 
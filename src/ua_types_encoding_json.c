@@ -443,11 +443,14 @@ ENCODE_JSON(String) {
 
     const unsigned char *end = src->data + src->length;
     for(const unsigned char *pos = src->data; pos < end; pos++) {
-        /* Skip to the first character that needs escaping */
+        /* Skip to the first character that needs escaping. The scan also stops
+         * at single quotes. They are written unescaped. */
         const unsigned char *start = pos;
-        for(; pos < end; pos++) {
-            if(*pos < ' ' || *pos == 127 || *pos == '\\' || *pos == '\"')
+        while(pos < end) {
+            pos += cj5_scan_plain((const char*)pos, (size_t)(end - pos));
+            if(pos == end || *pos != '\'')
                 break;
+            pos++;
         }
 
         /* Write out the unescaped sequence */
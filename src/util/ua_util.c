@@ -83,9 +83,10 @@ adjustType(UA_Variant *value, const UA_DataType *targetType) {
         return;
 
     /* A string is written to a byte array. the valuerank and array dimensions
-     * are checked later */
+     * are checked later. (The data pointer of shared data cannot change.) */
     if(targetType == &UA_TYPES[UA_TYPES_BYTE] &&
        type == &UA_TYPES[UA_TYPES_BYTESTRING] &&
+       value->storageType != UA_VARIANT_DATA_SHARED &&
        UA_Variant_isScalar(value)) {
         UA_ByteString *str = (UA_ByteString*)value->data;
         value->type = &UA_TYPES[UA_TYPES_BYTE];
@@ -381,6 +381,12 @@ typedef union {
 #endif
 } UA_Response;
 
+/* The data of the variant can be modified in-place. True for the
+ * UA_VARIANT_DATA storage type and for shared data that is referenced only by
+ * this variant. */
+UA_Boolean
+UA_Variant_isExclusive(const UA_Variant *v);
+
 /* Do not expose UA_String_equal_ignorecase to public API as it currently only handles
  * ASCII strings, and not UTF8! */
 UA_Boolean UA_EXPORT
@@ -0,0 +1,197 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <open62541/types.h>
+
+#include "ua_types_encoding_binary.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Compares the generated binary codecs with the generic en-/decoding along the
+ * member descriptions for typical service messages. For the generic handling,
+ * the codecs are removed from the side table. The results are printed to
+ * stdout as CSV with one line per measurement:
+ *
+ *   name,path,operation,bytes,iterations,ns_per_op
+ *
+ * Usage: benchmark_codecs [-t <milliseconds per measurement>] [-f <name filter>] */
+
+#define BATCH 64
+#define MESSAGE_VALUES 100
+
+static UA_DateTime minDuration = 20 * UA_DATETIME_MSEC;
+static const char *filter = NULL;
+
+static const UA_DataTypeBinaryCodec *codecs[UA_TYPES_COUNT];
+
+static void
+disableCodecs(void) {
+    for(size_t i = 0; i < UA_TYPES_COUNT; i++) {
+        codecs[i] = UA_TYPES_BINARYCODECS[i];
+        UA_TYPES_BINARYCODECS[i] = NULL;
+    }
+}
+
+static void
+enableCodecs(void) {
+    for(size_t i = 0; i < UA_TYPES_COUNT; i++)
+        UA_TYPES_BINARYCODECS[i] = codecs[i];
+}
+
+/*************/
+/* Measuring */
+/*************/
+
+typedef struct {
+    const void *value;
+    const UA_DataType *type;
+    UA_ByteString encoded;
+    UA_ByteString buf; /* Target buffer for the encoding */
+} Context;
+
+typedef UA_StatusCode (*Operation)(Context *c);
+
+static UA_StatusCode
+opEncode(Context *c) {
+    UA_ByteString out = c->buf;
+    return UA_encodeBinary(c->value, c->type, &out, NULL);
+}
+
+static UA_StatusCode
+opDecode(Context *c) {
+    void *dst = UA_new(c->type);
+    UA_StatusCode res = UA_decodeBinary(&c->encoded, dst, c->type, NULL);
+    UA_delete(dst, c->type);
+    return res;
+}
+
+static void
+measure(const char *name, const char *path, const char *operation,
+        Operation op, Context *c) {
+    UA_DateTime duration = 0;
+    size_t iterations = 0;
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    do {
+        UA_DateTime begin = UA_DateTime_nowMonotonic();
+        for(size_t i = 0; i < BATCH; i++)
+            res |= op(c);
+        duration += UA_DateTime_nowMonotonic() - begin;
+        iterations += BATCH;
+    } while(duration < minDuration);
+
+    if(res != UA_STATUSCODE_GOOD) {
+        fprintf(stderr, "%s %s: %s failed\n", name, path, operation);
+        return;
+    }
+
+    double ns = ((double)duration * 100.0) / (double)iterations;
+    printf("%s,%s,%s,%lu,%lu,%.1f\n", name, path, operation,
+           (unsigned long)c->encoded.length, (unsigned long)iterations, ns);
+}
+
+static void
+benchmarkMessage(const char *name, const void *value, const UA_DataType *type) {
+    if(filter && !strstr(name, filter))
+        return;
+
+    Context c;
+    memset(&c, 0, sizeof(Context));
+    c.value = value;
+    c.type = type;
+    UA_StatusCode res = UA_encodeBinary(value, type, &c.encoded, NULL);
+    if(res != UA_STATUSCODE_GOOD) {
+        fprintf(stderr, "%s: encoding failed (%s)\n", name, UA_StatusCode_name(res));
+        return;
+    }
+    res = UA_ByteString_allocBuffer(&c.buf, c.encoded.length);
+    if(res == UA_STATUSCODE_GOOD) {
+        measure(name, "codec", "encode", opEncode, &c);
+        measure(name, "codec", "decode", opDecode, &c);
+        disableCodecs();
+        measure(name, "generic", "encode", opEncode, &c);
+        measure(name, "generic", "decode", opDecode, &c);
+        enableCodecs();
+    }
+    UA_ByteString_clear(&c.encoded);
+    UA_ByteString_clear(&c.buf);
+}
+
+/********************/
+/* Service Messages */
+/********************/
+
+static void
+benchmarkMessages(void) {
+    /* ReadRequest */
+    UA_ReadValueId rvi[MESSAGE_VALUES];
+    for(size_t i = 0; i < MESSAGE_VALUES; i++) {
+        UA_ReadValueId_init(&rvi[i]);
+        rvi[i].nodeId = UA_NODEID_NUMERIC(1, (UA_UInt32)i + 1000);
+        rvi[i].attributeId = UA_ATTRIBUTEID_VALUE;
+    }
+    UA_ReadRequest readReq;
+    UA_ReadRequest_init(&readReq);
+    readReq.timestampsToReturn = UA_TIMESTAMPSTORETURN_BOTH;
+    readReq.nodesToRead = rvi;
+    readReq.nodesToReadSize = MESSAGE_VALUES;
+    benchmarkMessage("ReadRequest", &readReq, &UA_TYPES[UA_TYPES_READREQUEST]);
+
+    /* ReadResponse */
+    UA_Double d = 42.0;
+    UA_DataValue dv[MESSAGE_VALUES];
+    for(size_t i = 0; i < MESSAGE_VALUES; i++) {
+        UA_DataValue_init(&dv[i]);
+        UA_Variant_setScalar(&dv[i].value, &d, &UA_TYPES[UA_TYPES_DOUBLE]);
+        dv[i].hasValue = true;
+        dv[i].sourceTimestamp = UA_DATETIME_UNIX_EPOCH;
+        dv[i].hasSourceTimestamp = true;
+    }
+    UA_ReadResponse readResp;
+    UA_ReadResponse_init(&readResp);
+    readResp.results = dv;
+    readResp.resultsSize = MESSAGE_VALUES;
+    benchmarkMessage("ReadResponse", &readResp, &UA_TYPES[UA_TYPES_READRESPONSE]);
+
+    /* PublishResponse with a DataChangeNotification */
+    UA_MonitoredItemNotification min[MESSAGE_VALUES];
+    for(size_t i = 0; i < MESSAGE_VALUES; i++) {
+        UA_MonitoredItemNotification_init(&min[i]);
+        min[i].clientHandle = (UA_UInt32)i;
+        min[i].value = dv[i];
+    }
+    UA_DataChangeNotification dcn;
+    UA_DataChangeNotification_init(&dcn);
+    dcn.monitoredItems = min;
+    dcn.monitoredItemsSize = MESSAGE_VALUES;
+    UA_ExtensionObject eo;
+    UA_ExtensionObject_setValueNoDelete(&eo, &dcn,
+                                        &UA_TYPES[UA_TYPES_DATACHANGENOTIFICATION]);
+    UA_PublishResponse pubResp;
+    UA_PublishResponse_init(&pubResp);
+    pubResp.subscriptionId = 1;
+    pubResp.notificationMessage.sequenceNumber = 1;
+    pubResp.notificationMessage.notificationData = &eo;
+    pubResp.notificationMessage.notificationDataSize = 1;
+    benchmarkMessage("PublishResponse", &pubResp, &UA_TYPES[UA_TYPES_PUBLISHRESPONSE]);
+}
+
+int main(int argc, char **argv) {
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            minDuration = atoi(argv[++i]) * UA_DATETIME_MSEC;
+        } else if(strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else {
+            fprintf(stderr, "Usage: %s [-t <milliseconds per measurement>] "
+                    "[-f <name filter>]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("name,path,operation,bytes,iterations,ns_per_op\n");
+    benchmarkMessages();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,439 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <open62541/server.h>
+#include <open62541/server_config_default.h>
+#include <open62541/plugin/log_stdout.h>
+#include <open62541/plugin/nodestore.h>
+#include <open62541/plugin/nodestore_default.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if UA_MULTITHREADING >= 100 && defined(UA_ARCHITECTURE_POSIX)
+#include <pthread.h>
+#define BENCHMARK_SCALING 1
+#endif
+
+/* Benchmark for the NodeId handling in the information model. Measures the
+ * hashing and ordering of NodeIds, the lookup of nodes in the ZipTree and
+ * HashMap Nodestores, browsing in the server and the server startup with and
+ * without a Nodestore image. With multithreading, the throughput of parallel
+ * reads and browses is measured for an increasing number of threads. The results are printed to stdout as
+ * CSV with one line per measurement:
+ *
+ *   group,name,operation,iterations,ns_per_op
+ *
+ * Usage: benchmark_nodeid [-t <milliseconds per measurement>] [-f <name filter>] */
+
+#define BATCH 64
+#define NODES 100000
+#define LOOKUPS 4096 /* Size of the (random) sequence of looked up NodeIds */
+#define FOLDER_CHILDREN 1000
+
+static UA_DateTime minDuration = 20 * UA_DATETIME_MSEC;
+static const char *filter = NULL;
+
+/* Defeats the optimization of the measured operations */
+static volatile UA_UInt32 sink;
+
+/*************/
+/* Measuring */
+/*************/
+
+typedef void (*Operation)(void *ctx, size_t i);
+
+static void
+measure(const char *group, const char *name, const char *operation,
+        Operation op, void *ctx) {
+    if(filter && !strstr(name, filter))
+        return;
+
+    UA_DateTime duration = 0;
+    size_t iterations = 0;
+    do {
+        UA_DateTime begin = UA_DateTime_nowMonotonic();
+        for(size_t i = 0; i < BATCH; i++)
+            op(ctx, iterations + i);
+        duration += UA_DateTime_nowMonotonic() - begin;
+        iterations += BATCH;
+    } while(duration < minDuration);
+
+    double ns = ((double)duration * 100.0) / (double)iterations;
+    printf("%s,%s,%s,%lu,%.1f\n", group, name, operation,
+           (unsigned long)iterations, ns);
+}
+
+/***********/
+/* NodeIds */
+/***********/
+
+typedef enum {
+    IDS_NUMERIC,
+    IDS_STRING,
+    IDS_GUID
+} IdKind;
+
+static const char *idKindNames[] = {"numeric", "string", "guid"};
+
+/* Deterministic NodeIds that look like those of typical information models */
+static void
+makeNodeId(UA_NodeId *id, IdKind kind, UA_UInt32 i) {
+    char buf[64];
+    UA_Guid g;
+    switch(kind) {
+    case IDS_NUMERIC:
+    default:
+        *id = UA_NODEID_NUMERIC(1, 50000 + i);
+        break;
+    case IDS_STRING:
+        snprintf(buf, sizeof(buf), "Plant.Line%u.Machine%u.Temperature",
+                 (unsigned)(i / 100), (unsigned)(i % 100));
+        *id = UA_NODEID_STRING_ALLOC(1, buf);
+        break;
+    case IDS_GUID:
+        memset(&g, 0, sizeof(UA_Guid));
+        g.data1 = i * 2654435761u;
+        g.data2 = (UA_UInt16)i;
+        g.data3 = 0x4ae6;
+        memcpy(g.data4, &i, sizeof(UA_UInt32));
+        *id = UA_NODEID_GUID(1, g);
+        break;
+    }
+}
+
+typedef struct {
+    UA_NodeId ids[LOOKUPS];
+    UA_NodeId copies[LOOKUPS]; /* Equal to ids, but different memory */
+    UA_Nodestore *ns;
+} IdContext;
+
+static void
+opHash(void *ctx, size_t i) {
+    IdContext *c = (IdContext*)ctx;
+    sink = UA_NodeId_hash(&c->ids[i % LOOKUPS]);
+}
+
+static void
+opOrder(void *ctx, size_t i) {
+    IdContext *c = (IdContext*)ctx;
+    sink = (UA_UInt32)UA_NodeId_order(&c->ids[i % LOOKUPS],
+                                      &c->copies[i % LOOKUPS]);
+}
+
+static void
+opGetNode(void *ctx, size_t i) {
+    IdContext *c = (IdContext*)ctx;
+    const UA_Node *node = c->ns->getNode(c->ns, &c->ids[i % LOOKUPS], 0,
+                                         UA_REFERENCETYPESET_NONE,
+                                         UA_BROWSEDIRECTION_INVALID);
+    sink = (node != NULL);
+    c->ns->releaseNode(c->ns, node);
+}
+
+static void
+opInsertRemove(void *ctx, size_t i) {
+    IdContext *c = (IdContext*)ctx;
+    UA_NodeId id = c->ids[i % LOOKUPS];
+    id.namespaceIndex = 2; /* Not yet in the Nodestore */
+    UA_Node *node = c->ns->newNode(c->ns, UA_NODECLASS_OBJECT);
+    UA_NodeId_copy(&id, &node->head.nodeId);
+    c->ns->insertNode(c->ns, node, NULL);
+    c->ns->removeNode(c->ns, &id);
+}
+
+typedef struct {
+    const char *name;
+    UA_Nodestore * (*create)(void);
+} NodestoreKind;
+
+static const NodestoreKind nodestores[] = {
+    {"ziptree", UA_Nodestore_ZipTree},
+    {"hashmap", UA_Nodestore_HashMap},
+    {"concurrent", UA_Nodestore_Concurrent}
+};
+
+static void
+benchmarkIds(IdKind kind) {
+    IdContext *c = (IdContext*)calloc(1, sizeof(IdContext));
+    if(!c)
+        return;
+
+    /* Random sequence of existing NodeIds for the lookup */
+    UA_UInt32 state = 42;
+    for(size_t i = 0; i < LOOKUPS; i++) {
+        state = state * 1103515245u + 12345u;
+        makeNodeId(&c->ids[i], kind, (state >> 8) % NODES);
+        UA_NodeId_copy(&c->ids[i], &c->copies[i]);
+    }
+
+    const char *name = idKindNames[kind];
+    measure("nodeid", name, "hash", opHash, c);
+    measure("nodeid", name, "order", opOrder, c);
+
+    for(size_t n = 0; n < sizeof(nodestores) / sizeof(NodestoreKind); n++) {
+        /* Fill the Nodestore with NODES objects */
+        c->ns = nodestores[n].create();
+        if(!c->ns)
+            continue;
+        UA_DateTime begin = UA_DateTime_nowMonotonic();
+        for(UA_UInt32 i = 0; i < NODES; i++) {
+            UA_Node *node = c->ns->newNode(c->ns, UA_NODECLASS_OBJECT);
+            makeNodeId(&node->head.nodeId, kind, i);
+            c->ns->insertNode(c->ns, node, NULL);
+        }
+        UA_DateTime duration = UA_DateTime_nowMonotonic() - begin;
+        if(!filter || strstr(name, filter))
+            printf("%s,%s,fill,%lu,%.1f\n", nodestores[n].name, name,
+                   (unsigned long)NODES, ((double)duration * 100.0) / NODES);
+
+        measure(nodestores[n].name, name, "getNode", opGetNode, c);
+        measure(nodestores[n].name, name, "insertRemove", opInsertRemove, c);
+        c->ns->free(c->ns);
+    }
+
+    for(size_t i = 0; i < LOOKUPS; i++) {
+        UA_NodeId_clear(&c->ids[i]);
+        UA_NodeId_clear(&c->copies[i]);
+    }
+    free(c);
+}
+
+/**********/
+/* Browse */
+/**********/
+
+typedef struct {
+    UA_Server *server;
+    UA_BrowseDescription bd;
+} BrowseContext;
+
+static void
+opBrowse(void *ctx, size_t i) {
+    BrowseContext *c = (BrowseContext*)ctx;
+    UA_BrowseResult br = UA_Server_browse(c->server, 0, &c->bd);
+    sink = (UA_UInt32)br.referencesSize;
+    UA_BrowseResult_clear(&br);
+}
+
+static void
+opBrowseRecursive(void *ctx, size_t i) {
+    BrowseContext *c = (BrowseContext*)ctx;
+    size_t resultsSize = 0;
+    UA_ExpandedNodeId *results = NULL;
+    UA_Server_browseRecursive(c->server, &c->bd, &resultsSize, &results);
+    sink = (UA_UInt32)resultsSize;
+    UA_Array_delete(results, resultsSize, &UA_TYPES[UA_TYPES_EXPANDEDNODEID]);
+}
+
+static void
+benchmarkBrowse(void) {
+    UA_ServerConfig sc;
+    memset(&sc, 0, sizeof(UA_ServerConfig));
+    sc.logging = UA_Log_Stdout_new(UA_LOGLEVEL_ERROR);
+    UA_ServerConfig_setMinimal(&sc, 4840, NULL);
+    UA_Server *server = UA_Server_newWithConfig(&sc);
+    if(!server)
+        return;
+
+    /* A folder with many children */
+    UA_NodeId folderId = UA_NODEID_NUMERIC(1, 1000);
+    UA_ObjectAttributes oa = UA_ObjectAttributes_default;
+    UA_Server_addObjectNode(server, folderId,
+                            UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                            UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                            UA_QUALIFIEDNAME(1, "Folder"),
+                            UA_NODEID_NUMERIC(0, UA_NS0ID_FOLDERTYPE),
+                            oa, NULL, NULL);
+    char buf[32];
+    for(UA_UInt32 i = 0; i < FOLDER_CHILDREN; i++) {
+        snprintf(buf, sizeof(buf), "Child%u", (unsigned)i);
+        UA_Server_addObjectNode(server, UA_NODEID_NUMERIC(1, 2000 + i), folderId,
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                UA_QUALIFIEDNAME(1, buf),
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_BASEOBJECTTYPE),
+                                oa, NULL, NULL);
+    }
+
+    BrowseContext c;
+    UA_BrowseDescription_init(&c.bd);
+    c.server = server;
+    c.bd.nodeId = folderId;
+    c.bd.browseDirection = UA_BROWSEDIRECTION_FORWARD;
+    c.bd.referenceTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_HIERARCHICALREFERENCES);
+    c.bd.includeSubtypes = true;
+    c.bd.resultMask = UA_BROWSERESULTMASK_ALL;
+    measure("browse", "folder", "browse", opBrowse, &c);
+
+    /* Recursive browsing of the namespace zero hierarchy */
+    c.bd.nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_ROOTFOLDER);
+    c.bd.resultMask = UA_BROWSERESULTMASK_NONE;
+    measure("browse", "root", "browseRecursive", opBrowseRecursive, &c);
+
+    UA_Server_delete(server);
+}
+
+/***********/
+/* Startup */
+/***********/
+
+#define STARTUPS 20
+
+/* Creating a server. Either namespace zero is created by the generated code or
+ * it is served from a Nodestore image. Deleting the server (which stops the
+ * EventLoop) is not measured. */
+static void
+measureStartup(const char *name, const UA_ByteString *image) {
+    if(filter && !strstr(name, filter))
+        return;
+
+    UA_DateTime duration = 0;
+    for(size_t i = 0; i < STARTUPS; i++) {
+        UA_ServerConfig sc;
+        memset(&sc, 0, sizeof(UA_ServerConfig));
+        sc.logging = UA_Log_Stdout_new(UA_LOGLEVEL_ERROR);
+        UA_DateTime begin = UA_DateTime_nowMonotonic();
+        if(image)
+            sc.nodestore = UA_Nodestore_Image(image, NULL);
+        UA_ServerConfig_setMinimal(&sc, 4840, NULL);
+        UA_Server *server = UA_Server_newWithConfig(&sc);
+        duration += UA_DateTime_nowMonotonic() - begin;
+        sink = (server != NULL);
+        UA_Server_delete(server);
+    }
+
+    printf("startup,%s,serverNew,%lu,%.1f\n", name, (unsigned long)STARTUPS,
+           ((double)duration * 100.0) / STARTUPS);
+}
+
+static void
+benchmarkStartup(void) {
+    UA_ServerConfig sc;
+    memset(&sc, 0, sizeof(UA_ServerConfig));
+    sc.logging = UA_Log_Stdout_new(UA_LOGLEVEL_ERROR);
+    UA_ServerConfig_setMinimal(&sc, 4840, NULL);
+    UA_Server *server = UA_Server_newWithConfig(&sc);
+    if(!server)
+        return;
+    UA_ByteString image;
+    UA_StatusCode res = UA_Nodestore_Image_write(server, &image);
+    UA_Server_delete(server);
+    if(res != UA_STATUSCODE_GOOD)
+        return;
+
+    measureStartup("generated", NULL);
+    measureStartup("image", &image);
+    UA_ByteString_clear(&image);
+}
+
+/***********/
+/* Scaling */
+/***********/
+
+#ifdef BENCHMARK_SCALING
+
+#define SCALING_ITERATIONS 20000
+#define SCALING_MAX_THREADS 8
+
+/* Every thread reads the value of a variable and browses the objects folder
+ * directly on the server. With the ZipTree Nodestore the readers are serialized
+ * on the server lock. The Concurrent Nodestore lets them access the nodes
+ * without locking. */
+static void *
+scalingLoop(void *ctx) {
+    UA_Server *server = (UA_Server*)ctx;
+    UA_ReadValueId rvi;
+    UA_ReadValueId_init(&rvi);
+    rvi.nodeId = UA_NODEID_NUMERIC(1, 1001);
+    rvi.attributeId = UA_ATTRIBUTEID_VALUE;
+
+    UA_BrowseDescription bd;
+    UA_BrowseDescription_init(&bd);
+    bd.nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER);
+    bd.browseDirection = UA_BROWSEDIRECTION_FORWARD;
+    bd.resultMask = UA_BROWSERESULTMASK_BROWSENAME;
+
+    for(size_t i = 0; i < SCALING_ITERATIONS; i++) {
+        UA_DataValue dv = UA_Server_read(server, &rvi, UA_TIMESTAMPSTORETURN_NEITHER);
+        sink = dv.status;
+        UA_DataValue_clear(&dv);
+        UA_BrowseResult br = UA_Server_browse(server, 0, &bd);
+        sink = (UA_UInt32)br.referencesSize;
+        UA_BrowseResult_clear(&br);
+    }
+    return NULL;
+}
+
+static void
+benchmarkScaling(const char *name, UA_Nodestore *ns) {
+    if(filter && !strstr(name, filter)) {
+        ns->free(ns);
+        return;
+    }
+
+    UA_ServerConfig sc;
+    memset(&sc, 0, sizeof(UA_ServerConfig));
+    sc.logging = UA_Log_Stdout_new(UA_LOGLEVEL_ERROR);
+    sc.nodestore = ns;
+    UA_ServerConfig_setMinimal(&sc, 4840, NULL);
+    UA_Server *server = UA_Server_newWithConfig(&sc);
+    if(!server)
+        return;
+
+    UA_VariableAttributes attr = UA_VariableAttributes_default;
+    UA_Int32 value = 42;
+    UA_Variant_setScalar(&attr.value, &value, &UA_TYPES[UA_TYPES_INT32]);
+    UA_Server_addVariableNode(server, UA_NODEID_NUMERIC(1, 1001),
+                              UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                              UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                              UA_QUALIFIEDNAME(1, "Temperature"),
+                              UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                              attr, NULL, NULL);
+
+    pthread_t threads[SCALING_MAX_THREADS];
+    for(size_t n = 1; n <= SCALING_MAX_THREADS; n *= 2) {
+        UA_DateTime begin = UA_DateTime_nowMonotonic();
+        for(size_t i = 0; i < n; i++)
+            pthread_create(&threads[i], NULL, scalingLoop, server);
+        for(size_t i = 0; i < n; i++)
+            pthread_join(threads[i], NULL);
+        UA_DateTime duration = UA_DateTime_nowMonotonic() - begin;
+
+        /* Wall-clock time per read/browse over all threads */
+        size_t ops = n * SCALING_ITERATIONS * 2;
+        printf("scaling,%s,readBrowse%uThreads,%lu,%.1f\n", name, (unsigned)n,
+               (unsigned long)ops, ((double)duration * 100.0) / (double)ops);
+    }
+
+    UA_Server_delete(server);
+}
+
+#endif
+
+int main(int argc, char **argv) {
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            minDuration = atoi(argv[++i]) * UA_DATETIME_MSEC;
+        } else if(strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else {
+            fprintf(stderr, "Usage: %s [-t <milliseconds per measurement>] "
+                    "[-f <name filter>]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("group,name,operation,iterations,ns_per_op\n");
+    benchmarkIds(IDS_NUMERIC);
+    benchmarkIds(IDS_STRING);
+    benchmarkIds(IDS_GUID);
+    benchmarkBrowse();
+    benchmarkStartup();
+#ifdef BENCHMARK_SCALING
+    benchmarkScaling("ziptree", UA_Nodestore_ZipTree());
+    benchmarkScaling("concurrent", UA_Nodestore_Concurrent());
+#endif
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,91 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "timer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Benchmark for the timer backends (zip-tree and timing wheel) at different
+ * numbers of cyclic callbacks. Measures adding the callbacks, processing one
+ * second of callbacks (called every millisecond) and removing them again. The
+ * results are printed to stdout as CSV with one line per measurement:
+ *
+ *   backend,timers,operation,duration_ms,callbacks
+ *
+ * Usage: benchmark_timer [-n <maximum number of timers>] */
+
+static size_t count = 0;
+
+static void
+timerCallback(void *application, void *data) {
+    count++;
+}
+
+static double
+elapsedMs(UA_DateTime begin) {
+    return (double)(UA_DateTime_nowMonotonic() - begin) / UA_DATETIME_MSEC;
+}
+
+/* The "BaseTime" policy is used as the zip-tree backend otherwise searches for
+ * a batching partner on every insert */
+static void
+benchmarkBackend(UA_TimerBackend backend, const char *name, size_t n) {
+    UA_Timer timer;
+    UA_Timer_initBackend(&timer, backend);
+    UA_UInt64 *ids = (UA_UInt64*)UA_malloc(n * sizeof(UA_UInt64));
+    if(!ids)
+        return;
+    count = 0;
+
+    /* Intervals between 10ms and 10s */
+    UA_DateTime begin = UA_DateTime_nowMonotonic();
+    for(size_t i = 0; i < n; i++) {
+        UA_Double interval = (UA_Double)((i % 1000) + 1) * 10.0;
+        UA_StatusCode res =
+            UA_Timer_add(&timer, timerCallback, NULL, NULL, interval, 0, NULL,
+                         UA_TIMERPOLICY_BASETIME, &ids[i]);
+        if(res != UA_STATUSCODE_GOOD) {
+            fprintf(stderr, "%s %lu timers: adding failed\n", name, (unsigned long)n);
+            goto cleanup;
+        }
+    }
+    printf("%s,%lu,add,%.3f,\n", name, (unsigned long)n, elapsedMs(begin));
+
+    /* Process every 1ms for 1s */
+    begin = UA_DateTime_nowMonotonic();
+    for(UA_DateTime now = 0; now <= UA_DATETIME_SEC; now += UA_DATETIME_MSEC)
+        UA_Timer_process(&timer, now);
+    printf("%s,%lu,process,%.3f,%lu\n", name, (unsigned long)n,
+           elapsedMs(begin), (unsigned long)count);
+
+    begin = UA_DateTime_nowMonotonic();
+    for(size_t i = 0; i < n; i++)
+        UA_Timer_remove(&timer, ids[i]);
+    printf("%s,%lu,remove,%.3f,\n", name, (unsigned long)n, elapsedMs(begin));
+
+ cleanup:
+    UA_free(ids);
+    UA_Timer_clear(&timer);
+}
+
+int main(int argc, char **argv) {
+    size_t maxTimers = 1000000;
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            maxTimers = (size_t)atol(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [-n <maximum number of timers>]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("backend,timers,operation,duration_ms,callbacks\n");
+    for(size_t n = 10000; n <= maxTimers; n *= 10) {
+        benchmarkBackend(UA_TIMERBACKEND_ZIPTREE, "ziptree", n);
+        benchmarkBackend(UA_TIMERBACKEND_WHEEL, "wheel", n);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,810 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <open62541/types.h>
+#include <open62541/pubsub.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Throughput benchmark for the handling of data types. Representative
+ * instances are generated for every type in UA_TYPES along the type
+ * descriptions. Additionally, typical service messages, large values (arrays of
+ * numbers and long strings) and PubSub NetworkMessages are measured.
+ *
+ * For every instance and encoding (binary, JSON, XML) the encoding, decoding
+ * and calcSize operations are measured. Also copy and clear, which are
+ * independent of the encoding. The results are printed to stdout as CSV with
+ * one line per measurement:
+ *
+ *   group,name,encoding,operation,bytes,iterations,ns_per_op,bytes_per_s,allocs_per_op
+ *
+ * The allocations are counted via the malloc singleton. The column is empty if
+ * the library is built without UA_ENABLE_MALLOC_SINGLETON.
+ *
+ * Usage: benchmark_types [-t <milliseconds per measurement>] [-f <name filter>] */
+
+#define BATCH 64
+#define FILL_ARRAY 2
+#define FILL_DEPTH 3
+#define MESSAGE_VALUES 100
+#define NETWORKMESSAGE_FIELDS 10
+#define VALUE_DOUBLES 10000
+#define VALUE_STRING_LENGTH 4096
+
+static UA_DateTime minDuration = 20 * UA_DATETIME_MSEC;
+static const char *filter = NULL;
+
+/************************/
+/* Allocation Counting  */
+/************************/
+
+static size_t allocs = 0;
+
+#ifdef UA_ENABLE_MALLOC_SINGLETON
+static void *
+countingMalloc(size_t size) {
+    allocs++;
+    return malloc(size);
+}
+
+static void *
+countingCalloc(size_t nelem, size_t elsize) {
+    allocs++;
+    return calloc(nelem, elsize);
+}
+
+static void *
+countingRealloc(void *ptr, size_t size) {
+    allocs++;
+    return realloc(ptr, size);
+}
+#endif
+
+/*************/
+/* Encodings */
+/*************/
+
+typedef struct {
+    const char *name;
+    UA_StatusCode (*encode)(const void *p, const UA_DataType *type,
+                            UA_ByteString *buf, const void *ctx);
+    UA_StatusCode (*decode)(const UA_ByteString *buf, void *p,
+                            const UA_DataType *type, const void *ctx);
+    size_t (*calcSize)(const void *p, const UA_DataType *type, const void *ctx);
+} Encoding;
+
+static UA_StatusCode
+encodeBinary(const void *p, const UA_DataType *type,
+             UA_ByteString *buf, const void *ctx) {
+    return UA_encodeBinary(p, type, buf, NULL);
+}
+
+static UA_StatusCode
+decodeBinary(const UA_ByteString *buf, void *p,
+             const UA_DataType *type, const void *ctx) {
+    return UA_decodeBinary(buf, p, type, NULL);
+}
+
+static size_t
+calcSizeBinary(const void *p, const UA_DataType *type, const void *ctx) {
+    return UA_calcSizeBinary(p, type, NULL);
+}
+
+#ifdef UA_ENABLE_JSON_ENCODING
+static UA_StatusCode
+encodeJson(const void *p, const UA_DataType *type,
+           UA_ByteString *buf, const void *ctx) {
+    return UA_encodeJson(p, type, buf, NULL);
+}
+
+static UA_StatusCode
+decodeJson(const UA_ByteString *buf, void *p,
+           const UA_DataType *type, const void *ctx) {
+    return UA_decodeJson(buf, p, type, NULL);
+}
+
+static size_t
+calcSizeJson(const void *p, const UA_DataType *type, const void *ctx) {
+    return UA_calcSizeJson(p, type, NULL);
+}
+#endif
+
+#ifdef UA_ENABLE_XML_ENCODING
+static UA_StatusCode
+encodeXml(const void *p, const UA_DataType *type,
+          UA_ByteString *buf, const void *ctx) {
+    return UA_encodeXml(p, type, buf, NULL);
+}
+
+static UA_StatusCode
+decodeXml(const UA_ByteString *buf, void *p,
+          const UA_DataType *type, const void *ctx) {
+    return UA_decodeXml(buf, p, type, NULL);
+}
+
+static size_t
+calcSizeXml(const void *p, const UA_DataType *type, const void *ctx) {
+    return UA_calcSizeXml(p, type, NULL);
+}
+#endif
+
+static const Encoding typeEncodings[] = {
+    {"binary", encodeBinary, decodeBinary, calcSizeBinary}
+#ifdef UA_ENABLE_JSON_ENCODING
+    , {"json", encodeJson, decodeJson, calcSizeJson}
+#endif
+#ifdef UA_ENABLE_XML_ENCODING
+    , {"xml", encodeXml, decodeXml, calcSizeXml}
+#endif
+};
+
+#define TYPE_ENCODINGS (sizeof(typeEncodings) / sizeof(Encoding))
+
+/*************************/
+/* Benchmark Definitions */
+/*************************/
+
+/* The instance under test with the methods for its handling. The type is NULL
+ * for NetworkMessages. */
+typedef struct {
+    const char *group;
+    const char *name;
+    const UA_DataType *type;
+    size_t memSize;
+    const void *value;
+    const void *ctx; /* Passed to the encoding methods */
+    void (*clear)(void *p, const UA_DataType *type);
+    UA_StatusCode (*copy)(const void *src, void *dst,
+                          const UA_DataType *type); /* Can be NULL */
+    const Encoding *encodings;
+    size_t encodingsSize;
+} Subject;
+
+typedef enum {
+    OP_ENCODE,
+    OP_DECODE,
+    OP_CALCSIZE,
+    OP_COPY,
+    OP_CLEAR
+} Operation;
+
+static const char *operationNames[] = {
+    "encode", "decode", "calcSize", "copy", "clear"};
+
+typedef struct {
+    const Subject *s;
+    const Encoding *e;
+    UA_ByteString encoded; /* The instance in the encoding */
+    UA_ByteString buf;     /* Target buffer for the encoding */
+    UA_Byte *batch;        /* BATCH instances as decode/copy target */
+} Bench;
+
+static UA_StatusCode
+prepare(Bench *b, Operation op, size_t i) {
+    void *p = b->batch + (i * b->s->memSize);
+    if(op == OP_CLEAR)
+        return b->s->copy(b->s->value, p, b->s->type);
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+run(Bench *b, Operation op, size_t i) {
+    void *p = b->batch + (i * b->s->memSize);
+    UA_ByteString out;
+    switch(op) {
+    case OP_ENCODE:
+        out = b->buf;
+        return b->e->encode(b->s->value, b->s->type, &out, b->s->ctx);
+    case OP_DECODE:
+        return b->e->decode(&b->encoded, p, b->s->type, b->s->ctx);
+    case OP_CALCSIZE:
+        return (b->e->calcSize(b->s->value, b->s->type, b->s->ctx) ==
+                b->encoded.length) ? UA_STATUSCODE_GOOD : UA_STATUSCODE_BADINTERNALERROR;
+    case OP_COPY:
+        return b->s->copy(b->s->value, p, b->s->type);
+    case OP_CLEAR:
+    default:
+        b->s->clear(p, b->s->type);
+        return UA_STATUSCODE_GOOD;
+    }
+}
+
+static void
+cleanup(Bench *b, Operation op, size_t i) {
+    void *p = b->batch + (i * b->s->memSize);
+    if(op == OP_DECODE || op == OP_COPY)
+        b->s->clear(p, b->s->type);
+    memset(p, 0, b->s->memSize);
+}
+
+/* Run the operation in batches until the minimum duration is reached. Only the
+ * operation itself is timed. The preparation (e.g. a copy before clear) and
+ * cleanup (e.g. clear after decode) is not part of the measurement. */
+static void
+measure(Bench *b, Operation op) {
+    UA_DateTime duration = 0;
+    size_t iterations = 0;
+    size_t opAllocs = 0;
+    do {
+        for(size_t i = 0; i < BATCH; i++) {
+            if(prepare(b, op, i) != UA_STATUSCODE_GOOD)
+                goto error;
+        }
+        size_t allocsBefore = allocs;
+        UA_StatusCode res = UA_STATUSCODE_GOOD;
+        UA_DateTime begin = UA_DateTime_nowMonotonic();
+        for(size_t i = 0; i < BATCH; i++)
+            res |= run(b, op, i);
+        duration += UA_DateTime_nowMonotonic() - begin;
+        opAllocs += allocs - allocsBefore;
+        for(size_t i = 0; i < BATCH; i++)
+            cleanup(b, op, i);
+        if(res != UA_STATUSCODE_GOOD)
+            goto error;
+        iterations += BATCH;
+    } while(duration < minDuration);
+
+    double ns = ((double)duration * 100.0) / (double)iterations;
+    printf("%s,%s,%s,%s,", b->s->group, b->s->name,
+           (op == OP_COPY || op == OP_CLEAR) ? "" : b->e->name,
+           operationNames[op]);
+    if(op == OP_ENCODE || op == OP_DECODE)
+        printf("%lu,", (unsigned long)b->encoded.length);
+    else
+        printf(",");
+    printf("%lu,%.1f,", (unsigned long)iterations, ns);
+    if((op == OP_ENCODE || op == OP_DECODE) && ns > 0.0)
+        printf("%.0f,", (double)b->encoded.length * 1e9 / ns);
+    else
+        printf(",");
+#ifdef UA_ENABLE_MALLOC_SINGLETON
+    printf("%.2f\n", (double)opAllocs / (double)iterations);
+#else
+    printf("\n");
+#endif
+    return;
+
+ error:
+    fprintf(stderr, "%s %s %s: %s failed\n", b->s->group, b->s->name,
+            (op == OP_COPY || op == OP_CLEAR) ? "" : b->e->name,
+            operationNames[op]);
+}
+
+static void
+benchmarkSubject(const Subject *s) {
+    if(filter && !strstr(s->name, filter))
+        return;
+
+    Bench b;
+    memset(&b, 0, sizeof(Bench));
+    b.s = s;
+    b.batch = (UA_Byte*)calloc(BATCH, s->memSize);
+    if(!b.batch)
+        return;
+
+    for(size_t j = 0; j < s->encodingsSize; j++) {
+        b.e = &s->encodings[j];
+        UA_StatusCode res = b.e->encode(s->value, s->type, &b.encoded, s->ctx);
+        if(res != UA_STATUSCODE_GOOD) {
+            fprintf(stderr, "%s %s %s: encoding not supported (%s)\n", s->group,
+                    s->name, b.e->name, UA_StatusCode_name(res));
+            continue;
+        }
+        res = UA_ByteString_allocBuffer(&b.buf, b.encoded.length);
+        if(res == UA_STATUSCODE_GOOD) {
+            measure(&b, OP_ENCODE);
+            measure(&b, OP_DECODE);
+            measure(&b, OP_CALCSIZE);
+        }
+        UA_ByteString_clear(&b.encoded);
+        UA_ByteString_clear(&b.buf);
+    }
+
+    /* Copy and clear are independent of the encoding */
+    if(s->copy) {
+        measure(&b, OP_COPY);
+        measure(&b, OP_CLEAR);
+    }
+
+    free(b.batch);
+}
+
+/*****************************/
+/* Representative Instances  */
+/*****************************/
+
+/* Generate an instance along the type description. Arrays get FILL_ARRAY
+ * elements. Nested structures, arrays and optional fields are only filled up to
+ * FILL_DEPTH to bound the size of recursive types. */
+
+static void fill(void *p, const UA_DataType *type, size_t depth);
+
+static void *
+fillArray(size_t *size, const UA_DataType *type, size_t depth) {
+    *size = 0;
+    if(depth >= FILL_DEPTH)
+        return NULL;
+    void *arr = UA_Array_new(FILL_ARRAY, type);
+    if(!arr)
+        return NULL;
+    for(size_t i = 0; i < FILL_ARRAY; i++)
+        fill((UA_Byte*)arr + (i * type->memSize), type, depth + 1);
+    *size = FILL_ARRAY;
+    return arr;
+}
+
+static void
+fillStructure(void *p, const UA_DataType *type, size_t depth) {
+    uintptr_t ptr = (uintptr_t)p;
+    for(size_t i = 0; i < type->membersSize; i++) {
+        const UA_DataTypeMember *m = &type->members[i];
+        const UA_DataType *mt = m->memberType;
+        ptr += m->padding;
+        if(m->isArray) {
+            size_t *size = (size_t*)ptr;
+            ptr += sizeof(size_t);
+            *(void**)ptr = fillArray(size, mt, depth);
+            ptr += sizeof(void*);
+        } else if(m->isOptional) {
+            if(depth < FILL_DEPTH) {
+                void *field = UA_new(mt);
+                if(field)
+                    fill(field, mt, depth + 1);
+                *(void**)ptr = field;
+            }
+            ptr += sizeof(void*);
+        } else {
+            fill((void*)ptr, mt, depth + 1);
+            ptr += mt->memSize;
+        }
+    }
+}
+
+static void
+fillUnion(void *p, const UA_DataType *type, size_t depth) {
+    if(type->membersSize == 0)
+        return;
+    *(UA_UInt32*)p = 1; /* Select the first member */
+    const UA_DataTypeMember *m = &type->members[0];
+    uintptr_t ptr = (uintptr_t)p + m->padding;
+    if(m->isArray) {
+        size_t *size = (size_t*)ptr;
+        *(void**)(ptr + sizeof(size_t)) = fillArray(size, m->memberType, depth);
+    } else {
+        fill((void*)ptr, m->memberType, depth + 1);
+    }
+}
+
+static void
+fill(void *p, const UA_DataType *type, size_t depth) {
+    switch(type->typeKind) {
+    case UA_DATATYPEKIND_BOOLEAN:
+        *(UA_Boolean*)p = true;
+        break;
+    case UA_DATATYPEKIND_SBYTE:
+    case UA_DATATYPEKIND_BYTE:
+        *(UA_Byte*)p = 42;
+        break;
+    case UA_DATATYPEKIND_INT16:
+    case UA_DATATYPEKIND_UINT16:
+        *(UA_UInt16*)p = 4242;
+        break;
+    case UA_DATATYPEKIND_INT32:
+    case UA_DATATYPEKIND_UINT32:
+        *(UA_UInt32*)p = 424242;
+        break;
+    case UA_DATATYPEKIND_ENUM:
+        *(UA_UInt32*)p = 1;
+        break;
+    case UA_DATATYPEKIND_INT64:
+    case UA_DATATYPEKIND_UINT64:
+        *(UA_UInt64*)p = 42424242424242;
+        break;
+    case UA_DATATYPEKIND_FLOAT:
+        *(UA_Float*)p = 42.25f;
+        break;
+    case UA_DATATYPEKIND_DOUBLE:
+        *(UA_Double*)p = 42.4242;
+        break;
+    case UA_DATATYPEKIND_DATETIME:
+        *(UA_DateTime*)p = UA_DATETIME_UNIX_EPOCH + 1700000000 * UA_DATETIME_SEC;
+        break;
+    case UA_DATATYPEKIND_STATUSCODE:
+        *(UA_StatusCode*)p = UA_STATUSCODE_UNCERTAININITIALVALUE;
+        break;
+    case UA_DATATYPEKIND_STRING:
+    case UA_DATATYPEKIND_BYTESTRING:
+        *(UA_String*)p = UA_STRING_ALLOC("open62541 benchmark value");
+        break;
+    case UA_DATATYPEKIND_XMLELEMENT:
+        *(UA_String*)p = UA_STRING_ALLOC("<Value>42</Value>");
+        break;
+    case UA_DATATYPEKIND_GUID: {
+        UA_Guid *g = (UA_Guid*)p;
+        g->data1 = 0x72962b91;
+        g->data2 = 0xfa75;
+        g->data3 = 0x4ae6;
+        for(UA_Byte i = 0; i < 8; i++)
+            g->data4[i] = (UA_Byte)(0x8d + i);
+        break;
+    }
+    case UA_DATATYPEKIND_NODEID:
+        *(UA_NodeId*)p = UA_NODEID_NUMERIC(1, 4242);
+        break;
+    case UA_DATATYPEKIND_EXPANDEDNODEID:
+        ((UA_ExpandedNodeId*)p)->nodeId = UA_NODEID_NUMERIC(1, 4242);
+        break;
+    case UA_DATATYPEKIND_QUALIFIEDNAME:
+        *(UA_QualifiedName*)p = UA_QUALIFIEDNAME_ALLOC(1, "BenchmarkName");
+        break;
+    case UA_DATATYPEKIND_LOCALIZEDTEXT:
+        *(UA_LocalizedText*)p = UA_LOCALIZEDTEXT_ALLOC("en-US", "Benchmark text");
+        break;
+    case UA_DATATYPEKIND_EXTENSIONOBJECT: {
+        if(depth >= FILL_DEPTH)
+            break;
+        UA_Range *r = UA_Range_new();
+        if(!r)
+            break;
+        r->low = -42.0;
+        r->high = 42.0;
+        UA_ExtensionObject_setValue((UA_ExtensionObject*)p, r,
+                                    &UA_TYPES[UA_TYPES_RANGE]);
+        break;
+    }
+    case UA_DATATYPEKIND_DATAVALUE: {
+        UA_DataValue *dv = (UA_DataValue*)p;
+        UA_Double d = 42.4242;
+        UA_Variant_setScalarCopy(&dv->value, &d, &UA_TYPES[UA_TYPES_DOUBLE]);
+        dv->hasValue = true;
+        dv->sourceTimestamp = UA_DATETIME_UNIX_EPOCH + 1700000000 * UA_DATETIME_SEC;
+        dv->hasSourceTimestamp = true;
+        dv->serverTimestamp = dv->sourceTimestamp;
+        dv->hasServerTimestamp = true;
+        break;
+    }
+    case UA_DATATYPEKIND_VARIANT: {
+        UA_Double d = 42.4242;
+        UA_Variant_setScalarCopy((UA_Variant*)p, &d, &UA_TYPES[UA_TYPES_DOUBLE]);
+        break;
+    }
+    case UA_DATATYPEKIND_DIAGNOSTICINFO: {
+        UA_DiagnosticInfo *di = (UA_DiagnosticInfo*)p;
+        di->hasSymbolicId = true;
+        di->symbolicId = 42;
+        di->hasAdditionalInfo = true;
+        di->additionalInfo = UA_STRING_ALLOC("Benchmark diagnostics");
+        break;
+    }
+    case UA_DATATYPEKIND_STRUCTURE:
+    case UA_DATATYPEKIND_OPTSTRUCT:
+        fillStructure(p, type, depth);
+        break;
+    case UA_DATATYPEKIND_UNION:
+        fillUnion(p, type, depth);
+        break;
+    default:
+        break; /* Decimal, BitfieldCluster remain zeroed */
+    }
+}
+
+static void
+benchmarkTypes(void) {
+    for(size_t i = 0; i < UA_TYPES_COUNT; i++) {
+        const UA_DataType *type = &UA_TYPES[i];
+        void *value = UA_new(type);
+        if(!value)
+            continue;
+        fill(value, type, 0);
+
+#ifdef UA_ENABLE_TYPEDESCRIPTION
+        const char *name = type->typeName;
+#else
+        char name[16];
+        snprintf(name, sizeof(name), "i=%u", (unsigned)type->typeId.identifier.numeric);
+#endif
+        Subject s = {"type", name, type, type->memSize, value, NULL,
+                     UA_clear, UA_copy, typeEncodings, TYPE_ENCODINGS};
+        benchmarkSubject(&s);
+        UA_delete(value, type);
+    }
+}
+
+/********************/
+/* Service Messages */
+/********************/
+
+static void
+benchmarkMessage(const char *name, const void *value, const UA_DataType *type) {
+    Subject s = {"message", name, type, type->memSize, value, NULL,
+                 UA_clear, UA_copy, typeEncodings, TYPE_ENCODINGS};
+    benchmarkSubject(&s);
+}
+
+static void
+benchmarkMessages(void) {
+    /* ReadRequest */
+    UA_ReadValueId rvi[MESSAGE_VALUES];
+    for(size_t i = 0; i < MESSAGE_VALUES; i++) {
+        UA_ReadValueId_init(&rvi[i]);
+        rvi[i].nodeId = UA_NODEID_NUMERIC(1, (UA_UInt32)i + 1000);
+        rvi[i].attributeId = UA_ATTRIBUTEID_VALUE;
+    }
+    UA_ReadRequest readReq;
+    UA_ReadRequest_init(&readReq);
+    readReq.timestampsToReturn = UA_TIMESTAMPSTORETURN_BOTH;
+    readReq.nodesToRead = rvi;
+    readReq.nodesToReadSize = MESSAGE_VALUES;
+    benchmarkMessage("ReadRequest", &readReq, &UA_TYPES[UA_TYPES_READREQUEST]);
+
+    /* ReadResponse */
+    UA_Double d = 42.0;
+    UA_DataValue dv[MESSAGE_VALUES];
+    for(size_t i = 0; i < MESSAGE_VALUES; i++) {
+        UA_DataValue_init(&dv[i]);
+        UA_Variant_setScalar(&dv[i].value, &d, &UA_TYPES[UA_TYPES_DOUBLE]);
+        dv[i].hasValue = true;
+        dv[i].sourceTimestamp = UA_DATETIME_UNIX_EPOCH;
+        dv[i].hasSourceTimestamp = true;
+    }
+    UA_ReadResponse readResp;
+    UA_ReadResponse_init(&readResp);
+    readResp.results = dv;
+    readResp.resultsSize = MESSAGE_VALUES;
+    benchmarkMessage("ReadResponse", &readResp, &UA_TYPES[UA_TYPES_READRESPONSE]);
+
+    /* WriteRequest */
+    UA_WriteValue wv[MESSAGE_VALUES];
+    for(size_t i = 0; i < MESSAGE_VALUES; i++) {
+        UA_WriteValue_init(&wv[i]);
+        wv[i].nodeId = rvi[i].nodeId;
+        wv[i].attributeId = UA_ATTRIBUTEID_VALUE;
+        wv[i].value = dv[i];
+    }
+    UA_WriteRequest writeReq;
+    UA_WriteRequest_init(&writeReq);
+    writeReq.nodesToWrite = wv;
+    writeReq.nodesToWriteSize = MESSAGE_VALUES;
+    benchmarkMessage("WriteRequest", &writeReq, &UA_TYPES[UA_TYPES_WRITEREQUEST]);
+
+    /* PublishResponse with a DataChangeNotification */
+    UA_MonitoredItemNotification min[MESSAGE_VALUES];
+    for(size_t i = 0; i < MESSAGE_VALUES; i++) {
+        UA_MonitoredItemNotification_init(&min[i]);
+        min[i].clientHandle = (UA_UInt32)i;
+        min[i].value = dv[i];
+    }
+    UA_DataChangeNotification dcn;
+    UA_DataChangeNotification_init(&dcn);
+    dcn.monitoredItems = min;
+    dcn.monitoredItemsSize = MESSAGE_VALUES;
+    UA_ExtensionObject eo;
+    UA_ExtensionObject_setValueNoDelete(&eo, &dcn,
+                                        &UA_TYPES[UA_TYPES_DATACHANGENOTIFICATION]);
+    UA_PublishResponse pubResp;
+    UA_PublishResponse_init(&pubResp);
+    pubResp.subscriptionId = 1;
+    pubResp.notificationMessage.sequenceNumber = 1;
+    pubResp.notificationMessage.notificationData = &eo;
+    pubResp.notificationMessage.notificationDataSize = 1;
+    benchmarkMessage("PublishResponse", &pubResp, &UA_TYPES[UA_TYPES_PUBLISHRESPONSE]);
+}
+
+/****************/
+/* Large Values */
+/****************/
+
+/* The number formatting and the scanning of strings for characters to escape
+ * dominate the text encodings of these values */
+static void
+benchmarkValues(void) {
+    /* Variant with an array of doubles */
+    UA_Double *d = (UA_Double*)
+        UA_Array_new(VALUE_DOUBLES, &UA_TYPES[UA_TYPES_DOUBLE]);
+    if(!d)
+        return;
+    for(size_t i = 0; i < VALUE_DOUBLES; i++)
+        d[i] = (UA_Double)(i * 7919 % 100000) / 100.0 + (UA_Double)i / 3.0;
+    UA_Variant v;
+    UA_Variant_setArray(&v, d, VALUE_DOUBLES, &UA_TYPES[UA_TYPES_DOUBLE]);
+    Subject sv = {"value", "DoubleArray", &UA_TYPES[UA_TYPES_VARIANT],
+                  sizeof(UA_Variant), &v, NULL, UA_clear, UA_copy,
+                  typeEncodings, TYPE_ENCODINGS};
+    benchmarkSubject(&sv);
+    UA_Variant_clear(&v);
+
+    /* Long strings. Without and with characters to escape. */
+    UA_String str;
+    if(UA_ByteString_allocBuffer(&str, VALUE_STRING_LENGTH) != UA_STATUSCODE_GOOD)
+        return;
+    for(size_t i = 0; i < str.length; i++)
+        str.data[i] = (UA_Byte)('a' + (i % 26));
+    Subject ss = {"value", "String", &UA_TYPES[UA_TYPES_STRING],
+                  sizeof(UA_String), &str, NULL, UA_clear, UA_copy,
+                  typeEncodings, TYPE_ENCODINGS};
+    benchmarkSubject(&ss);
+    for(size_t i = 50; i < str.length; i += 100)
+        str.data[i] = '\n';
+    ss.name = "StringEscaped";
+    benchmarkSubject(&ss);
+    UA_String_clear(&str);
+}
+
+/**************************/
+/* PubSub NetworkMessages */
+/**************************/
+
+#ifdef UA_ENABLE_PUBSUB
+
+static UA_StatusCode
+encodeNetworkMessageBinary(const void *p, const UA_DataType *type,
+                           UA_ByteString *buf, const void *ctx) {
+    return UA_NetworkMessage_encodeBinary((const UA_NetworkMessage*)p, buf,
+                                          (const UA_NetworkMessage_EncodingOptions*)ctx);
+}
+
+static UA_StatusCode
+decodeNetworkMessageBinary(const UA_ByteString *buf, void *p,
+                           const UA_DataType *type, const void *ctx) {
+    return UA_NetworkMessage_decodeBinary(buf, (UA_NetworkMessage*)p,
+                                          (const UA_NetworkMessage_EncodingOptions*)ctx,
+                                          NULL);
+}
+
+static size_t
+calcSizeNetworkMessageBinary(const void *p, const UA_DataType *type,
+                             const void *ctx) {
+    return UA_NetworkMessage_calcSizeBinary((const UA_NetworkMessage*)p,
+                                            (const UA_NetworkMessage_EncodingOptions*)ctx);
+}
+
+#ifdef UA_ENABLE_JSON_ENCODING
+static UA_StatusCode
+encodeNetworkMessageJson(const void *p, const UA_DataType *type,
+                         UA_ByteString *buf, const void *ctx) {
+    return UA_NetworkMessage_encodeJson((const UA_NetworkMessage*)p, buf,
+                                        (const UA_NetworkMessage_EncodingOptions*)ctx,
+                                        NULL);
+}
+
+static UA_StatusCode
+decodeNetworkMessageJson(const UA_ByteString *buf, void *p,
+                         const UA_DataType *type, const void *ctx) {
+    return UA_NetworkMessage_decodeJson(buf, (UA_NetworkMessage*)p,
+                                        (const UA_NetworkMessage_EncodingOptions*)ctx,
+                                        NULL);
+}
+
+static size_t
+calcSizeNetworkMessageJson(const void *p, const UA_DataType *type,
+                           const void *ctx) {
+    return UA_NetworkMessage_calcSizeJson((const UA_NetworkMessage*)p,
+                                          (const UA_NetworkMessage_EncodingOptions*)ctx,
+                                          NULL);
+}
+#endif
+
+static void
+clearNetworkMessage(void *p, const UA_DataType *type) {
+    UA_NetworkMessage_clear((UA_NetworkMessage*)p);
+}
+
+static const Encoding networkMessageEncodings[] = {
+    {"binary", encodeNetworkMessageBinary, decodeNetworkMessageBinary,
+     calcSizeNetworkMessageBinary}
+#ifdef UA_ENABLE_JSON_ENCODING
+    , {"json", encodeNetworkMessageJson, decodeNetworkMessageJson,
+       calcSizeNetworkMessageJson}
+#endif
+};
+
+static void
+benchmarkNetworkMessage(const char *name, UA_FieldEncoding fieldEncoding) {
+    /* Metadata for the fields. Required for the JSON encoding. */
+    UA_FieldMetaData fmd[NETWORKMESSAGE_FIELDS];
+    char fieldNames[NETWORKMESSAGE_FIELDS][16];
+    memset(fmd, 0, sizeof(fmd));
+    for(size_t i = 0; i < NETWORKMESSAGE_FIELDS; i++) {
+        snprintf(fieldNames[i], sizeof(fieldNames[i]), "Field%u", (unsigned)i);
+        fmd[i].name = UA_STRING(fieldNames[i]);
+        fmd[i].dataType = UA_TYPES[UA_TYPES_DOUBLE].typeId;
+        fmd[i].builtInType = UA_TYPES_DOUBLE + 1;
+        fmd[i].valueRank = UA_VALUERANK_SCALAR;
+    }
+    UA_DataSetMessage_EncodingMetaData emd;
+    memset(&emd, 0, sizeof(emd));
+    emd.dataSetWriterId = 1;
+    emd.fields = fmd;
+    emd.fieldsSize = NETWORKMESSAGE_FIELDS;
+    UA_NetworkMessage_EncodingOptions eo;
+    eo.metaData = &emd;
+    eo.metaDataSize = 1;
+
+    /* DataSetMessage */
+    UA_Double d = 42.4242;
+    UA_DataValue fields[NETWORKMESSAGE_FIELDS];
+    for(size_t i = 0; i < NETWORKMESSAGE_FIELDS; i++) {
+        UA_DataValue_init(&fields[i]);
+        UA_Variant_setScalar(&fields[i].value, &d, &UA_TYPES[UA_TYPES_DOUBLE]);
+        fields[i].hasValue = true;
+        if(fieldEncoding == UA_FIELDENCODING_DATAVALUE) {
+            fields[i].sourceTimestamp = UA_DATETIME_UNIX_EPOCH;
+            fields[i].hasSourceTimestamp = true;
+        }
+    }
+    UA_DataSetMessage dsm;
+    memset(&dsm, 0, sizeof(UA_DataSetMessage));
+    dsm.header.dataSetMessageValid = true;
+    dsm.header.fieldEncoding = fieldEncoding;
+    dsm.header.dataSetMessageType = UA_DATASETMESSAGE_DATAKEYFRAME;
+    dsm.header.dataSetMessageSequenceNrEnabled = true;
+    dsm.header.dataSetMessageSequenceNr = 4711;
+    dsm.header.timestampEnabled = true;
+    dsm.header.timestamp = UA_DATETIME_UNIX_EPOCH;
+    dsm.fieldCount = NETWORKMESSAGE_FIELDS;
+    dsm.data.keyFrameFields = fields;
+
+    /* NetworkMessage */
+    UA_NetworkMessage nm;
+    memset(&nm, 0, sizeof(UA_NetworkMessage));
+    nm.version = 1;
+    nm.networkMessageType = UA_NETWORKMESSAGE_DATASET;
+    nm.publisherIdEnabled = true;
+    nm.publisherId.idType = UA_PUBLISHERIDTYPE_UINT16;
+    nm.publisherId.id.uint16 = 42;
+    nm.groupHeaderEnabled = true;
+    nm.groupHeader.writerGroupIdEnabled = true;
+    nm.groupHeader.writerGroupId = 1;
+    nm.groupHeader.sequenceNumberEnabled = true;
+    nm.groupHeader.sequenceNumber = 4711;
+    nm.payloadHeaderEnabled = true;
+    nm.messageCount = 1;
+    nm.dataSetWriterIds[0] = 1;
+    nm.payload.dataSetMessages = &dsm;
+
+    Subject s = {"networkmessage", name, NULL, sizeof(UA_NetworkMessage), &nm, &eo,
+                 clearNetworkMessage, NULL, networkMessageEncodings,
+                 sizeof(networkMessageEncodings) / sizeof(Encoding)};
+    benchmarkSubject(&s);
+}
+
+static void
+benchmarkNetworkMessages(void) {
+    benchmarkNetworkMessage("UadpVariant", UA_FIELDENCODING_VARIANT);
+    benchmarkNetworkMessage("UadpDataValue", UA_FIELDENCODING_DATAVALUE);
+}
+
+#endif /* UA_ENABLE_PUBSUB */
+
+int main(int argc, char **argv) {
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            minDuration = atoi(argv[++i]) * UA_DATETIME_MSEC;
+        } else if(strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else {
+            fprintf(stderr, "Usage: %s [-t <milliseconds per measurement>] "
+                    "[-f <name filter>]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+#ifdef UA_ENABLE_MALLOC_SINGLETON
+    UA_mallocSingleton = countingMalloc;
+    UA_callocSingleton = countingCalloc;
+    UA_reallocSingleton = countingRealloc;
+#endif
+
+    printf("group,name,encoding,operation,bytes,iterations,"
+           "ns_per_op,bytes_per_s,allocs_per_op\n");
+    benchmarkTypes();
+    benchmarkMessages();
+    benchmarkValues();
+#ifdef UA_ENABLE_PUBSUB
+    benchmarkNetworkMessages();
+#endif
+    return EXIT_SUCCESS;
+}
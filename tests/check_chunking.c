@@ -151,6 +151,125 @@ START_TEST(encodeTwoStringsIntoTenChunksShallWork) {
     UA_String_clear(&string);
 } END_TEST
 
+static size_t decodeIndex;
+
+static UA_StatusCode
+nextChunkMockUp(void *_, UA_Byte **bufPos, const UA_Byte **bufEnd) {
+    decodeIndex++;
+    if(decodeIndex >= bufIndex)
+        return UA_STATUSCODE_BADDECODINGERROR;
+    *bufPos = buffers[decodeIndex].data;
+    *bufEnd = &(*bufPos)[buffers[decodeIndex].length];
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Decode from separately allocated chunks of every size. The result has to
+ * match the original value. */
+static void
+decodeFromChunks(const void *p, const UA_DataType *type) {
+    UA_ByteString enc = UA_BYTESTRING_NULL;
+    UA_StatusCode retval = UA_encodeBinary(p, type, &enc, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_Arena arena;
+    UA_Arena_init(&arena);
+    for(size_t chunkSize = 1; chunkSize <= enc.length; chunkSize++) {
+        bufIndex = (enc.length + chunkSize - 1) / chunkSize; /* chunk count */
+        buffers = (UA_ByteString*)UA_Array_new(bufIndex, &UA_TYPES[UA_TYPES_BYTESTRING]);
+        for(size_t i = 0; i < bufIndex; i++) {
+            size_t len = enc.length - (i * chunkSize);
+            if(len > chunkSize)
+                len = chunkSize;
+            UA_ByteString_allocBuffer(&buffers[i], len);
+            memcpy(buffers[i].data, &enc.data[i * chunkSize], len);
+        }
+
+        /* Decode with the heap and with borrowing into the arena */
+        for(size_t borrow = 0; borrow < 2; borrow++) {
+            UA_DecodeBinaryOptions opts;
+            memset(&opts, 0, sizeof(UA_DecodeBinaryOptions));
+            if(borrow) {
+                opts.calloc = UA_Arena_calloc;
+                opts.callocContext = &arena;
+                opts.borrowBuffer = true;
+            }
+            void *dst = UA_malloc(type->memSize);
+            size_t offset = 0;
+            decodeIndex = 0;
+            retval = UA_decodeBinaryInternalStream(&buffers[0], &offset,
+                                                   enc.length - buffers[0].length,
+                                                   dst, type, &opts, nextChunkMockUp, NULL);
+            ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+            ck_assert_uint_eq(offset, enc.length);
+            ck_assert_uint_eq(decodeIndex, bufIndex - 1);
+            ck_assert(UA_order(p, dst, type) == UA_ORDER_EQ);
+            if(!borrow)
+                UA_clear(dst, type);
+            UA_free(dst);
+            UA_Arena_reset(&arena);
+        }
+
+        /* The last chunk is missing */
+        if(bufIndex > 1) {
+            void *dst = UA_malloc(type->memSize);
+            size_t offset = 0;
+            decodeIndex = 0;
+            bufIndex--;
+            retval = UA_decodeBinaryInternalStream(&buffers[0], &offset,
+                                                   enc.length - buffers[0].length,
+                                                   dst, type, NULL, nextChunkMockUp, NULL);
+            ck_assert_uint_eq(retval, UA_STATUSCODE_BADDECODINGERROR);
+            UA_free(dst);
+            bufIndex++;
+        }
+
+        UA_Array_delete(buffers, bufIndex, &UA_TYPES[UA_TYPES_BYTESTRING]);
+    }
+    UA_Arena_clear(&arena);
+    UA_ByteString_clear(&enc);
+}
+
+START_TEST(decodeFromChunksShallWork) {
+    UA_Int32 ar[20];
+    for(size_t i = 0; i < 20; i++)
+        ar[i] = (UA_Int32)i;
+    UA_Range ranges[3] = {{0.0, 1.0}, {2.0, 3.0}, {4.0, 5.0}};
+    UA_Guid guid = UA_GUID("72962B91-FA75-4AE6-8D28-B404DC7DAF63");
+    UA_String str = UA_STRING("open62541 decodes from chunks");
+
+    /* An ExtensionObject with an unknown type stays encoded */
+    UA_ExtensionObject unknown;
+    UA_ExtensionObject_init(&unknown);
+    unknown.encoding = UA_EXTENSIONOBJECT_ENCODED_BYTESTRING;
+    unknown.content.encoded.typeId = UA_NODEID_NUMERIC(2, 4711);
+    unknown.content.encoded.body = UA_BYTESTRING("body");
+
+    UA_WriteValue wv[7];
+    for(size_t i = 0; i < 7; i++) {
+        UA_WriteValue_init(&wv[i]);
+        wv[i].nodeId = UA_NODEID_STRING(1, "the.answer");
+        wv[i].attributeId = UA_ATTRIBUTEID_VALUE;
+        wv[i].value.hasValue = true;
+        wv[i].value.hasSourceTimestamp = true;
+        wv[i].value.sourceTimestamp = UA_DATETIME_UNIX_EPOCH + (UA_DateTime)i;
+    }
+    UA_Variant_setArray(&wv[0].value.value, ar, 20, &UA_TYPES[UA_TYPES_INT32]);
+    UA_Variant_setScalar(&wv[1].value.value, &str, &UA_TYPES[UA_TYPES_STRING]);
+    UA_Variant_setScalar(&wv[2].value.value, &ranges[0], &UA_TYPES[UA_TYPES_RANGE]);
+    UA_Variant_setArray(&wv[3].value.value, ranges, 3, &UA_TYPES[UA_TYPES_RANGE]);
+    UA_Variant_setScalar(&wv[4].value.value, &guid, &UA_TYPES[UA_TYPES_GUID]);
+    UA_Variant_setScalar(&wv[5].value.value, &unknown, &UA_TYPES[UA_TYPES_EXTENSIONOBJECT]);
+    wv[6].indexRange = UA_STRING("1:2");
+
+    UA_WriteRequest req;
+    UA_WriteRequest_init(&req);
+    req.requestHeader.requestHandle = 42;
+    req.requestHeader.timestamp = UA_DATETIME_UNIX_EPOCH;
+    req.nodesToWrite = wv;
+    req.nodesToWriteSize = 7;
+    decodeFromChunks(&req, &UA_TYPES[UA_TYPES_WRITEREQUEST]);
+} END_TEST
+
 int main(void) {
     Suite *s = suite_create("Chunked encoding");
     TCase *tc_message = tcase_create("encode chunking");
@@ -158,6 +277,9 @@ int main(void) {
     tcase_add_test(tc_message,encodeStringIntoFiveChunksShallWork);
     tcase_add_test(tc_message,encodeTwoStringsIntoTenChunksShallWork);
     suite_add_tcase(s, tc_message);
+    TCase *tc_decode = tcase_create("decode chunking");
+    tcase_add_test(tc_decode, decodeFromChunksShallWork);
+    suite_add_tcase(s, tc_decode);
 
     SRunner *sr = srunner_create(s);
     srunner_set_fork_status(sr, CK_NOFORK);
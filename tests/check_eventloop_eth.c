@@ -16,6 +16,7 @@ static UA_EventLoop *el;
 static char *testMsg = "open62541";
 static uintptr_t clientId;
 static UA_Boolean received;
+static size_t receivedCount;
 
 #define ETHERNET_INTERFACE "lo" /* use the loopback interface for testing */
 #define MULTICAST_MAC_ADDRESS "00-00-00-00-00-00"
@@ -63,6 +64,7 @@ connectionCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
         UA_ByteString rcv = UA_BYTESTRING(testMsg);
         ck_assert(UA_String_equal(&msg, &rcv));
         received = true;
+        receivedCount++;
     }
 }
 
@@ -113,7 +115,8 @@ START_TEST(listenETH) {
     ck_assert_uint_eq(testContext.connCount, 0);
 } END_TEST
 
-START_TEST(connectETH) {
+static void
+connectAndSend(UA_Boolean packetRing, size_t messages) {
     UA_ConnectionManager *cm = UA_ConnectionManager_new_POSIX_Ethernet(UA_STRING("udpCM"));
     el = UA_EventLoop_new_POSIX(UA_Log_Stdout);
     el->registerEventSource(el, &cm->eventSource);
@@ -124,7 +127,7 @@ START_TEST(connectETH) {
     UA_Boolean listen = true;
     UA_UInt16 etherType = 0xb62c; /* OPC UA PubSub EtherType */
 
-    UA_KeyValuePair params[4];
+    UA_KeyValuePair params[5];
     params[0].key = UA_QUALIFIEDNAME(0, "address");
     UA_Variant_setScalar(&params[0].value, &address, &UA_TYPES[UA_TYPES_STRING]);
     params[1].key = UA_QUALIFIEDNAME(0, "interface");
@@ -133,12 +136,14 @@ START_TEST(connectETH) {
     UA_Variant_setScalar(&params[2].value, &etherType, &UA_TYPES[UA_TYPES_UINT16]);
     params[3].key = UA_QUALIFIEDNAME(0, "listen");
     UA_Variant_setScalar(&params[3].value, &listen, &UA_TYPES[UA_TYPES_BOOLEAN]);
+    params[4].key = UA_QUALIFIEDNAME(0, "packet-ring");
+    UA_Variant_setScalar(&params[4].value, &packetRing, &UA_TYPES[UA_TYPES_BOOLEAN]);
 
     TestContext testContext;
     testContext.connCount = 0;
 
     /* Don't use the address parameter for listening */
-    UA_KeyValueMap kvm = {3, &params[1]};
+    UA_KeyValueMap kvm = {4, &params[1]};
     UA_StatusCode retval =
         cm->openConnection(cm, &kvm, NULL, &testContext, connectionCallback);
     ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
@@ -146,7 +151,8 @@ START_TEST(connectETH) {
     size_t listenSockets = testContext.connCount;
 
     /* Open a client connection. Don't use the listen parameter.*/
-    kvm.map = params;
+    UA_KeyValuePair clientParams[4] = {params[0], params[1], params[2], params[4]};
+    kvm.map = clientParams;
     clientId = 0;
     retval = cm->openConnection(cm, &kvm, NULL, &testContext, connectionCallback);
     ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
@@ -157,16 +163,19 @@ START_TEST(connectETH) {
     ck_assert(clientId != 0);
     ck_assert_uint_eq(testContext.connCount, listenSockets + 1);
 
-    /* Send a message from the client */
+    /* Send messages from the client */
     received = false;
-    UA_ByteString snd;
-    retval = cm->allocNetworkBuffer(cm, clientId, &snd, strlen(testMsg));
-    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
-    memcpy(snd.data, testMsg, strlen(testMsg));
-    retval = cm->sendWithConnection(cm, clientId, NULL, &snd);
-    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    receivedCount = 0;
+    for(size_t i = 0; i < messages; i++) {
+        UA_ByteString snd;
+        retval = cm->allocNetworkBuffer(cm, clientId, &snd, strlen(testMsg));
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+        memcpy(snd.data, testMsg, strlen(testMsg));
+        retval = cm->sendWithConnection(cm, clientId, NULL, &snd);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
 
-    while(!received) {
+    while(receivedCount < messages) {
         UA_DateTime next = el->run(el, 100);
         UA_fakeSleep((UA_UInt32)((next - UA_DateTime_now()) / UA_DATETIME_MSEC));
     }
@@ -195,6 +204,15 @@ START_TEST(connectETH) {
     ck_assert(el->state == UA_EVENTLOOPSTATE_STOPPED);
     el->free(el);
     el = NULL;
+}
+
+START_TEST(connectETH) {
+    connectAndSend(false, 1);
+} END_TEST
+
+/* Receive from the rx ring and send via the tx ring */
+START_TEST(connectETHPacketRing) {
+    connectAndSend(true, 5);
 } END_TEST
 
 int main(void) {
@@ -202,6 +220,7 @@ int main(void) {
     TCase *tc = tcase_create("test cases");
     tcase_add_test(tc, listenETH);
     tcase_add_test(tc, connectETH);
+    tcase_add_test(tc, connectETHPacketRing);
     suite_add_tcase(s, tc);
 
     SRunner *sr = srunner_create(s);
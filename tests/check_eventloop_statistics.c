@@ -0,0 +1,267 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <open62541/plugin/eventloop.h>
+#include <open62541/plugin/log_stdout.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <check.h>
+
+#define BUSY_TIME (2 * UA_DATETIME_MSEC)
+
+static UA_EventLoop *el;
+static size_t count;
+
+static void setupEL(void) {
+    el = UA_EventLoop_new_POSIX(UA_Log_Stdout);
+    el->start(el);
+}
+
+static void teardownEL(void) {
+    el->stop(el);
+    while(el->state != UA_EVENTLOOPSTATE_STOPPED)
+        el->run(el, 1);
+    el->free(el);
+    el = NULL;
+}
+
+/* Keep the EventLoop busy for the given time */
+static void
+busyWait(UA_DateTime duration) {
+    UA_DateTime end = el->dateTime_nowMonotonic(el) + duration;
+    while(el->dateTime_nowMonotonic(el) < end) {}
+}
+
+START_TEST(histogramPercentile) {
+    UA_EventLoopHistogram h;
+    memset(&h, 0, sizeof(UA_EventLoopHistogram));
+    ck_assert_int_eq(UA_EventLoopHistogram_percentile(&h, 50.0), 0);
+
+    /* 90 values of 2 and 10 values in the bucket of 1000 (896 to 1023) */
+    h.count = 100;
+    h.buckets[2] = 90;
+    h.buckets[4 * (9 - 1) + 3] = 10;
+    h.max = 1000;
+    ck_assert_int_eq(UA_EventLoopHistogram_percentile(&h, 50.0), 2);
+    ck_assert_int_eq(UA_EventLoopHistogram_percentile(&h, 90.0), 2);
+    ck_assert_int_eq(UA_EventLoopHistogram_percentile(&h, 99.0), 1000);
+    ck_assert_int_eq(UA_EventLoopHistogram_percentile(&h, 100.0), 1000);
+} END_TEST
+
+static void
+busyTimerCallback(void *application, void *data) {
+    busyWait(BUSY_TIME);
+    count++;
+}
+
+static void
+idleTimerCallback(void *application, void *data) {}
+
+struct TimerResult {
+    UA_UInt64 busyId;
+    UA_EventLoopCallbackStatistics busy;
+    size_t found;
+};
+
+static void
+checkTimer(void *context, UA_UInt64 callbackId, UA_Callback callback,
+           void *application, void *data,
+           const UA_EventLoopCallbackStatistics *stats) {
+    struct TimerResult *res = (struct TimerResult*)context;
+    res->found++;
+    if(callbackId == res->busyId)
+        res->busy = *stats;
+}
+
+START_TEST(timerStatistics) {
+    setupEL();
+
+    struct TimerResult res;
+    memset(&res, 0, sizeof(struct TimerResult));
+    UA_StatusCode retval =
+        el->addTimer(el, busyTimerCallback, NULL, NULL, 5.0, NULL,
+                     UA_TIMERPOLICY_CURRENTTIME, &res.busyId);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    retval = el->addTimer(el, idleTimerCallback, NULL, NULL, 1.0, NULL,
+                          UA_TIMERPOLICY_CURRENTTIME, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    count = 0;
+    while(count < 5)
+        el->run(el, 10);
+
+    UA_EventLoopStatistics stats;
+    UA_EventLoopPOSIX_getStatistics(el, &stats);
+    ck_assert_uint_gt(stats.timerCallbacks.count, 5);
+    ck_assert_int_ge(stats.timerCallbacks.max, BUSY_TIME);
+    ck_assert_uint_gt(stats.timerLag.count, 5);
+    ck_assert_uint_gt(stats.iterations.count, 0);
+    ck_assert_int_ge(stats.iterations.max, BUSY_TIME);
+
+    /* The percentile is an upper bound and covers the busy callback */
+    ck_assert_int_ge(UA_EventLoopHistogram_percentile(&stats.timerCallbacks, 100.0),
+                     BUSY_TIME);
+
+    /* The execution times are attributed to the busy timer */
+    UA_EventLoopPOSIX_iterateTimerStatistics(el, checkTimer, &res);
+    ck_assert_uint_eq(res.found, 2);
+    ck_assert_uint_eq(res.busy.count, 5);
+    ck_assert_int_ge(res.busy.total, 5 * BUSY_TIME);
+    ck_assert_int_ge(res.busy.max, BUSY_TIME);
+
+    /* Reset */
+    UA_EventLoopPOSIX_resetStatistics(el);
+    UA_EventLoopPOSIX_getStatistics(el, &stats);
+    ck_assert_uint_eq(stats.timerCallbacks.count, 0);
+    memset(&res.busy, 0, sizeof(UA_EventLoopCallbackStatistics));
+    res.found = 0;
+    UA_EventLoopPOSIX_iterateTimerStatistics(el, checkTimer, &res);
+    ck_assert_uint_eq(res.found, 2);
+    ck_assert_uint_eq(res.busy.count, 0);
+
+    teardownEL();
+} END_TEST
+
+static void
+delayedCallback(void *application, void *context) {
+    count++;
+}
+
+START_TEST(delayedStatistics) {
+    setupEL();
+
+    UA_DelayedCallback dc[3];
+    memset(dc, 0, sizeof(dc));
+    for(size_t i = 0; i < 3; i++) {
+        dc[i].callback = delayedCallback;
+        el->addDelayedCallback(el, &dc[i]);
+    }
+
+    count = 0;
+    el->run(el, 0);
+    ck_assert_uint_eq(count, 3);
+
+    UA_EventLoopStatistics stats;
+    UA_EventLoopPOSIX_getStatistics(el, &stats);
+    ck_assert_uint_eq(stats.delayedCallbacks.count, 3);
+    ck_assert_uint_eq(stats.delayedQueueLength, 3);
+    ck_assert_uint_eq(stats.delayedQueueLengthMax, 3);
+
+    el->run(el, 0);
+    UA_EventLoopPOSIX_getStatistics(el, &stats);
+    ck_assert_uint_eq(stats.delayedQueueLength, 0);
+    ck_assert_uint_eq(stats.delayedQueueLengthMax, 3);
+
+    teardownEL();
+} END_TEST
+
+static uintptr_t clientId;
+static UA_Boolean received;
+
+static void
+connectionCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
+                   void *application, void **connectionContext,
+                   UA_ConnectionState status,
+                   const UA_KeyValueMap *params,
+                   UA_ByteString msg) {
+    if(*connectionContext != NULL)
+        clientId = connectionId;
+    if(msg.length > 0) {
+        busyWait(BUSY_TIME);
+        received = true;
+    }
+}
+
+struct ConnectionResult {
+    UA_ConnectionManager *cm;
+    size_t found;
+    UA_DateTime max;
+};
+
+static void
+checkConnection(void *context, UA_ConnectionManager *cm, uintptr_t connectionId,
+                const UA_EventLoopCallbackStatistics *stats) {
+    struct ConnectionResult *res = (struct ConnectionResult*)context;
+    ck_assert_ptr_eq(cm, res->cm);
+    res->found++;
+    if(stats->max > res->max)
+        res->max = stats->max;
+}
+
+START_TEST(connectionStatistics) {
+    el = UA_EventLoop_new_POSIX(UA_Log_Stdout);
+    UA_ConnectionManager *cm =
+        UA_ConnectionManager_new_POSIX_TCP(UA_STRING("tcpCM"));
+    el->registerEventSource(el, &cm->eventSource);
+    el->start(el);
+
+    UA_UInt16 port = 4850;
+    UA_Boolean listen = true;
+    UA_String host = UA_STRING("localhost");
+    UA_KeyValuePair params[3];
+    params[0].key = UA_QUALIFIEDNAME(0, "port");
+    UA_Variant_setScalar(&params[0].value, &port, &UA_TYPES[UA_TYPES_UINT16]);
+    params[1].key = UA_QUALIFIEDNAME(0, "listen");
+    UA_Variant_setScalar(&params[1].value, &listen, &UA_TYPES[UA_TYPES_BOOLEAN]);
+    params[2].key = UA_QUALIFIEDNAME(0, "address");
+    UA_Variant_setScalar(&params[2].value, &host, &UA_TYPES[UA_TYPES_STRING]);
+    UA_KeyValueMap paramsMap = {3, params};
+    UA_StatusCode retval =
+        cm->openConnection(cm, &paramsMap, NULL, NULL, connectionCallback);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* Connect and send to the server side of the connection */
+    clientId = 0;
+    listen = false;
+    retval = cm->openConnection(cm, &paramsMap, NULL, (void*)0x01, connectionCallback);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    for(size_t i = 0; i < 10 && clientId == 0; i++)
+        el->run(el, 10);
+    ck_assert(clientId != 0);
+
+    received = false;
+    UA_ByteString snd;
+    retval = cm->allocNetworkBuffer(cm, clientId, &snd, 4);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    memcpy(snd.data, "ping", 4);
+    retval = cm->sendWithConnection(cm, clientId, NULL, &snd);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    for(size_t i = 0; i < 10 && !received; i++)
+        el->run(el, 10);
+    ck_assert(received);
+
+    UA_EventLoopStatistics stats;
+    UA_EventLoopPOSIX_getStatistics(el, &stats);
+    ck_assert_uint_gt(stats.fdCallbacks.count, 0);
+    ck_assert_int_ge(stats.fdCallbacks.max, BUSY_TIME);
+
+    /* The listen socket(s) and both ends of the connection */
+    struct ConnectionResult res;
+    memset(&res, 0, sizeof(struct ConnectionResult));
+    res.cm = cm;
+    UA_EventLoopPOSIX_iterateConnectionStatistics(el, checkConnection, &res);
+    ck_assert_uint_ge(res.found, 3);
+    ck_assert_int_ge(res.max, BUSY_TIME);
+
+    teardownEL();
+} END_TEST
+
+int main(void) {
+    Suite *s  = suite_create("Test EventLoop Statistics");
+    TCase *tc = tcase_create("test cases");
+    tcase_add_test(tc, histogramPercentile);
+    tcase_add_test(tc, timerStatistics);
+    tcase_add_test(tc, delayedStatistics);
+    tcase_add_test(tc, connectionStatistics);
+    suite_add_tcase(s, tc);
+
+    SRunner *sr = srunner_create(s);
+    srunner_set_fork_status(sr, CK_NOFORK);
+    srunner_run_all (sr, CK_NORMAL);
+    int number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -18,6 +18,7 @@ static unsigned connCount;
 static char *testMsg = "open62541";
 static uintptr_t clientId;
 static UA_Boolean received;
+static UA_Boolean useIOUring;
 
 static void setupEL(void) {
 #if defined(UA_ARCHITECTURE_LWIP)
@@ -26,6 +27,8 @@ static void setupEL(void) {
     el->registerEventSource(el, &cm->eventSource);
 #elif defined(UA_ARCHITECTURE_POSIX) || defined(UA_ARCHITECTURE_WIN32)
     el = UA_EventLoop_new_POSIX(UA_Log_Stdout);
+    UA_KeyValueMap_setScalar(&el->params, UA_QUALIFIEDNAME(0, "io-uring"),
+                             (void *)&useIOUring, &UA_TYPES[UA_TYPES_BOOLEAN]);
     cm = UA_ConnectionManager_new_POSIX_TCP(UA_STRING("tcpCM"));
     /* Set up the TCP EventLoop parameters */
     UA_UInt32 maxSockets = 2; /* Max number of server sockets (default: 0 -> unbounded) */
@@ -225,13 +228,250 @@ START_TEST(connectTCP) {
     el = NULL;
 } END_TEST
 
+static size_t receivedBytes;       /* Received by the server side */
+static size_t clientReceivedBytes; /* Received by the client side */
+static uintptr_t serverId;
+
+static void
+countingCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
+                 void *application, void **connectionContext,
+                 UA_ConnectionState status,
+                 const UA_KeyValueMap *params,
+                 UA_ByteString msg) {
+    if(*connectionContext != NULL)
+        clientId = connectionId;
+    if(msg.length == 0 && status == UA_CONNECTIONSTATE_ESTABLISHED)
+        connCount++;
+    if(status == UA_CONNECTIONSTATE_CLOSING)
+        connCount--;
+    if(*connectionContext != NULL) {
+        clientReceivedBytes += msg.length;
+    } else if(msg.length > 0) {
+        serverId = connectionId;
+        receivedBytes += msg.length;
+    }
+}
+
+static void
+runEL(void) {
+    UA_DateTime next = el->run(el, 1);
+    UA_fakeSleep((UA_UInt32)((next - UA_DateTime_now()) / UA_DATETIME_MSEC));
+}
+
+/* Start the EventLoop with the send queue parameters and open a connection to
+ * a listen socket of the same EventLoop. Returns the number of listen
+ * sockets. */
+static size_t
+openSendQueueConnection(UA_UInt32 queueLimit, UA_Boolean queueClose) {
+    setupEL();
+    UA_KeyValueMap_setScalar(&cm->eventSource.params,
+                             UA_QUALIFIEDNAME(0, "send-queue-limit"),
+                             (void *)&queueLimit, &UA_TYPES[UA_TYPES_UINT32]);
+    UA_KeyValueMap_setScalar(&cm->eventSource.params,
+                             UA_QUALIFIEDNAME(0, "send-queue-close"),
+                             (void *)&queueClose, &UA_TYPES[UA_TYPES_BOOLEAN]);
+    el->start(el);
+
+    UA_UInt16 port = 4840;
+    UA_Boolean listen = true;
+    UA_String host = UA_STRING("localhost");
+    UA_Boolean reuseaddr = true;
+
+    UA_KeyValuePair params[4];
+    params[0].key = UA_QUALIFIEDNAME(0, "port");
+    UA_Variant_setScalar(&params[0].value, &port, &UA_TYPES[UA_TYPES_UINT16]);
+    params[1].key = UA_QUALIFIEDNAME(0, "listen");
+    UA_Variant_setScalar(&params[1].value, &listen, &UA_TYPES[UA_TYPES_BOOLEAN]);
+    params[2].key = UA_QUALIFIEDNAME(0, "address");
+    UA_Variant_setScalar(&params[2].value, &host, &UA_TYPES[UA_TYPES_STRING]);
+    params[3].key = UA_QUALIFIEDNAME(0, "reuse");
+    UA_Variant_setScalar(&params[3].value, &reuseaddr, &UA_TYPES[UA_TYPES_BOOLEAN]);
+
+    UA_KeyValueMap paramsMap;
+    paramsMap.map = params;
+    paramsMap.mapSize = 4;
+
+    connCount = 0;
+    receivedBytes = 0;
+    clientReceivedBytes = 0;
+    serverId = 0;
+    cm->openConnection(cm, &paramsMap, NULL, NULL, countingCallback);
+    size_t listenSockets = connCount;
+
+    /* Open a client connection */
+    clientId = 0;
+    listen = false;
+    UA_StatusCode retval =
+        cm->openConnection(cm, &paramsMap, NULL, (void*)0x01, countingCallback);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    for(size_t i = 0; i < 2; i++)
+        runEL();
+    ck_assert(clientId != 0);
+    ck_assert_uint_eq(connCount, listenSockets + 2);
+    return listenSockets;
+}
+
+static void
+stopEL(void) {
+    int max_stop_iteration_count = 10;
+    int iteration = 0;
+    el->stop(el);
+    while(el->state != UA_EVENTLOOPSTATE_STOPPED &&
+          iteration < max_stop_iteration_count) {
+        runEL();
+        iteration++;
+    }
+    ck_assert(el->state == UA_EVENTLOOPSTATE_STOPPED);
+    el->free(el);
+    el = NULL;
+}
+
+static UA_StatusCode
+sendBytes(uintptr_t connectionId, size_t size, UA_Byte value) {
+    UA_ByteString snd;
+    UA_StatusCode retval = cm->allocNetworkBuffer(cm, connectionId, &snd, size);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    memset(snd.data, value, size);
+    return cm->sendWithConnection(cm, connectionId, NULL, &snd);
+}
+
+/* Send several messages that exceed the socket buffers by far */
+#define QUEUE_MSGSIZE (1 << 22) /* 4MB */
+#define QUEUE_MSGCOUNT 4
+
+/* Sending more than the socket buffers can take must not block. The remote end
+ * of the connection is served by the same EventLoop. */
+START_TEST(sendQueueTCP) {
+    openSendQueueConnection(0, false);
+
+    for(size_t i = 0; i < QUEUE_MSGCOUNT; i++) {
+        UA_StatusCode retval = sendBytes(clientId, QUEUE_MSGSIZE, (UA_Byte)i);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
+
+    /* The queued data gets sent out as the receiving side consumes it */
+    for(size_t i = 0; i < 10000 &&
+            receivedBytes < QUEUE_MSGSIZE * QUEUE_MSGCOUNT; i++)
+        runEL();
+    ck_assert_uint_eq(receivedBytes, QUEUE_MSGSIZE * QUEUE_MSGCOUNT);
+
+    stopEL();
+} END_TEST
+
+/* While the send queue exceeds the send-queue-limit, nothing is received from
+ * the connection. The reception resumes once the queue has been sent out. */
+START_TEST(sendQueueLimitTCP) {
+    const UA_UInt32 limit = 1 << 16; /* 64kB */
+    openSendQueueConnection(limit, false);
+
+    for(size_t i = 0; i < QUEUE_MSGCOUNT; i++) {
+        UA_StatusCode retval = sendBytes(clientId, QUEUE_MSGSIZE, (UA_Byte)i);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
+
+    /* Wait for the first message on the server side. Then send a response. */
+    for(size_t i = 0; i < 100 && serverId == 0; i++)
+        runEL();
+    ck_assert(serverId != 0);
+    ck_assert_uint_eq(sendBytes(serverId, 8, 0xff), UA_STATUSCODE_GOOD);
+
+    /* The response is received only once the client has caught up with the
+     * sending. Then at most the limit (plus what the socket buffers hold) is
+     * still in flight. */
+    size_t receivedAtResume = 0;
+    for(size_t i = 0; i < 10000 &&
+            receivedBytes < QUEUE_MSGSIZE * QUEUE_MSGCOUNT; i++) {
+        runEL();
+        if(clientReceivedBytes > 0 && receivedAtResume == 0)
+            receivedAtResume = receivedBytes;
+    }
+    ck_assert_uint_eq(receivedBytes, QUEUE_MSGSIZE * QUEUE_MSGCOUNT);
+    for(size_t i = 0; i < 100 && clientReceivedBytes == 0; i++)
+        runEL();
+    ck_assert_uint_eq(clientReceivedBytes, 8);
+    if(receivedAtResume == 0)
+        receivedAtResume = receivedBytes;
+    ck_assert_uint_gt(receivedAtResume, QUEUE_MSGSIZE);
+
+    stopEL();
+} END_TEST
+
+/* With send-queue-close, the connection is closed when the send queue exceeds
+ * the send-queue-limit */
+START_TEST(sendQueueCloseTCP) {
+    const UA_UInt32 limit = 1 << 16; /* 64kB */
+    size_t listenSockets = openSendQueueConnection(limit, true);
+
+    UA_StatusCode retval = UA_STATUSCODE_GOOD;
+    for(size_t i = 0; i < QUEUE_MSGCOUNT && retval == UA_STATUSCODE_GOOD; i++)
+        retval = sendBytes(clientId, QUEUE_MSGSIZE, (UA_Byte)i);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_BADCONNECTIONCLOSED);
+
+    /* Both ends of the connection get closed */
+    for(size_t i = 0; i < 100 && connCount > listenSockets; i++)
+        runEL();
+    ck_assert_uint_eq(connCount, listenSockets);
+    ck_assert_uint_lt(receivedBytes, QUEUE_MSGSIZE * QUEUE_MSGCOUNT);
+
+    stopEL();
+} END_TEST
+
+#if !defined(UA_ARCHITECTURE_LWIP)
+/* The EventLoop does not start with a malformed io-uring parameter */
+START_TEST(ioUringParamType) {
+    el = UA_EventLoop_new_POSIX(UA_Log_Stdout);
+    UA_Int32 wrongType = 1;
+    UA_KeyValueMap_setScalar(&el->params, UA_QUALIFIEDNAME(0, "io-uring"),
+                             (void *)&wrongType, &UA_TYPES[UA_TYPES_INT32]);
+    ck_assert_uint_ne(el->start(el), UA_STATUSCODE_GOOD);
+
+    UA_Boolean enable = true;
+    UA_KeyValueMap_setScalar(&el->params, UA_QUALIFIEDNAME(0, "io-uring"),
+                             (void *)&enable, &UA_TYPES[UA_TYPES_BOOLEAN]);
+#ifdef UA_ENABLE_IO_URING
+    ck_assert_uint_eq(el->start(el), UA_STATUSCODE_GOOD);
+    el->stop(el);
+    while(el->state != UA_EVENTLOOPSTATE_STOPPED)
+        el->run(el, 1);
+#else
+    /* Rejected if the io_uring backend is not built in */
+    ck_assert_uint_eq(el->start(el), UA_STATUSCODE_BADNOTSUPPORTED);
+#endif
+    el->free(el);
+    el = NULL;
+} END_TEST
+#endif
+
+#ifdef UA_ENABLE_IO_URING
+static void enableIOUring(void) { useIOUring = true; connCount = 0; }
+static void disableIOUring(void) { useIOUring = false; }
+#endif
+
 int main(void) {
     Suite *s  = suite_create("Test TCP EventLoop");
     TCase *tc = tcase_create("test cases");
     tcase_add_test(tc, listenTCP);
     tcase_add_test(tc, connectTCP);
+#if !defined(UA_ARCHITECTURE_LWIP)
+    tcase_add_test(tc, sendQueueTCP);
+    tcase_add_test(tc, sendQueueLimitTCP);
+    tcase_add_test(tc, sendQueueCloseTCP);
+    tcase_add_test(tc, ioUringParamType);
+#endif
     suite_add_tcase(s, tc);
 
+#ifdef UA_ENABLE_IO_URING
+    /* The same tests with the io_uring backend */
+    TCase *tc_uring = tcase_create("io_uring");
+    tcase_add_checked_fixture(tc_uring, enableIOUring, disableIOUring);
+    tcase_add_test(tc_uring, listenTCP);
+    tcase_add_test(tc_uring, connectTCP);
+    tcase_add_test(tc_uring, sendQueueTCP);
+    tcase_add_test(tc_uring, sendQueueLimitTCP);
+    tcase_add_test(tc_uring, sendQueueCloseTCP);
+    suite_add_tcase(s, tc_uring);
+#endif
+
     SRunner *sr = srunner_create(s);
     srunner_set_fork_status(sr, CK_NOFORK);
     srunner_run_all (sr, CK_NORMAL);
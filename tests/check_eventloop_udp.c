@@ -538,6 +538,118 @@ START_TEST(udpTalkerAndListenerDifferentDestination) {
     ck_assert_uint_eq(testContext.connCount, 0);
 } END_TEST
 
+#if !defined(UA_ARCHITECTURE_LWIP)
+
+#define BATCH_MSGCOUNT 5
+
+static size_t receivedCount;
+
+static void
+countingCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
+                 void *application, void **connectionContext,
+                 UA_ConnectionState status,
+                 const UA_KeyValueMap *params,
+                 UA_ByteString msg) {
+    if(msg.length == 0 && status == UA_CONNECTIONSTATE_ESTABLISHED)
+        clientId = connectionId;
+    if(msg.length > 0) {
+        UA_ByteString rcv = UA_BYTESTRING(testMsg);
+        ck_assert(UA_String_equal(&msg, &rcv));
+        receivedCount++;
+    }
+}
+
+/* Send several datagrams from within the EventLoop */
+static void
+sendBatch(void *application, void *context) {
+    uintptr_t connectionId = (uintptr_t)context;
+    for(size_t i = 0; i < BATCH_MSGCOUNT; i++) {
+        UA_ByteString snd;
+        UA_StatusCode res =
+            cmTalker->allocNetworkBuffer(cmTalker, connectionId, &snd, strlen(testMsg));
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+        memcpy(snd.data, testMsg, strlen(testMsg));
+        res = cmTalker->sendWithConnection(cmTalker, connectionId,
+                                           &UA_KEYVALUEMAP_NULL, &snd);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    }
+}
+
+/* The datagrams sent in one EventLoop iteration are coalesced and the listener
+ * drains them from the socket in a single iteration */
+START_TEST(udpBatchedTalkerAndListener) {
+    setupELTalkerAndListener();
+    UA_UInt16 batchSize = 8;
+    UA_KeyValueMap_setScalar(&cmTalker->eventSource.params,
+                             UA_QUALIFIEDNAME(0, "send-batchsize"),
+                             (void *)&batchSize, &UA_TYPES[UA_TYPES_UINT16]);
+    elListener->start(elListener);
+    elTalker->start(elTalker);
+
+    UA_UInt16 port = 30000;
+    UA_Boolean listen = true;
+    UA_String targetHost = UA_STRING("localhost");
+
+    UA_KeyValuePair params[3];
+    UA_KeyValueMap paramsMap = {2, params};
+    params[0].key = UA_QUALIFIEDNAME(0, "port");
+    UA_Variant_setScalar(&params[0].value, &port, &UA_TYPES[UA_TYPES_UINT16]);
+    params[1].key = UA_QUALIFIEDNAME(0, "listen");
+    UA_Variant_setScalar(&params[1].value, &listen, &UA_TYPES[UA_TYPES_BOOLEAN]);
+    params[2].key = UA_QUALIFIEDNAME(0, "address");
+    UA_Variant_setScalar(&params[2].value, &targetHost, &UA_TYPES[UA_TYPES_STRING]);
+
+    UA_StatusCode retval =
+        cmListener->openConnection(cmListener, &paramsMap, NULL, NULL,
+                                   countingCallback);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    clientId = 0;
+    listen = false;
+    paramsMap.mapSize = 3;
+    retval = cmTalker->openConnection(cmTalker, &paramsMap, NULL, NULL,
+                                      countingCallback);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    for(size_t i = 0; i < 2; i++) {
+        UA_DateTime next = elTalker->run(elTalker, 1);
+        UA_fakeSleep((UA_UInt32)((next - UA_DateTime_now()) / UA_DATETIME_MSEC));
+    }
+    ck_assert_uint_ne(clientId, 0);
+
+    /* Queue the datagrams from a callback of the talker EventLoop. They are
+     * sent out with the next iteration. */
+    UA_DelayedCallback dc;
+    memset(&dc, 0, sizeof(UA_DelayedCallback));
+    dc.callback = sendBatch;
+    dc.context = (void*)clientId;
+    elTalker->addDelayedCallback(elTalker, &dc);
+    for(size_t i = 0; i < 2; i++) {
+        UA_DateTime next = elTalker->run(elTalker, 1);
+        UA_fakeSleep((UA_UInt32)((next - UA_DateTime_now()) / UA_DATETIME_MSEC));
+    }
+
+    /* All datagrams are received in one iteration */
+    receivedCount = 0;
+    elListener->run(elListener, 1);
+    ck_assert_uint_eq(receivedCount, BATCH_MSGCOUNT);
+
+    elTalker->stop(elTalker);
+    for(size_t i = 0; i < 10 && elTalker->state != UA_EVENTLOOPSTATE_STOPPED; i++)
+        elTalker->run(elTalker, 1);
+    ck_assert_int_eq(elTalker->state, UA_EVENTLOOPSTATE_STOPPED);
+    elTalker->free(elTalker);
+    elTalker = NULL;
+
+    elListener->stop(elListener);
+    for(size_t i = 0; i < 10 && elListener->state != UA_EVENTLOOPSTATE_STOPPED; i++)
+        elListener->run(elListener, 1);
+    ck_assert_int_eq(elListener->state, UA_EVENTLOOPSTATE_STOPPED);
+    elListener->free(elListener);
+    elListener = NULL;
+} END_TEST
+
+#endif
+
 int main(void) {
     Suite *s  = suite_create("Test UDP EventLoop");
     TCase *tc = tcase_create("test cases");
@@ -547,6 +659,9 @@ int main(void) {
     tcase_add_test(tc, connectUDPValidationSucceeds);
     tcase_add_test(tc, udpTalkerAndListener);
     tcase_add_test(tc, udpTalkerAndListenerDifferentDestination);
+#if !defined(UA_ARCHITECTURE_LWIP)
+    tcase_add_test(tc, udpBatchedTalkerAndListener);
+#endif
     suite_add_tcase(s, tc);
 
     SRunner *sr = srunner_create(s);
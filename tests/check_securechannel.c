@@ -493,6 +493,34 @@ START_TEST(SecureChannel_assemblePartialChunks) {
     ck_assert_int_eq(chunks_processed, 5);
 } END_TEST
 
+/* Feed the same chunks in pieces of different sizes. Only the missing bytes of
+ * a split chunk are copied into the reassembly buffer. */
+START_TEST(SecureChannel_assembleSplitChunks) {
+    const char *hel = "HELF \x00\x00\x00\x00\x00\x00\x00\x00\x10\x00\x00\x00"
+                      "\x10\x00\x00\x00@\x00\x00\x00\x00\x00\x00\xff\xff\xff\xff";
+    UA_Byte data[4 * 32];
+    for(size_t i = 0; i < 4; i++)
+        memcpy(&data[i * 32], hel, 32);
+
+    const size_t pieceSizes[] = {1, 3, 7, 8, 9, 31, 33, 50};
+    for(size_t s = 0; s < sizeof(pieceSizes) / sizeof(size_t); s++) {
+        int chunks_processed = 0;
+        for(size_t pos = 0; pos < sizeof(data); pos += pieceSizes[s]) {
+            UA_ByteString buffer;
+            buffer.data = &data[pos];
+            buffer.length = pieceSizes[s];
+            if(pos + buffer.length > sizeof(data))
+                buffer.length = sizeof(data) - pos;
+            UA_StatusCode retval =
+                UA_SecureChannel_processBuffer(&testChannel, &chunks_processed, buffer);
+            ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+        }
+        ck_assert_int_eq(chunks_processed, 4);
+        ck_assert_uint_eq(testChannel.unprocessed.length, 0);
+        ck_assert_uint_eq(testChannel.unprocessedNext.length, 0);
+    }
+} END_TEST
+
 
 static Suite *
 testSuite_SecureChannel(void) {
@@ -533,6 +561,7 @@ testSuite_SecureChannel(void) {
     tcase_add_checked_fixture(tc_processBuffer, setup_key_sizes, teardown_key_sizes);
     tcase_add_checked_fixture(tc_processBuffer, setup_secureChannel, teardown_secureChannel);
     tcase_add_test(tc_processBuffer, SecureChannel_assemblePartialChunks);
+    tcase_add_test(tc_processBuffer, SecureChannel_assembleSplitChunks);
     suite_add_tcase(s, tc_processBuffer);
 
     return s;
@@ -53,10 +53,225 @@ START_TEST(benchmarkTimer) {
     UA_Timer_clear(&timer);
 } END_TEST
 
+static const UA_TimerBackend backends[2] =
+    {UA_TIMERBACKEND_ZIPTREE, UA_TIMERBACKEND_WHEEL};
+static const char *backendNames[2] = {"zip-tree", "timing wheel"};
+
+/* The time of the last and the current call to _process */
+static UA_DateTime lastNow;
+static UA_DateTime currentNow;
+
+/* Every callback is executed once in the first iteration where its time has
+ * come. The expected time is stored in the data pointer. */
+static void
+onceCallback(void *application, void *data) {
+    UA_DateTime *expected = (UA_DateTime*)data;
+    ck_assert_int_le(*expected, currentNow);
+    ck_assert_int_gt(*expected, lastNow);
+    *expected = -1; /* Mark as executed */
+    count++;
+}
+
+#define N_ONCE 2000
+
+START_TEST(executeOnceInTime) {
+    for(size_t b = 0; b < 2; b++) {
+        UA_Timer timer;
+        UA_Timer_initBackend(&timer, backends[b]);
+        ck_assert(timer.wheel != NULL || backends[b] == UA_TIMERBACKEND_ZIPTREE);
+
+        /* Spread the callbacks between 100ns and 100 days into the future to
+         * cover all levels of the wheel */
+        UA_random_seed(42);
+        UA_DateTime start = UA_DATETIME_SEC * 3600;
+        UA_DateTime *times = (UA_DateTime*)UA_malloc(N_ONCE * sizeof(UA_DateTime));
+        for(size_t i = 0; i < N_ONCE; i++) {
+            UA_Double interval = (UA_Double)(UA_UInt32_random() % 1000000) / 10000.0;
+            if(i % 4 == 1)
+                interval *= 1000.0;
+            else if(i % 4 == 2)
+                interval *= 1000000.0;
+            else if(i % 4 == 3)
+                interval *= 100000000.0;
+            if(interval <= 0.0)
+                interval = 0.0001;
+            times[i] = start + (UA_DateTime)(interval * UA_DATETIME_MSEC);
+            UA_StatusCode res =
+                UA_Timer_add(&timer, onceCallback, NULL, &times[i], interval,
+                             start, NULL, UA_TIMERPOLICY_ONCE, NULL);
+            ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+        }
+
+        /* Jump to the next time or a bit before */
+        count = 0;
+        lastNow = start;
+        currentNow = start;
+        UA_DateTime next = UA_Timer_next(&timer);
+        while(next != UA_INT64_MAX) {
+            ck_assert_int_gt(next, lastNow);
+            currentNow = next;
+            if(count % 3 == 1 && next - lastNow > 2)
+                currentNow = next - 1;
+            next = UA_Timer_process(&timer, currentNow);
+            lastNow = currentNow;
+        }
+
+        ck_assert_uint_eq(count, N_ONCE);
+        for(size_t i = 0; i < N_ONCE; i++)
+            ck_assert_int_eq(times[i], -1);
+        UA_free(times);
+        UA_Timer_clear(&timer);
+    }
+} END_TEST
+
+static size_t cycleCounts[2][64];
+
+static void
+cycleCallback(void *application, void *data) {
+    size_t *counter = (size_t*)data;
+    (*counter)++;
+}
+
+START_TEST(backendsAgree) {
+    for(size_t b = 0; b < 2; b++) {
+        UA_Timer timer;
+        UA_Timer_initBackend(&timer, backends[b]);
+        for(size_t i = 0; i < 64; i++) {
+            cycleCounts[b][i] = 0;
+            UA_Double interval = 0.5 + (UA_Double)(i * i);
+            UA_StatusCode res =
+                UA_Timer_add(&timer, cycleCallback, NULL, &cycleCounts[b][i],
+                             interval, 0, NULL, UA_TIMERPOLICY_BASETIME, NULL);
+            ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+        }
+
+        /* Process every 100us for 5s */
+        for(UA_DateTime now = 0; now <= 5 * UA_DATETIME_SEC; now += 1000)
+            UA_Timer_process(&timer, now);
+        UA_Timer_clear(&timer);
+    }
+
+    for(size_t i = 0; i < 64; i++) {
+        UA_DateTime interval = (UA_DateTime)((0.5 + (UA_Double)(i * i)) * UA_DATETIME_MSEC);
+        ck_assert_uint_eq(cycleCounts[0][i], (size_t)(5 * UA_DATETIME_SEC / interval));
+        ck_assert_uint_eq(cycleCounts[0][i], cycleCounts[1][i]);
+    }
+} END_TEST
+
+static UA_Timer *modTimer;
+static UA_UInt64 modIds[3];
+static size_t modCounts[3];
+
+/* The first callback removes the second and makes itself slower */
+static void
+modifyingCallback(void *application, void *data) {
+    size_t i = (size_t)(uintptr_t)data;
+    modCounts[i]++;
+    if(i != 0)
+        return;
+    UA_Timer_remove(modTimer, modIds[1]);
+    UA_StatusCode res =
+        UA_Timer_modify(modTimer, modIds[0], 20.0, currentNow, NULL,
+                        UA_TIMERPOLICY_BASETIME);
+    ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+}
+
+START_TEST(modifyAndRemove) {
+    for(size_t b = 0; b < 2; b++) {
+        UA_Timer timer;
+        UA_Timer_initBackend(&timer, backends[b]);
+        modTimer = &timer;
+        for(size_t i = 0; i < 3; i++) {
+            modCounts[i] = 0;
+            UA_StatusCode res =
+                UA_Timer_add(&timer, modifyingCallback, NULL, (void*)(uintptr_t)i,
+                             10.0, 0, NULL, UA_TIMERPOLICY_BASETIME, &modIds[i]);
+            ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+        }
+
+        /* Remove the third before it is executed */
+        UA_Timer_remove(&timer, modIds[2]);
+        ck_assert_int_eq(UA_Timer_modify(&timer, modIds[2], 10.0, 0, NULL,
+                                         UA_TIMERPOLICY_BASETIME),
+                         UA_STATUSCODE_BADNOTFOUND);
+
+        /* Executed at 10, 30, 50, ... 90 */
+        for(currentNow = 0; currentNow <= 100 * UA_DATETIME_MSEC;
+            currentNow += UA_DATETIME_MSEC)
+            UA_Timer_process(&timer, currentNow);
+
+        ck_assert_uint_eq(modCounts[0], 5);
+        ck_assert_uint_le(modCounts[1], 1); /* Depends on the execution order */
+        ck_assert_uint_eq(modCounts[2], 0);
+        UA_Timer_clear(&timer);
+    }
+} END_TEST
+
+/* Every callback stores its execution time. Within a call to _process, the
+ * callbacks are executed in the order of their time. */
+static UA_DateTime lastExecuted;
+
+static void
+orderedCallback(void *application, void *data) {
+    UA_DateTime *expected = (UA_DateTime*)data;
+    ck_assert_int_ge(*expected, lastExecuted);
+    ck_assert_int_le(*expected, currentNow);
+    lastExecuted = *expected;
+    *expected = -1; /* Mark as executed */
+    count++;
+}
+
+#define N_ORDERED 4000
+
+START_TEST(executeInOrder) {
+    for(size_t b = 0; b < 2; b++) {
+        UA_Timer timer;
+        UA_Timer_initBackend(&timer, backends[b]);
+
+        /* Distinct times 1ms apart, added in random order */
+        UA_random_seed(42);
+        UA_DateTime *times = (UA_DateTime*)UA_malloc(N_ORDERED * sizeof(UA_DateTime));
+        ck_assert_ptr_ne(times, NULL);
+        for(size_t i = 0; i < N_ORDERED; i++)
+            times[i] = (UA_DateTime)(i + 1) * UA_DATETIME_MSEC;
+        for(size_t i = N_ORDERED - 1; i > 0; i--) {
+            size_t j = UA_UInt32_random() % (i + 1);
+            UA_DateTime tmp = times[i];
+            times[i] = times[j];
+            times[j] = tmp;
+        }
+        for(size_t i = 0; i < N_ORDERED; i++) {
+            UA_StatusCode res =
+                UA_Timer_add(&timer, orderedCallback, NULL, &times[i],
+                             (UA_Double)times[i] / UA_DATETIME_MSEC, 0, NULL,
+                             UA_TIMERPOLICY_ONCE, NULL);
+            ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+        }
+
+        /* Process every 10ms. So several callbacks are due every time. */
+        count = 0;
+        lastExecuted = 0;
+        for(currentNow = 0; currentNow <= (N_ORDERED + 10) * UA_DATETIME_MSEC;
+            currentNow += 10 * UA_DATETIME_MSEC)
+            UA_Timer_process(&timer, currentNow);
+
+        ck_assert_uint_eq(count, N_ORDERED);
+        for(size_t i = 0; i < N_ORDERED; i++)
+            ck_assert_int_eq(times[i], -1);
+        ck_assert_int_eq(UA_Timer_next(&timer), UA_INT64_MAX);
+        UA_free(times);
+        UA_Timer_clear(&timer);
+    }
+} END_TEST
+
 int main(void) {
     Suite *s  = suite_create("Test Event Timer");
     TCase *tc = tcase_create("test cases");
     tcase_add_test(tc, benchmarkTimer);
+    tcase_add_test(tc, executeOnceInTime);
+    tcase_add_test(tc, backendsAgree);
+    tcase_add_test(tc, modifyAndRemove);
+    tcase_add_test(tc, executeInOrder);
     suite_add_tcase(s, tc);
 
     SRunner *sr = srunner_create(s);
@@ -1159,6 +1159,39 @@ START_TEST(UA_ExpandedNodeId_hashIdentical) {
 }
 END_TEST
 
+START_TEST(UA_NodeId_hashShallBeStable) {
+    /* The hash values must be the same on all platforms */
+    UA_NodeId n1 = UA_NODEID_NUMERIC(0, 85);
+    UA_NodeId n2 = UA_NODEID_NUMERIC(2, 123456);
+    UA_NodeId n3 = UA_NODEID_STRING(1, "Demo.Static.Scalar.Double");
+    UA_Guid g = {0x72962B91, 0xFA75, 0x4AE6,
+                 {0x8D, 0x28, 0xB4, 0x04, 0xDC, 0x7D, 0xAF, 0x63}};
+    UA_NodeId n4 = UA_NODEID_GUID(3, g);
+    UA_ByteString bs = UA_BYTESTRING("ab");
+
+    ck_assert_uint_eq(UA_NodeId_hash(&n1), 0x327e9f21);
+    ck_assert_uint_eq(UA_NodeId_hash(&n2), 0xa6b83ef4);
+    ck_assert_uint_eq(UA_NodeId_hash(&n3), 0x9449ea7f);
+    ck_assert_uint_eq(UA_NodeId_hash(&n4), 0x3fa6dec1);
+    ck_assert_uint_eq(UA_ByteString_hash(0, bs.data, bs.length), 0xdb6f7000);
+}
+END_TEST
+
+START_TEST(UA_NodeId_orderShallCompareNamespaceFirst) {
+    UA_NodeId n1 = UA_NODEID_NUMERIC(1, 500);
+    UA_NodeId n2 = UA_NODEID_NUMERIC(2, 5);
+    UA_NodeId n3 = UA_NODEID_NUMERIC(2, 6);
+    UA_NodeId n4 = UA_NODEID_STRING(1, "a");
+
+    ck_assert_int_eq(UA_NodeId_order(&n1, &n2), UA_ORDER_LESS);
+    ck_assert_int_eq(UA_NodeId_order(&n2, &n1), UA_ORDER_MORE);
+    ck_assert_int_eq(UA_NodeId_order(&n2, &n3), UA_ORDER_LESS);
+    ck_assert_int_eq(UA_NodeId_order(&n3, &n3), UA_ORDER_EQ);
+    ck_assert_int_eq(UA_NodeId_order(&n1, &n4), UA_ORDER_LESS);
+    ck_assert_int_eq(UA_NodeId_order(&n4, &n2), UA_ORDER_LESS);
+}
+END_TEST
+
 START_TEST(UA_ExpandedNodeId_constructors) {
     /* Test UA_EXPANDEDNODEID_STRING */
     char testStr[] = "TestString";
@@ -1617,6 +1650,116 @@ START_TEST(UA_Variant_copyShallWorkOn2DArrayExample) {
 }
 END_TEST
 
+START_TEST(UA_Variant_copySharedShallTakeReferences) {
+    // given
+    UA_String srcArray[3] = {UA_STRING_STATIC("__open"), UA_STRING_STATIC("_62541"),
+                             UA_STRING_STATIC("opc ua")};
+    UA_UInt32 dimensions[1] = {3};
+    UA_Variant value;
+    UA_Variant_setArray(&value, srcArray, 3, &UA_TYPES[UA_TYPES_STRING]);
+    value.arrayDimensionsSize = 1;
+    value.arrayDimensions = dimensions;
+
+    // when
+    UA_Variant shared, copy1, copy2;
+    UA_StatusCode res = UA_Variant_copyShared(&value, &shared);
+    res |= UA_Variant_copy(&shared, &copy1);
+    res |= UA_Variant_copyShared(&copy1, &copy2);
+
+    // then
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(shared.storageType, UA_VARIANT_DATA_SHARED);
+    ck_assert_int_eq(copy1.storageType, UA_VARIANT_DATA_SHARED);
+    ck_assert_ptr_ne(shared.data, srcArray);
+    ck_assert_ptr_eq(copy1.data, shared.data);
+    ck_assert_ptr_eq(copy2.data, shared.data);
+    ck_assert_ptr_ne(copy1.arrayDimensions, shared.arrayDimensions);
+    ck_assert(UA_order(&value, &copy2, &UA_TYPES[UA_TYPES_VARIANT]) == UA_ORDER_EQ);
+
+    // the data lives until the last reference is cleared
+    UA_Variant_clear(&shared);
+    UA_Variant_clear(&copy1);
+    ck_assert(UA_String_equal(&((UA_String*)copy2.data)[2], &srcArray[2]));
+
+    // finally
+    UA_Variant_clear(&copy2);
+}
+END_TEST
+
+START_TEST(UA_Variant_shareAndUnshareShallMoveData) {
+    // given
+    UA_Variant value;
+    UA_String *s = UA_String_new();
+    *s = UA_STRING_ALLOC("opc ua");
+    UA_Variant_setScalar(&value, s, &UA_TYPES[UA_TYPES_STRING]);
+    UA_Byte *chars = s->data;
+
+    // when
+    UA_StatusCode res = UA_Variant_share(&value);
+
+    // then the members are moved
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(value.storageType, UA_VARIANT_DATA_SHARED);
+    ck_assert(UA_Variant_isScalar(&value));
+    ck_assert_ptr_eq(((UA_String*)value.data)->data, chars);
+
+    // unsharing with other references makes a deep copy
+    UA_Variant copy;
+    res = UA_Variant_copy(&value, &copy);
+    res |= UA_Variant_unshare(&copy);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(copy.storageType, UA_VARIANT_DATA);
+    ck_assert_ptr_ne(((UA_String*)copy.data)->data, chars);
+    ck_assert(UA_order(&value, &copy, &UA_TYPES[UA_TYPES_VARIANT]) == UA_ORDER_EQ);
+    UA_Variant_clear(&copy);
+
+    // unsharing the last reference moves the members
+    res = UA_Variant_unshare(&value);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(value.storageType, UA_VARIANT_DATA);
+    ck_assert_ptr_eq(((UA_String*)value.data)->data, chars);
+
+    // finally
+    UA_Variant_clear(&value);
+}
+END_TEST
+
+START_TEST(UA_Variant_setRangeShallCopyOnWrite) {
+    // given
+    UA_Int32 srcArray[4] = {0, 1, 2, 3};
+    UA_Variant value, shared, copy;
+    UA_Variant_setArray(&value, srcArray, 4, &UA_TYPES[UA_TYPES_INT32]);
+    UA_StatusCode res = UA_Variant_copyShared(&value, &shared);
+    res |= UA_Variant_copy(&shared, &copy);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    // when
+    UA_Int32 update = 42;
+    UA_NumericRangeDimension dim = {1, 1};
+    UA_NumericRange range = {1, &dim};
+    res = UA_Variant_setRangeCopy(&copy, &update, 1, range);
+
+    // then only the modified variant sees the change
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_ptr_ne(copy.data, shared.data);
+    ck_assert_int_eq(copy.storageType, UA_VARIANT_DATA_SHARED);
+    ck_assert_int_eq(((UA_Int32*)copy.data)[1], 42);
+    ck_assert_int_eq(((UA_Int32*)shared.data)[1], 1);
+
+    // the last reference is modified in-place
+    void *data = copy.data;
+    update = 43;
+    res = UA_Variant_setRangeCopy(&copy, &update, 1, range);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_ptr_eq(copy.data, data);
+    ck_assert_int_eq(((UA_Int32*)copy.data)[1], 43);
+
+    // finally
+    UA_Variant_clear(&shared);
+    UA_Variant_clear(&copy);
+}
+END_TEST
+
 START_TEST(UA_ExtensionObject_encodeDecodeShallWorkOnExtensionObject) {
     /* UA_Int32 val = 42; */
     /* UA_VariableAttributes varAttr; */
@@ -1792,6 +1935,52 @@ START_TEST(UA_Variant_encodeDecodeShallWorkOnVariantWithArrayOfExtensionObjectsN
 }
 END_TEST
 
+START_TEST(UA_Variant_decodeLazyShallKeepExtensionObjectsEncoded) {
+    // given
+    UA_Range ranges[3] = {{1.0, 2.0}, {3.0, 4.0}, {5.0, 6.0}};
+    UA_Variant src;
+    UA_Variant_setArray(&src, ranges, 3, &UA_TYPES[UA_TYPES_RANGE]);
+    UA_ByteString enc = UA_BYTESTRING_NULL;
+    UA_StatusCode retval = UA_encodeBinary(&src, &UA_TYPES[UA_TYPES_VARIANT], &enc, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    // when
+    UA_DecodeBinaryOptions opt;
+    memset(&opt, 0, sizeof(UA_DecodeBinaryOptions));
+    opt.lazyExtensionObjects = true;
+    UA_Variant dst;
+    retval = UA_decodeBinary(&enc, &dst, &UA_TYPES[UA_TYPES_VARIANT], &opt);
+
+    // then the content stays encoded
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert(UA_Variant_hasArrayType(&dst, &UA_TYPES[UA_TYPES_EXTENSIONOBJECT]));
+    ck_assert_uint_eq(dst.arrayLength, 3);
+    UA_ExtensionObject *eo = (UA_ExtensionObject*)dst.data;
+    ck_assert_int_eq(eo[0].encoding, UA_EXTENSIONOBJECT_ENCODED_BYTESTRING);
+    ck_assert(UA_NodeId_equal(&eo[0].content.encoded.typeId,
+                              &UA_TYPES[UA_TYPES_RANGE].binaryEncodingId));
+
+    // then it is encoded back without changes
+    UA_ByteString enc2 = UA_BYTESTRING_NULL;
+    retval = UA_encodeBinary(&dst, &UA_TYPES[UA_TYPES_VARIANT], &enc2, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert(UA_ByteString_equal(&enc, &enc2));
+
+    // then decoding on demand gives the result of the eager decoding
+    retval = UA_ExtensionObject_decodeBinaryBody(&eo[1], NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert(UA_ExtensionObject_hasDecodedType(&eo[1], &UA_TYPES[UA_TYPES_RANGE]));
+    retval = UA_Variant_decodeBinaryExtensionObjects(&dst, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert(UA_order(&src, &dst, &UA_TYPES[UA_TYPES_VARIANT]) == UA_ORDER_EQ);
+
+    // finally
+    UA_Variant_clear(&dst);
+    UA_ByteString_clear(&enc);
+    UA_ByteString_clear(&enc2);
+}
+END_TEST
+
 START_TEST(UA_StatusCode_utils) {
 
     ck_assert(UA_TRUE == UA_StatusCode_isBad(UA_STATUSCODE_BADINTERNALERROR));
@@ -1864,6 +2053,7 @@ static Suite *testSuite_builtin(void) {
     tcase_add_test(tc_encode, UA_Variant_encodeDecodeShallWorkOnVariantWithArrayOfExtensionObjectsWithUnknownType);
     tcase_add_test(tc_encode, UA_Variant_encodeDecodeShallWorkOnVariantWithArrayOfExtensionObjectsXmlEncoded);
     tcase_add_test(tc_encode, UA_Variant_encodeDecodeShallWorkOnVariantWithArrayOfExtensionObjectsNoBody);
+    tcase_add_test(tc_encode, UA_Variant_decodeLazyShallKeepExtensionObjectsEncoded);
     suite_add_tcase(s, tc_encode);
 
     TCase *tc_convert = tcase_create("convert");
@@ -1877,6 +2067,8 @@ static Suite *testSuite_builtin(void) {
 
     TCase *tc_hash = tcase_create("hash");
     tcase_add_test(tc_hash, UA_ExpandedNodeId_hashIdentical);
+    tcase_add_test(tc_hash, UA_NodeId_hashShallBeStable);
+    tcase_add_test(tc_hash, UA_NodeId_orderShallCompareNamespaceFirst);
     tcase_add_test(tc_hash, UA_ExpandedNodeId_constructors);
     suite_add_tcase(s, tc_hash);
 
@@ -1888,6 +2080,9 @@ static Suite *testSuite_builtin(void) {
     tcase_add_test(tc_copy, UA_Variant_copyShallWorkOn1DArrayExample);
     tcase_add_test(tc_copy, UA_Variant_copyShallWorkOn2DArrayExample);
     tcase_add_test(tc_copy, UA_Variant_copyShallWorkOnByteStringIndexRange);
+    tcase_add_test(tc_copy, UA_Variant_copySharedShallTakeReferences);
+    tcase_add_test(tc_copy, UA_Variant_shareAndUnshareShallMoveData);
+    tcase_add_test(tc_copy, UA_Variant_setRangeShallCopyOnWrite);
 
     tcase_add_test(tc_copy, UA_DiagnosticInfo_copyShallWorkOnExample);
     tcase_add_test(tc_copy, UA_ApplicationDescription_copyShallWorkOnExample);
@@ -190,6 +190,55 @@ START_TEST(UA_String_escapeutf_json_encode) {
 }
 END_TEST
 
+/* The special characters are placed at all positions relative to the blocks of
+ * the vectorized scanning */
+#define ESCAPE_STRING_LENGTH 40
+
+START_TEST(UA_String_escapeAllPositions_json_encode) {
+    // given
+    char str[ESCAPE_STRING_LENGTH + 1];
+    memset(str, 'a', ESCAPE_STRING_LENGTH);
+    str[ESCAPE_STRING_LENGTH] = 0;
+    str[_i] = '"';
+    str[(_i + 7) % ESCAPE_STRING_LENGTH] = '\x01';
+    str[(_i + 19) % ESCAPE_STRING_LENGTH] = '\'';
+    UA_String src = UA_STRING(str);
+
+    // when
+    UA_ByteString buf = UA_BYTESTRING_NULL;
+    status s = UA_encodeJson(&src, &UA_TYPES[UA_TYPES_STRING], &buf, NULL);
+    ck_assert_int_eq(s, UA_STATUSCODE_GOOD);
+
+    // then
+    char result[ESCAPE_STRING_LENGTH + 16];
+    size_t pos = 0;
+    result[pos++] = '"';
+    for(size_t i = 0; i < ESCAPE_STRING_LENGTH; i++) {
+        if(str[i] == '"') {
+            memcpy(&result[pos], "\\\"", 2);
+            pos += 2;
+        } else if(str[i] == '\x01') {
+            memcpy(&result[pos], "\\u0001", 6);
+            pos += 6;
+        } else {
+            result[pos++] = str[i];
+        }
+    }
+    result[pos++] = '"';
+    ck_assert_uint_eq(buf.length, pos);
+    ck_assert(memcmp(buf.data, result, pos) == 0);
+
+    // then the decoding gives the original string
+    UA_String out;
+    s = UA_decodeJson(&buf, &out, &UA_TYPES[UA_TYPES_STRING], NULL);
+    ck_assert_int_eq(s, UA_STATUSCODE_GOOD);
+    ck_assert(UA_String_equal(&src, &out));
+
+    UA_String_clear(&out);
+    UA_ByteString_clear(&buf);
+}
+END_TEST
+
 START_TEST(UA_String_special_json_encode) {
     // given
     UA_String src = UA_STRING("𝄞𠂊𝕥🔍");
@@ -5407,6 +5456,46 @@ START_TEST(UA_Boolean_true_public_json_encode) {
 }
 END_TEST
 
+/* Random bit patterns roundtrip through JSON without changes */
+#define RANDOM_DOUBLES 10000
+
+START_TEST(UA_Double_randomRoundtrip_json) {
+    UA_UInt64 state = 88172645463325252ULL;
+    for(size_t i = 0; i < RANDOM_DOUBLES; i++) {
+        /* xorshift */
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        UA_Double d;
+        memcpy(&d, &state, sizeof(UA_Double));
+        if(d != d)
+            continue; /* NaN */
+
+        UA_Byte buf[64];
+        UA_ByteString bs = {sizeof(buf), buf};
+        UA_StatusCode res = UA_encodeJson(&d, &UA_TYPES[UA_TYPES_DOUBLE], &bs, NULL);
+        ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+        UA_Double out;
+        res = UA_decodeJson(&bs, &out, &UA_TYPES[UA_TYPES_DOUBLE], NULL);
+        ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+        ck_assert(memcmp(&d, &out, sizeof(UA_Double)) == 0);
+
+        UA_Float f;
+        UA_UInt32 fbits = (UA_UInt32)(state >> 32);
+        memcpy(&f, &fbits, sizeof(UA_Float));
+        if(f != f)
+            continue; /* NaN */
+        bs.length = sizeof(buf);
+        res = UA_encodeJson(&f, &UA_TYPES[UA_TYPES_FLOAT], &bs, NULL);
+        ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+        UA_Float fout;
+        res = UA_decodeJson(&bs, &fout, &UA_TYPES[UA_TYPES_FLOAT], NULL);
+        ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+        ck_assert(memcmp(&f, &fout, sizeof(UA_Float)) == 0);
+    }
+}
+END_TEST
+
 static Suite *testSuite_builtin_json(void) {
     Suite *s = suite_create("Built-in Data Types 62541-6 Json");
 
@@ -5421,6 +5510,8 @@ static Suite *testSuite_builtin_json(void) {
     tcase_add_test(tc_json_encode, UA_String_escapesimple_json_encode);
     tcase_add_test(tc_json_encode, UA_String_escapeutf_json_encode);
     tcase_add_test(tc_json_encode, UA_String_special_json_encode);
+    tcase_add_loop_test(tc_json_encode, UA_String_escapeAllPositions_json_encode,
+                        0, ESCAPE_STRING_LENGTH);
 
 
     tcase_add_test(tc_json_encode, UA_Byte_Max_Number_json_encode);
@@ -5755,6 +5846,10 @@ static Suite *testSuite_builtin_json(void) {
     tcase_add_test(tc_json_decode, UA_Boolean_true_public_json_encode);
     suite_add_tcase(s, tc_json_decode);
 
+    TCase *tc_json_roundtrip = tcase_create("json_roundtrip");
+    tcase_add_test(tc_json_roundtrip, UA_Double_randomRoundtrip_json);
+    suite_add_tcase(s, tc_json_roundtrip);
+
     TCase *tc_json_helper = tcase_create("json_helper");
     tcase_add_test(tc_json_decode, UA_JsonHelper);
     suite_add_tcase(s, tc_json_helper);
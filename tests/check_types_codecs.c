@@ -0,0 +1,208 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <open62541/types.h>
+
+#include "ua_types_encoding_binary.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <check.h>
+
+/* Compare the generated binary codecs with the generic handling along the
+ * member descriptions. The codecs are removed from the side table for the
+ * generic en-/decoding. */
+
+static const UA_DataTypeBinaryCodec *codecs[UA_TYPES_COUNT];
+
+static void
+disableCodecs(void) {
+    for(size_t i = 0; i < UA_TYPES_COUNT; i++) {
+        codecs[i] = UA_TYPES_BINARYCODECS[i];
+        UA_TYPES_BINARYCODECS[i] = NULL;
+    }
+}
+
+static void
+enableCodecs(void) {
+    for(size_t i = 0; i < UA_TYPES_COUNT; i++)
+        UA_TYPES_BINARYCODECS[i] = codecs[i];
+}
+
+START_TEST(codecsShallBeGenerated) {
+    ck_assert_ptr_ne(UA_TYPES_BINARYCODECS[UA_TYPES_READREQUEST], NULL);
+    ck_assert_ptr_ne(UA_TYPES_BINARYCODECS[UA_TYPES_READVALUEID], NULL);
+    ck_assert_ptr_ne(UA_TYPES_BINARYCODECS[UA_TYPES_PUBLISHRESPONSE], NULL);
+    /* Only for plain structures */
+    ck_assert_ptr_eq(UA_TYPES_BINARYCODECS[UA_TYPES_DATAVALUE], NULL);
+    ck_assert_ptr_eq(UA_TYPES_BINARYCODECS[UA_TYPES_TIMESTAMPSTORETURN], NULL);
+} END_TEST
+
+#define RANDOM_TESTS 100
+
+/* Decode random buffers. Values that decode are encoded again. The results
+ * must not differ from the generic handling. */
+START_TEST(codecShallMatchGenericHandling) {
+    const UA_DataType *type = &UA_TYPES[_i];
+    UA_ByteString buf;
+    UA_StatusCode res = UA_ByteString_allocBuffer(&buf, 256);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+#ifdef UA_ARCHITECTURE_WIN32
+    srand(42);
+#else
+    srandom(42);
+#endif
+    for(int n = 0; n < RANDOM_TESTS; n++) {
+        for(size_t i = 0; i < buf.length; i++) {
+#ifdef UA_ARCHITECTURE_WIN32
+            buf.data[i] = (UA_Byte)rand();
+#else
+            buf.data[i] = (UA_Byte)random();
+#endif
+            /* Short array lengths get the decoding further */
+            if(i % 4 == 1 && buf.data[i - 1] % 2 == 0)
+                buf.data[i] = 0;
+        }
+
+        void *v1 = UA_new(type);
+        void *v2 = UA_new(type);
+        UA_StatusCode res1 = UA_decodeBinary(&buf, v1, type, NULL);
+        disableCodecs();
+        UA_StatusCode res2 = UA_decodeBinary(&buf, v2, type, NULL);
+        enableCodecs();
+        ck_assert_uint_eq(res1, res2);
+
+        if(res1 == UA_STATUSCODE_GOOD) {
+            ck_assert(UA_order(v1, v2, type) == UA_ORDER_EQ);
+
+            UA_ByteString enc1 = UA_BYTESTRING_NULL;
+            UA_ByteString enc2 = UA_BYTESTRING_NULL;
+            res1 = UA_encodeBinary(v1, type, &enc1, NULL);
+            disableCodecs();
+            res2 = UA_encodeBinary(v1, type, &enc2, NULL);
+            enableCodecs();
+            ck_assert_uint_eq(res1, res2);
+            ck_assert(UA_ByteString_equal(&enc1, &enc2));
+
+            /* The buffer is too short. (An empty buffer would be allocated
+             * by UA_encodeBinary.) */
+            if(enc1.length > 1) {
+                UA_Byte *short1 = (UA_Byte*)UA_malloc(enc1.length - 1);
+                UA_ByteString out = {enc1.length - 1, short1};
+                res1 = UA_encodeBinary(v1, type, &out, NULL);
+                out.length = enc1.length - 1;
+                disableCodecs();
+                res2 = UA_encodeBinary(v1, type, &out, NULL);
+                enableCodecs();
+                ck_assert_uint_eq(res1, res2);
+                UA_free(short1);
+            }
+
+            UA_ByteString_clear(&enc1);
+            UA_ByteString_clear(&enc2);
+        }
+
+        UA_delete(v1, type);
+        UA_delete(v2, type);
+    }
+    UA_ByteString_clear(&buf);
+} END_TEST
+
+/* Typical service messages are encoded to the same bytes as with the generic
+ * handling and decode to the original value */
+
+#define MESSAGE_VALUES 100
+
+static void
+checkMessage(const void *p, const UA_DataType *type) {
+    UA_ByteString enc1 = UA_BYTESTRING_NULL;
+    UA_ByteString enc2 = UA_BYTESTRING_NULL;
+    UA_StatusCode res = UA_encodeBinary(p, type, &enc1, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    disableCodecs();
+    res = UA_encodeBinary(p, type, &enc2, NULL);
+    enableCodecs();
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(UA_ByteString_equal(&enc1, &enc2));
+
+    void *dst = UA_new(type);
+    res = UA_decodeBinary(&enc1, dst, type, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(UA_order(p, dst, type) == UA_ORDER_EQ);
+    UA_delete(dst, type);
+
+    UA_ByteString_clear(&enc1);
+    UA_ByteString_clear(&enc2);
+}
+
+START_TEST(messagesShallRoundtrip) {
+    /* ReadRequest */
+    UA_ReadValueId rvi[MESSAGE_VALUES];
+    for(size_t i = 0; i < MESSAGE_VALUES; i++) {
+        UA_ReadValueId_init(&rvi[i]);
+        rvi[i].nodeId = UA_NODEID_NUMERIC(1, (UA_UInt32)i + 1000);
+        rvi[i].attributeId = UA_ATTRIBUTEID_VALUE;
+    }
+    UA_ReadRequest readReq;
+    UA_ReadRequest_init(&readReq);
+    readReq.timestampsToReturn = UA_TIMESTAMPSTORETURN_BOTH;
+    readReq.nodesToRead = rvi;
+    readReq.nodesToReadSize = MESSAGE_VALUES;
+    checkMessage(&readReq, &UA_TYPES[UA_TYPES_READREQUEST]);
+
+    /* ReadResponse */
+    UA_Double d = 42.0;
+    UA_DataValue dv[MESSAGE_VALUES];
+    for(size_t i = 0; i < MESSAGE_VALUES; i++) {
+        UA_DataValue_init(&dv[i]);
+        UA_Variant_setScalar(&dv[i].value, &d, &UA_TYPES[UA_TYPES_DOUBLE]);
+        dv[i].hasValue = true;
+        dv[i].sourceTimestamp = UA_DATETIME_UNIX_EPOCH;
+        dv[i].hasSourceTimestamp = true;
+    }
+    UA_ReadResponse readResp;
+    UA_ReadResponse_init(&readResp);
+    readResp.results = dv;
+    readResp.resultsSize = MESSAGE_VALUES;
+    checkMessage(&readResp, &UA_TYPES[UA_TYPES_READRESPONSE]);
+
+    /* PublishResponse with a DataChangeNotification */
+    UA_MonitoredItemNotification min[MESSAGE_VALUES];
+    for(size_t i = 0; i < MESSAGE_VALUES; i++) {
+        UA_MonitoredItemNotification_init(&min[i]);
+        min[i].clientHandle = (UA_UInt32)i;
+        min[i].value = dv[i];
+    }
+    UA_DataChangeNotification dcn;
+    UA_DataChangeNotification_init(&dcn);
+    dcn.monitoredItems = min;
+    dcn.monitoredItemsSize = MESSAGE_VALUES;
+    UA_ExtensionObject eo;
+    UA_ExtensionObject_setValueNoDelete(&eo, &dcn,
+                                        &UA_TYPES[UA_TYPES_DATACHANGENOTIFICATION]);
+    UA_PublishResponse pubResp;
+    UA_PublishResponse_init(&pubResp);
+    pubResp.subscriptionId = 1;
+    pubResp.notificationMessage.sequenceNumber = 1;
+    pubResp.notificationMessage.notificationData = &eo;
+    pubResp.notificationMessage.notificationDataSize = 1;
+    checkMessage(&pubResp, &UA_TYPES[UA_TYPES_PUBLISHRESPONSE]);
+} END_TEST
+
+int main(void) {
+    Suite *s = suite_create("Test Generated Binary Codecs");
+    TCase *tc = tcase_create("Codecs");
+    tcase_add_test(tc, codecsShallBeGenerated);
+    tcase_add_loop_test(tc, codecShallMatchGenericHandling,
+                        UA_TYPES_NODEID, UA_TYPES_COUNT - 1);
+    tcase_add_test(tc, messagesShallRoundtrip);
+    suite_add_tcase(s, tc);
+
+    SRunner *sr = srunner_create(s);
+    srunner_set_fork_status(sr, CK_NOFORK);
+    srunner_run_all(sr, CK_NORMAL);
+    int number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -206,6 +206,144 @@ START_TEST(decodeComplexTypeFromRandomBufferShallSurvive) {
 }
 END_TEST
 
+START_TEST(decodeComplexTypeFromRandomBufferIntoArenaShallSurvive) {
+    // given
+    UA_ByteString msg1;
+    UA_UInt32 buflen = 256;
+    UA_StatusCode retval = UA_ByteString_allocBuffer(&msg1, buflen); // fixed size
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    UA_Arena arena;
+    UA_Arena_init(&arena);
+    UA_DecodeBinaryOptions opt;
+    memset(&opt, 0, sizeof(UA_DecodeBinaryOptions));
+    opt.calloc = UA_Arena_calloc;
+    opt.callocContext = &arena;
+#ifdef UA_ARCHITECTURE_WIN32
+    srand(42);
+#else
+    srandom(42);
+#endif
+    // when
+    for(int n = 0; n < RANDOM_TESTS; n++) {
+        for(UA_UInt32 i = 0; i < buflen; i++) {
+#ifdef UA_ARCHITECTURE_WIN32
+            UA_UInt32 rnd;
+            rnd = rand();
+            msg1.data[i] = rnd;
+#else
+            msg1.data[i] = (UA_Byte)random();  // when
+#endif
+        }
+        size_t pos = 0;
+        void *obj1 = UA_new(&UA_TYPES[_i]);
+        retval = UA_decodeBinaryInternal(&msg1, &pos, obj1, &UA_TYPES[_i], &opt);
+        (void)retval;
+        UA_free(obj1); /* The members are in the arena */
+        UA_Arena_reset(&arena);
+    }
+
+    // finally
+    UA_Arena_clear(&arena);
+    UA_ByteString_clear(&msg1);
+}
+END_TEST
+
+START_TEST(arenaShallBeReused) {
+    // given
+    UA_ReadValueId rvi[1000];
+    for(size_t i = 0; i < 1000; i++) {
+        UA_ReadValueId_init(&rvi[i]);
+        rvi[i].nodeId = UA_NODEID_STRING(1, "a string nodeid in the arena");
+        rvi[i].attributeId = UA_ATTRIBUTEID_VALUE;
+    }
+    UA_ReadRequest req;
+    UA_ReadRequest_init(&req);
+    req.nodesToRead = rvi;
+    req.nodesToReadSize = 1000;
+    UA_ByteString msg = UA_BYTESTRING_NULL;
+    UA_StatusCode retval =
+        UA_encodeBinary(&req, &UA_TYPES[UA_TYPES_READREQUEST], &msg, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_Arena arena;
+    UA_Arena_init(&arena);
+    UA_DecodeBinaryOptions opt;
+    memset(&opt, 0, sizeof(UA_DecodeBinaryOptions));
+    opt.calloc = UA_Arena_calloc;
+    opt.callocContext = &arena;
+
+    // when
+    for(size_t n = 0; n < 3; n++) {
+        UA_ReadRequest req2;
+        size_t offset = 0;
+        retval = UA_decodeBinaryInternal(&msg, &offset, &req2,
+                                         &UA_TYPES[UA_TYPES_READREQUEST], &opt);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+        ck_assert(UA_order(&req, &req2, &UA_TYPES[UA_TYPES_READREQUEST]) == UA_ORDER_EQ);
+        UA_Arena_reset(&arena);
+    }
+
+    // then the arena was grown to hold the request in a single block
+    ck_assert_uint_gt(arena.blockSize, UA_ARENA_BLOCKSIZE);
+    ck_assert_ptr_ne(arena.blocks, NULL);
+    ck_assert_uint_eq(arena.used, 0);
+
+    // finally
+    UA_Arena_clear(&arena);
+    UA_ByteString_clear(&msg);
+}
+END_TEST
+
+START_TEST(borrowedArraysShallPointIntoBuffer) {
+    // given
+    UA_Double d[16];
+    for(size_t i = 0; i < 16; i++)
+        d[i] = (UA_Double)i;
+    UA_WriteValue wv;
+    UA_WriteValue_init(&wv);
+    wv.nodeId = UA_NODEID_STRING(1, "a string nodeid in the buffer");
+    wv.attributeId = UA_ATTRIBUTEID_VALUE;
+    wv.value.hasValue = true;
+    UA_Variant_setArray(&wv.value.value, d, 16, &UA_TYPES[UA_TYPES_DOUBLE]);
+    UA_WriteRequest req;
+    UA_WriteRequest_init(&req);
+    req.nodesToWrite = &wv;
+    req.nodesToWriteSize = 1;
+    UA_ByteString msg = UA_BYTESTRING_NULL;
+    UA_StatusCode retval =
+        UA_encodeBinary(&req, &UA_TYPES[UA_TYPES_WRITEREQUEST], &msg, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_Arena arena;
+    UA_Arena_init(&arena);
+    UA_DecodeBinaryOptions opt;
+    memset(&opt, 0, sizeof(UA_DecodeBinaryOptions));
+    opt.calloc = UA_Arena_calloc;
+    opt.callocContext = &arena;
+    opt.borrowBuffer = true;
+
+    // when
+    UA_WriteRequest req2;
+    size_t offset = 0;
+    retval = UA_decodeBinaryInternal(&msg, &offset, &req2,
+                                     &UA_TYPES[UA_TYPES_WRITEREQUEST], &opt);
+
+    // then
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert(UA_order(&req, &req2, &UA_TYPES[UA_TYPES_WRITEREQUEST]) == UA_ORDER_EQ);
+    UA_Byte *id = req2.nodesToWrite[0].nodeId.identifier.string.data;
+    ck_assert(id >= msg.data && id < msg.data + msg.length);
+    /* The doubles are borrowed only if aligned in the buffer */
+    UA_Byte *data = (UA_Byte*)req2.nodesToWrite[0].value.value.data;
+    if(data >= msg.data && data < msg.data + msg.length)
+        ck_assert_uint_eq(((uintptr_t)data) & 7, 0);
+
+    // finally
+    UA_Arena_clear(&arena);
+    UA_ByteString_clear(&msg);
+}
+END_TEST
+
 START_TEST(calcSizeBinaryShallBeCorrect) {
     void *obj = UA_new(&UA_TYPES[_i]);
     size_t predicted_size = UA_calcSizeBinary(obj, &UA_TYPES[_i], NULL);
@@ -245,6 +383,13 @@ int main(void) {
                         UA_TYPES_BOOLEAN, UA_TYPES_DOUBLE);
     tcase_add_loop_test(tc, decodeComplexTypeFromRandomBufferShallSurvive,
                         UA_TYPES_NODEID, UA_TYPES_COUNT - 1);
+    tcase_add_loop_test(tc, decodeComplexTypeFromRandomBufferIntoArenaShallSurvive,
+                        UA_TYPES_NODEID, UA_TYPES_COUNT - 1);
+    suite_add_tcase(s, tc);
+
+    tc = tcase_create("Decoding into an Arena");
+    tcase_add_test(tc, arenaShallBeReused);
+    tcase_add_test(tc, borrowedArraysShallPointIntoBuffer);
     suite_add_tcase(s, tc);
 
     tc = tcase_create("Test calcSizeBinary");
@@ -822,6 +822,38 @@ START_TEST(Node_ReadWrite_Value) {
 }
 END_TEST
 
+/* The array spans several chunks. Without message security the chunks are
+ * sent partially from the memory of the value. */
+START_TEST(Node_Read_LargeArray) {
+    const size_t length = 256 * 1024;
+    UA_UInt32 *array = (UA_UInt32*)UA_Array_new(length, &UA_TYPES[UA_TYPES_UINT32]);
+    ck_assert_ptr_ne(array, NULL);
+    for(size_t i = 0; i < length; i++)
+        array[i] = (UA_UInt32)i;
+
+    UA_VariableAttributes attr = UA_VariableAttributes_default;
+    UA_Variant_setArray(&attr.value, array, length, &UA_TYPES[UA_TYPES_UINT32]);
+    attr.dataType = UA_TYPES[UA_TYPES_UINT32].typeId;
+    UA_NodeId largeArrayId = UA_NODEID_STRING(1, "LargeArray");
+    UA_StatusCode retval =
+        UA_Server_addVariableNode(server, largeArrayId,
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                  UA_QUALIFIEDNAME(1, "LargeArray"),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                  attr, NULL, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_Variant val;
+    retval = UA_Client_readValueAttribute(client, largeArrayId, &val);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_ptr_eq(val.type, &UA_TYPES[UA_TYPES_UINT32]);
+    ck_assert_uint_eq(val.arrayLength, length);
+    ck_assert_int_eq(memcmp(val.data, array, length * sizeof(UA_UInt32)), 0);
+    UA_Variant_clear(&val);
+    UA_Array_delete(array, length, &UA_TYPES[UA_TYPES_UINT32]);
+} END_TEST
+
 START_TEST(Node_ReadWrite_DataType) {
     UA_NodeId dataType;
 
@@ -1040,6 +1072,7 @@ static Suite *testSuite_Client(void) {
     tcase_add_checked_fixture(tc_misc, setup, teardown);
     tcase_add_test(tc_misc, Misc_State);
     tcase_add_test(tc_misc, Misc_NamespaceGetIndex);
+    tcase_add_test(tc_misc, Node_Read_LargeArray);
     suite_add_tcase(s, tc_misc);
 
     TCase *tc_nodes = tcase_create("Client Highlevel Node Management");
@@ -0,0 +1,418 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <open62541/plugin/log_stdout.h>
+#include <open62541/client_config_default.h>
+#include <open62541/client_highlevel.h>
+#include <open62541/client_subscriptions.h>
+#include <open62541/server_config_default.h>
+#include <open62541/plugin/nodestore_default.h>
+
+#include "server/ua_server_internal.h"
+
+#include <check.h>
+#include <stdlib.h>
+
+#include "test_helpers.h"
+#include "testing_clock.h"
+#include "thread_wrapper.h"
+
+#define NETWORK_LOOPS 3
+#define NUMBER_OF_CLIENTS 16
+#define CLIENT_ITERATIONS 100
+
+static UA_Server *server;
+static UA_EventLoop *networkLoops[NETWORK_LOOPS];
+static THREAD_HANDLE networkThreads[NETWORK_LOOPS];
+static THREAD_HANDLE server_thread;
+static UA_Boolean serverRunning;
+static UA_Boolean networkRunning;
+static size_t notifications;
+static UA_Nodestore *nodestore; /* Use the default Nodestore if NULL */
+
+THREAD_CALLBACK(serverloop) {
+    while(serverRunning)
+        UA_Server_run_iterate(server, true);
+    return 0;
+}
+
+THREAD_CALLBACK_PARAM(networkLoop, param) {
+    UA_EventLoop *el = *(UA_EventLoop**)param;
+    while(networkRunning)
+        el->run(el, 100);
+    return 0;
+}
+
+static void setup(void) {
+    serverRunning = true;
+    networkRunning = true;
+    if(!nodestore) {
+        server = UA_Server_newForUnitTest();
+    } else {
+        UA_ServerConfig sc;
+        memset(&sc, 0, sizeof(UA_ServerConfig));
+        sc.logging = UA_Log_Stdout_new(UA_LOGLEVEL_WARNING);
+        sc.nodestore = nodestore;
+        UA_ServerConfig_setMinimal(&sc, 4840, NULL);
+        sc.eventLoop->dateTime_now = UA_DateTime_now_fake;
+        sc.eventLoop->dateTime_nowMonotonic = UA_DateTime_now_fake;
+        sc.tcpReuseAddr = true;
+        server = UA_Server_newWithConfig(&sc);
+        nodestore = NULL; /* Owned by the server */
+    }
+    ck_assert(server != NULL);
+
+    UA_ServerConfig *config = UA_Server_getConfig(server);
+    for(size_t i = 0; i < NETWORK_LOOPS; i++) {
+        networkLoops[i] = UA_EventLoop_new_POSIX(config->logging);
+        UA_ConnectionManager *cm =
+            UA_ConnectionManager_new_POSIX_TCP(UA_STRING("tcp connection manager"));
+        networkLoops[i]->registerEventSource(networkLoops[i], &cm->eventSource);
+    }
+    config->networkEventLoops = networkLoops;
+    config->networkEventLoopsSize = NETWORK_LOOPS;
+
+    UA_StatusCode res = UA_Server_run_startup(server);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    THREAD_CREATE(server_thread, serverloop);
+    for(size_t i = 0; i < NETWORK_LOOPS; i++)
+        THREAD_CREATE_PARAM(networkThreads[i], networkLoop, networkLoops[i]);
+}
+
+static void setupConcurrent(void) {
+    nodestore = UA_Nodestore_Concurrent();
+    setup();
+}
+
+static void teardown(void) {
+    serverRunning = false;
+    THREAD_JOIN(server_thread);
+
+    /* The network EventLoops are still running to close the SecureChannels */
+    UA_Server_run_shutdown(server);
+
+    /* Free the network EventLoops before the server (and its logger) */
+    networkRunning = false;
+    for(size_t i = 0; i < NETWORK_LOOPS; i++) {
+        THREAD_JOIN(networkThreads[i]);
+        UA_EventLoop *el = networkLoops[i];
+        el->stop(el);
+        while(el->state != UA_EVENTLOOPSTATE_STOPPED)
+            el->run(el, 100);
+        el->free(el);
+    }
+    UA_Server_delete(server);
+}
+
+static size_t
+countNetworkLoopChannels(void) {
+    size_t count = 0;
+    lockServer(server);
+    UA_SecureChannel *channel;
+    TAILQ_FOREACH(channel, &server->channels, serverEntry) {
+        if(channel->connectionManager->eventSource.eventLoop !=
+           server->config.eventLoop)
+            count++;
+    }
+    unlockServer(server);
+    return count;
+}
+
+static void
+dataChangeHandler(UA_Client *client, UA_UInt32 subId, void *subContext,
+                  UA_UInt32 monId, void *monContext, UA_DataValue *value) {
+    notifications++;
+}
+
+START_TEST(connectToNetworkLoops) {
+    UA_Client *clients[NUMBER_OF_CLIENTS];
+    for(size_t i = 0; i < NUMBER_OF_CLIENTS; i++) {
+        clients[i] = UA_Client_newForUnitTest();
+        UA_StatusCode res = UA_Client_connect(clients[i], "opc.tcp://localhost:4840");
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    }
+
+    /* The connections are distributed among the listen sockets */
+    ck_assert_uint_gt(countNetworkLoopChannels(), 0);
+
+    for(size_t i = 0; i < NUMBER_OF_CLIENTS; i++) {
+        UA_Variant val;
+        UA_StatusCode res =
+            UA_Client_readValueAttribute(clients[i],
+                UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERSTATUS_STATE), &val);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+        UA_Variant_clear(&val);
+    }
+
+    for(size_t i = 0; i < NUMBER_OF_CLIENTS; i++) {
+        UA_Client_disconnect(clients[i]);
+        UA_Client_delete(clients[i]);
+    }
+} END_TEST
+
+/* The publish responses are sent from the server thread */
+START_TEST(subscribeOnNetworkLoops) {
+    UA_Client *clients[NUMBER_OF_CLIENTS];
+    for(size_t i = 0; i < NUMBER_OF_CLIENTS; i++) {
+        clients[i] = UA_Client_newForUnitTest();
+        UA_StatusCode res = UA_Client_connect(clients[i], "opc.tcp://localhost:4840");
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+        UA_CreateSubscriptionRequest request = UA_CreateSubscriptionRequest_default();
+        UA_CreateSubscriptionResponse response =
+            UA_Client_Subscriptions_create(clients[i], request, NULL, NULL, NULL);
+        ck_assert_uint_eq(response.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+
+        UA_MonitoredItemCreateRequest monRequest =
+            UA_MonitoredItemCreateRequest_default(
+                UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERSTATUS_STATE));
+        UA_MonitoredItemCreateResult monResponse =
+            UA_Client_MonitoredItems_createDataChange(clients[i], response.subscriptionId,
+                                                      UA_TIMESTAMPSTORETURN_BOTH,
+                                                      monRequest, NULL,
+                                                      dataChangeHandler, NULL);
+        ck_assert_uint_eq(monResponse.statusCode, UA_STATUSCODE_GOOD);
+    }
+
+    /* Every client receives the initial notification */
+    notifications = 0;
+    for(size_t round = 0; round < 100 && notifications < NUMBER_OF_CLIENTS; round++) {
+        UA_fakeSleep(501);
+        for(size_t i = 0; i < NUMBER_OF_CLIENTS; i++)
+            UA_Client_run_iterate(clients[i], 10);
+    }
+    ck_assert_uint_ge(notifications, NUMBER_OF_CLIENTS);
+
+    for(size_t i = 0; i < NUMBER_OF_CLIENTS; i++) {
+        UA_Client_disconnect(clients[i]);
+        UA_Client_delete(clients[i]);
+    }
+} END_TEST
+
+/* Every client runs in its own thread. With the Concurrent Nodestore, the
+ * requests of the clients on the network EventLoops are processed in
+ * parallel. */
+THREAD_CALLBACK_PARAM(clientLoop, param) {
+    size_t *failed = (size_t*)param;
+    UA_Client *client = UA_Client_newForUnitTest();
+    UA_StatusCode res = UA_Client_connect(client, "opc.tcp://localhost:4840");
+    if(res != UA_STATUSCODE_GOOD) {
+        (*failed)++;
+        UA_Client_delete(client);
+        return 0;
+    }
+
+    UA_BrowseDescription bd;
+    UA_BrowseDescription_init(&bd);
+    bd.nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER);
+    bd.referenceTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_HIERARCHICALREFERENCES);
+    bd.includeSubtypes = true;
+    bd.browseDirection = UA_BROWSEDIRECTION_FORWARD;
+    bd.resultMask = UA_BROWSERESULTMASK_ALL;
+
+    for(size_t i = 0; i < CLIENT_ITERATIONS; i++) {
+        UA_Variant val;
+        res = UA_Client_readValueAttribute(client,
+                  UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERSTATUS_STATE), &val);
+        if(res != UA_STATUSCODE_GOOD)
+            (*failed)++;
+        UA_Variant_clear(&val);
+
+        /* Limit the references to get a ContinuationPoint attached to the
+         * Session. Then release it with BrowseNext. */
+        UA_BrowseRequest bReq;
+        UA_BrowseRequest_init(&bReq);
+        bReq.requestedMaxReferencesPerNode = 1;
+        bReq.nodesToBrowse = &bd;
+        bReq.nodesToBrowseSize = 1;
+        UA_BrowseResponse bResp = UA_Client_Service_browse(client, bReq);
+        if(bResp.responseHeader.serviceResult != UA_STATUSCODE_GOOD ||
+           bResp.resultsSize != 1 || bResp.results[0].referencesSize != 1 ||
+           bResp.results[0].continuationPoint.length == 0) {
+            (*failed)++;
+        } else {
+            UA_BrowseNextRequest bnReq;
+            UA_BrowseNextRequest_init(&bnReq);
+            bnReq.releaseContinuationPoints = true;
+            bnReq.continuationPoints = &bResp.results[0].continuationPoint;
+            bnReq.continuationPointsSize = 1;
+            UA_BrowseNextResponse bnResp = UA_Client_Service_browseNext(client, bnReq);
+            if(bnResp.responseHeader.serviceResult != UA_STATUSCODE_GOOD)
+                (*failed)++;
+            UA_BrowseNextResponse_clear(&bnResp);
+        }
+        UA_BrowseResponse_clear(&bResp);
+    }
+
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+    return 0;
+}
+
+START_TEST(parallelReadBrowse) {
+    THREAD_HANDLE handles[NUMBER_OF_CLIENTS];
+    size_t failed[NUMBER_OF_CLIENTS];
+    memset(failed, 0, sizeof(failed));
+    for(size_t i = 0; i < NUMBER_OF_CLIENTS; i++)
+        THREAD_CREATE_PARAM(handles[i], clientLoop, failed[i]);
+    for(size_t i = 0; i < NUMBER_OF_CLIENTS; i++)
+        THREAD_JOIN(handles[i]);
+    for(size_t i = 0; i < NUMBER_OF_CLIENTS; i++)
+        ck_assert_uint_eq(failed[i], 0);
+} END_TEST
+
+/* The async reads are answered from the server thread */
+static UA_Boolean answerAsyncReads;
+static size_t canceledReads;
+
+static void
+answerAsyncRead(UA_Server *s, void *data) {
+    UA_DataValue *out = (UA_DataValue*)data;
+    UA_Int32 val = 42;
+    UA_Variant_setScalarCopy(&out->value, &val, &UA_TYPES[UA_TYPES_INT32]);
+    out->hasValue = true;
+    UA_Server_setAsyncReadResult(s, out);
+}
+
+static UA_StatusCode
+readAsync(UA_Server *s, const UA_NodeId *sessionId, void *sessionContext,
+          const UA_NodeId *nodeId, void *nodeContext,
+          UA_Boolean includeSourceTimeStamp, const UA_NumericRange *range,
+          UA_DataValue *value) {
+    if(answerAsyncReads)
+        UA_Server_addTimedCallback(s, answerAsyncRead, value,
+                                   UA_DateTime_now_fake(NULL), NULL);
+    return UA_STATUSCODE_GOODCOMPLETESASYNCHRONOUSLY;
+}
+
+static void
+cancelAsyncRead(UA_Server *s, const void *out) {
+    canceledReads++;
+}
+
+/* The lock of the async read callback is not leaked. Also not when the value
+ * is read internally (here to check the ValueRank) and the async read is
+ * abandoned. */
+START_TEST(asyncReadOnNetworkLoops) {
+    UA_ServerConfig *config = UA_Server_getConfig(server);
+    config->asyncOperationCancelCallback = cancelAsyncRead;
+    canceledReads = 0;
+    answerAsyncReads = true;
+
+    UA_NodeId asyncId = UA_NODEID_STRING(1, "async");
+    UA_VariableAttributes attr = UA_VariableAttributes_default;
+    attr.dataType = UA_TYPES[UA_TYPES_INT32].typeId;
+    attr.accessLevel = UA_ACCESSLEVELMASK_READ;
+    UA_StatusCode res =
+        UA_Server_addVariableNode(server, asyncId,
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                  UA_QUALIFIEDNAME(1, "async"),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                  attr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    UA_CallbackValueSource cvs = {readAsync, NULL};
+    res = UA_Server_setVariableNode_callbackValueSource(server, asyncId, cvs);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    UA_Client *client = UA_Client_newForUnitTest();
+    res = UA_Client_connect(client, "opc.tcp://localhost:4840");
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    for(size_t i = 0; i < 10; i++) {
+        UA_Variant val;
+        res = UA_Client_readValueAttribute(client, asyncId, &val);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+        ck_assert(UA_Variant_hasScalarType(&val, &UA_TYPES[UA_TYPES_INT32]));
+        ck_assert_int_eq(*(UA_Int32*)val.data, 42);
+        UA_Variant_clear(&val);
+    }
+
+    /* The write checks the current value. The read is not answered. */
+    answerAsyncReads = false;
+    res = UA_Server_writeValueRank(server, asyncId, UA_VALUERANK_SCALAR);
+    ck_assert_uint_eq(res, UA_STATUSCODE_BADWAITINGFORRESPONSE);
+    ck_assert_uint_eq(canceledReads, 1);
+
+    /* Creating a Session takes the server lock in the network EventLoop */
+    UA_Client *client2 = UA_Client_newForUnitTest();
+    res = UA_Client_connect(client2, "opc.tcp://localhost:4840");
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    UA_Client_disconnect(client2);
+    UA_Client_delete(client2);
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+} END_TEST
+
+/* Only the SecureChannels of the network EventLoops are served without the
+ * server lock */
+static size_t
+countMainLoopChannels(void) {
+    size_t count = 0;
+    lockServer(server);
+    UA_SecureChannel *channel;
+    TAILQ_FOREACH(channel, &server->channels, serverEntry) {
+        UA_Boolean mainLoop = (channel->connectionManager->eventSource.eventLoop ==
+                               server->config.eventLoop);
+        ck_assert(isNetworkLoopChannel(server, channel) == !mainLoop);
+        if(mainLoop)
+            count++;
+    }
+    unlockServer(server);
+    return count;
+}
+
+/* Connect clients until one is accepted by the listen socket of the main
+ * EventLoop */
+START_TEST(mainLoopKeepsLock) {
+    UA_Client *clients[64];
+    size_t connected = 0;
+    for(; connected < 64; connected++) {
+        clients[connected] = UA_Client_newForUnitTest();
+        UA_StatusCode res =
+            UA_Client_connect(clients[connected], "opc.tcp://localhost:4840");
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+        if(countMainLoopChannels() > 0 && countNetworkLoopChannels() > 0) {
+            connected++;
+            break;
+        }
+    }
+    ck_assert_uint_gt(countMainLoopChannels(), 0);
+    ck_assert_uint_gt(countNetworkLoopChannels(), 0);
+
+    for(size_t i = 0; i < connected; i++) {
+        UA_Client_disconnect(clients[i]);
+        UA_Client_delete(clients[i]);
+    }
+} END_TEST
+
+static Suite* testSuite_networkEventLoops(void) {
+    Suite *s = suite_create("Multithreading");
+    TCase *tc = tcase_create("Network EventLoops");
+    tcase_add_checked_fixture(tc, setup, teardown);
+    tcase_add_test(tc, connectToNetworkLoops);
+    tcase_add_test(tc, subscribeOnNetworkLoops);
+    tcase_add_test(tc, parallelReadBrowse);
+    suite_add_tcase(s, tc);
+
+    TCase *tcc = tcase_create("Network EventLoops with concurrent reads");
+    tcase_add_checked_fixture(tcc, setupConcurrent, teardown);
+    tcase_add_test(tcc, connectToNetworkLoops);
+    tcase_add_test(tcc, subscribeOnNetworkLoops);
+    tcase_add_test(tcc, parallelReadBrowse);
+    tcase_add_test(tcc, asyncReadOnNetworkLoops);
+    tcase_add_test(tcc, mainLoopKeepsLock);
+    suite_add_tcase(s, tcc);
+    return s;
+}
+
+int main(void) {
+    Suite *s = testSuite_networkEventLoops();
+    SRunner *sr = srunner_create(s);
+    srunner_set_fork_status(sr, CK_NOFORK);
+    srunner_run_all(sr, CK_NORMAL);
+    int number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -5,6 +5,7 @@
 #include <open62541/plugin/log_stdout.h>
 #include <open62541/client_config_default.h>
 #include <open62541/client_highlevel.h>
+#include <open62541/plugin/nodestore_default.h>
 #include <check.h>
 #include <stdlib.h>
 
@@ -18,6 +19,10 @@
 #define NUMBER_OF_CLIENTS 10
 #define ITERATIONS_PER_CLIENT 10
 
+/* Concurrent reads and browses with the Concurrent Nodestore */
+#define CONCURRENT_THREADS 4
+#define CONCURRENT_ITERATIONS 1000
+
 UA_NodeId pumpTypeId = {1, UA_NODEIDTYPE_NUMERIC, {1001}};
 
 static
@@ -101,12 +106,83 @@ START_TEST(readValueAttribute) {
     }
 END_TEST
 
+/* Every thread reads the value of the variable and browses the objects folder
+ * directly on the server. The Concurrent Nodestore lets them access the nodes
+ * without locking. */
+
+static UA_Server *concurrentServer;
+
+THREAD_CALLBACK_PARAM(concurrentLoop, val) {
+    size_t *failed = (size_t*)val;
+    UA_ReadValueId rvi;
+    UA_ReadValueId_init(&rvi);
+    rvi.nodeId = pumpTypeId;
+    rvi.attributeId = UA_ATTRIBUTEID_VALUE;
+
+    UA_BrowseDescription bd;
+    UA_BrowseDescription_init(&bd);
+    bd.nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER);
+    bd.browseDirection = UA_BROWSEDIRECTION_FORWARD;
+    bd.resultMask = UA_BROWSERESULTMASK_BROWSENAME;
+
+    for(size_t i = 0; i < CONCURRENT_ITERATIONS; i++) {
+        UA_DataValue dv = UA_Server_read(concurrentServer, &rvi,
+                                         UA_TIMESTAMPSTORETURN_NEITHER);
+        if(dv.status != UA_STATUSCODE_GOOD || !dv.hasValue ||
+           dv.value.type != &UA_TYPES[UA_TYPES_INT32] ||
+           *(UA_Int32*)dv.value.data != 42)
+            (*failed)++;
+        UA_DataValue_clear(&dv);
+
+        UA_BrowseResult br = UA_Server_browse(concurrentServer, 0, &bd);
+        UA_Boolean found = false;
+        for(size_t j = 0; j < br.referencesSize; j++) {
+            if(UA_NodeId_equal(&br.references[j].nodeId.nodeId, &pumpTypeId))
+                found = true;
+        }
+        if(br.statusCode != UA_STATUSCODE_GOOD || !found)
+            (*failed)++;
+        UA_BrowseResult_clear(&br);
+    }
+    return 0;
+}
+
+START_TEST(concurrentReadBrowse) {
+    UA_ServerConfig sc;
+    memset(&sc, 0, sizeof(UA_ServerConfig));
+    sc.logging = UA_Log_Stdout_new(UA_LOGLEVEL_WARNING);
+    sc.nodestore = UA_Nodestore_Concurrent();
+    UA_ServerConfig_setMinimal(&sc, 4840, NULL);
+    concurrentServer = UA_Server_newWithConfig(&sc);
+    ck_assert(concurrentServer != NULL);
+    tc.server = concurrentServer;
+    addVariableNode();
+
+    THREAD_HANDLE handles[CONCURRENT_THREADS];
+    size_t failed[CONCURRENT_THREADS];
+    memset(failed, 0, sizeof(failed));
+    for(size_t i = 0; i < CONCURRENT_THREADS; i++)
+        THREAD_CREATE_PARAM(handles[i], concurrentLoop, failed[i]);
+    for(size_t i = 0; i < CONCURRENT_THREADS; i++)
+        THREAD_JOIN(handles[i]);
+    for(size_t i = 0; i < CONCURRENT_THREADS; i++)
+        ck_assert_uint_eq(failed[i], 0);
+
+    UA_Server_delete(concurrentServer);
+    concurrentServer = NULL;
+    tc.server = NULL;
+} END_TEST
+
 static Suite* testSuite_immutableNodes(void) {
     Suite *s = suite_create("Multithreading");
     TCase *valueCallback = tcase_create("Read Write attribute");
     tcase_add_checked_fixture(valueCallback, setup, teardown);
     tcase_add_test(valueCallback, readValueAttribute);
     suite_add_tcase(s,valueCallback);
+
+    TCase *concurrent = tcase_create("Concurrent Nodestore");
+    tcase_add_test(concurrent, concurrentReadBrowse);
+    suite_add_tcase(s, concurrent);
     return s;
 }
 
@@ -1255,6 +1255,165 @@ START_TEST(UA_PubSub_EnDecode_ShallWorkOn2DSVariant) {
 }
 END_TEST
 
+/* Decode with the precomputed layout of the reader and compare with the
+ * generic decoding */
+static void
+decodeWithPlan(UA_FieldEncoding fieldEncoding, UA_Boolean changeType) {
+    UA_UInt16 writerId = 1698;
+    UA_Int32 iv = -27;
+    UA_Double dv = 231.3;
+    UA_Boolean bv = true;
+    UA_DateTime tv = UA_DateTime_now();
+
+    /* Metadata of the reader */
+    UA_FieldMetaData fields[4];
+    const UA_DataType *types[4] = {&UA_TYPES[UA_TYPES_INT32], &UA_TYPES[UA_TYPES_DOUBLE],
+                                   &UA_TYPES[UA_TYPES_BOOLEAN], &UA_TYPES[UA_TYPES_DATETIME]};
+    void *values[4] = {&iv, &dv, &bv, &tv};
+    for(size_t i = 0; i < 4; i++) {
+        UA_FieldMetaData_init(&fields[i]);
+        fields[i].dataType = types[i]->typeId;
+        fields[i].builtInType = (UA_Byte)(types[i]->typeKind + 1);
+        fields[i].valueRank = -1; /* scalar */
+    }
+
+    UA_DataSetMessage_EncodingMetaData emd;
+    memset(&emd, 0, sizeof(UA_DataSetMessage_EncodingMetaData));
+    emd.dataSetWriterId = writerId;
+    emd.fields = fields;
+    emd.fieldsSize = 4;
+    UA_NetworkMessage_EncodingOptions eo;
+    eo.metaData = &emd;
+    eo.metaDataSize = 1;
+
+    /* Encode */
+    UA_NetworkMessage m;
+    memset(&m, 0, sizeof(UA_NetworkMessage));
+    m.version = 1;
+    m.networkMessageType = UA_NETWORKMESSAGE_DATASET;
+    m.payloadHeaderEnabled = true;
+    m.dataSetWriterIds[0] = writerId;
+    UA_DataSetMessage dmkf;
+    memset(&dmkf, 0, sizeof(UA_DataSetMessage));
+    dmkf.header.dataSetMessageValid = true;
+    dmkf.header.fieldEncoding = fieldEncoding;
+    dmkf.header.dataSetMessageType = UA_DATASETMESSAGE_DATAKEYFRAME;
+    dmkf.fieldCount = 4;
+    UA_DataValue kf[4];
+    for(size_t i = 0; i < 4; i++) {
+        UA_DataValue_init(&kf[i]);
+        UA_Variant_setScalar(&kf[i].value, values[i], types[i]);
+        kf[i].hasValue = true;
+    }
+    /* The publisher sends a different type than the reader expects */
+    UA_UInt32 uv = 27;
+    if(changeType)
+        UA_Variant_setScalar(&kf[0].value, &uv, &UA_TYPES[UA_TYPES_UINT32]);
+    dmkf.data.keyFrameFields = kf;
+    m.payload.dataSetMessages = &dmkf;
+    m.messageCount = 1;
+
+    UA_ByteString buffer;
+    size_t msgSize = UA_NetworkMessage_calcSizeBinary(&m, &eo);
+    UA_StatusCode rv = UA_ByteString_allocBuffer(&buffer, msgSize);
+    ck_assert_int_eq(rv, UA_STATUSCODE_GOOD);
+    rv = UA_NetworkMessage_encodeBinary(&m, &buffer, &eo);
+    ck_assert_int_eq(rv, UA_STATUSCODE_GOOD);
+
+    /* Decode with the plan */
+    UA_DataSetMessage_DecodePlan plan;
+    rv = UA_DataSetMessage_DecodePlan_init(&plan, fields, 4, NULL);
+    ck_assert_int_eq(rv, UA_STATUSCODE_GOOD);
+    const UA_DataSetMessage_DecodePlan *plans[1] = {&plan};
+
+    PubSubDecodeCtx ctx;
+    memset(&ctx, 0, sizeof(PubSubDecodeCtx));
+    ctx.ctx.pos = buffer.data;
+    ctx.ctx.end = buffer.data + buffer.length;
+    ctx.eo = eo;
+    ctx.plans = plans;
+    UA_NetworkMessage m2;
+    memset(&m2, 0, sizeof(UA_NetworkMessage));
+    rv = UA_NetworkMessage_decodeHeaders(&ctx, &m2);
+    ck_assert_int_eq(rv, UA_STATUSCODE_GOOD);
+    rv = UA_NetworkMessage_decodePayload(&ctx, &m2);
+    ck_assert_int_eq(rv, UA_STATUSCODE_GOOD);
+    ck_assert_ptr_eq(ctx.ctx.pos, ctx.ctx.end);
+
+    /* Compare with the generic decoding */
+    UA_NetworkMessage m3;
+    rv = UA_NetworkMessage_decodeBinary(&buffer, &m3, &eo, NULL);
+    ck_assert_int_eq(rv, UA_STATUSCODE_GOOD);
+
+    UA_DataSetMessage *d2 = &m2.payload.dataSetMessages[0];
+    UA_DataSetMessage *d3 = &m3.payload.dataSetMessages[0];
+    ck_assert_uint_eq(d2->fieldCount, 4);
+    ck_assert_uint_eq(d3->fieldCount, 4);
+    for(size_t i = 0; i < 4; i++) {
+        ck_assert(UA_order(&d2->data.keyFrameFields[i], &d3->data.keyFrameFields[i],
+                           &UA_TYPES[UA_TYPES_DATAVALUE]) == UA_ORDER_EQ);
+        ck_assert(UA_order(&d2->data.keyFrameFields[i].value, &kf[i].value,
+                           &UA_TYPES[UA_TYPES_VARIANT]) == UA_ORDER_EQ);
+        /* The values of the plan are placed behind the DataValues */
+        if(!changeType || fieldEncoding == UA_FIELDENCODING_RAWDATA)
+            ck_assert_int_eq(d2->data.keyFrameFields[i].value.storageType,
+                             UA_VARIANT_DATA_NODELETE);
+        else
+            ck_assert_int_eq(d2->data.keyFrameFields[i].value.storageType,
+                             UA_VARIANT_DATA);
+    }
+
+    UA_DataSetMessage_DecodePlan_clear(&plan);
+    UA_NetworkMessage_clear(&m2);
+    UA_NetworkMessage_clear(&m3);
+    UA_ByteString_clear(&buffer);
+}
+
+START_TEST(UA_PubSub_DecodePlan_ShallWorkOnRawKeyFrame) {
+    decodeWithPlan(UA_FIELDENCODING_RAWDATA, false);
+}
+END_TEST
+
+START_TEST(UA_PubSub_DecodePlan_ShallWorkOnVariantKeyFrame) {
+    decodeWithPlan(UA_FIELDENCODING_VARIANT, false);
+}
+END_TEST
+
+START_TEST(UA_PubSub_DecodePlan_ShallFallBackOnTypeMismatch) {
+    decodeWithPlan(UA_FIELDENCODING_VARIANT, true);
+}
+END_TEST
+
+START_TEST(UA_PubSub_DecodePlan_ShallRejectVariableSizeFields) {
+    UA_FieldMetaData fields[2];
+    UA_FieldMetaData_init(&fields[0]);
+    fields[0].dataType = UA_TYPES[UA_TYPES_INT32].typeId;
+    fields[0].builtInType = UA_TYPES_INT32 + 1;
+    fields[0].valueRank = -1;
+    UA_FieldMetaData_init(&fields[1]);
+    fields[1].dataType = UA_TYPES[UA_TYPES_STRING].typeId;
+    fields[1].builtInType = UA_TYPES_STRING + 1;
+    fields[1].valueRank = -1;
+
+    UA_DataSetMessage_DecodePlan plan;
+    UA_StatusCode rv = UA_DataSetMessage_DecodePlan_init(&plan, fields, 2, NULL);
+    ck_assert_int_eq(rv, UA_STATUSCODE_BADNOTSUPPORTED);
+    ck_assert_uint_eq(plan.fieldsSize, 0);
+
+    /* Arrays are not supported */
+    fields[1] = fields[0];
+    fields[1].valueRank = 1;
+    rv = UA_DataSetMessage_DecodePlan_init(&plan, fields, 2, NULL);
+    ck_assert_int_eq(rv, UA_STATUSCODE_BADNOTSUPPORTED);
+
+    rv = UA_DataSetMessage_DecodePlan_init(&plan, fields, 1, NULL);
+    ck_assert_int_eq(rv, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(plan.rawSize, sizeof(UA_Int32));
+    ck_assert_uint_eq(plan.variantSize, 2 + 1 + sizeof(UA_Int32));
+    UA_DataSetMessage_DecodePlan_clear(&plan);
+}
+END_TEST
+
 int main(void) {
     TCase *tc_encode = tcase_create("encode");
     tcase_add_test(tc_encode, UA_PubSub_Encode_WithBufferTooSmallShallReturnError);
@@ -1280,11 +1439,18 @@ int main(void) {
     TCase *tc_ende2 = tcase_create("encode_decode2DS");
     tcase_add_test(tc_ende2, UA_PubSub_EnDecode_ShallWorkOn2DSVariant);
 
+    TCase *tc_plan = tcase_create("decodePlan");
+    tcase_add_test(tc_plan, UA_PubSub_DecodePlan_ShallWorkOnRawKeyFrame);
+    tcase_add_test(tc_plan, UA_PubSub_DecodePlan_ShallWorkOnVariantKeyFrame);
+    tcase_add_test(tc_plan, UA_PubSub_DecodePlan_ShallFallBackOnTypeMismatch);
+    tcase_add_test(tc_plan, UA_PubSub_DecodePlan_ShallRejectVariableSizeFields);
+
     Suite *s = suite_create("PubSub NetworkMessage");
     suite_add_tcase(s, tc_encode);
     suite_add_tcase(s, tc_decode);
     suite_add_tcase(s, tc_ende1);
     suite_add_tcase(s, tc_ende2);
+    suite_add_tcase(s, tc_plan);
 
     SRunner *sr = srunner_create(s);
     srunner_set_fork_status(sr, CK_NOFORK);
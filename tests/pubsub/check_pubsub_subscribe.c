@@ -1373,6 +1373,186 @@ START_TEST(SinglePublishSubscribeBool) {
         checkReceived();
 } END_TEST
 
+/* Memory of the subscribed Double variable with an external value source */
+static UA_Double externalDouble;
+static UA_DataValue externalValue;
+static UA_DataValue *externalValuePtr;
+
+START_TEST(SinglePublishSubscribeFixedFieldsRawExternal) {
+        /* To check status after running both publisher and subscriber */
+        UA_StatusCode retVal = UA_STATUSCODE_GOOD;
+        UA_PublishedDataSetConfig pdsConfig;
+        UA_NodeId dataSetWriter;
+        UA_NodeId readerIdentifier;
+        UA_NodeId writerGroup;
+        UA_DataSetReaderConfig readerConfig;
+
+        /* Published DataSet */
+        memset(&pdsConfig, 0, sizeof(UA_PublishedDataSetConfig));
+        pdsConfig.publishedDataSetType = UA_PUBSUB_DATASET_PUBLISHEDITEMS;
+        pdsConfig.name = UA_STRING("PublishedDataSet Test");
+        retVal = UA_Server_addPublishedDataSet(server, &pdsConfig, &publishedDataSetId).addResult;
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+
+        /* Create variables to publish Int32 and Double data */
+        UA_NodeId publisherNodes[2];
+        UA_VariableAttributes attr = UA_VariableAttributes_default;
+        attr.displayName = UA_LOCALIZEDTEXT("en-US","Published Int32");
+        attr.dataType    = UA_TYPES[UA_TYPES_INT32].typeId;
+        UA_Int32 publisherData = 42;
+        UA_Variant_setScalar(&attr.value, &publisherData, &UA_TYPES[UA_TYPES_INT32]);
+        retVal = UA_Server_addVariableNode(server, UA_NODEID_NUMERIC(1, PUBLISHVARIABLE_NODEID),
+                                           UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                           UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                           UA_QUALIFIEDNAME(1, "Published Int32"),
+                                           UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                           attr, NULL, &publisherNodes[0]);
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+
+        attr.displayName = UA_LOCALIZEDTEXT("en-US","Published Double");
+        attr.dataType    = UA_TYPES[UA_TYPES_DOUBLE].typeId;
+        UA_Double publisherDouble = 12.5;
+        UA_Variant_setScalar(&attr.value, &publisherDouble, &UA_TYPES[UA_TYPES_DOUBLE]);
+        retVal = UA_Server_addVariableNode(server, UA_NODEID_NUMERIC(1, PUBLISHVARIABLE_NODEID + 10),
+                                           UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                           UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                           UA_QUALIFIEDNAME(1, "Published Double"),
+                                           UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                           attr, NULL, &publisherNodes[1]);
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+
+        /* Data Set Fields */
+        for(size_t i = 0; i < 2; i++) {
+            UA_NodeId dataSetFieldIdent;
+            UA_DataSetFieldConfig dataSetFieldConfig;
+            memset(&dataSetFieldConfig, 0, sizeof(UA_DataSetFieldConfig));
+            dataSetFieldConfig.dataSetFieldType              = UA_PUBSUB_DATASETFIELD_VARIABLE;
+            dataSetFieldConfig.field.variable.fieldNameAlias = (i == 0) ?
+                UA_STRING("Published Int32") : UA_STRING("Published Double");
+            dataSetFieldConfig.field.variable.publishParameters.publishedVariable = publisherNodes[i];
+            dataSetFieldConfig.field.variable.publishParameters.attributeId = UA_ATTRIBUTEID_VALUE;
+            retVal = UA_Server_addDataSetField(server, publishedDataSetId, &dataSetFieldConfig,
+                                               &dataSetFieldIdent).result;
+            ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+        }
+
+        /* Writer group */
+        UA_WriterGroupConfig writerGroupConfig;
+        memset(&writerGroupConfig, 0, sizeof(writerGroupConfig));
+        writerGroupConfig.name               = UA_STRING("WriterGroup Test");
+        writerGroupConfig.publishingInterval = PUBLISH_INTERVAL;
+        writerGroupConfig.writerGroupId      = WRITER_GROUP_ID;
+        writerGroupConfig.encodingMimeType   = UA_PUBSUB_ENCODING_UADP;
+        writerGroupConfig.messageSettings.encoding             = UA_EXTENSIONOBJECT_DECODED;
+        writerGroupConfig.messageSettings.content.decoded.type = &UA_TYPES[UA_TYPES_UADPWRITERGROUPMESSAGEDATATYPE];
+        UA_UadpWriterGroupMessageDataType *writerGroupMessage  = UA_UadpWriterGroupMessageDataType_new();
+        writerGroupMessage->networkMessageContentMask =
+            (UA_UadpNetworkMessageContentMask)UA_UADPNETWORKMESSAGECONTENTMASK_PUBLISHERID |
+            (UA_UadpNetworkMessageContentMask)UA_UADPNETWORKMESSAGECONTENTMASK_GROUPHEADER |
+            (UA_UadpNetworkMessageContentMask)UA_UADPNETWORKMESSAGECONTENTMASK_WRITERGROUPID |
+            (UA_UadpNetworkMessageContentMask)UA_UADPNETWORKMESSAGECONTENTMASK_PAYLOADHEADER;
+        writerGroupConfig.messageSettings.content.decoded.data = writerGroupMessage;
+        retVal |= UA_Server_addWriterGroup(server, connectionId, &writerGroupConfig, &writerGroup);
+        UA_UadpWriterGroupMessageDataType_delete(writerGroupMessage);
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+
+        /* DataSetWriter with the RawData field encoding */
+        UA_DataSetWriterConfig dataSetWriterConfig;
+        memset(&dataSetWriterConfig, 0, sizeof(dataSetWriterConfig));
+        dataSetWriterConfig.name            = UA_STRING("DataSetWriter Test");
+        dataSetWriterConfig.dataSetWriterId = DATASET_WRITER_ID;
+        dataSetWriterConfig.keyFrameCount   = 10;
+        dataSetWriterConfig.dataSetFieldContentMask = UA_DATASETFIELDCONTENTMASK_RAWDATA;
+        retVal |= UA_Server_addDataSetWriter(server, writerGroup, publishedDataSetId,
+                                             &dataSetWriterConfig, &dataSetWriter);
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+
+        /* Reader Group */
+        UA_ReaderGroupConfig readerGroupConfig;
+        memset (&readerGroupConfig, 0, sizeof (UA_ReaderGroupConfig));
+        readerGroupConfig.name = UA_STRING ("ReaderGroup Test");
+        retVal |=  UA_Server_addReaderGroup(server, connectionId, &readerGroupConfig, &readerGroupId);
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+
+        /* Data Set Reader with fixed-size fields. The KeyFrames are decoded
+         * with a precomputed layout. */
+        memset (&readerConfig, 0, sizeof (UA_DataSetReaderConfig));
+        readerConfig.name = UA_STRING ("DataSetReader Test");
+        readerConfig.publisherId.idType = UA_PUBLISHERIDTYPE_UINT16;
+        readerConfig.publisherId.id.uint16 = PUBLISHER_ID;
+        readerConfig.writerGroupId    = WRITER_GROUP_ID;
+        readerConfig.dataSetWriterId  = DATASET_WRITER_ID;
+        UA_DataSetMetaDataType *pMetaData = &readerConfig.dataSetMetaData;
+        UA_DataSetMetaDataType_init (pMetaData);
+        pMetaData->name       = UA_STRING ("DataSet Test");
+        pMetaData->fieldsSize = 2;
+        pMetaData->fields     = (UA_FieldMetaData*)
+            UA_Array_new(pMetaData->fieldsSize, &UA_TYPES[UA_TYPES_FIELDMETADATA]);
+        UA_FieldMetaData_init (&pMetaData->fields[0]);
+        pMetaData->fields[0].dataType    = UA_TYPES[UA_TYPES_INT32].typeId;
+        pMetaData->fields[0].builtInType = UA_NS0ID_INT32;
+        pMetaData->fields[0].valueRank   = -1; /* scalar */
+        UA_FieldMetaData_init (&pMetaData->fields[1]);
+        pMetaData->fields[1].dataType    = UA_TYPES[UA_TYPES_DOUBLE].typeId;
+        pMetaData->fields[1].builtInType = UA_NS0ID_DOUBLE;
+        pMetaData->fields[1].valueRank   = -1; /* scalar */
+        retVal |= UA_Server_addDataSetReader(server, readerGroupId, &readerConfig,
+                                             &readerIdentifier);
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+        UA_free(pMetaData->fields);
+
+        /* Subscribed variables. The Double is written into external memory. */
+        UA_NodeId subscribedNodes[2];
+        UA_VariableAttributes vAttr = UA_VariableAttributes_default;
+        vAttr.displayName = UA_LOCALIZEDTEXT ("en-US", "Subscribed Int32");
+        vAttr.dataType    = UA_TYPES[UA_TYPES_INT32].typeId;
+        retVal = UA_Server_addVariableNode(
+            server, UA_NODEID_NUMERIC(1, SUBSCRIBEVARIABLE_NODEID), folderId,
+            UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT),
+            UA_QUALIFIEDNAME(1, "Subscribed Int32"),
+            UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+            vAttr, NULL, &subscribedNodes[0]);
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+
+        vAttr.displayName = UA_LOCALIZEDTEXT ("en-US", "Subscribed Double");
+        vAttr.dataType    = UA_TYPES[UA_TYPES_DOUBLE].typeId;
+        retVal = UA_Server_addVariableNode(
+            server, UA_NODEID_NUMERIC(1, SUBSCRIBEVARIABLE2_NODEID), folderId,
+            UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT),
+            UA_QUALIFIEDNAME(1, "Subscribed Double"),
+            UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+            vAttr, NULL, &subscribedNodes[1]);
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+
+        externalDouble = 0.0;
+        UA_DataValue_init(&externalValue);
+        UA_Variant_setScalar(&externalValue.value, &externalDouble, &UA_TYPES[UA_TYPES_DOUBLE]);
+        externalValue.hasValue = true;
+        externalValuePtr = &externalValue;
+        retVal = UA_Server_setVariableNode_externalValueSource(server, subscribedNodes[1],
+                                                               &externalValuePtr, NULL);
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+
+        UA_FieldTargetDataType targetVars[2];
+        for(size_t i = 0; i < 2; i++) {
+            UA_FieldTargetDataType_init(&targetVars[i]);
+            targetVars[i].attributeId  = UA_ATTRIBUTEID_VALUE;
+            targetVars[i].targetNodeId = subscribedNodes[i];
+        }
+        retVal |= UA_Server_DataSetReader_createTargetVariables(server, readerIdentifier,
+                                                                2, targetVars);
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+
+        /* run server - publisher and subscriber */
+        ck_assert_int_eq(UA_STATUSCODE_GOOD, UA_Server_enableAllPubSubComponents(server));
+        checkReceived();
+
+        /* The received value was copied into the external memory */
+        ck_assert_ptr_eq(externalValuePtr, &externalValue);
+        ck_assert_ptr_eq(externalValue.value.data, &externalDouble);
+        ck_assert(externalDouble == publisherDouble);
+} END_TEST
+
 START_TEST(SinglePublishSubscribewithValidIdentifiers) {
         /* To check status after running both publisher and subscriber */
         UA_StatusCode retVal = UA_STATUSCODE_GOOD;
@@ -2541,6 +2721,7 @@ int main(void) {
     tcase_add_test(tc_pubsub_publish_subscribe, SinglePublishSubscribeInt32StatusCode);
     tcase_add_test(tc_pubsub_publish_subscribe, SinglePublishSubscribeInt64);
     tcase_add_test(tc_pubsub_publish_subscribe, SinglePublishSubscribeBool);
+    tcase_add_test(tc_pubsub_publish_subscribe, SinglePublishSubscribeFixedFieldsRawExternal);
     tcase_add_test(tc_pubsub_publish_subscribe, SinglePublishSubscribewithValidIdentifiers);
     tcase_add_test(tc_pubsub_publish_subscribe, SinglePublishSubscribeHeartbeat);
     tcase_add_test(tc_pubsub_publish_subscribe, SinglePublishSubscribeWithoutPayloadHeader);
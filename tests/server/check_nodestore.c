@@ -13,7 +13,7 @@
 #include <time.h>
 #include "check.h"
 
-#if UA_MULTITHREADING >= 200
+#if UA_MULTITHREADING >= 100
 #include <pthread.h>
 #endif
 
@@ -23,6 +23,14 @@ static void setupZipTree(void) {
     ns = UA_Nodestore_ZipTree();
 }
 
+static void setupHashMap(void) {
+    ns = UA_Nodestore_HashMap();
+}
+
+static void setupConcurrent(void) {
+    ns = UA_Nodestore_Concurrent();
+}
+
 static void teardown(void) {
     ns->free(ns);
 }
@@ -185,6 +193,277 @@ START_TEST(failToFindNonExistentNodeInUA_NodeStoreWithSeveralEntries) {
 }
 END_TEST
 
+static void countVisitor(void *context, const UA_Node *node) {
+    (*(size_t*)context)++;
+}
+
+/* Removes and replaces nodes while the hash-map is resized */
+START_TEST(insertRemoveManyNodes) {
+    const UA_UInt32 count = 5000;
+    for(UA_UInt32 i = 0; i < count; i++) {
+        UA_Node *n = createNode(1, i+1);
+        UA_StatusCode retval = ns->insertNode(ns, n, NULL);
+        ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+
+        /* Remove every third node right away */
+        if(i % 3 == 0) {
+            UA_NodeId id = UA_NODEID_NUMERIC(1, i+1);
+            retval = ns->removeNode(ns, &id);
+            ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+        }
+
+        /* Replace every fifth node */
+        if(i % 5 == 1) {
+            UA_NodeId id = UA_NODEID_NUMERIC(1, i);
+            UA_Node *copy;
+            retval = ns->getNodeCopy(ns, &id, &copy);
+            if(i % 3 == 1) {
+                ck_assert_int_eq(retval, UA_STATUSCODE_BADNODEIDUNKNOWN);
+                continue;
+            }
+            ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+            retval = ns->replaceNode(ns, copy);
+            ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+        }
+    }
+
+    /* Duplicates are rejected */
+    UA_Node *n = createNode(1, 2);
+    ck_assert_int_eq(ns->insertNode(ns, n, NULL), UA_STATUSCODE_BADNODEIDEXISTS);
+
+    size_t found = 0;
+    for(UA_UInt32 i = 0; i < count; i++) {
+        UA_NodeId id = UA_NODEID_NUMERIC(1, i+1);
+        const UA_Node *node = ns->getNode(ns, &id, ~(UA_UInt32)0,
+                                          UA_REFERENCETYPESET_ALL,
+                                          UA_BROWSEDIRECTION_BOTH);
+        if(i % 3 == 0) {
+            ck_assert_ptr_eq(node, NULL);
+            continue;
+        }
+        ck_assert_ptr_ne(node, NULL);
+        ck_assert(UA_NodeId_equal(&node->head.nodeId, &id));
+        ns->releaseNode(ns, node);
+        found++;
+    }
+
+    size_t visited = 0;
+    ns->iterate(ns, countVisitor, &visited);
+    ck_assert_uint_eq(visited, found);
+}
+END_TEST
+
+/* Nodes with ns=x;i=0 get a random unused numeric identifier */
+START_TEST(insertRandomNodeIds) {
+    UA_NodeId ids[200];
+    for(size_t i = 0; i < 200; i++) {
+        UA_Node *n = createNode(1, 0);
+        UA_StatusCode retval = ns->insertNode(ns, n, &ids[i]);
+        ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+        ck_assert_uint_ge(ids[i].identifier.numeric, 50000);
+        for(size_t j = 0; j < i; j++)
+            ck_assert(!UA_NodeId_equal(&ids[i], &ids[j]));
+    }
+    size_t visited = 0;
+    ns->iterate(ns, countVisitor, &visited);
+    ck_assert_uint_eq(visited, 200);
+}
+END_TEST
+
+static UA_Int32
+readInt32Value(const UA_NodeId *id) {
+    const UA_Node *node = ns->getNode(ns, id, ~(UA_UInt32)0,
+                                      UA_REFERENCETYPESET_ALL,
+                                      UA_BROWSEDIRECTION_BOTH);
+    ck_assert_ptr_ne(node, NULL);
+    UA_Int32 val = *(UA_Int32*)node->variableNode.valueSource.internal.value.value.data;
+    ns->releaseNode(ns, node);
+    return val;
+}
+
+static void
+writeInt32Value(UA_Node *node, UA_Int32 val) {
+    UA_DataValue *dv = &node->variableNode.valueSource.internal.value;
+    UA_DataValue_clear(dv);
+    UA_Variant_setScalarCopy(&dv->value, &val, &UA_TYPES[UA_TYPES_INT32]);
+    dv->hasValue = true;
+}
+
+static UA_Node *
+createValueNode(UA_UInt32 id, UA_Int32 val) {
+    UA_Node *n = createNode(1, id);
+    writeInt32Value(n, val);
+    return n;
+}
+
+/* Changes to an edited node are visible after it is released */
+START_TEST(editNode) {
+    ns->insertNode(ns, createValueNode(1, 1), NULL);
+    UA_NodeId id = UA_NODEID_NUMERIC(1, 1);
+    UA_Node *edit = ns->getEditNode(ns, &id, ~(UA_UInt32)0,
+                                    UA_REFERENCETYPESET_ALL,
+                                    UA_BROWSEDIRECTION_BOTH);
+    ck_assert_ptr_ne(edit, NULL);
+    writeInt32Value(edit, 2);
+    ns->releaseNode(ns, edit);
+    ck_assert_int_eq(readInt32Value(&id), 2);
+
+    /* Edit and remove */
+    edit = ns->getEditNode(ns, &id, ~(UA_UInt32)0, UA_REFERENCETYPESET_ALL,
+                           UA_BROWSEDIRECTION_BOTH);
+    writeInt32Value(edit, 3);
+    ck_assert_int_eq(ns->removeNode(ns, &id), UA_STATUSCODE_GOOD);
+    ns->releaseNode(ns, edit);
+    ck_assert_ptr_eq(ns->getNode(ns, &id, ~(UA_UInt32)0, UA_REFERENCETYPESET_ALL,
+                                 UA_BROWSEDIRECTION_BOTH), NULL);
+}
+END_TEST
+
+#if UA_MULTITHREADING >= 100
+static void *
+readOnce(void *_) {
+    UA_NodeId id = UA_NODEID_NUMERIC(1, 1);
+    ns->releaseNode(ns, ns->getNode(ns, &id, ~(UA_UInt32)0,
+                                    UA_REFERENCETYPESET_ALL,
+                                    UA_BROWSEDIRECTION_BOTH));
+    return NULL;
+}
+
+/* Once a second thread has accessed the Concurrent Nodestore, edits are made on
+ * a copy. Pointers that were retrieved before keep pointing to the old
+ * version. */
+START_TEST(editNodeCopyOnWrite) {
+    ns->insertNode(ns, createValueNode(1, 1), NULL);
+    pthread_t reader;
+    pthread_create(&reader, NULL, readOnce, NULL);
+    pthread_join(reader, NULL);
+
+    UA_NodeId id = UA_NODEID_NUMERIC(1, 1);
+    const UA_Node *before = ns->getNode(ns, &id, ~(UA_UInt32)0,
+                                        UA_REFERENCETYPESET_ALL,
+                                        UA_BROWSEDIRECTION_BOTH);
+    UA_Node *edit = ns->getEditNode(ns, &id, ~(UA_UInt32)0,
+                                    UA_REFERENCETYPESET_ALL,
+                                    UA_BROWSEDIRECTION_BOTH);
+    ck_assert_ptr_ne(edit, NULL);
+    ck_assert_ptr_ne(edit, before);
+    writeInt32Value(edit, 2);
+
+    /* Nested edits return the same copy */
+    UA_Node *edit2 = ns->getEditNode(ns, &id, ~(UA_UInt32)0,
+                                     UA_REFERENCETYPESET_ALL,
+                                     UA_BROWSEDIRECTION_BOTH);
+    ck_assert_ptr_eq(edit, edit2);
+    ns->releaseNode(ns, edit2);
+    ck_assert_int_eq(readInt32Value(&id), 1);
+
+    ns->releaseNode(ns, edit);
+    ck_assert_int_eq(readInt32Value(&id), 2);
+    ck_assert_int_eq(*(UA_Int32*)before->variableNode.valueSource.
+                     internal.value.value.data, 1);
+    ns->releaseNode(ns, before);
+
+    /* A copy made before the edit can no longer replace the node */
+    UA_Node *copy;
+    ck_assert_int_eq(ns->getNodeCopy(ns, &id, &copy), UA_STATUSCODE_GOOD);
+    edit = ns->getEditNode(ns, &id, ~(UA_UInt32)0, UA_REFERENCETYPESET_ALL,
+                           UA_BROWSEDIRECTION_BOTH);
+    writeInt32Value(edit, 3);
+    ns->releaseNode(ns, edit);
+    ck_assert_int_eq(ns->replaceNode(ns, copy), UA_STATUSCODE_BADINTERNALERROR);
+    ck_assert_int_eq(readInt32Value(&id), 3);
+
+    /* The edit is discarded if the node is replaced in the meantime */
+    edit = ns->getEditNode(ns, &id, ~(UA_UInt32)0, UA_REFERENCETYPESET_ALL,
+                           UA_BROWSEDIRECTION_BOTH);
+    writeInt32Value(edit, 4);
+    ck_assert_int_eq(ns->getNodeCopy(ns, &id, &copy), UA_STATUSCODE_GOOD);
+    writeInt32Value(copy, 5);
+    ck_assert_int_eq(ns->replaceNode(ns, copy), UA_STATUSCODE_GOOD);
+    ns->releaseNode(ns, edit);
+    ck_assert_int_eq(readInt32Value(&id), 5);
+
+    /* The edit is discarded if the node is removed in the meantime */
+    edit = ns->getEditNode(ns, &id, ~(UA_UInt32)0, UA_REFERENCETYPESET_ALL,
+                           UA_BROWSEDIRECTION_BOTH);
+    writeInt32Value(edit, 4);
+    ck_assert_int_eq(ns->removeNode(ns, &id), UA_STATUSCODE_GOOD);
+    ns->releaseNode(ns, edit);
+    ck_assert_ptr_eq(ns->getNode(ns, &id, ~(UA_UInt32)0, UA_REFERENCETYPESET_ALL,
+                                 UA_BROWSEDIRECTION_BOTH), NULL);
+}
+END_TEST
+
+#define CONCURRENT_NODES 64
+#define CONCURRENT_READERS 4
+
+static void *concurrentRunning; /* Modified atomically */
+
+/* The value of every node equals its numeric identifier modulo
+ * CONCURRENT_NODES. The writer keeps that invariant. */
+static void *
+concurrentReader(void *_) {
+    size_t reads = 0;
+    while(UA_atomic_load(&concurrentRunning) || reads < 1000) {
+        UA_NodeId id = UA_NODEID_NUMERIC(1, (UA_UInt32)(reads % CONCURRENT_NODES) + 1);
+        const UA_Node *node = ns->getNode(ns, &id, ~(UA_UInt32)0,
+                                          UA_REFERENCETYPESET_ALL,
+                                          UA_BROWSEDIRECTION_BOTH);
+        reads++;
+        if(!node)
+            continue; /* Removed and not yet inserted again */
+        ck_assert(UA_NodeId_equal(&node->head.nodeId, &id));
+        UA_Int32 val = *(UA_Int32*)
+            node->variableNode.valueSource.internal.value.value.data;
+        ck_assert_int_eq(val % CONCURRENT_NODES, id.identifier.numeric % CONCURRENT_NODES);
+        ns->releaseNode(ns, node);
+    }
+    return NULL;
+}
+
+/* Readers access the nodes without a lock while they are edited, replaced,
+ * removed and inserted. Run with the AddressSanitizer to detect access to
+ * reclaimed nodes. */
+START_TEST(concurrentReadWhileWriting) {
+    for(UA_UInt32 i = 1; i <= CONCURRENT_NODES; i++)
+        ns->insertNode(ns, createValueNode(i, (UA_Int32)i), NULL);
+
+    UA_atomic_xchg(&concurrentRunning, (void*)0x01);
+    pthread_t readers[CONCURRENT_READERS];
+    for(size_t i = 0; i < CONCURRENT_READERS; i++)
+        pthread_create(&readers[i], NULL, concurrentReader, NULL);
+
+    for(UA_UInt32 round = 1; round <= 2000; round++) {
+        UA_UInt32 i = (round % CONCURRENT_NODES) + 1;
+        UA_NodeId id = UA_NODEID_NUMERIC(1, i);
+        UA_Int32 val = (UA_Int32)(i + round * CONCURRENT_NODES);
+        if(round % 3 == 0) {
+            UA_Node *edit = ns->getEditNode(ns, &id, ~(UA_UInt32)0,
+                                            UA_REFERENCETYPESET_ALL,
+                                            UA_BROWSEDIRECTION_BOTH);
+            ck_assert_ptr_ne(edit, NULL);
+            writeInt32Value(edit, val);
+            ns->releaseNode(ns, edit);
+        } else if(round % 3 == 1) {
+            UA_Node *copy;
+            ck_assert_int_eq(ns->getNodeCopy(ns, &id, &copy), UA_STATUSCODE_GOOD);
+            writeInt32Value(copy, val);
+            ck_assert_int_eq(ns->replaceNode(ns, copy), UA_STATUSCODE_GOOD);
+        } else {
+            /* Insert more nodes to resize the hash-map in between */
+            ck_assert_int_eq(ns->removeNode(ns, &id), UA_STATUSCODE_GOOD);
+            ns->insertNode(ns, createValueNode(i, val), NULL);
+            ns->insertNode(ns, createNode(2, round), NULL);
+        }
+    }
+
+    UA_atomic_xchg(&concurrentRunning, NULL);
+    for(size_t i = 0; i < CONCURRENT_READERS; i++)
+        pthread_join(readers[i], NULL);
+}
+END_TEST
+#endif
+
 /************************************/
 /* Performance Profiling Test Cases */
 /************************************/
@@ -267,6 +546,7 @@ static Suite * namespace_suite (void) {
     tcase_add_checked_fixture(tc_replace, setupZipTree, teardown);
     tcase_add_test (tc_replace, replaceExistingNode);
     tcase_add_test (tc_replace, replaceOldNode);
+    tcase_add_test (tc_replace, editNode);
     suite_add_tcase (s, tc_replace);
 
     TCase* tc_iterate = tcase_create ("Iterate-ZipTree");
@@ -280,6 +560,84 @@ static Suite * namespace_suite (void) {
     tcase_add_test (tc_profile, profileGetDelete);
     suite_add_tcase (s, tc_profile);
 
+    TCase* tc_many = tcase_create ("Many-ZipTree");
+    tcase_add_checked_fixture(tc_many, setupZipTree, teardown);
+    tcase_add_test (tc_many, insertRemoveManyNodes);
+    tcase_add_test (tc_many, insertRandomNodeIds);
+    suite_add_tcase (s, tc_many);
+
+    TCase* tc_find_hm = tcase_create ("Find-HashMap");
+    tcase_add_checked_fixture(tc_find_hm, setupHashMap, teardown);
+    tcase_add_test (tc_find_hm, findNodeInUA_NodeStoreWithSingleEntry);
+    tcase_add_test (tc_find_hm, findNodeInUA_NodeStoreWithSeveralEntries);
+    tcase_add_test (tc_find_hm, findNodeInExpandedNamespace);
+    tcase_add_test (tc_find_hm, failToFindNonExistentNodeInUA_NodeStoreWithSeveralEntries);
+    tcase_add_test (tc_find_hm, failToFindNodeInOtherUA_NodeStore);
+    suite_add_tcase (s, tc_find_hm);
+
+    TCase *tc_replace_hm = tcase_create("Replace-HashMap");
+    tcase_add_checked_fixture(tc_replace_hm, setupHashMap, teardown);
+    tcase_add_test (tc_replace_hm, replaceExistingNode);
+    tcase_add_test (tc_replace_hm, replaceOldNode);
+    tcase_add_test (tc_replace_hm, editNode);
+    suite_add_tcase (s, tc_replace_hm);
+
+    TCase* tc_iterate_hm = tcase_create ("Iterate-HashMap");
+    tcase_add_checked_fixture(tc_iterate_hm, setupHashMap, teardown);
+    tcase_add_test (tc_iterate_hm, iterateOverUA_NodeStoreShallNotVisitEmptyNodes);
+    tcase_add_test (tc_iterate_hm, iterateOverExpandedNamespaceShallNotVisitEmptyNodes);
+    suite_add_tcase (s, tc_iterate_hm);
+
+    TCase* tc_profile_hm = tcase_create ("Profile-HashMap");
+    tcase_add_checked_fixture(tc_profile_hm, setupHashMap, teardown);
+    tcase_add_test (tc_profile_hm, profileGetDelete);
+    suite_add_tcase (s, tc_profile_hm);
+
+    TCase* tc_many_hm = tcase_create ("Many-HashMap");
+    tcase_add_checked_fixture(tc_many_hm, setupHashMap, teardown);
+    tcase_add_test (tc_many_hm, insertRemoveManyNodes);
+    tcase_add_test (tc_many_hm, insertRandomNodeIds);
+    suite_add_tcase (s, tc_many_hm);
+
+    TCase* tc_find_c = tcase_create ("Find-Concurrent");
+    tcase_add_checked_fixture(tc_find_c, setupConcurrent, teardown);
+    tcase_add_test (tc_find_c, findNodeInUA_NodeStoreWithSingleEntry);
+    tcase_add_test (tc_find_c, findNodeInUA_NodeStoreWithSeveralEntries);
+    tcase_add_test (tc_find_c, findNodeInExpandedNamespace);
+    tcase_add_test (tc_find_c, failToFindNonExistentNodeInUA_NodeStoreWithSeveralEntries);
+    tcase_add_test (tc_find_c, failToFindNodeInOtherUA_NodeStore);
+    suite_add_tcase (s, tc_find_c);
+
+    TCase *tc_replace_c = tcase_create("Replace-Concurrent");
+    tcase_add_checked_fixture(tc_replace_c, setupConcurrent, teardown);
+    tcase_add_test (tc_replace_c, replaceExistingNode);
+    tcase_add_test (tc_replace_c, replaceOldNode);
+    tcase_add_test (tc_replace_c, editNode);
+#if UA_MULTITHREADING >= 100
+    tcase_add_test (tc_replace_c, editNodeCopyOnWrite);
+#endif
+    suite_add_tcase (s, tc_replace_c);
+
+    TCase* tc_iterate_c = tcase_create ("Iterate-Concurrent");
+    tcase_add_checked_fixture(tc_iterate_c, setupConcurrent, teardown);
+    tcase_add_test (tc_iterate_c, iterateOverUA_NodeStoreShallNotVisitEmptyNodes);
+    tcase_add_test (tc_iterate_c, iterateOverExpandedNamespaceShallNotVisitEmptyNodes);
+    suite_add_tcase (s, tc_iterate_c);
+
+    TCase* tc_profile_c = tcase_create ("Profile-Concurrent");
+    tcase_add_checked_fixture(tc_profile_c, setupConcurrent, teardown);
+    tcase_add_test (tc_profile_c, profileGetDelete);
+    suite_add_tcase (s, tc_profile_c);
+
+    TCase* tc_many_c = tcase_create ("Many-Concurrent");
+    tcase_add_checked_fixture(tc_many_c, setupConcurrent, teardown);
+    tcase_add_test (tc_many_c, insertRemoveManyNodes);
+    tcase_add_test (tc_many_c, insertRandomNodeIds);
+#if UA_MULTITHREADING >= 100
+    tcase_add_test (tc_many_c, concurrentReadWhileWriting);
+#endif
+    suite_add_tcase (s, tc_many_c);
+
     return s;
 }
 
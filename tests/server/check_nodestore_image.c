@@ -0,0 +1,388 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <open62541/server_config_default.h>
+#include <open62541/plugin/nodestore_default.h>
+
+#include "ua_server_internal.h"
+
+#include <check.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "test_helpers.h"
+
+/* The image is written once from a server with a few additional nodes. Every
+ * test opens a new Image Nodestore on it. */
+
+static UA_Server *server;
+static UA_ByteString image;
+static UA_Nodestore *ns;
+
+#define VARIABLE_ID UA_NODEID_NUMERIC(2, 1001)
+#define OBJECT_ID UA_NODEID_NUMERIC(2, 1000)
+#define REFTYPE_ID UA_NODEID_NUMERIC(2, 1002)
+
+static void setup(void) {
+    server = UA_Server_newForUnitTest();
+    ck_assert(server != NULL);
+    ck_assert_uint_eq(UA_Server_addNamespace(server, "urn:test:image"), 2);
+
+    UA_ObjectAttributes oa = UA_ObjectAttributes_default;
+    oa.displayName = UA_LOCALIZEDTEXT("en-US", "Object");
+    UA_StatusCode res =
+        UA_Server_addObjectNode(server, OBJECT_ID,
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                UA_QUALIFIEDNAME(2, "Object"),
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_BASEOBJECTTYPE),
+                                oa, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    UA_VariableAttributes va = UA_VariableAttributes_default;
+    UA_Int32 value = 42;
+    UA_Variant_setScalar(&va.value, &value, &UA_TYPES[UA_TYPES_INT32]);
+    va.description = UA_LOCALIZEDTEXT("en-US", "The answer");
+    res = UA_Server_addVariableNode(server, VARIABLE_ID, OBJECT_ID,
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT),
+                                    UA_QUALIFIEDNAME(2, "Variable"),
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                    va, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    UA_ReferenceTypeAttributes ra = UA_ReferenceTypeAttributes_default;
+    ra.inverseName = UA_LOCALIZEDTEXT("", "IsReferencedBy");
+    res = UA_Server_addReferenceTypeNode(server, REFTYPE_ID,
+                                         UA_NODEID_NUMERIC(0, UA_NS0ID_NONHIERARCHICALREFERENCES),
+                                         UA_NODEID_NUMERIC(0, UA_NS0ID_HASSUBTYPE),
+                                         UA_QUALIFIEDNAME(2, "References"),
+                                         ra, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    res = UA_Nodestore_Image_write(server, &image);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ns = UA_Nodestore_Image(&image, NULL);
+    ck_assert(ns != NULL);
+}
+
+static void teardown(void) {
+    if(ns)
+        ns->free(ns);
+    UA_ByteString_clear(&image);
+    UA_Server_delete(server);
+}
+
+static const UA_Node *
+getNode(UA_Nodestore *store, const UA_NodeId id) {
+    return store->getNode(store, &id, UA_NODEATTRIBUTESMASK_ALL,
+                          UA_REFERENCETYPESET_ALL, UA_BROWSEDIRECTION_BOTH);
+}
+
+START_TEST(readVariableFromImage) {
+    const UA_Node *node = getNode(ns, VARIABLE_ID);
+    ck_assert(node != NULL);
+    ck_assert_int_eq(node->head.nodeClass, UA_NODECLASS_VARIABLE);
+    UA_QualifiedName bn = UA_QUALIFIEDNAME(2, "Variable");
+    ck_assert(UA_QualifiedName_equal(&node->head.browseName, &bn));
+    ck_assert(node->head.description != NULL);
+    UA_String desc = UA_STRING("The answer");
+    ck_assert(UA_String_equal(&node->head.description->localizedText.text, &desc));
+
+    const UA_DataValue *dv = &node->variableNode.valueSource.internal.value;
+    ck_assert_int_eq(node->variableNode.valueSourceType, UA_VALUESOURCETYPE_INTERNAL);
+    ck_assert(UA_Variant_hasScalarType(&dv->value, &UA_TYPES[UA_TYPES_INT32]));
+    ck_assert_int_eq(*(UA_Int32*)dv->value.data, 42);
+    ns->releaseNode(ns, node);
+}
+END_TEST
+
+typedef struct {
+    UA_Nodestore *image;
+    size_t visited;
+    size_t mismatch;
+} CompareContext;
+
+static void
+compareNode(void *context, const UA_Node *orig) {
+    CompareContext *ctx = (CompareContext*)context;
+    ctx->visited++;
+    const UA_Node *node = getNode(ctx->image, orig->head.nodeId);
+    if(!node) {
+        ctx->mismatch++;
+        return;
+    }
+    if(node->head.nodeClass != orig->head.nodeClass ||
+       !UA_QualifiedName_equal(&node->head.browseName, &orig->head.browseName) ||
+       node->head.referencesSize != orig->head.referencesSize ||
+       node->head.writeMask != orig->head.writeMask)
+        ctx->mismatch++;
+    for(size_t i = 0; i < node->head.referencesSize &&
+            i < orig->head.referencesSize; i++) {
+        if(node->head.references[i].targetsSize != orig->head.references[i].targetsSize ||
+           node->head.references[i].referenceTypeIndex !=
+           orig->head.references[i].referenceTypeIndex)
+            ctx->mismatch++;
+    }
+    if(orig->head.nodeClass == UA_NODECLASS_REFERENCETYPE &&
+       node->referenceTypeNode.referenceTypeIndex !=
+       orig->referenceTypeNode.referenceTypeIndex)
+        ctx->mismatch++;
+    ctx->image->releaseNode(ctx->image, node);
+}
+
+START_TEST(allNodesInImage) {
+    /* Every node of the server can be found in the image */
+    UA_Nodestore *orig = UA_Server_getConfig(server)->nodestore;
+    CompareContext ctx = {ns, 0, 0};
+    orig->iterate(orig, compareNode, &ctx);
+    ck_assert_uint_gt(ctx.visited, 0);
+    ck_assert_uint_eq(ctx.mismatch, 0);
+
+    /* The ReferenceTypeIndices are retained */
+    for(UA_Byte i = 0; i < UA_REFERENCETYPESET_MAX; i++) {
+        const UA_NodeId *origId = orig->getReferenceTypeId(orig, i);
+        const UA_NodeId *imageId = ns->getReferenceTypeId(ns, i);
+        if(!origId) {
+            ck_assert(imageId == NULL);
+            break;
+        }
+        ck_assert(imageId != NULL);
+        ck_assert(UA_NodeId_equal(origId, imageId));
+    }
+}
+END_TEST
+
+START_TEST(removeAndInsert) {
+    /* Cannot insert a node that exists in the image */
+    UA_Node *node = ns->newNode(ns, UA_NODECLASS_OBJECT);
+    node->head.nodeId = OBJECT_ID;
+    ck_assert_uint_eq(ns->insertNode(ns, node, NULL), UA_STATUSCODE_BADNODEIDEXISTS);
+
+    /* Remove without decoding the node first */
+    UA_NodeId id = OBJECT_ID;
+    ck_assert_uint_eq(ns->removeNode(ns, &id), UA_STATUSCODE_GOOD);
+    ck_assert(getNode(ns, OBJECT_ID) == NULL);
+    ck_assert_uint_ne(ns->removeNode(ns, &id), UA_STATUSCODE_GOOD);
+
+    /* Insert a new node with the same NodeId */
+    node = ns->newNode(ns, UA_NODECLASS_OBJECT);
+    node->head.nodeId = OBJECT_ID;
+    ck_assert_uint_eq(ns->insertNode(ns, node, NULL), UA_STATUSCODE_GOOD);
+    const UA_Node *found = getNode(ns, OBJECT_ID);
+    ck_assert(found == node);
+    ck_assert_uint_eq(found->head.referencesSize, 0);
+    ns->releaseNode(ns, found);
+
+    /* Remove a decoded node */
+    found = getNode(ns, VARIABLE_ID);
+    ck_assert(found != NULL);
+    ns->releaseNode(ns, found);
+    id = VARIABLE_ID;
+    ck_assert_uint_eq(ns->removeNode(ns, &id), UA_STATUSCODE_GOOD);
+    ck_assert(getNode(ns, VARIABLE_ID) == NULL);
+}
+END_TEST
+
+START_TEST(replaceNode) {
+    UA_NodeId id = VARIABLE_ID;
+    UA_Node *copy = NULL;
+    ck_assert_uint_eq(ns->getNodeCopy(ns, &id, &copy), UA_STATUSCODE_GOOD);
+    ck_assert(copy != NULL);
+    copy->head.writeMask = 0x1234;
+    ck_assert_uint_eq(ns->replaceNode(ns, copy), UA_STATUSCODE_GOOD);
+    const UA_Node *node = getNode(ns, VARIABLE_ID);
+    ck_assert_uint_eq(node->head.writeMask, 0x1234);
+    ns->releaseNode(ns, node);
+}
+END_TEST
+
+START_TEST(insertRandomNodeIds) {
+    /* Random NodeIds do not collide with the nodes in the image */
+    for(size_t i = 0; i < 1000; i++) {
+        UA_Node *node = ns->newNode(ns, UA_NODECLASS_OBJECT);
+        node->head.nodeId = UA_NODEID_NUMERIC(2, 0);
+        UA_NodeId added;
+        ck_assert_uint_eq(ns->insertNode(ns, node, &added), UA_STATUSCODE_GOOD);
+        ck_assert_uint_ne(added.identifier.numeric, 1000);
+        ck_assert_uint_ne(added.identifier.numeric, 1001);
+        ck_assert_uint_ne(added.identifier.numeric, 1002);
+    }
+}
+END_TEST
+
+START_TEST(insertReferenceType) {
+    UA_Nodestore *orig = UA_Server_getConfig(server)->nodestore;
+    UA_Byte count = 0;
+    while(orig->getReferenceTypeId(orig, count))
+        count++;
+
+    UA_Node *node = ns->newNode(ns, UA_NODECLASS_REFERENCETYPE);
+    node->head.nodeId = UA_NODEID_NUMERIC(2, 2000);
+    ck_assert_uint_eq(ns->insertNode(ns, node, NULL), UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(node->referenceTypeNode.referenceTypeIndex, count);
+    const UA_NodeId *id = ns->getReferenceTypeId(ns, count);
+    ck_assert(id != NULL);
+    ck_assert(UA_NodeId_equal(id, &node->head.nodeId));
+}
+END_TEST
+
+START_TEST(rejectInvalidImage) {
+    UA_ByteString broken;
+    UA_ByteString_copy(&image, &broken);
+    broken.data[0] ^= 0xff;
+    ck_assert(UA_Nodestore_Image(&broken, NULL) == NULL);
+    UA_ByteString_clear(&broken);
+
+    UA_ByteString_copy(&image, &broken);
+    broken.length = 20; /* Truncated header */
+    ck_assert(UA_Nodestore_Image(&broken, NULL) == NULL);
+    UA_ByteString_clear(&broken);
+}
+END_TEST
+
+START_TEST(addNamespaces) {
+    UA_Server *server2 = UA_Server_newForUnitTest();
+    ck_assert_uint_eq(UA_Nodestore_Image_addNamespaces(ns, server2),
+                      UA_STATUSCODE_GOOD);
+    size_t index;
+    ck_assert_uint_eq(UA_Server_getNamespaceByName(server2, UA_STRING("urn:test:image"),
+                                                   &index), UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(index, 2);
+    UA_Server_delete(server2);
+
+    /* The namespace index does not match */
+    server2 = UA_Server_newForUnitTest();
+    UA_Server_addNamespace(server2, "urn:test:other");
+    ck_assert_uint_ne(UA_Nodestore_Image_addNamespaces(ns, server2),
+                      UA_STATUSCODE_GOOD);
+    UA_Server_delete(server2);
+}
+END_TEST
+
+static UA_Boolean
+isCallbackValueSource(UA_Server *s, UA_UInt32 id) {
+    UA_Nodestore *store = UA_Server_getConfig(s)->nodestore;
+    const UA_Node *node = getNode(store, UA_NODEID_NUMERIC(0, id));
+    if(!node)
+        return false;
+    UA_Boolean res = (node->head.nodeClass == UA_NODECLASS_VARIABLE &&
+                      node->variableNode.valueSourceType == UA_VALUESOURCETYPE_CALLBACK);
+    store->releaseNode(store, node);
+    return res;
+}
+
+/* The image contains namespace zero. The server does not create it again but
+ * connects the callbacks to the nodes from the image. */
+START_TEST(serverOnImage) {
+    UA_ServerConfig sc;
+    memset(&sc, 0, sizeof(UA_ServerConfig));
+    sc.nodestore = ns;
+    ns = NULL; /* Owned by the server */
+    UA_ServerConfig_setMinimal(&sc, 4840, NULL);
+    UA_Server *server2 = UA_Server_newWithConfig(&sc);
+    ck_assert(server2 != NULL);
+
+    /* The nodes added before the image was written */
+    UA_Variant value;
+    UA_StatusCode res = UA_Server_readValue(server2, VARIABLE_ID, &value);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(UA_Variant_hasScalarType(&value, &UA_TYPES[UA_TYPES_INT32]));
+    ck_assert_int_eq(*(UA_Int32*)value.data, 42);
+    UA_Variant_clear(&value);
+
+    /* ServiceLevel and Auditing */
+    ck_assert(isCallbackValueSource(server2, UA_NS0ID_SERVER_SERVICELEVEL));
+    ck_assert(isCallbackValueSource(server2, UA_NS0ID_SERVER_AUDITING));
+    res = UA_Server_readValue(server2, UA_NS0ID(SERVER_SERVICELEVEL), &value);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(UA_Variant_hasScalarType(&value, &UA_TYPES[UA_TYPES_BYTE]));
+    ck_assert_uint_eq(*(UA_Byte*)value.data, 255);
+    UA_Variant_clear(&value);
+
+    /* The OperationLimits follow the configuration of this server */
+    UA_Server_getConfig(server2)->maxNodesPerRead = 123;
+    res = UA_Server_readValue(server2,
+        UA_NS0ID(SERVER_SERVERCAPABILITIES_OPERATIONLIMITS_MAXNODESPERREAD), &value);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(UA_Variant_hasScalarType(&value, &UA_TYPES[UA_TYPES_UINT32]));
+    ck_assert_uint_eq(*(UA_UInt32*)value.data, 123);
+    UA_Variant_clear(&value);
+
+#ifdef UA_ENABLE_DIAGNOSTICS
+    ck_assert(isCallbackValueSource(server2,
+        UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SERVERDIAGNOSTICSSUMMARY_CURRENTSESSIONCOUNT));
+    ck_assert(isCallbackValueSource(server2,
+        UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SESSIONSDIAGNOSTICSSUMMARY_SESSIONDIAGNOSTICSARRAY));
+#endif
+
+#if defined(UA_ENABLE_METHODCALLS) && defined(UA_ENABLE_SUBSCRIPTIONS)
+    /* The method callback is attached. The Subscription does not exist. */
+    UA_UInt32 subscriptionId = 1234;
+    UA_CallMethodRequest cmr;
+    UA_CallMethodRequest_init(&cmr);
+    cmr.objectId = UA_NS0ID(SERVER);
+    cmr.methodId = UA_NS0ID(SERVER_GETMONITOREDITEMS);
+    UA_Variant_setScalar(&value, &subscriptionId, &UA_TYPES[UA_TYPES_UINT32]);
+    cmr.inputArguments = &value;
+    cmr.inputArgumentsSize = 1;
+    UA_CallMethodResult cr = UA_Server_call(server2, &cmr);
+    ck_assert_uint_eq(cr.statusCode, UA_STATUSCODE_BADSUBSCRIPTIONIDINVALID);
+    UA_CallMethodResult_clear(&cr);
+#endif
+
+    UA_Server_delete(server2);
+}
+END_TEST
+
+#ifdef UA_ARCHITECTURE_POSIX
+START_TEST(mapImageFile) {
+    const char *path = "nodestore_image_test.bin";
+    FILE *f = fopen(path, "wb");
+    ck_assert(f != NULL);
+    ck_assert_uint_eq(fwrite(image.data, 1, image.length, f), image.length);
+    fclose(f);
+
+    UA_Nodestore *fileNs = UA_Nodestore_ImageFile(path, NULL);
+    remove(path); /* The mapping remains valid */
+    ck_assert(fileNs != NULL);
+    const UA_Node *node = getNode(fileNs, VARIABLE_ID);
+    ck_assert(node != NULL);
+    ck_assert_int_eq(node->head.nodeClass, UA_NODECLASS_VARIABLE);
+    fileNs->releaseNode(fileNs, node);
+    fileNs->free(fileNs);
+
+    ck_assert(UA_Nodestore_ImageFile("does_not_exist.bin", NULL) == NULL);
+}
+END_TEST
+#endif
+
+static Suite * testSuite_NodestoreImage(void) {
+    Suite *s = suite_create("Nodestore Image");
+    TCase *tc = tcase_create("Image");
+    tcase_add_checked_fixture(tc, setup, teardown);
+    tcase_add_test(tc, readVariableFromImage);
+    tcase_add_test(tc, allNodesInImage);
+    tcase_add_test(tc, removeAndInsert);
+    tcase_add_test(tc, replaceNode);
+    tcase_add_test(tc, insertRandomNodeIds);
+    tcase_add_test(tc, insertReferenceType);
+    tcase_add_test(tc, rejectInvalidImage);
+    tcase_add_test(tc, addNamespaces);
+    tcase_add_test(tc, serverOnImage);
+#ifdef UA_ARCHITECTURE_POSIX
+    tcase_add_test(tc, mapImageFile);
+#endif
+    suite_add_tcase(s, tc);
+    return s;
+}
+
+int main(void) {
+    Suite *s = testSuite_NodestoreImage();
+    SRunner *sr = srunner_create(s);
+    srunner_set_fork_status(sr, CK_NOFORK);
+    srunner_run_all(sr, CK_NORMAL);
+    int number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
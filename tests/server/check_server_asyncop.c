@@ -279,6 +279,99 @@ START_TEST(Async_read) {
     UA_Client_delete(client);
 } END_TEST
 
+static void
+clientReadMixedCallback(UA_Client *client, void *userdata,
+                        UA_UInt32 requestId, UA_ReadResponse *rr) {
+    ck_assert_uint_eq(rr->responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(rr->resultsSize, 2);
+    ck_assert(UA_Variant_hasScalarType(&rr->results[0].value,
+                                       &UA_TYPES[UA_TYPES_UINT32]));
+    ck_assert_uint_eq(*(UA_UInt32*)rr->results[0].value.data, 42);
+    ck_assert(UA_Variant_hasArrayType(&rr->results[1].value,
+                                      &UA_TYPES[UA_TYPES_DOUBLE]));
+    ck_assert_uint_eq(rr->results[1].value.arrayLength, 64);
+    for(size_t i = 0; i < 64; i++)
+        ck_assert(((UA_Double*)rr->results[1].value.data)[i] == (UA_Double)i);
+    clientCounter++;
+}
+
+static void
+clientReadCountCallback(UA_Client *client, void *userdata,
+                        UA_UInt32 requestId, UA_ReadResponse *rr) {
+    clientCounter++;
+}
+
+/* The synchronous result in an async response must survive the processing of
+ * other requests on the SecureChannel */
+START_TEST(Async_read_mixed) {
+    UA_Double d[64];
+    for(size_t i = 0; i < 64; i++)
+        d[i] = (UA_Double)i;
+    UA_Variant v;
+    UA_Variant_setArray(&v, d, 64, &UA_TYPES[UA_TYPES_DOUBLE]);
+    UA_StatusCode retval = UA_Server_writeValue(server, UA_NODEID_STRING(1, "syncVar"), v);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_Client *client = UA_Client_newForUnitTest();
+    retval = UA_Client_connect(client, "opc.tcp://localhost:4840");
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* Stop the server thread. Iterate manually from now on */
+    running = false;
+    THREAD_JOIN(server_thread);
+
+    UA_ReadValueId rvi[2];
+    UA_ReadValueId_init(&rvi[0]);
+    rvi[0].nodeId = UA_NODEID_STRING(1, "asyncVar");
+    rvi[0].attributeId = UA_ATTRIBUTEID_VALUE;
+    UA_ReadValueId_init(&rvi[1]);
+    rvi[1].nodeId = UA_NODEID_STRING(1, "syncVar");
+    rvi[1].attributeId = UA_ATTRIBUTEID_VALUE;
+    UA_ReadRequest request;
+    UA_ReadRequest_init(&request);
+    request.nodesToRead = rvi;
+    request.nodesToReadSize = 2;
+    retval = UA_Client_sendAsyncReadRequest(client, &request, clientReadMixedCallback,
+                                            NULL, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* Send more requests on the SecureChannel before the async response */
+    UA_ReadValueId rvi2[32];
+    for(size_t i = 0; i < 32; i++) {
+        UA_ReadValueId_init(&rvi2[i]);
+        rvi2[i].nodeId = UA_NS0ID(SERVER_NAMESPACEARRAY);
+        rvi2[i].attributeId = UA_ATTRIBUTEID_VALUE;
+    }
+    UA_ReadRequest request2;
+    UA_ReadRequest_init(&request2);
+    request2.nodesToRead = rvi2;
+    request2.nodesToReadSize = 32;
+    for(size_t i = 0; i < 10; i++) {
+        retval = UA_Client_sendAsyncReadRequest(client, &request2, clientReadCountCallback,
+                                                NULL, NULL);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
+    while(clientCounter < 10) {
+        UA_Server_run_iterate(server, true);
+        UA_Client_run_iterate(client, 0);
+    }
+    ck_assert_uint_eq(clientCounter, 10);
+
+    /* Iterate and pick up the async response to be sent out */
+    while(clientCounter == 10) {
+        UA_fakeSleep(1000);
+        UA_Server_run_iterate(server, true);
+        UA_Client_run_iterate(client, 0);
+    }
+    ck_assert_uint_eq(clientCounter, 11);
+
+    running = true;
+    THREAD_CREATE(server_thread, serverloop);
+
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+} END_TEST
+
 START_TEST(Async_write) {
     UA_Client *client = UA_Client_newForUnitTest();
     UA_StatusCode retval = UA_Client_connect(client, "opc.tcp://localhost:4840");
@@ -478,6 +571,7 @@ static Suite* method_async_suite(void) {
     tcase_add_checked_fixture(tc_manager, setup, teardown);
     tcase_add_test(tc_manager, Async_call);
     tcase_add_test(tc_manager, Async_read);
+    tcase_add_test(tc_manager, Async_read_mixed);
     tcase_add_test(tc_manager, Async_write);
     tcase_add_test(tc_manager, Async_timeout);
     tcase_add_test(tc_manager, Async_forget);
@@ -135,6 +135,9 @@ endfunction()
 #                   attached to the server.
 #   [GEN_DOC]       Optional argument. If given, a .rst file for documenting the
 #                   generated datatypes is generated.
+#   [GEN_CODECS]    Optional argument. If given, specialized binary en-/decoding
+#                   functions are generated for the structures. Only for the
+#                   types compiled into the library (uses internal headers).
 #
 #   Arguments taking one value:
 #
@@ -163,7 +166,7 @@ endfunction()
 
 function(ua_generate_datatypes)
     find_package(Python3 REQUIRED)
-    set(options BUILTIN INTERNAL AUTOLOAD GEN_DOC)
+    set(options BUILTIN INTERNAL AUTOLOAD GEN_DOC GEN_CODECS)
     set(oneValueArgs NAME TARGET_SUFFIX TARGET_PREFIX OUTPUT_DIR FILE_XML FILE_CSV)
     set(multiValueArgs FILES_BSD IMPORT_BSD FILES_SELECTED)
     cmake_parse_arguments(UA_GEN_DT "${options}" "${oneValueArgs}" "${multiValueArgs}" ${ARGN} )
@@ -203,6 +206,11 @@ function(ua_generate_datatypes)
         set(UA_GEN_DOC_ARG "--gen-doc")
     endif()
 
+    set(UA_GEN_CODECS_ARG "")
+    if(UA_GEN_DT_GEN_CODECS)
+        set(UA_GEN_CODECS_ARG "--gen-codecs")
+    endif()
+
     set(UA_GEN_DT_INTERNAL_ARG "")
     if(UA_GEN_DT_INTERNAL)
         set(UA_GEN_DT_INTERNAL_ARG "--internal")
@@ -247,6 +255,7 @@ function(ua_generate_datatypes)
                                ${UA_GEN_DT_INTERNAL_ARG}
                                ${UA_GEN_DT_OUTPUT_DIR}/${UA_GEN_DT_NAME}
                                ${UA_GEN_DOC_ARG}
+                               ${UA_GEN_CODECS_ARG}
                        OUTPUT  ${UA_GEN_DT_OUTPUT_DIR}/${UA_GEN_DT_NAME}_generated.c
                                ${UA_GEN_DT_OUTPUT_DIR}/${UA_GEN_DT_NAME}_generated.h
                        DEPENDS ${open62541_TOOLS_DIR}/generate_datatypes.py
@@ -72,6 +72,11 @@ parser.add_argument('--gen-doc',
                     dest="gen_doc",
                     help='Generate a .rst documentation version of the type definition')
 
+parser.add_argument('--gen-codecs',
+                    action='store_true',
+                    dest="gen_codecs",
+                    help='Generate specialized binary en-/decoding functions for the structures (only for types compiled into the library)')
+
 parser.add_argument('-t', '--type-bsd',
                     metavar="<typeBsds>",
                     type=argparse.FileType('r'),
@@ -120,6 +125,26 @@ builtin_overlayable = {"SByte": "true",
                                "offsetof(UA_Guid, data3) == (sizeof(UA_UInt16) + sizeof(UA_UInt32)) && " +
                                "offsetof(UA_Guid, data4) == (2*sizeof(UA_UInt32)))"}
 
+# Fixed-size types that are en-/decoded inline by the generated codecs. Maps the
+# type kind to the encoded length. Float and Double are not included as the NaN
+# values are normalized during encoding.
+codec_fixed_size = {"UA_DATATYPEKIND_BOOLEAN": 1,
+                    "UA_DATATYPEKIND_SBYTE": 1,
+                    "UA_DATATYPEKIND_BYTE": 1,
+                    "UA_DATATYPEKIND_INT16": 2,
+                    "UA_DATATYPEKIND_UINT16": 2,
+                    "UA_DATATYPEKIND_INT32": 4,
+                    "UA_DATATYPEKIND_UINT32": 4,
+                    "UA_DATATYPEKIND_STATUSCODE": 4,
+                    "UA_DATATYPEKIND_ENUM": 4,
+                    "UA_DATATYPEKIND_INT64": 8,
+                    "UA_DATATYPEKIND_UINT64": 8,
+                    "UA_DATATYPEKIND_DATETIME": 8}
+
+# Maximum length of a run of fixed-size members. A run that spans two buffers
+# is decoded from the stitch buffer (UA_DECODE_STITCH_MAX).
+codec_max_run = 64
+
 whitelistFuncAttrWarnUnusedResult = []  # for instances [ "String", "ByteString", "LocalizedText" ]
 
 
@@ -147,12 +172,13 @@ def getNodeidTypeAndId(nodeId):
         return "UA_NODEIDTYPE_STRING, {{ .string = UA_STRING_STATIC(\"{id}\") }}".format(id=strId.replace("\"", "\\\""))
 
 class CGenerator:
-    def __init__(self, parser, inname, outfile, is_internal_types, gen_doc, namespaceMap):
+    def __init__(self, parser, inname, outfile, is_internal_types, gen_doc, gen_codecs, namespaceMap):
         self.parser = parser
         self.inname = inname
         self.outfile = outfile
         self.is_internal_types = is_internal_types
         self.gen_doc = gen_doc
+        self.gen_codecs = gen_codecs
         self.filtered_types = None
         self.namespaceMap = namespaceMap
         self.fh = None
@@ -312,6 +338,199 @@ class CGenerator:
                 before = member
         return members + "};"
 
+    def has_codec(self, datatype):
+        return self.gen_codecs and isinstance(datatype, StructType) and \
+            self.get_type_kind(datatype) == "UA_DATATYPEKIND_STRUCTURE"
+
+    def get_codec_member(self, member):
+        """Returns the C type, type kind and UA_DataType pointer of a member"""
+        if not member.member_type.members and isinstance(member.member_type, StructType):
+            type_name = "ExtensionObject"
+            kind = "UA_DATATYPEKIND_EXTENSIONOBJECT"
+        else:
+            type_name = member.member_type.name
+            kind = self.get_type_kind(member.member_type)
+        ptr = "&UA_{}[UA_{}_{}]".format(member.member_type.outname.upper(),
+                                        member.member_type.outname.upper(),
+                                        makeCIdentifier(type_name.upper()))
+        return ("UA_" + makeCIdentifier(type_name), kind, ptr)
+
+    def get_codec_runs(self, datatype):
+        """Group the members into runs of fixed-size scalars (that need only a
+        single buffer length check) and single other members"""
+        runs = []
+        run_size = 0
+        for member in datatype.members:
+            (_, kind, _) = self.get_codec_member(member)
+            fixed = not member.is_array and kind in codec_fixed_size
+            size = codec_fixed_size[kind] if fixed else 0
+            if fixed and len(runs) > 0 and runs[-1][0] and \
+               run_size + size <= codec_max_run:
+                runs[-1][1].append(member)
+                run_size += size
+            else:
+                runs.append((fixed, [member]))
+                run_size = size
+        return runs
+
+    def print_codec_prototypes(self, datatype):
+        idName = makeCIdentifier(datatype.name)
+        return "static UA_StatusCode\n" + \
+            "{}_encodeBinaryCodec(Ctx *UA_RESTRICT ctx, const UA_{} *UA_RESTRICT src,\n".format(idName, idName) + \
+            "    const UA_DataType *type);\n" + \
+            "static UA_StatusCode\n" + \
+            "{}_decodeBinaryCodec(Ctx *UA_RESTRICT ctx, UA_{} *UA_RESTRICT dst,\n".format(idName, idName) + \
+            "    const UA_DataType *type);"
+
+    @staticmethod
+    def print_codec_encode_func(member, kind, codec_names):
+        # Directly call the generated encoding of the member type
+        if (member.member_type.outname, member.member_type.name) in codec_names:
+            return "(encodeBinarySignature){}_encodeBinaryCodec".format(
+                makeCIdentifier(member.member_type.name))
+        return "encodeBinaryJumpTable[{}]".format(kind)
+
+    def print_codec_encode(self, datatype, codec_names):
+        idName = makeCIdentifier(datatype.name)
+        out = "static UA_StatusCode\n"
+        out += "{}_encodeBinaryCodec(Ctx *UA_RESTRICT ctx, const UA_{} *UA_RESTRICT src,\n".format(idName, idName)
+        out += "    const UA_DataType *type) {\n"
+        out += "    if(ctx->depth > UA_ENCODING_MAX_RECURSION)\n"
+        out += "        return UA_STATUSCODE_BADENCODINGERROR;\n"
+        out += "    ctx->depth++;\n"
+        out += "    UA_StatusCode ret = UA_STATUSCODE_GOOD;\n"
+        for (fixed, members) in self.get_codec_runs(datatype):
+            if not fixed:
+                m = members[0]
+                name = makeCIdentifier(m.name)
+                (_, kind, ptr) = self.get_codec_member(m)
+                if m.is_array:
+                    out += "    ret = Array_encodeBinary(ctx, src->{}, src->{}Size, {});\n".format(name, name, ptr)
+                else:
+                    out += "    ret = encodeWithExchangeBufferFunc(ctx, {},\n".format(
+                        self.print_codec_encode_func(m, kind, codec_names))
+                    out += "        &src->{}, {});\n".format(name, ptr)
+                out += "    if(ret != UA_STATUSCODE_GOOD)\n        goto out;\n"
+                continue
+            # Encode the run inline if it fits into the buffer. Otherwise fall
+            # back to the member-wise encoding which exchanges the buffer.
+            size = sum([codec_fixed_size[self.get_codec_member(m)[1]] for m in members])
+            out += "    if(!ctx->end) {\n"
+            out += "        ctx->pos += {};\n".format(size)
+            out += "    }} else if(ctx->pos + {} <= ctx->end) {{\n".format(size)
+            offset = 0
+            for m in members:
+                name = makeCIdentifier(m.name)
+                (_, kind, _) = self.get_codec_member(m)
+                length = codec_fixed_size[kind]
+                pos = "ctx->pos + {}".format(offset) if offset > 0 else "ctx->pos"
+                if length == 1:
+                    out += "        ctx->pos[{}] = (UA_Byte)src->{};\n".format(offset, name)
+                else:
+                    out += "        encodeFixed{}({}, (UA_UInt{})src->{});\n".format(
+                        length * 8, pos, length * 8, name)
+                offset += length
+            out += "        ctx->pos += {};\n".format(size)
+            out += "    } else {\n"
+            for m in members:
+                name = makeCIdentifier(m.name)
+                (_, kind, ptr) = self.get_codec_member(m)
+                out += "        ret = encodeWithExchangeBufferFunc(ctx, encodeBinaryJumpTable[{}],\n".format(kind)
+                out += "            &src->{}, {});\n".format(name, ptr)
+                out += "        if(ret != UA_STATUSCODE_GOOD)\n            goto out;\n"
+            out += "    }\n"
+        out += " out:\n"
+        out += "    ctx->depth--;\n"
+        out += "    return ret;\n"
+        out += "}"
+        return out
+
+    def print_codec_decode(self, datatype, codec_names):
+        idName = makeCIdentifier(datatype.name)
+        out = "static UA_StatusCode\n"
+        out += "{}_decodeBinaryCodec(Ctx *UA_RESTRICT ctx, UA_{} *UA_RESTRICT dst,\n".format(idName, idName)
+        out += "    const UA_DataType *type) {\n"
+        out += "    if(ctx->depth > UA_ENCODING_MAX_RECURSION)\n"
+        out += "        return UA_STATUSCODE_BADENCODINGERROR;\n"
+        out += "    ctx->depth++;\n"
+        out += "    UA_StatusCode ret = UA_STATUSCODE_GOOD;\n"
+        for (fixed, members) in self.get_codec_runs(datatype):
+            if not fixed:
+                m = members[0]
+                name = makeCIdentifier(m.name)
+                (_, kind, ptr) = self.get_codec_member(m)
+                if m.is_array:
+                    out += "    ret = Array_decodeBinary(ctx, (void**)&dst->{}, &dst->{}Size, {});\n".format(name, name, ptr)
+                elif (m.member_type.outname, m.member_type.name) in codec_names:
+                    # Directly call the generated decoding of the member type
+                    out += "    ret = {}_decodeBinaryCodec(ctx, &dst->{}, {});\n".format(
+                        makeCIdentifier(m.member_type.name), name, ptr)
+                else:
+                    out += "    ret = decodeBinaryJumpTable[{}](ctx, &dst->{}, {});\n".format(kind, name, ptr)
+                out += "    if(ret != UA_STATUSCODE_GOOD)\n        goto out;\n"
+                continue
+            # Check the buffer length once for the run. Continue in the next
+            # buffer if decoding from a sequence of buffers.
+            size = sum([codec_fixed_size[self.get_codec_member(m)[1]] for m in members])
+            out += "    if(ctx->pos + {} > ctx->end) {{\n".format(size)
+            out += "        ret = nextDecodeBuffer(ctx, {});\n".format(size)
+            out += "        if(ret != UA_STATUSCODE_GOOD)\n"
+            out += "            goto out;\n"
+            out += "    }\n"
+            offset = 0
+            for m in members:
+                name = makeCIdentifier(m.name)
+                (ctype, kind, _) = self.get_codec_member(m)
+                length = codec_fixed_size[kind]
+                pos = "ctx->pos + {}".format(offset) if offset > 0 else "ctx->pos"
+                if kind == "UA_DATATYPEKIND_BOOLEAN":
+                    out += "    dst->{} = (ctx->pos[{}] > 0) ? true : false;\n".format(name, offset)
+                elif length == 1:
+                    out += "    dst->{} = ({})ctx->pos[{}];\n".format(name, ctype, offset)
+                else:
+                    out += "    dst->{} = ({})decodeFixed{}({});\n".format(name, ctype, length * 8, pos)
+                offset += length
+            out += "    ctx->pos += {};\n".format(size)
+        out += " out:\n"
+        out += "    ctx->depth--;\n"
+        out += "    return ret;\n"
+        out += "}"
+        return out
+
+    def print_codecs(self):
+        codec_types = []
+        for ns in self.filtered_types:
+            for t_name in self.filtered_types[ns]:
+                t = self.filtered_types[ns][t_name]
+                if self.has_codec(t):
+                    codec_types.append(t)
+        if len(codec_types) == 0:
+            return
+
+        self.printc("\n/* Generated binary en-/decoding */")
+        codec_names = set([(t.outname, t.name) for t in codec_types])
+        for t in codec_types:
+            self.printc("\n" + self.print_codec_prototypes(t))
+        for t in codec_types:
+            idName = makeCIdentifier(t.name)
+            self.printc("\n/* " + t.name + " */")
+            self.printc(self.print_codec_encode(t, codec_names) + "\n")
+            self.printc(self.print_codec_decode(t, codec_names) + "\n")
+            self.printc("static const UA_DataTypeBinaryCodec {}_binaryCodec = {{\n".format(idName) +
+                        "    (encodeBinarySignature){}_encodeBinaryCodec,\n".format(idName) +
+                        "    (decodeBinarySignature){}_decodeBinaryCodec\n}};".format(idName))
+
+    def print_codec_table(self):
+        # Side table of the codecs. Indexed like the array of type descriptions.
+        outname = self.parser.outname.upper()
+        self.printc("const UA_DataTypeBinaryCodec *UA_{}_BINARYCODECS[UA_{}_COUNT] = {{".format(outname, outname))
+        for ns in self.filtered_types:
+            for t_name in self.filtered_types[ns]:
+                t = self.filtered_types[ns][t_name]
+                codec = "&%s_binaryCodec" % makeCIdentifier(t.name) if self.has_codec(t) else "NULL"
+                self.printc("    {}, /* {} */".format(codec, t.name))
+        self.printc("};\n")
+
     @staticmethod
     def print_datatype_ptr(datatype):
         return "&UA_" + datatype.outname.upper() + "[UA_" + makeCIdentifier(
@@ -562,6 +781,8 @@ _UA_END_DECLS
  **********************************/
 
 #include "''' + self.parser.outname + '''_generated.h"''')
+        if self.gen_codecs:
+            self.printc('#include "ua_types_encoding_binary.h"')
 
         totalCount = 0
         for ns in self.filtered_types:
@@ -572,6 +793,9 @@ _UA_END_DECLS
                 self.printc("/* " + t.name + " */")
                 self.printc(CGenerator.print_members(t))
 
+        if self.gen_codecs:
+            self.print_codecs()
+
         if totalCount > 0:
             self.printc(
                 "UA_DataType UA_{}[UA_{}_COUNT] = {{".format(self.parser.outname.upper(), self.parser.outname.upper()))
@@ -583,6 +807,9 @@ _UA_END_DECLS
                     self.printc(self.print_datatype(t) + ",")
             self.printc("};\n")
 
+            if self.gen_codecs:
+                self.print_codec_table()
+
 ###########################################
 # Execute with the command line arguments #
 ###########################################
@@ -603,5 +830,5 @@ parser = CSVBSDTypeParser(args.opaque_map, args.selected_types,
                           namespaceMap)
 parser.create_types()
 
-generator = CGenerator(parser, inname, args.outfile, args.internal, args.gen_doc, namespaceMap)
+generator = CGenerator(parser, inname, args.outfile, args.internal, args.gen_doc, args.gen_codecs, namespaceMap)
 generator.write_definitions()
@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+
+### This Source Code Form is subject to the terms of the Mozilla Public
+### License, v. 2.0. If a copy of the MPL was not distributed with this
+### file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+# The image backend generates the same code as the open62541 backend. In
+# addition it generates <outputFile>_image.c with a main function. Compiled and
+# linked with the generated code and the library, the program creates a server
+# with all nodes and writes the Nodestore image (see UA_Nodestore_Image) into
+# the file given as the first argument.
+
+from .nodeset import *
+from .backend_open62541 import generateOpen62541Code
+
+from os.path import basename
+import codecs
+
+import logging
+logger = logging.getLogger(__name__)
+
+def generateImageCode(nodeset, outfilename, internal_headers=False, typesArray=[]):
+    generateOpen62541Code(nodeset, outfilename, internal_headers, typesArray)
+    outfilebase = basename(outfilename)
+
+    # The nodes of namespace zero are added by the server itself. Call the
+    # generated function only if there are additional nodes.
+    addNodes = any(not node.hidden and node.id.ns != 0
+                   for node in nodeset.nodes.values())
+    if addNodes:
+        addCode = """    UA_StatusCode res = %s(server);
+    if(res != UA_STATUSCODE_GOOD) {
+        fprintf(stderr, "Adding the nodes failed: %%s\\n", UA_StatusCode_name(res));
+        UA_Server_delete(server);
+        return EXIT_FAILURE;
+    }
+""" % outfilebase
+    else:
+        addCode = ""
+
+    outfilec = codecs.open(outfilename + "_image.c", r"w+", encoding='utf-8')
+    outfilec.write("""/* WARNING: This is a generated file.
+ * Any manual changes will be overwritten. */
+
+#include <open62541/server.h>
+#include <open62541/plugin/nodestore_default.h>
+
+#include "%s.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+int main(int argc, char **argv) {
+    if(argc != 2) {
+        fprintf(stderr, "Usage: %%s <image file>\\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    UA_Server *server = UA_Server_new();
+    if(!server)
+        return EXIT_FAILURE;
+
+%s
+    UA_ByteString image = UA_BYTESTRING_NULL;
+    UA_StatusCode retval = UA_Nodestore_Image_write(server, &image);
+    UA_Server_delete(server);
+    if(retval != UA_STATUSCODE_GOOD) {
+        fprintf(stderr, "Writing the image failed: %%s\\n", UA_StatusCode_name(retval));
+        return EXIT_FAILURE;
+    }
+
+    FILE *f = fopen(argv[1], "wb");
+    size_t written = 0;
+    if(f) {
+        written = fwrite(image.data, 1, image.length, f);
+        fclose(f);
+    }
+    UA_Boolean complete = (written == image.length);
+    UA_ByteString_clear(&image);
+    if(!complete) {
+        fprintf(stderr, "Could not write %%s\\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+""" % (outfilebase, addCode))
+    outfilec.close()
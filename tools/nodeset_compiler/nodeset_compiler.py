@@ -89,7 +89,7 @@ parser.add_argument('--backend',
                     default='open62541',
                     const='open62541',
                     nargs='?',
-                    choices=['open62541', 'graphviz'],
+                    choices=['open62541', 'image', 'graphviz'],
                     help='Backend for the output files (default: %(default)s)')
 
 args = parser.parse_args()
@@ -225,6 +225,10 @@ if args.backend == "open62541":
     # Create the C code with the open62541 backend of the compiler
     from .backend_open62541 import generateOpen62541Code
     generateOpen62541Code(ns, args.outputFile, args.internal_headers, args.typesArray)
+elif args.backend == "image":
+    # Additionally create a program that writes the Nodestore image
+    from .backend_image import generateImageCode
+    generateImageCode(ns, args.outputFile, args.internal_headers, args.typesArray)
 elif args.backend == "graphviz":
     from .backend_graphviz import generateGraphvizCode
     generateGraphvizCode(ns, filename=args.outputFile)